@@ -0,0 +1,58 @@
+/**
+ *  Measures the throughput of moving a chunk between the two shards of a local cluster, once with a
+ *  single clone stream and once with several concurrent clone streams.
+ *
+ *  Run with: mongo --nodb jstests/perf/chunk_migration_throughput.js
+ */
+(function() {
+"use strict";
+
+var docs = 200000;
+var collection_name = "chunk_migration_throughput";
+
+function measure(chunkMigrationConcurrency) {
+    // Raise the maximum chunk size so that the whole collection can move as a single chunk
+    var st = new ShardingTest({
+        shards: 2,
+        other: {
+            chunkSize: 1024,
+            shardOptions: {setParameter: {chunkMigrationConcurrency: chunkMigrationConcurrency}}
+        }
+    });
+
+    var ns = "test." + collection_name;
+    assert.commandWorked(st.s.adminCommand({enableSharding: "test"}));
+    st.ensurePrimaryShard("test", st.shard0.shardName);
+    assert.commandWorked(st.s.adminCommand({shardCollection: ns, key: {_id: 1}}));
+
+    var coll = st.s.getDB("test")[collection_name];
+    var payload = "x".repeat(1024);
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < docs; i++) {
+        bulk.insert({_id: i, a: i % 100, payload: payload});
+    }
+    assert.commandWorked(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    var start = Date.now();
+    assert.commandWorked(st.s.adminCommand({
+        moveChunk: ns,
+        find: {_id: 0},
+        to: st.shard1.shardName,
+        _waitForDelete: true
+    }));
+    var millis = Date.now() - start;
+    st.stop();
+
+    return {
+        chunkMigrationConcurrency: chunkMigrationConcurrency,
+        millis: millis,
+        docsPerSec: Math.round(docs * 1000 / millis)
+    };
+}
+
+var before = measure(1);
+var after = measure(4);
+print("moveChunk throughput before: " + tojson(before));
+print("moveChunk throughput after:  " + tojson(after));
+})();
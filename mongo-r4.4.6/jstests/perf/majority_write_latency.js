@@ -0,0 +1,53 @@
+/**
+ *  Measures the latency of w:majority writes on a local three-node replica set, once with the
+ *  secondaries reporting progress one replSetUpdatePosition at a time and once with pipelined
+ *  progress reports.
+ *
+ *  Run with: mongo --nodb jstests/perf/majority_write_latency.js
+ */
+(function() {
+"use strict";
+
+var writes = 2000;
+var collection_name = "majority_write_latency";
+
+function percentile(sorted, p) {
+    return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+}
+
+function measure(maxInFlightUpdates) {
+    var rst = new ReplSetTest({
+        nodes: 3,
+        nodeOptions: {setParameter: {replProgressMaxInFlightUpdates: maxInFlightUpdates}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    var coll = rst.getPrimary().getDB("test")[collection_name];
+    assert.commandWorked(coll.insert({_id: -1}, {writeConcern: {w: "majority"}}));
+
+    var latencies = [];
+    for (var i = 0; i < writes; i++) {
+        var start = Date.now();
+        assert.commandWorked(coll.insert({_id: i}, {writeConcern: {w: "majority"}}));
+        latencies.push(Date.now() - start);
+    }
+    rst.stopSet();
+
+    latencies.sort(function(a, b) {
+        return a - b;
+    });
+    return {
+        maxInFlightUpdates: maxInFlightUpdates,
+        p50: percentile(latencies, 0.5),
+        p90: percentile(latencies, 0.9),
+        p99: percentile(latencies, 0.99),
+        max: latencies[latencies.length - 1]
+    };
+}
+
+var before = measure(1);
+var after = measure(2);
+print("w:majority insert latency (ms) before: " + tojson(before));
+print("w:majority insert latency (ms) after:  " + tojson(after));
+})();
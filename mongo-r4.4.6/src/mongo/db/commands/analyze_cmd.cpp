@@ -0,0 +1,215 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Scans the whole index 'desc' and builds the statistics of its leading field. The scan yields its
+ * locks periodically and checks for interrupts when it does, so that analyzing a large index
+ * neither blocks writers nor holds a storage snapshot open for the duration of the scan. It throws
+ * if the collection or the index is dropped while the scan yields.
+ */
+std::shared_ptr<const IndexStatistics> buildIndexStatistics(OperationContext* opCtx,
+                                                            const Collection* collection,
+                                                            const IndexDescriptor* desc) {
+    // Bound the scan by the first and the last key whatever the direction of each field
+    BSONObjBuilder startKey;
+    BSONObjBuilder endKey;
+    for (const auto& field : desc->keyPattern()) {
+        if (field.number() < 0) {
+            startKey.appendMaxKey("");
+            endKey.appendMinKey("");
+        } else {
+            startKey.appendMinKey("");
+            endKey.appendMaxKey("");
+        }
+    }
+
+    auto expCtx = make_intrusive<ExpressionContext>(
+        opCtx, std::unique_ptr<CollatorInterface>(nullptr), collection->ns());
+    auto ws = std::make_unique<WorkingSet>();
+
+    IndexScanParams params(opCtx, desc);
+    params.bounds.isSimpleRange = true;
+    params.bounds.startKey = startKey.obj();
+    params.bounds.endKey = endKey.obj();
+    params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+    // Every key counts towards the statistics, including the keys of the same multikey document
+    params.shouldDedup = false;
+    auto root = std::make_unique<IndexScan>(expCtx.get(), std::move(params), ws.get(), nullptr);
+
+    auto exec = uassertStatusOK(PlanExecutor::make(
+        expCtx, std::move(ws), std::move(root), collection, PlanExecutor::YIELD_AUTO));
+
+    IndexStatisticsBuilder builder(internalQueryStatisticsSampleSize.load(),
+                                   opCtx->getClient()->getPrng().nextInt64());
+
+    BSONObj key;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&key, nullptr))) {
+        builder.addKey(key);
+    }
+
+    if (PlanExecutor::FAILURE == state) {
+        uassertStatusOK(WorkingSetCommon::getMemberObjectStatus(key).withContext(
+            "Executor error while scanning the index for the analyze command"));
+    }
+
+    return builder.done(collection->numRecords(opCtx));
+}
+
+/**
+ * The 'analyze' command collects the statistics used for cost-based plan selection for all the
+ * btree indexes of a collection, or for a single one of them:
+ *
+ *    {
+ *        analyze: <collection>,
+ *        index: <index name>
+ *    }
+ *
+ * The statistics are kept in memory and are lost on restart and when the index is dropped.
+ */
+class AnalyzeCommand final : public BasicCommand {
+public:
+    AnalyzeCommand() : BasicCommand("analyze") {}
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kOptIn;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        AuthorizationSession* authzSession = AuthorizationSession::get(client);
+        ResourcePattern pattern = parseResourcePattern(dbname, cmdObj);
+
+        if (authzSession->isAuthorizedForActionsOnResource(pattern, ActionType::planCacheWrite)) {
+            return Status::OK();
+        }
+
+        return Status(ErrorCodes::Unauthorized, "unauthorized");
+    }
+
+    std::string help() const override {
+        return "Collects the index statistics used to choose query plans by estimated cost.";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        std::string indexName;
+        if (auto indexElem = cmdObj["index"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'index' must be the name of an index",
+                    indexElem.type() == String);
+            indexName = indexElem.String();
+        }
+
+        // The statistics are owned by the collection, but collecting them only reads it.
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "collection " << nss << " does not exist",
+                collection);
+
+        // The index catalog may change while the scans yield, so the indexes are only looked up
+        // by name before each scan.
+        std::vector<std::string> indexNames;
+        bool foundIndex = false;
+        auto ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (ii->more()) {
+            const IndexDescriptor* desc = ii->next()->descriptor();
+            if (!indexName.empty() && desc->indexName() != indexName) {
+                continue;
+            }
+            foundIndex = true;
+
+            if (desc->getIndexType() == INDEX_BTREE) {
+                indexNames.push_back(desc->indexName());
+            }
+        }
+
+        uassert(ErrorCodes::IndexNotFound,
+                str::stream() << "index " << indexName << " does not exist on " << nss,
+                indexName.empty() || foundIndex);
+
+        BSONObjBuilder indexesBuilder(result.subobjStart("indexes"));
+        for (const auto& name : indexNames) {
+            const IndexDescriptor* desc =
+                collection->getIndexCatalog()->findIndexByName(opCtx, name);
+            uassert(ErrorCodes::IndexNotFound,
+                    str::stream() << "index " << name << " was dropped while analyzing " << nss,
+                    desc);
+
+            auto stats = buildIndexStatistics(opCtx, collection, desc);
+            indexesBuilder.append(name, stats->toBSON());
+            CollectionQueryInfo::get(collection).setIndexStatistics(name, std::move(stats));
+        }
+        indexesBuilder.doneFast();
+
+        LOGV2_DEBUG(5023419,
+                    1,
+                    "Collected index statistics",
+                    "namespace"_attr = nss,
+                    "index"_attr = indexName);
+        return true;
+    }
+} analyzeCommand;
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,184 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/and_bitmap.h"
+
+#include <algorithm>
+
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Upper limit for the bitmaps. Stage execution fails once they use more than this, which takes
+// hundreds of millions of RecordIds.
+const size_t kDefaultMaxMemUsageBytes = 32 * 1024 * 1024;
+
+}  // namespace
+
+// static
+const char* AndBitmapStage::kStageType = "AND_BITMAP";
+
+AndBitmapStage::AndBitmapStage(ExpressionContext* expCtx, WorkingSet* ws)
+    : AndBitmapStage(expCtx, ws, kDefaultMaxMemUsageBytes) {}
+
+AndBitmapStage::AndBitmapStage(ExpressionContext* expCtx, WorkingSet* ws, size_t maxMemUsage)
+    : PlanStage(kStageType, expCtx), _ws(ws), _maxMemUsage(maxMemUsage) {}
+
+void AndBitmapStage::addChild(std::unique_ptr<PlanStage> child) {
+    _children.emplace_back(std::move(child));
+}
+
+bool AndBitmapStage::isEOF() {
+    if (_exhausted) {
+        return true;
+    }
+
+    // We're done when the last child is, provided we got as far as reading it.
+    invariant(_children.size() >= 2);
+    return _currentChild == _children.size() - 1 && _children.back()->isEOF();
+}
+
+PlanStage::StageState AndBitmapStage::doWork(WorkingSetID* out) {
+    if (isEOF()) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (_currentChild < _children.size() - 1) {
+        return readChild(out);
+    }
+    return probeLastChild(out);
+}
+
+PlanStage::StageState AndBitmapStage::readChild(WorkingSetID* out) {
+    auto& bitmap = _currentChild == 0 ? _bitmap : _childBitmap;
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState childStatus = _children[_currentChild]->work(&id);
+
+    if (PlanStage::ADVANCED == childStatus) {
+        WorkingSetMember* member = _ws->get(id);
+
+        // The child must give us a WorkingSetMember with a record id, since we intersect index keys
+        // based on the record id. The planner ensures that the child stage can never produce an
+        // WSM with no record id.
+        invariant(member->hasRecordId());
+
+        // A later child only needs the RecordIds which survived the previous ones.
+        if (_currentChild == 0 || _bitmap.contains(member->recordId)) {
+            bitmap.insert(member->recordId);
+        }
+        _ws->free(id);
+
+        const size_t memUsage = _bitmap.getMemUsage() + _childBitmap.getMemUsage();
+        if (memUsage > _maxMemUsage) {
+            str::stream ss;
+            ss << "bitmap AND stage buffered data usage of " << memUsage
+               << " bytes exceeds internal limit of " << _maxMemUsage << " bytes";
+            Status status(ErrorCodes::Overflow, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::IS_EOF == childStatus) {
+        if (_currentChild > 0) {
+            _bitmap.intersectWith(_childBitmap);
+            _childBitmap = RecordIdBitmap();
+        }
+        _specificStats.bitmapAfterChild.push_back(_bitmap.size());
+        _specificStats.memUsage = std::max(_specificStats.memUsage, _bitmap.getMemUsage());
+
+        // If nothing is left to intersect with, don't read the remaining children.
+        if (_bitmap.empty()) {
+            _exhausted = true;
+            return PlanStage::IS_EOF;
+        }
+
+        ++_currentChild;
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == childStatus) {
+        // The stage which produces a failure is responsible for allocating a working set member
+        // with error details.
+        invariant(WorkingSet::INVALID_ID != id);
+        *out = id;
+        return childStatus;
+    } else {
+        if (PlanStage::NEED_YIELD == childStatus) {
+            *out = id;
+        }
+
+        return childStatus;
+    }
+}
+
+PlanStage::StageState AndBitmapStage::probeLastChild(WorkingSetID* out) {
+    StageState childStatus = _children.back()->work(out);
+    if (PlanStage::ADVANCED != childStatus) {
+        return childStatus;
+    }
+
+    WorkingSetMember* member = _ws->get(*out);
+    invariant(member->hasRecordId());
+
+    // Erasing the RecordId also drops any later copy of the same document from the last child.
+    if (!_bitmap.erase(member->recordId)) {
+        _ws->free(*out);
+        return PlanStage::NEED_TIME;
+    }
+
+    if (_bitmap.empty()) {
+        _exhausted = true;
+    }
+    return PlanStage::ADVANCED;
+}
+
+std::unique_ptr<PlanStageStats> AndBitmapStage::getStats() {
+    _commonStats.isEOF = isEOF();
+
+    _specificStats.memLimit = _maxMemUsage;
+
+    auto ret = std::make_unique<PlanStageStats>(_commonStats, STAGE_AND_BITMAP);
+    ret->specific = std::make_unique<AndBitmapStats>(_specificStats);
+    for (size_t i = 0; i < _children.size(); ++i) {
+        ret->children.emplace_back(_children[i]->getStats());
+    }
+
+    return ret;
+}
+
+const SpecificStats* AndBitmapStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
+
+namespace mongo {
+
+/**
+ * Reads from N children, each of which must have a valid RecordId, and outputs the results of the
+ * last child whose RecordId was also produced by every other child.
+ *
+ * The RecordIds of the first N - 1 children are collected into compressed bitmaps which are
+ * intersected as each child reaches EOF. Unlike AndHashStage no WorkingSetMember is buffered, so
+ * the stage holds a few bits per RecordId, yielding is free, and the intersection of large index
+ * scans stays cheap. The output carries only the last child's index key data.
+ *
+ * Preconditions: Valid RecordId. More than one child.
+ */
+class AndBitmapStage final : public PlanStage {
+public:
+    AndBitmapStage(ExpressionContext* expCtx, WorkingSet* ws);
+
+    /**
+     * For testing only. Allows tests to set memory usage threshold.
+     */
+    AndBitmapStage(ExpressionContext* expCtx, WorkingSet* ws, size_t maxMemUsage);
+
+    void addChild(std::unique_ptr<PlanStage> child);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return STAGE_AND_BITMAP;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    StageState readChild(WorkingSetID* out);
+    StageState probeLastChild(WorkingSetID* out);
+
+    // Not owned by us.
+    WorkingSet* _ws;
+
+    // The intersection of the RecordIds of the children read so far.
+    RecordIdBitmap _bitmap;
+
+    // The RecordIds of the child being read, when it is not the first.
+    RecordIdBitmap _childBitmap;
+
+    // Which child are we currently working on?
+    size_t _currentChild = 0;
+
+    // Set once an empty intersection makes the result empty.
+    bool _exhausted = false;
+
+    AndBitmapStats _specificStats;
+
+    // Upper limit for the memory used by '_bitmap' and '_childBitmap'.
+    size_t _maxMemUsage;
+};
+
+}  // namespace mongo
@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+//
+// This file contains tests for mongo/db/exec/and_bitmap.cpp
+//
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/and_bitmap.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("db.dummy");
+
+class AndBitmapStageTest : public ServiceContextMongoDTest {
+public:
+    AndBitmapStageTest()
+        : _opCtx(makeOperationContext()),
+          _expCtx(make_intrusive<ExpressionContext>(_opCtx.get(), nullptr, kNss)) {}
+
+protected:
+    /**
+     * Returns a stage which produces a WorkingSetMember for each of 'recordIds', in order.
+     */
+    std::unique_ptr<PlanStage> makeChild(const std::vector<int64_t>& recordIds) {
+        auto child = std::make_unique<QueuedDataStage>(_expCtx.get(), &_ws);
+        for (auto recordId : recordIds) {
+            WorkingSetID id = _ws.allocate();
+            _ws.get(id)->recordId = RecordId(recordId);
+            _ws.transitionToRecordIdAndIdx(id);
+            child->pushBack(id);
+        }
+        return child;
+    }
+
+    /**
+     * Works 'stage' to EOF and returns the RecordIds it produced.
+     */
+    std::vector<int64_t> runToEOF(PlanStage* stage) {
+        std::vector<int64_t> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = stage->work(&id)) != PlanStage::IS_EOF) {
+            ASSERT_NE(PlanStage::FAILURE, state);
+            if (state == PlanStage::ADVANCED) {
+                results.push_back(_ws.get(id)->recordId.repr());
+                _ws.free(id);
+            }
+        }
+        return results;
+    }
+
+    ExpressionContext* expCtx() {
+        return _expCtx.get();
+    }
+
+    WorkingSet _ws;
+
+private:
+    ServiceContext::UniqueOperationContext _opCtx;
+    boost::intrusive_ptr<ExpressionContext> _expCtx;
+};
+
+TEST_F(AndBitmapStageTest, OutputsIntersectionInLastChildOrder) {
+    AndBitmapStage stage(expCtx(), &_ws);
+    stage.addChild(makeChild({5, 1, 9, 3, 7}));
+    stage.addChild(makeChild({3, 4, 5, 6, 7, 1}));
+    stage.addChild(makeChild({7, 2, 5, 1}));
+
+    ASSERT(runToEOF(&stage) == std::vector<int64_t>({7, 5, 1}));
+
+    auto stats = stage.getStats();
+    auto specific = static_cast<const AndBitmapStats*>(stats->specific.get());
+    ASSERT(specific->bitmapAfterChild == std::vector<size_t>({5, 4}));
+}
+
+TEST_F(AndBitmapStageTest, DeduplicatesLastChild) {
+    AndBitmapStage stage(expCtx(), &_ws);
+    stage.addChild(makeChild({1, 2, 3}));
+    stage.addChild(makeChild({2, 2, 4, 3, 3}));
+
+    ASSERT(runToEOF(&stage) == std::vector<int64_t>({2, 3}));
+}
+
+TEST_F(AndBitmapStageTest, StopsReadingChildrenOnceIntersectionIsEmpty) {
+    AndBitmapStage stage(expCtx(), &_ws);
+    stage.addChild(makeChild({1, 2}));
+    stage.addChild(makeChild({3, 4}));
+    stage.addChild(makeChild({1, 2, 3, 4}));
+
+    ASSERT(runToEOF(&stage).empty());
+    auto stats = stage.getStats();
+    ASSERT_EQ(0U, stats->children[2]->common.works);
+}
+
+TEST_F(AndBitmapStageTest, IntersectsDenseRanges) {
+    // Enough RecordIds in one chunk for the bitmaps to switch to their dense representation.
+    std::vector<int64_t> evens;
+    std::vector<int64_t> multiplesOfThree;
+    for (int64_t i = 0; i < 30000; ++i) {
+        if (i % 2 == 0) {
+            evens.push_back(i);
+        }
+        if (i % 3 == 0) {
+            multiplesOfThree.push_back(i);
+        }
+    }
+
+    AndBitmapStage stage(expCtx(), &_ws);
+    stage.addChild(makeChild(evens));
+    stage.addChild(makeChild(multiplesOfThree));
+
+    auto results = runToEOF(&stage);
+    ASSERT_EQ(5000U, results.size());
+    for (auto recordId : results) {
+        ASSERT_EQ(0, recordId % 6);
+    }
+}
+
+TEST_F(AndBitmapStageTest, FailsWhenOverMemoryLimit) {
+    AndBitmapStage stage(expCtx(), &_ws, 64);
+    stage.addChild(makeChild({1, 2, 3}));
+    stage.addChild(makeChild({1, 2, 3}));
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state;
+    while ((state = stage.work(&id)) == PlanStage::NEED_TIME) {
+    }
+    ASSERT_EQ(PlanStage::FAILURE, state);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -204,7 +204,11 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache, s
 
     _specificStats.replanReason = std::move(reason);
 
-    if (shouldCache) {
+    // The cached plan may only be poor for the constants of this query, in which case the new plan
+    // is cached for these constants and the entry stays active for the others.
+    const bool cacheParameterVariant =
+        shouldCache && internalQueryCacheMaxParameterVariantsPerEntry.load() > 0;
+    if (shouldCache && !cacheParameterVariant) {
         // Deactivate the current cache entry.
         PlanCache* cache = CollectionQueryInfo::get(collection()).getPlanCache();
         cache->deactivate(*_canonicalQuery);
@@ -220,6 +224,12 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache, s
     auto solutions = std::move(statusWithSolutions.getValue());
 
     if (1 == solutions.size()) {
+        if (cacheParameterVariant) {
+            // No variant can be cached without multi-planning, so deactivate the entry as usual.
+            PlanCache* cache = CollectionQueryInfo::get(collection()).getPlanCache();
+            cache->deactivate(*_canonicalQuery);
+        }
+
         // Only one possible plan. Build the stages from the solution.
         auto newRoot =
             StageBuilder::build(opCtx(), collection(), *_canonicalQuery, *solutions[0], _ws);
@@ -241,8 +251,10 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache, s
 
     // Many solutions. Create a MultiPlanStage to pick the best, update the cache,
     // and so on. The working set will be shared by all candidate plans.
-    auto cachingMode = shouldCache ? MultiPlanStage::CachingMode::AlwaysCache
-                                   : MultiPlanStage::CachingMode::NeverCache;
+    auto cachingMode = cacheParameterVariant
+        ? MultiPlanStage::CachingMode::CacheParameterVariant
+        : shouldCache ? MultiPlanStage::CachingMode::AlwaysCache
+                      : MultiPlanStage::CachingMode::NeverCache;
     _children.emplace_back(
         new MultiPlanStage(expCtx(), collection(), _canonicalQuery, cachingMode));
     MultiPlanStage* multiPlanStage = static_cast<MultiPlanStage*>(child().get());
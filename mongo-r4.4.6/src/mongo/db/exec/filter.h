@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/matchable.h"
 
@@ -159,6 +160,22 @@ public:
         return filter->matches(&doc, nullptr);
     }
 
+    /**
+     * As above, but evaluates 'compiledFilter', the program compiled from 'filter', when 'wsm'
+     * has a document. 'compiledFilter' may be null.
+     */
+    static bool passes(WorkingSetMember* wsm,
+                       const MatchExpression* filter,
+                       const CompiledMatchExpression* compiledFilter) {
+        if (nullptr == filter) {
+            return true;
+        }
+        if (compiledFilter && wsm->hasObj()) {
+            return compiledFilter->matches(wsm->doc.value().toBson());
+        }
+        return passes(wsm, filter);
+    }
+
     static bool passes(const BSONObj& keyData,
                        const BSONObj& keyPattern,
                        const MatchExpression* filter) {
@@ -276,7 +276,8 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // write to the plan cache.
     //
     // TODO: We can remove this if we introduce replanning logic to the SubplanStage.
-    bool canCache = (_cachingMode == CachingMode::AlwaysCache);
+    bool canCache = (_cachingMode == CachingMode::AlwaysCache ||
+                     _cachingMode == CachingMode::CacheParameterVariant);
     if (_cachingMode == CachingMode::SometimesCache) {
         // In "sometimes cache" mode, we cache unless we hit one of the special cases below.
         canCache = true;
@@ -359,7 +360,15 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
             }
         }
 
-        if (validSolutions) {
+        if (validSolutions && _cachingMode == CachingMode::CacheParameterVariant) {
+            CollectionQueryInfo::get(collection())
+                .getPlanCache()
+                ->setParameterVariant(*_query,
+                                      solutions,
+                                      std::move(ranking),
+                                      opCtx()->getServiceContext()->getPreciseClockSource()->now())
+                .transitional_ignore();
+        } else if (validSolutions) {
             CollectionQueryInfo::get(collection())
                 .getPlanCache()
                 ->set(*_query,
@@ -378,7 +387,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.stopped) {
             continue;
         }
 
@@ -439,7 +448,46 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
         }
     }
 
-    return !doneWorking;
+    return !doneWorking && stopLaggingCandidates();
+}
+
+bool MultiPlanStage::stopLaggingCandidates() {
+    const double ratio = internalQueryPlanEvaluationLaggingCandidateRatio.load();
+
+    boost::optional<size_t> leaderIdx;
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        const CandidatePlan& candidate = _candidates[ix];
+        if (!candidate.failed && !candidate.stopped &&
+            (!leaderIdx || candidate.results.size() > _candidates[*leaderIdx].results.size())) {
+            leaderIdx = ix;
+        }
+    }
+    if (!leaderIdx) {
+        return false;
+    }
+    // A ratio below one would stop candidates which returned as many results as the leader
+    if (ratio < 1) {
+        return true;
+    }
+
+    const size_t leaderResults = _candidates[*leaderIdx].results.size();
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        CandidatePlan& candidate = _candidates[ix];
+        if (ix == leaderIdx || candidate.failed || candidate.stopped ||
+            leaderResults < ratio * (candidate.results.size() + 1)) {
+            continue;
+        }
+
+        candidate.stopped = true;
+        LOGV2_DEBUG(5023425,
+                    5,
+                    "Stopped working lagging candidate plan during the trial period",
+                    "candidate"_attr = ix,
+                    "results"_attr = candidate.results.size(),
+                    "leader"_attr = *leaderIdx,
+                    "leaderResults"_attr = leaderResults);
+    }
+    return true;
 }
 
 bool MultiPlanStage::hasBackupPlan() const {
@@ -68,6 +68,10 @@ public:
 
         // Do not write to the plan cache.
         NeverCache,
+
+        // Write the winning plan as a variant of the active cache entry for the query shape, used
+        // only for queries with the same constants. See PlanCache::setParameterVariant().
+        CacheParameterVariant,
     };
 
     /**
@@ -174,6 +178,16 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Stops working the candidates which have returned far fewer results than the candidate with
+     * the most results, as set by 'internalQueryPlanEvaluationLaggingCandidateRatio', so that the
+     * rest of the trial period is spent on the candidates which may still win. A ratio below one
+     * disables stopping candidates.
+     *
+     * Returns false if no candidate is left to work.
+     */
+    bool stopLaggingCandidates();
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
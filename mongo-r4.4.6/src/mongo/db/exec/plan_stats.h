@@ -157,6 +157,29 @@ private:
     PlanStageStats& operator=(const PlanStageStats&) = delete;
 };
 
+struct AndBitmapStats : public SpecificStats {
+    AndBitmapStats() = default;
+
+    SpecificStats* clone() const final {
+        AndBitmapStats* specific = new AndBitmapStats(*this);
+        return specific;
+    }
+
+    uint64_t estimateObjectSizeInBytes() const {
+        return container_size_helper::estimateObjectSizeInBytes(bitmapAfterChild) +
+            sizeof(*this);
+    }
+
+    // How many RecordIds are left in the intersection after each child but the last?
+    std::vector<size_t> bitmapAfterChild;
+
+    // The largest size of the intersection bitmap, in bytes.
+    size_t memUsage = 0u;
+
+    // What's our memory limit?
+    size_t memLimit = 0u;
+};
+
 struct AndHashStats : public SpecificStats {
     AndHashStats() = default;
 
@@ -610,12 +633,15 @@ struct SortStats : public SpecificStats {
     }
 
     uint64_t estimateObjectSizeInBytes() const {
-        return sortPattern.objsize() + sizeof(*this);
+        return sortPattern.objsize() + sortPrefix.objsize() + sizeof(*this);
     }
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
 
+    // The leading fields of 'sortPattern' by which the input is already sorted, if any.
+    BSONObj sortPrefix;
+
     // The number of results to return from the sort.
     uint64_t limit = 0u;
 
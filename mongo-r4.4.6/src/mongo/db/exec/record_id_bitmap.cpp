@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+namespace {
+
+size_t countBits(uint64_t word) {
+    return std::bitset<64>(word).count();
+}
+
+}  // namespace
+
+bool RecordIdBitmap::Chunk::insert(uint16_t low) {
+    if (isBitset()) {
+        uint64_t& word = bitset[low / 64];
+        const uint64_t mask = uint64_t(1) << (low % 64);
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+        ++size;
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) {
+        return false;
+    }
+    array.insert(it, low);
+    ++size;
+    if (size > kMaxArrayChunkSize) {
+        toBitset();
+    }
+    return true;
+}
+
+bool RecordIdBitmap::Chunk::erase(uint16_t low) {
+    if (isBitset()) {
+        uint64_t& word = bitset[low / 64];
+        const uint64_t mask = uint64_t(1) << (low % 64);
+        if (!(word & mask)) {
+            return false;
+        }
+        word &= ~mask;
+        --size;
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it == array.end() || *it != low) {
+        return false;
+    }
+    array.erase(it);
+    --size;
+    return true;
+}
+
+bool RecordIdBitmap::Chunk::contains(uint16_t low) const {
+    if (isBitset()) {
+        return bitset[low / 64] & (uint64_t(1) << (low % 64));
+    }
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+size_t RecordIdBitmap::Chunk::intersectWith(const Chunk& other) {
+    if (isBitset() && other.isBitset()) {
+        size = 0;
+        for (size_t i = 0; i < kBitsetWords; ++i) {
+            bitset[i] &= other.bitset[i];
+            size += countBits(bitset[i]);
+        }
+        if (size <= kMaxArrayChunkSize) {
+            toArray();
+        }
+    } else if (isBitset()) {
+        std::vector<uint16_t> result;
+        std::copy_if(other.array.begin(),
+                     other.array.end(),
+                     std::back_inserter(result),
+                     [&](uint16_t low) { return contains(low); });
+        bitset.clear();
+        array = std::move(result);
+        size = array.size();
+    } else if (other.isBitset()) {
+        array.erase(std::remove_if(array.begin(),
+                                   array.end(),
+                                   [&](uint16_t low) { return !other.contains(low); }),
+                    array.end());
+        size = array.size();
+    } else {
+        std::vector<uint16_t> result;
+        std::set_intersection(array.begin(),
+                              array.end(),
+                              other.array.begin(),
+                              other.array.end(),
+                              std::back_inserter(result));
+        array = std::move(result);
+        size = array.size();
+    }
+    return size;
+}
+
+void RecordIdBitmap::Chunk::toBitset() {
+    bitset.assign(kBitsetWords, 0);
+    for (auto low : array) {
+        bitset[low / 64] |= uint64_t(1) << (low % 64);
+    }
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void RecordIdBitmap::Chunk::toArray() {
+    array.clear();
+    array.reserve(size);
+    for (size_t i = 0; i < kBitsetWords; ++i) {
+        for (uint64_t word = bitset[i]; word; word &= word - 1) {
+            array.push_back(static_cast<uint16_t>(i * 64 + countTrailingZeros64(word)));
+        }
+    }
+    bitset.clear();
+    bitset.shrink_to_fit();
+}
+
+bool RecordIdBitmap::insert(const RecordId& id) {
+    auto [it, isNewChunk] = _chunks.try_emplace(_chunkKey(id));
+    const size_t bytesBefore = isNewChunk ? 0 : it->second.getMemUsage();
+    if (!it->second.insert(_lowBits(id))) {
+        return false;
+    }
+    _chunkBytes += it->second.getMemUsage() - bytesBefore;
+    ++_size;
+    return true;
+}
+
+bool RecordIdBitmap::erase(const RecordId& id) {
+    auto it = _chunks.find(_chunkKey(id));
+    if (it == _chunks.end() || !it->second.erase(_lowBits(id))) {
+        return false;
+    }
+    if (it->second.size == 0) {
+        _chunkBytes -= it->second.getMemUsage();
+        _chunks.erase(it);
+    }
+    --_size;
+    return true;
+}
+
+bool RecordIdBitmap::contains(const RecordId& id) const {
+    auto it = _chunks.find(_chunkKey(id));
+    return it != _chunks.end() && it->second.contains(_lowBits(id));
+}
+
+void RecordIdBitmap::intersectWith(const RecordIdBitmap& other) {
+    _size = 0;
+    _chunkBytes = 0;
+    for (auto it = _chunks.begin(); it != _chunks.end();) {
+        auto otherIt = other._chunks.find(it->first);
+        if (otherIt == other._chunks.end() || it->second.intersectWith(otherIt->second) == 0) {
+            _chunks.erase(it++);
+        } else {
+            _size += it->second.size;
+            _chunkBytes += it->second.getMemUsage();
+            ++it;
+        }
+    }
+}
+
+}  // namespace mongo
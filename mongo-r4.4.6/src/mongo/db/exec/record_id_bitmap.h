@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds, organized like a roaring bitmap: ids are partitioned into chunks
+ * of 2^16 consecutive values, and each chunk stores its members either as a sorted array of their
+ * low 16 bits, while it is sparse, or as a bitset of 2^16 bits once it holds more than
+ * kMaxArrayChunkSize members. A chunk therefore never takes more than 8KB, and a dense range of
+ * RecordIds costs about one bit per id rather than a hash table entry.
+ */
+class RecordIdBitmap {
+public:
+    // The number of members from which a chunk switches from a sorted array to a bitset. At this
+    // size both representations take 8KB.
+    static constexpr size_t kMaxArrayChunkSize = 4096;
+
+    /**
+     * Adds 'id' to the set. Returns false if it was already a member.
+     */
+    bool insert(const RecordId& id);
+
+    /**
+     * Removes 'id' from the set. Returns false if it was not a member.
+     */
+    bool erase(const RecordId& id);
+
+    bool contains(const RecordId& id) const;
+
+    /**
+     * Removes every member which is not also a member of 'other'.
+     */
+    void intersectWith(const RecordIdBitmap& other);
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Returns an estimate of the number of bytes the set occupies.
+     */
+    size_t getMemUsage() const {
+        return sizeof(*this) + _chunkBytes;
+    }
+
+private:
+    static constexpr size_t kBitsetWords = (1 << 16) / 64;
+
+    struct Chunk {
+        bool isBitset() const {
+            return !bitset.empty();
+        }
+
+        bool insert(uint16_t low);
+        bool erase(uint16_t low);
+        bool contains(uint16_t low) const;
+
+        /**
+         * Keeps the members also in 'other' and returns how many remain.
+         */
+        size_t intersectWith(const Chunk& other);
+
+        void toBitset();
+        void toArray();
+
+        size_t getMemUsage() const {
+            return sizeof(int64_t) + sizeof(Chunk) + array.capacity() * sizeof(uint16_t) +
+                bitset.capacity() * sizeof(uint64_t);
+        }
+
+        // The sorted low bits of the members when the chunk is sparse, empty otherwise.
+        std::vector<uint16_t> array;
+
+        // The members as a bitset of kBitsetWords words when the chunk is dense, empty otherwise.
+        std::vector<uint64_t> bitset;
+
+        size_t size = 0;
+    };
+
+    static int64_t _chunkKey(const RecordId& id) {
+        return id.repr() >> 16;
+    }
+
+    static uint16_t _lowBits(const RecordId& id) {
+        return static_cast<uint16_t>(id.repr() & 0xFFFF);
+    }
+
+    stdx::unordered_map<int64_t, Chunk> _chunks;
+    size_t _size = 0;
+
+    // The sum of the memory usage of '_chunks', maintained as they change.
+    size_t _chunkBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <set>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdBitmapTest, InsertEraseContains) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.empty());
+
+    ASSERT_TRUE(bitmap.insert(RecordId(5)));
+    ASSERT_FALSE(bitmap.insert(RecordId(5)));
+    ASSERT_TRUE(bitmap.insert(RecordId(1LL << 40)));
+    ASSERT_TRUE(bitmap.insert(RecordId(-3)));
+    ASSERT_EQ(3U, bitmap.size());
+
+    ASSERT_TRUE(bitmap.contains(RecordId(5)));
+    ASSERT_TRUE(bitmap.contains(RecordId(1LL << 40)));
+    ASSERT_TRUE(bitmap.contains(RecordId(-3)));
+    ASSERT_FALSE(bitmap.contains(RecordId(6)));
+    ASSERT_FALSE(bitmap.contains(RecordId(5 + (1 << 16))));
+
+    ASSERT_TRUE(bitmap.erase(RecordId(5)));
+    ASSERT_FALSE(bitmap.erase(RecordId(5)));
+    ASSERT_FALSE(bitmap.contains(RecordId(5)));
+    ASSERT_EQ(2U, bitmap.size());
+}
+
+TEST(RecordIdBitmapTest, DenseChunksUseLessMemoryThanArrays) {
+    RecordIdBitmap bitmap;
+    for (int64_t i = 0; i < 60000; ++i) {
+        bitmap.insert(RecordId(i));
+    }
+    ASSERT_EQ(60000U, bitmap.size());
+    ASSERT_LT(bitmap.getMemUsage(), 10000U);
+    for (int64_t i = 0; i < 60000; ++i) {
+        ASSERT_TRUE(bitmap.contains(RecordId(i)));
+    }
+    ASSERT_FALSE(bitmap.contains(RecordId(60000)));
+}
+
+TEST(RecordIdBitmapTest, IntersectionMatchesSetIntersection) {
+    PseudoRandom random(1);
+
+    // Mix sparse and dense chunks, so that every combination of representations is intersected.
+    for (int round = 0; round < 4; ++round) {
+        const int64_t range = round % 2 ? 1 << 16 : 1 << 20;
+        RecordIdBitmap left;
+        RecordIdBitmap right;
+        std::set<int64_t> leftSet;
+        std::set<int64_t> rightSet;
+        for (int i = 0; i < 20000; ++i) {
+            const int64_t leftId = random.nextInt64(round < 2 ? range : 1 << 16);
+            const int64_t rightId = random.nextInt64(range);
+            left.insert(RecordId(leftId));
+            leftSet.insert(leftId);
+            right.insert(RecordId(rightId));
+            rightSet.insert(rightId);
+        }
+
+        left.intersectWith(right);
+        size_t expected = 0;
+        for (auto id : leftSet) {
+            const bool inBoth = rightSet.count(id);
+            expected += inBoth;
+            ASSERT_EQ(inBoth, left.contains(RecordId(id)));
+        }
+        ASSERT_EQ(expected, left.size());
+    }
+}
+
+TEST(RecordIdBitmapTest, IntersectionWithEmptySetIsEmpty) {
+    RecordIdBitmap bitmap;
+    for (int64_t i = 0; i < 100; ++i) {
+        bitmap.insert(RecordId(i));
+    }
+    bitmap.intersectWith(RecordIdBitmap());
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_FALSE(bitmap.contains(RecordId(1)));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/exec/working_set_common.h"
 
@@ -38,12 +39,22 @@ namespace mongo {
 SortStage::SortStage(boost::intrusive_ptr<ExpressionContext> expCtx,
                      WorkingSet* ws,
                      SortPattern sortPattern,
+                     uint64_t limit,
                      bool addSortKeyMetadata,
+                     boost::optional<SortPattern> sortPrefix,
                      std::unique_ptr<PlanStage> child)
     : PlanStage(kStageType.rawData(), expCtx.get()),
       _ws(ws),
       _sortKeyGen(sortPattern, expCtx->getCollator()),
-      _addSortKeyMetadata(addSortKeyMetadata) {
+      _addSortKeyMetadata(addSortKeyMetadata),
+      _limit(limit),
+      _prefixKeyGen(sortPrefix ? boost::make_optional(
+                                     SortKeyGenerator(*sortPrefix, expCtx->getCollator()))
+                               : boost::none),
+      _sortPrefixForExplain(
+          sortPrefix
+              ? sortPrefix->serialize(SortPattern::SortKeySerialization::kForExplain).toBson()
+              : BSONObj()) {
     _children.emplace_back(std::move(child));
 }
 
@@ -60,6 +71,22 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
             // The plan must be structured such that a previous stage has attached the sort key
             // metadata.
             try {
+                if (_prefixKeyGen) {
+                    auto prefixKey = _prefixKeyGen->computeSortKey(*_ws->get(id));
+                    if (_runPrefixKey &&
+                        ValueComparator::kInstance.evaluate(*_runPrefixKey != prefixKey)) {
+                        // The input moved on to the next run, so the current one can be sorted.
+                        // The plan may yield while the current run is returned, so the result
+                        // which starts the next one must not point into the storage cursor.
+                        _ws->get(id)->makeObjOwnedIfNeeded();
+                        _nextRunFirst = id;
+                        _nextRunPrefixKey = std::move(prefixKey);
+                        _populated = true;
+                        loadingDone();
+                        return PlanStage::NEED_TIME;
+                    }
+                    _runPrefixKey = std::move(prefixKey);
+                }
                 spool(id);
             } catch (const AssertionException&) {
                 // Propagate runtime errors using the FAILED status code.
@@ -89,14 +116,40 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
         return code;
     }
 
-    return unspool(out);
+    const StageState code = unspool(out);
+    if (!_prefixKeyGen) {
+        return code;
+    }
+
+    if (code == PlanStage::ADVANCED) {
+        _limitReached = _limit && ++_numReturned >= _limit;
+    } else if (code == PlanStage::IS_EOF && _nextRunFirst != WorkingSet::INVALID_ID) {
+        // The current run is exhausted, so start loading the next one with the result which
+        // ended the current one.
+        startNextRun();
+        _populated = false;
+        _runPrefixKey = std::move(_nextRunPrefixKey);
+        const WorkingSetID first = _nextRunFirst;
+        _nextRunFirst = WorkingSet::INVALID_ID;
+        try {
+            spool(first);
+        } catch (const AssertionException&) {
+            // Propagate runtime errors using the FAILED status code.
+            *out = WorkingSetCommon::allocateStatusMember(_ws, exceptionToStatus());
+            return PlanStage::FAILURE;
+        }
+        return PlanStage::NEED_TIME;
+    }
+    return code;
 }
 
 std::unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
     std::unique_ptr<PlanStageStats> ret =
         std::make_unique<PlanStageStats>(_commonStats, stageType());
-    ret->specific = std::unique_ptr<SpecificStats>{getSpecificStats()->clone()};
+    auto specific = std::unique_ptr<SpecificStats>{getSpecificStats()->clone()};
+    static_cast<SortStats*>(specific.get())->sortPrefix = _sortPrefixForExplain;
+    ret->specific = std::move(specific);
     ret->children.emplace_back(child()->getStats());
     return ret;
 }
@@ -107,8 +160,15 @@ SortStageDefault::SortStageDefault(boost::intrusive_ptr<ExpressionContext> expCt
                                    uint64_t limit,
                                    uint64_t maxMemoryUsageBytes,
                                    bool addSortKeyMetadata,
-                                   std::unique_ptr<PlanStage> child)
-    : SortStage(expCtx, ws, sortPattern, addSortKeyMetadata, std::move(child)),
+                                   std::unique_ptr<PlanStage> child,
+                                   boost::optional<SortPattern> sortPrefix)
+    : SortStage(expCtx,
+                ws,
+                sortPattern,
+                limit,
+                addSortKeyMetadata,
+                std::move(sortPrefix),
+                std::move(child)),
       _sortExecutor(std::move(sortPattern),
                     limit,
                     maxMemoryUsageBytes,
@@ -143,8 +203,15 @@ SortStageSimple::SortStageSimple(boost::intrusive_ptr<ExpressionContext> expCtx,
                                  uint64_t limit,
                                  uint64_t maxMemoryUsageBytes,
                                  bool addSortKeyMetadata,
-                                 std::unique_ptr<PlanStage> child)
-    : SortStage(expCtx, ws, sortPattern, addSortKeyMetadata, std::move(child)),
+                                 std::unique_ptr<PlanStage> child,
+                                 boost::optional<SortPattern> sortPrefix)
+    : SortStage(expCtx,
+                ws,
+                sortPattern,
+                limit,
+                addSortKeyMetadata,
+                std::move(sortPrefix),
+                std::move(child)),
       _sortExecutor(std::move(sortPattern),
                     limit,
                     maxMemoryUsageBytes,
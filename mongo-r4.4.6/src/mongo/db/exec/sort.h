@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <set>
 #include <vector>
 
@@ -46,6 +47,11 @@ namespace mongo {
  * 'addSortKeyMetadata' is true, then also attaches the sort key as metadata. This could be consumed
  * downstream for a sort-merge on a merging node, or by a $meta:"sortKey" expression.
  *
+ * If 'sortPrefix' is provided, the input must already be sorted by these leading fields of the
+ * sort pattern. The stage then only sorts each run of results with equal values of these fields,
+ * returning the sorted results of a run before reading the next one, and stops reading the input
+ * once 'limit' results have been returned.
+ *
  * Concrete implementations derive from this abstract base class by implementing methods for
  * spooling and unspooling.
  */
@@ -56,7 +62,9 @@ public:
     SortStage(boost::intrusive_ptr<ExpressionContext> expCtx,
               WorkingSet* ws,
               SortPattern sortPattern,
+              uint64_t limit,
               bool addSortKeyMetadata,
+              boost::optional<SortPattern> sortPrefix,
               std::unique_ptr<PlanStage> child);
 
     /**
@@ -83,6 +91,12 @@ public:
      */
     virtual StageState unspool(WorkingSetID* out) = 0;
 
+    /**
+     * Prepares for spooling the next run of results once the sorted results of the previous run
+     * have all been unspooled. Only called if there is a sort prefix.
+     */
+    virtual void startNextRun() = 0;
+
     StageState doWork(WorkingSetID* out) final;
 
     std::unique_ptr<PlanStageStats> getStats() override final;
@@ -95,9 +109,36 @@ protected:
 
     const bool _addSortKeyMetadata;
 
+    /**
+     * Returns true if the stage has returned all of its results, given whether the sorted stream
+     * of the current run is exhausted.
+     */
+    bool isDone(bool runExhausted) const {
+        return _limitReached || (runExhausted && _nextRunFirst == WorkingSet::INVALID_ID);
+    }
+
 private:
-    // Whether or not we have finished loading data into '_sortExecutor'.
+    const uint64_t _limit;
+
+    // Generates the keys of the sort prefix, if any.
+    const boost::optional<SortKeyGenerator> _prefixKeyGen;
+
+    // The sort prefix, as displayed by explain.
+    const BSONObj _sortPrefixForExplain;
+
+    // Whether or not we have finished loading the current run into '_sortExecutor'.
     bool _populated = false;
+
+    // The prefix key of the run being loaded.
+    boost::optional<Value> _runPrefixKey;
+
+    // The first result of the next run, read from the child while loading the current one, and
+    // its prefix key.
+    WorkingSetID _nextRunFirst = WorkingSet::INVALID_ID;
+    Value _nextRunPrefixKey;
+
+    uint64_t _numReturned = 0;
+    bool _limitReached = false;
 };
 
 /**
@@ -112,7 +153,8 @@ public:
                      uint64_t limit,
                      uint64_t maxMemoryUsageBytes,
                      bool addSortKeyMetadata,
-                     std::unique_ptr<PlanStage> child);
+                     std::unique_ptr<PlanStage> child,
+                     boost::optional<SortPattern> sortPrefix = boost::none);
 
     void spool(WorkingSetID wsid) override final;
 
@@ -122,12 +164,16 @@ public:
 
     StageState unspool(WorkingSetID* out) override final;
 
+    void startNextRun() override final {
+        _sortExecutor.reset();
+    }
+
     StageType stageType() const final {
         return STAGE_SORT_DEFAULT;
     }
 
     bool isEOF() final {
-        return _sortExecutor.isEOF();
+        return isDone(_sortExecutor.isEOF());
     }
 
     const SpecificStats* getSpecificStats() const final {
@@ -155,7 +201,8 @@ public:
                     uint64_t limit,
                     uint64_t maxMemoryUsageBytes,
                     bool addSortKeyMetadata,
-                    std::unique_ptr<PlanStage> child);
+                    std::unique_ptr<PlanStage> child,
+                    boost::optional<SortPattern> sortPrefix = boost::none);
 
     virtual void spool(WorkingSetID wsid) override final;
 
@@ -165,12 +212,16 @@ public:
 
     virtual StageState unspool(WorkingSetID* out) override final;
 
+    void startNextRun() override final {
+        _sortExecutor.reset();
+    }
+
     StageType stageType() const final {
         return STAGE_SORT_SIMPLE;
     }
 
     bool isEOF() final {
-        return _sortExecutor.isEOF();
+        return isDone(_sortExecutor.isEOF());
     }
 
     const SpecificStats* getSpecificStats() const final {
@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/storage/key_string.h"
 
 namespace mongo {
 namespace {
@@ -49,15 +50,55 @@ std::string nextFileName() {
     static AtomicWord<unsigned> sortExecutorFileCounter;
     return "extsort-sort-executor." + std::to_string(sortExecutorFileCounter.fetchAndAdd(1));
 }
+
+void appendSortKeyComponent(BSONObjBuilder* builder, const Value& component) {
+    if (component.missing()) {
+        builder->appendUndefined("");
+    } else {
+        component.addToBsonObj(builder, ""_sd);
+    }
+}
 }  // namespace
+
+std::string SortExecutorKey::encode(const Value& sortKey,
+                                    size_t sortPatternSize,
+                                    Ordering ordering) {
+    BSONObjBuilder components;
+    if (sortPatternSize == 1) {
+        appendSortKeyComponent(&components, sortKey);
+    } else {
+        for (size_t i = 0; i < sortPatternSize; ++i) {
+            appendSortKeyComponent(&components, sortKey[i]);
+        }
+    }
+
+    KeyString::Builder builder(KeyString::Version::kLatestVersion, components.done(), ordering);
+    return std::string(builder.getBuffer(), builder.getSize());
+}
+
+void SortExecutorKey::serializeForSorter(BufBuilder& buf) const {
+    _sortKey.serializeForSorter(buf);
+    buf.appendNum(static_cast<int>(_encodedKey.size()));
+    buf.appendBuf(_encodedKey.data(), _encodedKey.size());
+}
+
+SortExecutorKey SortExecutorKey::deserializeForSorter(BufReader& buf,
+                                                      const SorterDeserializeSettings&) {
+    Value sortKey = Value::deserializeForSorter(buf, Value::SorterDeserializeSettings());
+    const int encodedKeySize = buf.read<LittleEndian<int>>();
+    const char* encodedKey = static_cast<const char*>(buf.skip(encodedKeySize));
+    return {std::move(sortKey), std::string(encodedKey, encodedKeySize)};
+}
 }  // namespace mongo
 
 #include "mongo/db/sorter/sorter.cpp"
 
-MONGO_CREATE_SORTER(mongo::Value,
+MONGO_CREATE_SORTER(mongo::SortExecutorKey,
                     mongo::Document,
                     mongo::SortExecutor<mongo::Document>::Comparator);
-MONGO_CREATE_SORTER(mongo::Value,
+MONGO_CREATE_SORTER(mongo::SortExecutorKey,
                     mongo::SortableWorkingSetMember,
                     mongo::SortExecutor<mongo::SortableWorkingSetMember>::Comparator);
-MONGO_CREATE_SORTER(mongo::Value, mongo::BSONObj, mongo::SortExecutor<mongo::BSONObj>::Comparator);
+MONGO_CREATE_SORTER(mongo::SortExecutorKey,
+                    mongo::BSONObj,
+                    mongo::SortExecutor<mongo::BSONObj>::Comparator);
@@ -29,15 +29,68 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <string>
+
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/sort_key_comparator.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
+/**
+ * The key by which the SortExecutor sorts a data item. Along with the sort key itself, it may hold
+ * an encoding of the sort key as a KeyString under the ordering of the sort pattern, so that two
+ * encoded keys compare byte-wise in the same order as SortKeyComparator orders their sort keys.
+ */
+class SortExecutorKey {
+public:
+    struct SorterDeserializeSettings {};  // unused
+
+    /**
+     * Encodes 'sortKey', which is generated for a sort pattern with 'sortPatternSize' components,
+     * as a KeyString under 'ordering'. Missing components are encoded as undefined, which they are
+     * equal to when comparing sort keys.
+     */
+    static std::string encode(const Value& sortKey, size_t sortPatternSize, Ordering ordering);
+
+    static SortExecutorKey deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&);
+
+    SortExecutorKey() = default;
+    SortExecutorKey(Value sortKey, std::string encodedKey)
+        : _sortKey(std::move(sortKey)), _encodedKey(std::move(encodedKey)) {}
+
+    const Value& sortKey() const {
+        return _sortKey;
+    }
+
+    /**
+     * Returns the KeyString encoding of the sort key, or an empty string if it was not encoded.
+     */
+    const std::string& encodedKey() const {
+        return _encodedKey;
+    }
+
+    void serializeForSorter(BufBuilder& buf) const;
+
+    int memUsageForSorter() const {
+        return _sortKey.memUsageForSorter() + sizeof(_encodedKey) + _encodedKey.capacity();
+    }
+
+    SortExecutorKey getOwned() const {
+        return {_sortKey.getOwned(), _encodedKey};
+    }
+
+private:
+    Value _sortKey;
+    std::string _encodedKey;
+};
+
 /**
  * The SortExecutor class is the internal implementation of sorting for query execution. The
  * caller should provide input documents by repeated calls to the add() function, and then
@@ -51,17 +104,22 @@ namespace mongo {
 template <typename T>
 class SortExecutor {
 public:
-    using DocumentSorter = Sorter<Value, T>;
+    using DocumentSorter = Sorter<SortExecutorKey, T>;
     class Comparator {
     public:
-        Comparator(const SortPattern& sortPattern) : _sortKeyComparator(sortPattern) {}
+        Comparator(const SortPattern& sortPattern, bool compareEncodedKeys)
+            : _sortKeyComparator(sortPattern), _compareEncodedKeys(compareEncodedKeys) {}
         int operator()(const typename DocumentSorter::Data& lhs,
                        const typename DocumentSorter::Data& rhs) const {
-            return _sortKeyComparator(lhs.first, rhs.first);
+            if (_compareEncodedKeys) {
+                return lhs.first.encodedKey().compare(rhs.first.encodedKey());
+            }
+            return _sortKeyComparator(lhs.first.sortKey(), rhs.first.sortKey());
         }
 
     private:
         SortKeyComparator _sortKeyComparator;
+        bool _compareEncodedKeys;
     };
 
     /**
@@ -74,7 +132,8 @@ public:
                  bool allowDiskUse)
         : _sortPattern(std::move(sortPattern)),
           _tempDir(std::move(tempDir)),
-          _diskUseAllowed(allowDiskUse) {
+          _diskUseAllowed(allowDiskUse),
+          _encodingOrdering(makeEncodingOrdering(_sortPattern)) {
         _stats.sortPattern =
             _sortPattern.serialize(SortPattern::SortKeySerialization::kForExplain).toBson();
         _stats.limit = limit;
@@ -124,9 +183,13 @@ public:
      */
     void add(const Value& sortKey, const T& data) {
         if (!_sorter) {
-            _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
+            _sorter.reset(DocumentSorter::make(makeSortOptions(), makeComparator()));
         }
-        _sorter->add(sortKey, data);
+        _sorter->add({sortKey,
+                      _encodingOrdering ? SortExecutorKey::encode(
+                                              sortKey, _sortPattern.size(), *_encodingOrdering)
+                                        : std::string()},
+                     data);
 
         _stats.totalDataSizeBytes += data.memUsageForSorter();
     }
@@ -137,7 +200,7 @@ public:
     void loadingDone() {
         // This conditional should only pass if no documents were added to the sorter.
         if (!_sorter) {
-            _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
+            _sorter.reset(DocumentSorter::make(makeSortOptions(), makeComparator()));
         }
         _output.reset(_sorter->done());
         _stats.wasDiskUsed = _stats.wasDiskUsed || _sorter->usedDisk();
@@ -168,10 +231,42 @@ public:
      * end-of-stream must be detected with 'hasNext()'.
      */
     std::pair<Value, T> getNext() {
-        return _output->next();
+        auto next = _output->next();
+        return {next.first.sortKey(), std::move(next.second)};
+    }
+
+    /**
+     * Prepares the sort executor to sort another set of data items once the sorted stream of the
+     * previous ones has been exhausted. The statistics keep accumulating across the sets.
+     */
+    void reset() {
+        invariant(_isEOF);
+        invariant(!_sorter);
+        _isEOF = false;
     }
 
 private:
+    /**
+     * Returns the ordering under which to encode the sort keys, or boost::none if they are to be
+     * compared value by value.
+     */
+    static boost::optional<Ordering> makeEncodingOrdering(const SortPattern& sortPattern) {
+        if (!internalQueryEncodeSortKeys.load() ||
+            sortPattern.size() > Ordering::kMaxCompoundIndexKeys) {
+            return boost::none;
+        }
+
+        BSONObjBuilder directions;
+        for (auto&& part : sortPattern) {
+            directions.append("", part.isAscending ? 1 : -1);
+        }
+        return Ordering::make(directions.done());
+    }
+
+    Comparator makeComparator() const {
+        return Comparator(_sortPattern, static_cast<bool>(_encodingOrdering));
+    }
+
     SortOptions makeSortOptions() const {
         SortOptions opts;
         if (_stats.limit) {
@@ -191,6 +286,9 @@ private:
     const std::string _tempDir;
     const bool _diskUseAllowed;
 
+    // The ordering under which the sort keys are encoded, if they are.
+    const boost::optional<Ordering> _encodingOrdering;
+
     std::unique_ptr<DocumentSorter> _sorter;
     std::unique_ptr<typename DocumentSorter::Iterator> _output;
 
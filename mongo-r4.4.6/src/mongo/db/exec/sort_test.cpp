@@ -41,9 +41,11 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_mock.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -304,4 +306,80 @@ TEST_F(SortStageDefaultTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+TEST_F(SortStageDefaultTest, SortEncodedKeysOfMixedTypes) {
+    const char* input =
+        "{input: [{a: 'x', b: 1}, {a: 2, b: 1}, {a: null, b: 2}, {b: 3}, {a: 1.5, b: 4}, "
+        "{a: NumberLong(2), b: 2}, {a: {c: 1}, b: 1}, {a: {$minKey: 1}, b: 1}]}";
+    const char* expected =
+        "{output: [{a: {$minKey: 1}, b: 1}, {b: 3}, {a: null, b: 2}, {a: 1.5, b: 4}, "
+        "{a: NumberLong(2), b: 2}, {a: 2, b: 1}, {a: 'x', b: 1}, {a: {c: 1}, b: 1}]}";
+
+    const bool oldEncodeSortKeys = internalQueryEncodeSortKeys.load();
+    ON_BLOCK_EXIT([oldEncodeSortKeys] { internalQueryEncodeSortKeys.store(oldEncodeSortKeys); });
+    for (bool encodeSortKeys : {false, true}) {
+        internalQueryEncodeSortKeys.store(encodeSortKeys);
+        testWork("{a: 1, b: -1}", nullptr, 0, input, expected);
+    }
+}
+
+TEST_F(SortStageDefaultTest, SortWithPrefixOnlySortsWithinRunsAndStopsAtLimit) {
+    WorkingSet ws;
+
+    auto expCtx = make_intrusive<ExpressionContext>(opCtx(), nullptr, kNss);
+
+    // The input is ordered by 'a' but not by 'b'.
+    auto queuedDataStage = std::make_unique<QueuedDataStage>(expCtx.get(), &ws);
+    for (auto&& obj : {BSON("a" << 1 << "b" << 2),
+                       BSON("a" << 1 << "b" << 1),
+                       BSON("a" << 2 << "b" << 3),
+                       BSON("a" << 2 << "b" << 1),
+                       BSON("a" << 2 << "b" << 2),
+                       BSON("a" << 3 << "b" << 1),
+                       BSON("a" << 4 << "b" << 1)}) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        wsm->doc = {SnapshotId(), Document{obj}};
+        wsm->transitionToOwnedObj();
+        queuedDataStage->pushBack(id);
+    }
+    auto queuedDataStageRaw = queuedDataStage.get();
+
+    auto sortPattern = BSON("a" << 1 << "b" << 1);
+    auto sortKeyGen = std::make_unique<SortKeyGeneratorStage>(
+        expCtx, std::move(queuedDataStage), &ws, sortPattern);
+    SortStageDefault sort(expCtx,
+                          &ws,
+                          SortPattern{sortPattern, expCtx},
+                          4u,
+                          kMaxMemoryUsageBytes,
+                          false,  // addSortKeyMetadata
+                          std::move(sortKeyGen),
+                          SortPattern{BSON("a" << 1), expCtx});
+
+    std::vector<BSONObj> results;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (state != PlanStage::IS_EOF) {
+        state = sort.work(&id);
+        if (state == PlanStage::ADVANCED) {
+            results.push_back(ws.get(id)->doc.value().toBson());
+
+            // The first run is returned before the rest of the input is read.
+            if (results.size() == 1u) {
+                ASSERT_FALSE(queuedDataStageRaw->isEOF());
+            }
+        }
+    }
+
+    ASSERT_EQ(results.size(), 4u);
+    ASSERT_BSONOBJ_EQ(results[0], BSON("a" << 1 << "b" << 1));
+    ASSERT_BSONOBJ_EQ(results[1], BSON("a" << 1 << "b" << 2));
+    ASSERT_BSONOBJ_EQ(results[2], BSON("a" << 2 << "b" << 1));
+    ASSERT_BSONOBJ_EQ(results[3], BSON("a" << 2 << "b" << 2));
+    ASSERT_TRUE(sort.isEOF());
+
+    // The runs after the one which reached the limit were never read.
+    ASSERT_FALSE(queuedDataStageRaw->isEOF());
+}
 }  // namespace
@@ -139,7 +139,8 @@ Status SubplanStage::planSubqueries() {
         // Populate branchResult->cachedSolution if an active cachedSolution entry exists.
         if (planCache->shouldCacheQuery(*branchResult->canonicalQuery)) {
             auto planCacheKey = planCache->computeKey(*branchResult->canonicalQuery);
-            if (auto cachedSol = planCache->getCacheEntryIfActive(planCacheKey)) {
+            if (auto cachedSol = planCache->getCacheEntryIfActive(
+                    planCacheKey, branchResult->canonicalQuery.get())) {
                 // We have a CachedSolution. Store it for later.
                 LOGV2_DEBUG(
                     20599,
@@ -0,0 +1,341 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <cmath>
+#include <type_traits>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+
+namespace mongo {
+
+namespace {
+
+template <MatchExpression::MatchType op>
+using MatchTypeTag = std::integral_constant<MatchExpression::MatchType, op>;
+
+template <MatchExpression::MatchType op, typename T>
+bool compare(const T& lhs, const T& rhs) {
+    switch (op) {
+        case MatchExpression::EQ:
+            return lhs == rhs;
+        case MatchExpression::LT:
+            return lhs < rhs;
+        case MatchExpression::LTE:
+            return lhs <= rhs;
+        case MatchExpression::GT:
+            return lhs > rhs;
+        case MatchExpression::GTE:
+            return lhs >= rhs;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+// static
+template <MatchExpression::MatchType op>
+bool CompiledMatchExpression::longKernel(const Instruction& instruction, const BSONElement& elem) {
+    switch (elem.type()) {
+        case NumberInt:
+            return compare<op, long long>(elem._numberInt(), instruction.longConstant);
+        case NumberLong:
+            return compare<op, long long>(elem._numberLong(), instruction.longConstant);
+        default:
+            return genericKernel(instruction, elem);
+    }
+}
+
+// static
+template <MatchExpression::MatchType op>
+bool CompiledMatchExpression::doubleKernel(const Instruction& instruction,
+                                           const BSONElement& elem) {
+    // NaN compares unlike any other double, so it takes the generic path. The constant is known
+    // not to be NaN.
+    if (elem.type() == NumberDouble && !std::isnan(elem._numberDouble())) {
+        return compare<op, double>(elem._numberDouble(), instruction.doubleConstant);
+    }
+    return genericKernel(instruction, elem);
+}
+
+// static
+template <MatchExpression::MatchType op>
+bool CompiledMatchExpression::stringKernel(const Instruction& instruction,
+                                           const BSONElement& elem) {
+    // Only used without a collation, where strings compare bytewise.
+    if (elem.type() == String) {
+        return compare<op, StringData>(elem.valueStringData(), instruction.stringConstant);
+    }
+    return genericKernel(instruction, elem);
+}
+
+// static
+bool CompiledMatchExpression::genericKernel(const Instruction& instruction,
+                                            const BSONElement& elem) {
+    return static_cast<const PathMatchExpression*>(instruction.expr)
+        ->matchesSingleElement(elem, nullptr);
+}
+
+// static
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* expr) {
+    invariant(expr);
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression());
+    compiled->_compile(expr);
+    compiled->_resolved.resize(compiled->_paths.size());
+    return compiled;
+}
+
+CompiledMatchExpression::CompiledMatchExpression() {
+    _paths.push_back({0, ""});
+}
+
+void CompiledMatchExpression::_compile(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            _compileLogical(expr, OpCode::kJumpIfFalse, true);
+            return;
+        case MatchExpression::OR:
+            _compileLogical(expr, OpCode::kJumpIfTrue, false);
+            return;
+        case MatchExpression::NOR:
+            _compileLogical(expr, OpCode::kJumpIfTrue, false);
+            _program.push_back({OpCode::kNot});
+            return;
+        case MatchExpression::NOT:
+            _compile(expr->getChild(0));
+            _program.push_back({OpCode::kNot});
+            return;
+        case MatchExpression::ALWAYS_FALSE:
+        case MatchExpression::ALWAYS_TRUE: {
+            Instruction instruction{OpCode::kConstant};
+            instruction.constant = expr->matchType() == MatchExpression::ALWAYS_TRUE;
+            _program.push_back(instruction);
+            return;
+        }
+        default:
+            break;
+    }
+
+    auto pathExpr = dynamic_cast<const PathMatchExpression*>(expr);
+    if (pathExpr && !pathExpr->path().empty()) {
+        _compileLeaf(expr);
+        return;
+    }
+
+    Instruction instruction{OpCode::kTree};
+    instruction.expr = expr;
+    _program.push_back(instruction);
+}
+
+void CompiledMatchExpression::_compileLogical(const MatchExpression* expr,
+                                              OpCode shortCircuit,
+                                              bool ifEmpty) {
+    if (expr->numChildren() == 0) {
+        Instruction instruction{OpCode::kConstant};
+        instruction.constant = ifEmpty;
+        _program.push_back(instruction);
+        return;
+    }
+
+    // The result of the child which short-circuits is also the result of the whole node, so every
+    // jump goes to the end of the node.
+    std::vector<size_t> jumps;
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (i > 0) {
+            jumps.push_back(_program.size());
+            _program.push_back({shortCircuit});
+        }
+        _compile(expr->getChild(i));
+    }
+    for (auto jump : jumps) {
+        _program[jump].target = _program.size();
+    }
+}
+
+void CompiledMatchExpression::_compileLeaf(const MatchExpression* expr) {
+    auto pathExpr = static_cast<const PathMatchExpression*>(expr);
+
+    Instruction instruction{OpCode::kLeaf};
+    instruction.expr = expr;
+    instruction.pathSlot = _internPath(pathExpr->path());
+    instruction.kernel = &genericKernel;
+
+    auto selectKernel = [&](auto kernel) {
+        switch (expr->matchType()) {
+            case MatchExpression::EQ:
+                return kernel(MatchTypeTag<MatchExpression::EQ>());
+            case MatchExpression::LT:
+                return kernel(MatchTypeTag<MatchExpression::LT>());
+            case MatchExpression::LTE:
+                return kernel(MatchTypeTag<MatchExpression::LTE>());
+            case MatchExpression::GT:
+                return kernel(MatchTypeTag<MatchExpression::GT>());
+            case MatchExpression::GTE:
+                return kernel(MatchTypeTag<MatchExpression::GTE>());
+            default:
+                MONGO_UNREACHABLE;
+        }
+    };
+
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE: {
+            auto comparison = static_cast<const ComparisonMatchExpression*>(expr);
+            const BSONElement& rhs = comparison->getData();
+            switch (rhs.type()) {
+                case NumberInt:
+                case NumberLong:
+                    instruction.longConstant = rhs.numberLong();
+                    instruction.kernel = selectKernel(
+                        [](auto op) -> Kernel { return &longKernel<decltype(op)::value>; });
+                    break;
+                case NumberDouble:
+                    if (!std::isnan(rhs._numberDouble())) {
+                        instruction.doubleConstant = rhs._numberDouble();
+                        instruction.kernel = selectKernel(
+                            [](auto op) -> Kernel { return &doubleKernel<decltype(op)::value>; });
+                    }
+                    break;
+                case String:
+                    if (!comparison->getCollator()) {
+                        instruction.stringConstant = rhs.valueStringData();
+                        instruction.kernel = selectKernel(
+                            [](auto op) -> Kernel { return &stringKernel<decltype(op)::value>; });
+                    }
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    _program.push_back(instruction);
+}
+
+size_t CompiledMatchExpression::_internPath(StringData path) {
+    FieldRef fieldRef(path);
+    size_t slot = 0;
+    for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+        auto prefix = fieldRef.dottedSubstring(0, i + 1);
+        auto it = _pathSlotsByPrefix.find(prefix);
+        if (it != _pathSlotsByPrefix.end()) {
+            slot = it->second;
+            continue;
+        }
+        _paths.push_back({slot, fieldRef.getPart(i).toString()});
+        slot = _paths.size() - 1;
+        _pathSlotsByPrefix[prefix.toString()] = slot;
+    }
+    return slot;
+}
+
+const CompiledMatchExpression::ResolvedPath& CompiledMatchExpression::_resolve(
+    size_t slot, const BSONObj& doc) const {
+    auto& resolved = _resolved[slot];
+    if (resolved.generation == _generation) {
+        return resolved;
+    }
+
+    // Mirrors getFieldDottedOrArray(): a path through a scalar, or through a missing field, has
+    // no value. Once an array is reached the path can match several values, which only the tree
+    // knows how to enumerate.
+    const auto& pathSlot = _paths[slot];
+    resolved.elem = BSONElement();
+    resolved.crossesArray = false;
+    if (pathSlot.parent == 0) {
+        resolved.elem = doc.getField(pathSlot.fieldName);
+    } else {
+        const auto& parent = _resolve(pathSlot.parent, doc);
+        if (parent.crossesArray) {
+            resolved.crossesArray = true;
+        } else if (parent.elem.type() == Object) {
+            resolved.elem = parent.elem.embeddedObject().getField(pathSlot.fieldName);
+        }
+    }
+    if (resolved.elem.type() == Array) {
+        resolved.crossesArray = true;
+    }
+    resolved.generation = _generation;
+    return resolved;
+}
+
+bool CompiledMatchExpression::matches(const BSONObj& doc) const {
+    // Invalidates the path values resolved for the previous document.
+    ++_generation;
+
+    bool result = true;
+    size_t pc = 0;
+    while (pc < _program.size()) {
+        const auto& instruction = _program[pc];
+        switch (instruction.opCode) {
+            case OpCode::kLeaf: {
+                const auto& resolved = _resolve(instruction.pathSlot, doc);
+                result = resolved.crossesArray
+                    ? instruction.expr->matchesBSON(doc, nullptr)
+                    : instruction.kernel(instruction, resolved.elem);
+                ++pc;
+                break;
+            }
+            case OpCode::kTree:
+                result = instruction.expr->matchesBSON(doc, nullptr);
+                ++pc;
+                break;
+            case OpCode::kConstant:
+                result = instruction.constant;
+                ++pc;
+                break;
+            case OpCode::kNot:
+                result = !result;
+                ++pc;
+                break;
+            case OpCode::kJumpIfFalse:
+                pc = result ? pc + 1 : instruction.target;
+                break;
+            case OpCode::kJumpIfTrue:
+                pc = result ? instruction.target : pc + 1;
+                break;
+        }
+    }
+    return result;
+}
+
+}  // namespace mongo
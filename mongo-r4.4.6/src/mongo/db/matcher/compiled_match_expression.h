@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * A MatchExpression tree lowered into a flat program for evaluating documents in bulk.
+ *
+ * The logical nodes ($and, $or, $nor, $not) become short-circuiting jumps. Every field path the
+ * tree refers to is interned in a trie of path slots, so that a prefix shared by several
+ * predicates (for example 'a.b' in {'a.b.c': 1, 'a.b.d': 2}) is looked up at most once per
+ * document. Comparisons against a number or a string constant run a kernel specialized for the
+ * constant's type instead of the general BSON comparison.
+ *
+ * The program only handles the common case itself: a predicate whose path crosses an array, and
+ * any node without a compiled form ($where, $expr, JSON Schema keywords, ...), are evaluated by
+ * the MatchExpression they were compiled from. Results are therefore always identical to those
+ * of MatchExpression::matchesBSON(). The tree must outlive the program and is still what explain
+ * and serialization see.
+ *
+ * Not thread safe: matches() reuses scratch space owned by the program.
+ */
+class CompiledMatchExpression {
+    CompiledMatchExpression(const CompiledMatchExpression&) = delete;
+    CompiledMatchExpression& operator=(const CompiledMatchExpression&) = delete;
+
+public:
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* expr);
+
+    /**
+     * Returns whether 'doc' satisfies the expression this program was compiled from.
+     */
+    bool matches(const BSONObj& doc) const;
+
+    size_t numInstructions() const {
+        return _program.size();
+    }
+
+    /**
+     * Returns the number of distinct non-empty path prefixes the program resolves.
+     */
+    size_t numPathSlots() const {
+        return _paths.size() - 1;
+    }
+
+private:
+    enum class OpCode {
+        // Evaluates a path predicate against the value of a path slot.
+        kLeaf,
+        // Evaluates a subtree with MatchExpression::matchesBSON().
+        kTree,
+        kConstant,
+        kNot,
+        kJumpIfFalse,
+        kJumpIfTrue,
+    };
+
+    struct Instruction;
+
+    /**
+     * Evaluates a predicate against the value found at its path when no array is on the path.
+     */
+    using Kernel = bool (*)(const Instruction& instruction, const BSONElement& elem);
+
+    struct Instruction {
+        OpCode opCode;
+
+        // Used by kLeaf and kTree.
+        const MatchExpression* expr = nullptr;
+
+        // Used by kLeaf.
+        size_t pathSlot = 0;
+        Kernel kernel = nullptr;
+        long long longConstant = 0;
+        double doubleConstant = 0;
+        StringData stringConstant;
+
+        // Used by kConstant.
+        bool constant = false;
+
+        // Used by the jumps.
+        size_t target = 0;
+    };
+
+    /**
+     * One component of a field path. Slot 0 is the document itself, and a slot's parent always
+     * precedes it.
+     */
+    struct PathSlot {
+        size_t parent;
+        std::string fieldName;
+    };
+
+    /**
+     * The value of a path slot in the document being matched.
+     */
+    struct ResolvedPath {
+        BSONElement elem;
+        bool crossesArray = false;
+        unsigned long long generation = 0;
+    };
+
+    template <MatchExpression::MatchType op>
+    static bool longKernel(const Instruction& instruction, const BSONElement& elem);
+    template <MatchExpression::MatchType op>
+    static bool doubleKernel(const Instruction& instruction, const BSONElement& elem);
+    template <MatchExpression::MatchType op>
+    static bool stringKernel(const Instruction& instruction, const BSONElement& elem);
+    static bool genericKernel(const Instruction& instruction, const BSONElement& elem);
+
+    CompiledMatchExpression();
+
+    void _compile(const MatchExpression* expr);
+    void _compileLogical(const MatchExpression* expr, OpCode shortCircuit, bool ifEmpty);
+    void _compileLeaf(const MatchExpression* expr);
+    size_t _internPath(StringData path);
+
+    const ResolvedPath& _resolve(size_t slot, const BSONObj& doc) const;
+
+    std::vector<Instruction> _program;
+    std::vector<PathSlot> _paths;
+
+    // Maps each dotted path prefix to its slot, so that predicates share their common prefixes.
+    StringMap<size_t> _pathSlotsByPrefix;
+
+    // Scratch space for matches(). An entry is valid for the current document only when its
+    // generation equals '_generation'.
+    mutable std::vector<ResolvedPath> _resolved;
+    mutable unsigned long long _generation = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Documents covering the shapes the compiled program treats specially: missing fields, paths
+ * through scalars and nested documents, arrays on and at the end of a path, and values of every
+ * type that a specialized comparison kernel has to hand back to the generic one.
+ */
+std::vector<BSONObj> corpus() {
+    return {fromjson("{}"),
+            fromjson("{a: 1}"),
+            fromjson("{a: 5, b: 'x'}"),
+            fromjson("{a: NumberLong(5)}"),
+            fromjson("{a: 5.5}"),
+            fromjson("{a: NaN}"),
+            fromjson("{a: NumberDecimal('5')}"),
+            fromjson("{a: null}"),
+            fromjson("{a: undefined}"),
+            fromjson("{a: {$minKey: 1}}"),
+            fromjson("{a: {$maxKey: 1}}"),
+            fromjson("{a: 'abc'}"),
+            fromjson("{a: 'ab\\u0000c'}"),
+            fromjson("{a: 'b', b: 'abd'}"),
+            fromjson("{a: {b: 1, c: 'x'}}"),
+            fromjson("{a: {b: {c: 2}}, b: 3}"),
+            fromjson("{a: {b: null}}"),
+            fromjson("{a: {b: 'abc'}}"),
+            fromjson("{a: [1, 5, 9]}"),
+            fromjson("{a: []}"),
+            fromjson("{a: [{b: 1}, {b: 7}]}"),
+            fromjson("{a: {b: [2, 3]}}"),
+            fromjson("{a: [[5]]}"),
+            fromjson("{a: {'0': 5}}"),
+            fromjson("{a: [5, {b: 5}], b: [1]}"),
+            fromjson("{a: 1, b: 2, c: {d: 3}}")};
+}
+
+/**
+ * Checks that the program compiled from 'query' agrees with the match expression tree on every
+ * document of the corpus.
+ */
+void assertCompiledMatchesTree(const BSONObj& query,
+                               std::unique_ptr<CollatorInterface> collator = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(std::move(collator));
+    auto expr = uassertStatusOK(MatchExpressionParser::parse(query, expCtx));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    for (const auto& doc : corpus()) {
+        ASSERT_EQ(expr->matchesBSON(doc), compiled->matches(doc))
+            << "query: " << query << ", document: " << doc;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, IntegralComparisons) {
+    for (auto op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesTree(BSON("a" << BSON(op << 5)));
+        assertCompiledMatchesTree(BSON("a" << BSON(op << 5LL)));
+        assertCompiledMatchesTree(BSON("a.b" << BSON(op << 1)));
+    }
+}
+
+TEST(CompiledMatchExpressionTest, DoubleComparisons) {
+    for (auto op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesTree(BSON("a" << BSON(op << 5.5)));
+        assertCompiledMatchesTree(BSON("a" << BSON(op << -0.0)));
+        assertCompiledMatchesTree(
+            BSON("a" << BSON(op << std::numeric_limits<double>::quiet_NaN())));
+    }
+}
+
+TEST(CompiledMatchExpressionTest, StringComparisons) {
+    for (auto op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesTree(BSON("a" << BSON(op << "abc")));
+        assertCompiledMatchesTree(BSON("a" << BSON(op << "ab")));
+        assertCompiledMatchesTree(BSON("a.b" << BSON(op << "abc")));
+    }
+}
+
+TEST(CompiledMatchExpressionTest, StringComparisonsWithCollation) {
+    for (auto op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesTree(BSON("a" << BSON(op << "abc")),
+                                  std::make_unique<CollatorInterfaceMock>(
+                                      CollatorInterfaceMock::MockType::kReverseString));
+    }
+}
+
+TEST(CompiledMatchExpressionTest, ComparisonsAcrossTypes) {
+    for (auto op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesTree(BSON("a" << BSON(op << BSONNULL)));
+        assertCompiledMatchesTree(BSON("a" << BSON(op << MINKEY)));
+        assertCompiledMatchesTree(BSON("a" << BSON(op << MAXKEY)));
+        assertCompiledMatchesTree(BSON("a" << BSON(op << BSON("b" << 1))));
+        assertCompiledMatchesTree(BSON("a" << BSON(op << BSON_ARRAY(5))));
+    }
+}
+
+TEST(CompiledMatchExpressionTest, OtherLeaves) {
+    assertCompiledMatchesTree(fromjson("{a: {$in: [1, 'abc', null]}}"));
+    assertCompiledMatchesTree(fromjson("{a: {$exists: false}}"));
+    assertCompiledMatchesTree(fromjson("{'a.b': {$exists: true}}"));
+    assertCompiledMatchesTree(fromjson("{a: {$type: 'string'}}"));
+    assertCompiledMatchesTree(fromjson("{a: {$regex: '^ab'}}"));
+    assertCompiledMatchesTree(fromjson("{a: {$size: 3}}"));
+    assertCompiledMatchesTree(fromjson("{a: {$elemMatch: {b: 7}}}"));
+    assertCompiledMatchesTree(fromjson("{'a.0': 5}"));
+}
+
+TEST(CompiledMatchExpressionTest, LogicalNodes) {
+    assertCompiledMatchesTree(fromjson("{a: {$gt: 1}, b: 'x'}"));
+    assertCompiledMatchesTree(fromjson("{$or: [{a: 1}, {'a.b': 1}, {b: 3}]}"));
+    assertCompiledMatchesTree(fromjson("{$nor: [{a: 1}, {b: 'x'}]}"));
+    assertCompiledMatchesTree(fromjson("{a: {$not: {$gt: 2}}}"));
+    assertCompiledMatchesTree(
+        fromjson("{$and: [{$or: [{a: 5}, {b: 3}]}, {$nor: [{'a.b.c': 2}, {a: {$lt: 0}}]}]}"));
+    assertCompiledMatchesTree(fromjson("{$alwaysTrue: 1}"));
+    assertCompiledMatchesTree(fromjson("{$alwaysFalse: 1}"));
+}
+
+TEST(CompiledMatchExpressionTest, NodesWithoutCompiledForm) {
+    assertCompiledMatchesTree(fromjson("{$expr: {$eq: ['$a', 5]}}"));
+    assertCompiledMatchesTree(fromjson("{$jsonSchema: {required: ['a']}, b: 3}"));
+}
+
+TEST(CompiledMatchExpressionTest, SharedPathPrefixesAreResolvedOnce) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto query = fromjson("{'a.b.c': 1, 'a.b.d': 2, 'a.e': 3, f: 4}");
+    auto expr = uassertStatusOK(MatchExpressionParser::parse(query, expCtx));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+
+    // a, a.b, a.b.c, a.b.d, a.e and f.
+    ASSERT_EQ(6U, compiled->numPathSlots());
+    ASSERT_TRUE(compiled->matches(fromjson("{a: {b: {c: 1, d: 2}, e: 3}, f: 4}")));
+    ASSERT_FALSE(compiled->matches(fromjson("{a: {b: {c: 1, d: 3}, e: 3}, f: 4}")));
+}
+
+TEST(CompiledMatchExpressionTest, ProgramCanBeReused) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto query = fromjson("{'a.b': {$gte: 2}}");
+    auto expr = uassertStatusOK(MatchExpressionParser::parse(query, expCtx));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+
+    // The path value resolved for one document must not leak into the next one.
+    ASSERT_TRUE(compiled->matches(fromjson("{a: {b: 3}}")));
+    ASSERT_FALSE(compiled->matches(fromjson("{a: {b: 1}}")));
+    ASSERT_TRUE(compiled->matches(fromjson("{a: [{b: 1}, {b: 2}]}")));
+    ASSERT_FALSE(compiled->matches(fromjson("{a: 3}")));
+}
+
+}  // namespace
+}  // namespace mongo
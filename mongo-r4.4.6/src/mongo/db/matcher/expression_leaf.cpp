@@ -44,6 +44,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/path.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/regex_util.h"
 #include "mongo/util/str.h"
 
@@ -376,6 +377,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_updateEqualityHashSet();
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -385,9 +387,24 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
 }
 
 bool InMatchExpression::contains(const BSONElement& e) const {
+    if (_equalityHashSet) {
+        return _equalityHashSet->count(e) > 0;
+    }
     return std::binary_search(_equalitySet.begin(), _equalitySet.end(), e, _eltCmp.makeLessThan());
 }
 
+void InMatchExpression::_updateEqualityHashSet() {
+    _equalityHashSet = boost::none;
+    if (_equalitySet.empty() ||
+        _equalitySet.size() < static_cast<size_t>(internalQueryMinInListSizeForHashLookup.load())) {
+        return;
+    }
+
+    _equalityHashSet.emplace(_eltCmp.makeBSONEltUnorderedSet());
+    _equalityHashSet->reserve(_equalitySet.size());
+    _equalityHashSet->insert(_equalitySet.begin(), _equalitySet.end());
+}
+
 bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails* details) const {
     if (_hasNull && e.eoo()) {
         return true;
@@ -496,6 +513,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
                      _originalEqualityVector.end(),
                      std::back_inserter(_equalitySet),
                      _eltCmp.makeEqualTo());
+    _updateEqualityHashSet();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -529,6 +547,7 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
                      _originalEqualityVector.end(),
                      std::back_inserter(_equalitySet),
                      _eltCmp.makeEqualTo());
+    _updateEqualityHashSet();
 
     return Status::OK();
 }
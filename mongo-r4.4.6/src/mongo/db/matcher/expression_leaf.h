@@ -460,6 +460,12 @@ public:
 private:
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Rebuilds '_equalityHashSet' from '_equalitySet'. Must be called whenever either
+     * '_equalitySet' or '_eltCmp' changes.
+     */
+    void _updateEqualityHashSet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -483,10 +489,14 @@ private:
     // support std::binary_search. Because we need to sort the elements anyway for things like index
     // bounds building, using binary search avoids the overhead of inserting into a hash table which
     // doesn't pay for itself in the common case where lookups are done a few times if ever.
-    // TODO It may be worth dynamically creating a hashset after matchesSingleElement() has been
-    // called "many" times.
     std::vector<BSONElement> _equalitySet;
 
+    // Hash table over the elements of '_equalitySet', only built when there are at least
+    // internalQueryMinInListSizeForHashLookup of them. Hashes and compares elements with
+    // '_eltCmp', so lookups respect the collation and treat equal numbers of different types as
+    // equal, like the binary search does.
+    boost::optional<BSONEltUnorderedSet> _equalityHashSet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
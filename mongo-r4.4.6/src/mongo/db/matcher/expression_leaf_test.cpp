@@ -37,6 +37,7 @@
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/death_test.h"
 
 namespace mongo {
@@ -1370,6 +1371,90 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.contains(obj2.firstElement()));
 }
 
+/**
+ * Lowers internalQueryMinInListSizeForHashLookup for the lifetime of the object, so that $in
+ * lists of the given size look values up in a hash table.
+ */
+class ScopedMinInListSizeForHashLookup {
+public:
+    explicit ScopedMinInListSizeForHashLookup(int size)
+        : _saved(internalQueryMinInListSizeForHashLookup.load()) {
+        internalQueryMinInListSizeForHashLookup.store(size);
+    }
+
+    ~ScopedMinInListSizeForHashLookup() {
+        internalQueryMinInListSizeForHashLookup.store(_saved);
+    }
+
+private:
+    const int _saved;
+};
+
+TEST(InMatchExpression, HashLookupMatchesEqualNumbersOfAnyType) {
+    ScopedMinInListSizeForHashLookup scopedSize(2);
+    BSONArrayBuilder operandBuilder;
+    for (int i = 0; i < 100; ++i) {
+        operandBuilder.append(i * 2);
+    }
+    BSONArray operand = operandBuilder.arr();
+
+    InMatchExpression in("a");
+    std::vector<BSONElement> equalities;
+    for (auto&& elem : operand) {
+        equalities.push_back(elem);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    ASSERT(in.matchesBSON(BSON("a" << 10), nullptr));
+    ASSERT(in.matchesBSON(BSON("a" << 10LL), nullptr));
+    ASSERT(in.matchesBSON(BSON("a" << 10.0), nullptr));
+    ASSERT(in.matchesBSON(BSON("a" << BSON_ARRAY(1 << 198)), nullptr));
+    ASSERT(!in.matchesBSON(BSON("a" << 11), nullptr));
+    ASSERT(!in.matchesBSON(BSON("a" << 10.5), nullptr));
+    ASSERT(!in.matchesBSON(BSON("a"
+                                << "10"),
+                           nullptr));
+    ASSERT(!in.matchesBSON(BSONObj(), nullptr));
+}
+
+TEST(InMatchExpression, HashLookupRespectsCollation) {
+    ScopedMinInListSizeForHashLookup scopedSize(1);
+    BSONArray operand = BSON_ARRAY("abc"
+                                   << "def");
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InMatchExpression in("");
+    in.setCollator(&collator);
+    std::vector<BSONElement> equalities{operand[0], operand[1]};
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    BSONObj match = BSON(""
+                         << "ABC");
+    BSONObj notMatch = BSON(""
+                            << "ghi");
+    ASSERT(in.matchesSingleElement(match.firstElement()));
+    ASSERT(!in.matchesSingleElement(notMatch.firstElement()));
+
+    // The hash table is rebuilt for the new collation
+    in.setCollator(nullptr);
+    ASSERT(!in.matchesSingleElement(match.firstElement()));
+    ASSERT(in.matchesSingleElement(operand[0]));
+}
+
+TEST(InMatchExpression, ClonedExpressionUsesItsOwnHashLookup) {
+    ScopedMinInListSizeForHashLookup scopedSize(1);
+    BSONArray operand = BSON_ARRAY(1 << 2 << 3);
+    std::unique_ptr<MatchExpression> clone;
+    {
+        InMatchExpression in("a");
+        std::vector<BSONElement> equalities{operand[0], operand[1], operand[2]};
+        ASSERT_OK(in.setEqualities(std::move(equalities)));
+        clone = in.shallowClone();
+    }
+
+    ASSERT(clone->matchesBSON(BSON("a" << 2), nullptr));
+    ASSERT(!clone->matchesBSON(BSON("a" << 4), nullptr));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
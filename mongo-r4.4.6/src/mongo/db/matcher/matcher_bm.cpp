@@ -0,0 +1,216 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Measures how fast parsed match expressions evaluate documents, for the operators whose cost
+ * grows with the size of the query or of the document: $in over long lists, $regex, $elemMatch
+ * and paths through nested documents and arrays. Also compares conjunctions evaluated by walking
+ * the expression tree with the same conjunctions compiled into a CompiledMatchExpression.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+const int kNumDocs = 1000;
+
+/**
+ * Parses 'query', which must outlive the returned expression.
+ */
+std::unique_ptr<MatchExpression> parse(const BSONObj& query) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    return uassertStatusOK(MatchExpressionParser::parse(query, expCtx));
+}
+
+/**
+ * Evaluates 'expr' against every document of 'docs' once per iteration.
+ */
+void runMatcher(benchmark::State& state,
+                const MatchExpression& expr,
+                const std::vector<BSONObj>& docs) {
+    long long numMatches = 0;
+    for (auto _ : state) {
+        for (const auto& doc : docs) {
+            numMatches += expr.matchesBSON(doc, nullptr);
+        }
+    }
+    benchmark::DoNotOptimize(numMatches);
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+/**
+ * $in over state.range(0) integers, looked up by binary search when state.range(1) is 0 and in a
+ * hash table otherwise. About one document in ten matches.
+ */
+void BM_inList(benchmark::State& state) {
+    const auto listSize = state.range(0);
+    const int savedMinSize = internalQueryMinInListSizeForHashLookup.load();
+    internalQueryMinInListSizeForHashLookup.store(state.range(1) ? 0 : listSize + 1);
+
+    BSONArrayBuilder values;
+    for (long long i = 0; i < listSize; ++i) {
+        values.append(i * 10);
+    }
+    const BSONObj query = BSON("a" << BSON("$in" << values.arr()));
+    auto expr = parse(query);
+    internalQueryMinInListSizeForHashLookup.store(savedMinSize);
+
+    PseudoRandom random(listSize);
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < kNumDocs; ++i) {
+        docs.push_back(BSON("_id" << i << "a" << random.nextInt64(listSize * 10)));
+    }
+
+    runMatcher(state, *expr, docs);
+}
+
+/**
+ * Anchored and unanchored regular expressions over short strings.
+ */
+void BM_regex(benchmark::State& state) {
+    const BSONObj query = state.range(0) ? BSON("s" << BSONRegEx("^user_1.*9$"))
+                                         : BSON("s" << BSONRegEx("ser_1.*9"));
+    auto expr = parse(query);
+
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < kNumDocs; ++i) {
+        docs.push_back(BSON("_id" << i << "s" << ("user_" + std::to_string(i * 7))));
+    }
+
+    runMatcher(state, *expr, docs);
+}
+
+/**
+ * $elemMatch with two predicates over arrays of state.range(0) subdocuments.
+ */
+void BM_elemMatch(benchmark::State& state) {
+    const BSONObj query =
+        BSON("arr" << BSON("$elemMatch" << BSON("x" << BSON("$gt" << 95) << "y" << 1)));
+    auto expr = parse(query);
+
+    PseudoRandom random(state.range(0));
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < kNumDocs; ++i) {
+        BSONArrayBuilder arr;
+        for (long long j = 0; j < state.range(0); ++j) {
+            arr.append(BSON("x" << random.nextInt32(100) << "y" << random.nextInt32(2)));
+        }
+        docs.push_back(BSON("_id" << i << "arr" << arr.arr()));
+    }
+
+    runMatcher(state, *expr, docs);
+}
+
+/**
+ * Equality on a path of state.range(0) components. When state.range(1) is set, every level of
+ * the document is an array of two subdocuments, so the path fans out.
+ */
+void BM_deepPath(benchmark::State& state) {
+    const auto depth = state.range(0);
+    const bool arrays = state.range(1);
+
+    std::string path = "f";
+    for (long long i = 1; i < depth; ++i) {
+        path += ".f";
+    }
+    const BSONObj query = BSON(path << 3);
+    auto expr = parse(query);
+
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < kNumDocs; ++i) {
+        BSONObj value = BSON("f" << i % 5);
+        for (long long level = 1; level < depth; ++level) {
+            value = arrays ? BSON("f" << BSON_ARRAY(value << value)) : BSON("f" << value);
+        }
+        BSONObjBuilder doc;
+        doc.append("_id", i);
+        doc.appendElements(value);
+        docs.push_back(doc.obj());
+    }
+
+    runMatcher(state, *expr, docs);
+}
+
+/**
+ * A conjunction of comparisons on paths sharing the prefix 'a', evaluated by the expression tree
+ * when state.range(0) is 0 and by the compiled program otherwise.
+ */
+void BM_conjunction(benchmark::State& state) {
+    const BSONObj query = BSON("a.b.c" << BSON("$gte" << 10) << "a.b.d"
+                                       << "x"
+                                       << "a.e" << BSON("$lt" << 5.5) << "f" << BSON("$ne" << 0));
+    auto expr = parse(query);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+
+    PseudoRandom random(1);
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < kNumDocs; ++i) {
+        docs.push_back(BSON("_id" << i << "a"
+                                  << BSON("b" << BSON("c" << random.nextInt32(20) << "d"
+                                                          << (random.nextInt32(2) ? "x" : "y"))
+                                              << "e" << random.nextCanonicalDouble() * 10)
+                                  << "f" << random.nextInt32(10)));
+    }
+
+    if (!state.range(0)) {
+        runMatcher(state, *expr, docs);
+        return;
+    }
+
+    long long numMatches = 0;
+    for (auto _ : state) {
+        for (const auto& doc : docs) {
+            numMatches += compiled->matches(doc);
+        }
+    }
+    benchmark::DoNotOptimize(numMatches);
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+BENCHMARK(BM_inList)->RangeMultiplier(10)->Ranges({{10, 100'000}, {0, 1}});
+BENCHMARK(BM_regex)->Arg(0)->Arg(1);
+BENCHMARK(BM_elemMatch)->RangeMultiplier(10)->Range(1, 100);
+BENCHMARK(BM_deepPath)->RangeMultiplier(2)->Ranges({{1, 8}, {0, 1}});
+BENCHMARK(BM_conjunction)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace mongo
@@ -45,8 +45,11 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -430,6 +433,85 @@ TEST_F(DocumentSourceSortExecutionTest, ShouldBeAbleToPauseLoadingWhileSpilled)
     ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(0));
 }
 
+TEST_F(DocumentSourceSortExecutionTest, SpilledSortOfEncodedKeysMatchesInMemorySort) {
+    auto expCtx = getExpCtx();
+    expCtx->setCollator(
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kReverseString));
+
+    // Allow the $sort stage to spill to disk.
+    unittest::TempDir tempDir("DocumentSourceSortTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    // Numbers of all types including NaN and infinities, strings which the collator reverses,
+    // arrays, nested objects and other types, each of which ends up in several spilled runs.
+    BSONArrayBuilder valuesBuilder;
+    valuesBuilder << 1 << 1.5 << -2LL << Decimal128("1.5") << Decimal128("-0.25")
+                  << Decimal128("1E+400") << std::numeric_limits<double>::quiet_NaN()
+                  << Decimal128::kPositiveNaN << -std::numeric_limits<double>::infinity()
+                  << Decimal128::kPositiveInfinity;
+    valuesBuilder << "ab"
+                  << "ba"
+                  << "b";
+    valuesBuilder << BSON_ARRAY(3 << 1) << BSON_ARRAY("ba"
+                                                      << "ab")
+                  << BSONArray() << BSON_ARRAY(BSON("x" << 2) << BSON("x" << 1));
+    valuesBuilder << BSON("x" << 1 << "y" << 2) << BSON("x" << 1)
+                  << BSON("x" << BSON("z"
+                                      << "ab"))
+                  << BSON("x" << BSON("z"
+                                      << "ba"));
+    valuesBuilder << BSONNULL << MINKEY << MAXKEY << true << Date_t::fromMillisSinceEpoch(1);
+    const BSONArray values = valuesBuilder.arr();
+
+    std::vector<BSONElement> valueElements;
+    for (auto&& value : values) {
+        valueElements.push_back(value);
+    }
+
+    const string padding(200, 'x');
+    const int numValues = valueElements.size();
+    deque<DocumentSource::GetNextResult> inputDocs;
+    for (int i = 0; i < 3 * numValues; ++i) {
+        inputDocs.push_back(Document{{"_id", i},
+                                     {"a", Value(valueElements[i % numValues])},
+                                     {"b", i % 3},
+                                     {"padding", padding}});
+    }
+
+    const bool oldEncodeSortKeys = internalQueryEncodeSortKeys.load();
+    ON_BLOCK_EXIT([oldEncodeSortKeys] { internalQueryEncodeSortKeys.store(oldEncodeSortKeys); });
+
+    const auto runSort = [&](const BSONObj& sortSpec,
+                             uint64_t maxMemoryUsageBytes,
+                             bool encodeSortKeys,
+                             bool expectDiskUse) {
+        internalQueryEncodeSortKeys.store(encodeSortKeys);
+        auto sort = DocumentSourceSort::create(expCtx, sortSpec, 0, maxMemoryUsageBytes);
+        auto source = DocumentSourceMock::createForTest(inputDocs);
+        sort->setSource(source.get());
+
+        BSONArrayBuilder results;
+        for (auto next = sort->getNext(); next.isAdvanced(); next = sort->getNext()) {
+            results << next.releaseDocument();
+        }
+        ASSERT_EQ(sort->usedDisk(), expectDiskUse);
+        return results.arr();
+    };
+
+    for (auto&& sortSpec : {BSON("a" << 1 << "_id" << 1),
+                            BSON("a" << -1 << "_id" << 1),
+                            BSON("b" << 1 << "a" << -1 << "_id" << -1),
+                            BSON("a.x" << -1 << "b" << 1 << "_id" << 1)}) {
+        // Every few documents exceed the memory limit, so most of them are merged from disk.
+        const auto expected = runSort(sortSpec, 100 * 1024 * 1024, false, false);
+        ASSERT_EQ(expected.nFields(), 3 * numValues);
+        ASSERT_BSONOBJ_EQ(expected, runSort(sortSpec, 1000, false, true));
+        ASSERT_BSONOBJ_EQ(expected, runSort(sortSpec, 1000, true, true));
+        ASSERT_BSONOBJ_EQ(expected, runSort(sortSpec, 100 * 1024 * 1024, true, false));
+    }
+}
+
 TEST_F(DocumentSourceSortExecutionTest,
        ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
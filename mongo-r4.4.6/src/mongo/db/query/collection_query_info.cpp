@@ -238,6 +238,9 @@ void CollectionQueryInfo::addedIndex(OperationContext* opCtx, const IndexDescrip
 void CollectionQueryInfo::droppedIndex(OperationContext* opCtx, StringData indexName) {
     rebuildIndexData(opCtx);
     _indexUsageTracker.unregisterIndex(indexName);
+
+    stdx::lock_guard<Latch> lk(_indexStatisticsMutex);
+    _indexStatistics.erase(indexName);
 }
 
 void CollectionQueryInfo::rebuildIndexData(OperationContext* opCtx) {
@@ -257,4 +260,17 @@ CollectionIndexUsageTracker::CollectionScanStats CollectionQueryInfo::getCollect
     return _indexUsageTracker.getCollectionScanStats();
 }
 
+std::shared_ptr<const IndexStatistics> CollectionQueryInfo::getIndexStatistics(
+    StringData indexName) const {
+    stdx::lock_guard<Latch> lk(_indexStatisticsMutex);
+    auto it = _indexStatistics.find(indexName);
+    return it == _indexStatistics.end() ? nullptr : it->second;
+}
+
+void CollectionQueryInfo::setIndexStatistics(StringData indexName,
+                                             std::shared_ptr<const IndexStatistics> stats) {
+    stdx::lock_guard<Latch> lk(_indexStatisticsMutex);
+    _indexStatistics[indexName.toString()] = std::move(stats);
+}
+
 }  // namespace mongo
@@ -33,10 +33,13 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -79,6 +82,18 @@ public:
 
     CollectionIndexUsageTracker::CollectionScanStats getCollectionScanStats() const;
 
+    /**
+     * Returns the statistics collected by the 'analyze' command for the index named 'indexName',
+     * or nullptr if there are none.
+     */
+    std::shared_ptr<const IndexStatistics> getIndexStatistics(StringData indexName) const;
+
+    /**
+     * Replaces the statistics of the index named 'indexName'. They are discarded when the index is
+     * dropped.
+     */
+    void setIndexStatistics(StringData indexName, std::shared_ptr<const IndexStatistics> stats);
+
     /**
      * Builds internal cache state based on the current state of the Collection's IndexCatalog.
      */
@@ -130,6 +145,12 @@ private:
 
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
+
+    // Index statistics used for cost-based plan selection, keyed by index name. Set by commands
+    // holding only an intent lock, so guarded by a mutex of their own.
+    mutable Mutex _indexStatisticsMutex =
+        MONGO_MAKE_LATCH("CollectionQueryInfo::_indexStatisticsMutex");
+    StringMap<std::shared_ptr<const IndexStatistics>> _indexStatistics;
 };
 
 }  // namespace mongo
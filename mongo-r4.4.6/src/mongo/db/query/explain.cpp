@@ -339,7 +339,19 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     }
 
     // Stage-specific stats
-    if (STAGE_AND_HASH == stats.stageType) {
+    if (STAGE_AND_BITMAP == stats.stageType) {
+        AndBitmapStats* spec = static_cast<AndBitmapStats*>(stats.specific.get());
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("memUsage", spec->memUsage);
+            bob->appendNumber("memLimit", spec->memLimit);
+
+            for (size_t i = 0; i < spec->bitmapAfterChild.size(); ++i) {
+                bob->appendNumber(string(stream() << "bitmapAfterChild_" << i),
+                                  spec->bitmapAfterChild[i]);
+            }
+        }
+    } else if (STAGE_AND_HASH == stats.stageType) {
         AndHashStats* spec = static_cast<AndHashStats*>(stats.specific.get());
 
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
@@ -540,6 +552,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (isSortStageType(stats.stageType)) {
         SortStats* spec = static_cast<SortStats*>(stats.specific.get());
         bob->append("sortPattern", spec->sortPattern);
+        if (!spec->sortPrefix.isEmpty()) {
+            bob->append("sortPrefix", spec->sortPrefix);
+        }
         bob->appendIntOrLL("memLimit", spec->maxMemoryUsageBytes);
 
         if (spec->limit > 0) {
@@ -1038,6 +1053,14 @@ void Explain::planCacheEntryToBSON(const PlanCacheEntry& entry, BSONObjBuilder*
     out->append("works", static_cast<long long>(entry.works));
     out->append("timeOfCreation", entry.timeOfCreation);
 
+    if (!entry.parameterVariants.empty()) {
+        BSONArrayBuilder variantsBuilder(out->subarrayStart("parameterVariants"));
+        for (auto&& variant : entry.parameterVariants) {
+            variantsBuilder.append(BSON("parameters" << variant.parameters << "works"
+                                                     << static_cast<long long>(variant.works)));
+        }
+    }
+
     if (entry.debugInfo) {
         const auto& debugInfo = *entry.debugInfo;
         invariant(debugInfo.decision);
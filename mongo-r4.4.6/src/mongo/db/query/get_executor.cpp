@@ -69,6 +69,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cost_estimator.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -268,6 +269,17 @@ void fillOutPlannerParams(OperationContext* opCtx,
             indexEntryFromIndexCatalogEntry(opCtx, *ice, canonicalQuery));
     }
 
+    if (internalQueryPlannerEnableSkipScan.load()) {
+        const auto& queryInfo = CollectionQueryInfo::get(collection);
+        for (const auto& index : plannerParams->indices) {
+            const auto stats = queryInfo.getIndexStatistics(index.identifier.catalogName);
+            if (stats && stats->numRecords() > 0) {
+                plannerParams->leadingFieldDistinctRatios[index.identifier.catalogName] =
+                    stats->numDistinct() / stats->numRecords();
+            }
+        }
+    }
+
     // If query supports index filters, filter params.indices by indices in query settings.
     // Ignore index filters when it is possible to use the id-hack.
     applyIndexFilters(collection, *canonicalQuery, plannerParams);
@@ -499,7 +511,7 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         // Try to look up a cached solution for the query.
         if (auto cs = CollectionQueryInfo::get(collection)
                           .getPlanCache()
-                          ->getCacheEntryIfActive(planCacheKey)) {
+                          ->getCacheEntryIfActive(planCacheKey, canonicalQuery.get())) {
             // We have a CachedSolution.  Have the planner turn it into a QuerySolution.
             auto statusWithQs = QueryPlanner::planFromCache(*canonicalQuery, plannerParams, *cs);
 
@@ -580,6 +592,30 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // If the index statistics set one plan clearly apart from the others, skip the trial run.
+    if (solutions.size() > 1 && internalQueryEnableCostBasedPlanSelection.load()) {
+        const auto& queryInfo = CollectionQueryInfo::get(collection);
+        PlanCostEstimator estimator(collection->numRecords(opCtx), [&](const IndexEntry& index) {
+            return queryInfo.getIndexStatistics(index.identifier.catalogName);
+        });
+
+        if (auto winner = estimator.chooseSolution(
+                solutions, internalQueryCostBasedPlanSelectionConfidenceRatio.load())) {
+            auto root =
+                StageBuilder::build(opCtx, collection, *canonicalQuery, *solutions[*winner], ws);
+
+            LOGV2_DEBUG(5023418,
+                        2,
+                        "Chose the plan with the lowest estimated cost; it will be run but will "
+                        "not be cached",
+                        "query"_attr = redact(canonicalQuery->toStringShort()),
+                        "planSummary"_attr = Explain::getPlanSummary(root.get()));
+
+            return PrepareExecutionResult(
+                std::move(canonicalQuery), std::move(solutions[*winner]), std::move(root));
+        }
+    }
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         auto root = StageBuilder::build(opCtx, collection, *canonicalQuery, *solutions[0], ws);
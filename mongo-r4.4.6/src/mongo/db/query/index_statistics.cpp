@@ -0,0 +1,233 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+namespace {
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+BSONObj makeValue(const BSONElement& elem) {
+    BSONObjBuilder bob;
+    bob.appendAs(elem, "");
+    return bob.obj();
+}
+
+}  // namespace
+
+IndexStatistics::IndexStatistics(long long numKeys,
+                                 long long numRecords,
+                                 double numDistinct,
+                                 BSONObj minValue,
+                                 std::vector<Bucket> buckets)
+    : _numKeys(numKeys),
+      _numRecords(numRecords),
+      _numDistinct(numDistinct),
+      _minValue(std::move(minValue)),
+      _buckets(std::move(buckets)) {}
+
+double IndexStatistics::estimateKeys(const OrderedIntervalList& oil) const {
+    double numKeys = 0;
+    for (const auto& interval : oil.intervals) {
+        numKeys += estimateKeys(interval);
+    }
+    return std::min(numKeys, static_cast<double>(_numKeys));
+}
+
+double IndexStatistics::estimateKeys(const Interval& interval) const {
+    if (_buckets.empty()) {
+        return 0;
+    }
+
+    if (interval.isPoint()) {
+        return _estimatePoint(interval.start);
+    }
+
+    // Intervals over descending index fields go from the largest value to the smallest
+    BSONElement low = interval.start;
+    bool lowInclusive = interval.startInclusive;
+    BSONElement high = interval.end;
+    bool highInclusive = interval.endInclusive;
+    if (compareValues(low, high) > 0) {
+        std::swap(low, high);
+        std::swap(lowInclusive, highInclusive);
+    }
+
+    double numKeys = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        // The first bucket starts at the smallest sampled value, the others right after the upper
+        // bound of the previous bucket
+        const auto lower =
+            i == 0 ? _minValue.firstElement() : _buckets[i - 1].upperBound.firstElement();
+        const bool lowerInclusive = i == 0;
+        const auto upper = _buckets[i].upperBound.firstElement();
+
+        const int highVsLower = compareValues(high, lower);
+        if (highVsLower < 0 || (highVsLower == 0 && (!lowerInclusive || !highInclusive))) {
+            break;
+        }
+
+        const int lowVsUpper = compareValues(low, upper);
+        if (lowVsUpper > 0 || (lowVsUpper == 0 && !lowInclusive)) {
+            continue;
+        }
+
+        const int lowVsLower = compareValues(low, lower);
+        const int highVsUpper = compareValues(high, upper);
+        const bool containsLower =
+            lowVsLower < 0 || (lowVsLower == 0 && (!lowerInclusive || lowInclusive));
+        const bool containsUpper = highVsUpper > 0 || (highVsUpper == 0 && highInclusive);
+
+        // Values are assumed to be spread evenly in the buckets the interval only partly covers
+        numKeys += (containsLower && containsUpper) ? _buckets[i].numKeys
+                                                    : _buckets[i].numKeys / 2;
+    }
+
+    return numKeys;
+}
+
+double IndexStatistics::_estimatePoint(const BSONElement& value) const {
+    if (compareValues(value, _minValue.firstElement()) < 0) {
+        return 0;
+    }
+
+    const auto it = std::find_if(_buckets.begin(), _buckets.end(), [&](const Bucket& bucket) {
+        return compareValues(value, bucket.upperBound.firstElement()) <= 0;
+    });
+    if (it == _buckets.end()) {
+        return 0;
+    }
+
+    return it->numKeys / std::max(it->numDistinct, 1.0);
+}
+
+BSONObj IndexStatistics::toBSON() const {
+    BSONObjBuilder bob;
+    bob.appendNumber("numKeys", _numKeys);
+    bob.appendNumber("numRecords", _numRecords);
+    bob.append("numDistinct", _numDistinct);
+    if (!_minValue.isEmpty()) {
+        bob.appendAs(_minValue.firstElement(), "min");
+    }
+
+    BSONArrayBuilder bucketsBuilder(bob.subarrayStart("buckets"));
+    for (const auto& bucket : _buckets) {
+        BSONObjBuilder bucketBuilder(bucketsBuilder.subobjStart());
+        bucketBuilder.appendAs(bucket.upperBound.firstElement(), "upperBound");
+        bucketBuilder.append("numKeys", bucket.numKeys);
+        bucketBuilder.append("numDistinct", bucket.numDistinct);
+    }
+    bucketsBuilder.doneFast();
+
+    return bob.obj();
+}
+
+IndexStatisticsBuilder::IndexStatisticsBuilder(size_t sampleSize, int64_t seed)
+    : _sampleSize(sampleSize), _random(seed) {
+    invariant(_sampleSize > 0);
+}
+
+void IndexStatisticsBuilder::addKey(const BSONObj& key) {
+    ++_numKeys;
+
+    if (_sample.size() < _sampleSize) {
+        _sample.push_back(makeValue(key.firstElement()));
+        return;
+    }
+
+    // Reservoir sampling keeps every key seen so far in the sample with the same probability
+    const auto slot = _random.nextInt64(_numKeys);
+    if (slot < static_cast<long long>(_sampleSize)) {
+        _sample[slot] = makeValue(key.firstElement());
+    }
+}
+
+std::shared_ptr<const IndexStatistics> IndexStatisticsBuilder::done(long long numRecords) {
+    if (_sample.empty()) {
+        return std::make_shared<IndexStatistics>(
+            0, numRecords, 0, BSONObj(), std::vector<IndexStatistics::Bucket>());
+    }
+
+    std::sort(_sample.begin(), _sample.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return compareValues(lhs.firstElement(), rhs.firstElement()) < 0;
+    });
+
+    // Group the sorted sample into runs of equal values, so that no value spans two buckets
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t i = 0; i < _sample.size(); ++i) {
+        if (runs.empty() ||
+            compareValues(_sample[i].firstElement(), _sample[runs.back().first].firstElement())) {
+            runs.emplace_back(i, 0);
+        }
+        ++runs.back().second;
+    }
+
+    // Scale the number of distinct values in the sample up to the whole index with the Guaranteed
+    // Error Estimator: values seen once in the sample stand for sqrt(numKeys / sampleSize) values
+    const double scale = static_cast<double>(_numKeys) / _sample.size();
+    const auto numSingletons = std::count_if(
+        runs.begin(), runs.end(), [](const auto& run) { return run.second == 1; });
+    const double numDistinct =
+        std::min(std::sqrt(scale) * numSingletons + (runs.size() - numSingletons),
+                 static_cast<double>(_numKeys));
+    const double distinctScale = numDistinct / runs.size();
+
+    const size_t keysPerBucket = (_sample.size() + kMaxBuckets - 1) / kMaxBuckets;
+
+    std::vector<IndexStatistics::Bucket> buckets;
+    size_t bucketKeys = 0;
+    size_t bucketRuns = 0;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        bucketKeys += runs[i].second;
+        ++bucketRuns;
+
+        if (bucketKeys >= keysPerBucket || i == runs.size() - 1) {
+            buckets.push_back({_sample[runs[i].first],
+                               bucketKeys * scale,
+                               std::max(bucketRuns * distinctScale, 1.0)});
+            bucketKeys = 0;
+            bucketRuns = 0;
+        }
+    }
+
+    return std::make_shared<IndexStatistics>(
+        _numKeys, numRecords, numDistinct, _sample.front(), std::move(buckets));
+}
+
+}  // namespace mongo
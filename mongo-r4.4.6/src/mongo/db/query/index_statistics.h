@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+
+/**
+ * Statistics about the values of the leading field of an index, used to estimate how many keys an
+ * index scan examines without running it. Holds an equi-depth histogram built from a uniform
+ * sample of the index keys, where each bucket covers the values greater than the upper bound of
+ * the previous bucket up to and including its own upper bound, and records how many keys and how
+ * many distinct values fall in that range.
+ *
+ * Instances are immutable once built by an IndexStatisticsBuilder and may be shared between
+ * threads.
+ */
+class IndexStatistics {
+public:
+    struct Bucket {
+        // Single element object holding the largest value of the bucket
+        BSONObj upperBound;
+
+        // Estimated number of keys and of distinct values in the bucket
+        double numKeys;
+        double numDistinct;
+    };
+
+    IndexStatistics(long long numKeys,
+                    long long numRecords,
+                    double numDistinct,
+                    BSONObj minValue,
+                    std::vector<Bucket> buckets);
+
+    /**
+     * Returns the estimated number of keys whose leading field falls in one of the intervals of
+     * 'oil'.
+     */
+    double estimateKeys(const OrderedIntervalList& oil) const;
+
+    /**
+     * Returns the estimated number of keys whose leading field falls in 'interval'.
+     */
+    double estimateKeys(const Interval& interval) const;
+
+    /**
+     * Number of keys in the index and of records in the collection when the statistics were
+     * collected.
+     */
+    long long numKeys() const {
+        return _numKeys;
+    }
+
+    long long numRecords() const {
+        return _numRecords;
+    }
+
+    /**
+     * Estimated number of distinct values of the leading field.
+     */
+    double numDistinct() const {
+        return _numDistinct;
+    }
+
+    const std::vector<Bucket>& buckets() const {
+        return _buckets;
+    }
+
+    BSONObj toBSON() const;
+
+private:
+    double _estimatePoint(const BSONElement& value) const;
+
+    const long long _numKeys;
+    const long long _numRecords;
+    const double _numDistinct;
+
+    // Single element object holding the smallest sampled value, the lower bound of the first
+    // bucket
+    const BSONObj _minValue;
+
+    const std::vector<Bucket> _buckets;
+};
+
+/**
+ * Builds IndexStatistics from the keys of an index, given in any order. Keeps a reservoir sample of
+ * the leading field of at most 'sampleSize' keys, so that building statistics for a large index
+ * uses bounded memory.
+ */
+class IndexStatisticsBuilder {
+public:
+    // Maximum number of buckets in the histogram
+    static constexpr size_t kMaxBuckets = 100;
+
+    IndexStatisticsBuilder(size_t sampleSize, int64_t seed);
+
+    /**
+     * Adds an index key, as returned by the index cursor with empty field names.
+     */
+    void addKey(const BSONObj& key);
+
+    /**
+     * Builds the statistics from the keys added so far, for a collection with 'numRecords'
+     * records.
+     */
+    std::shared_ptr<const IndexStatistics> done(long long numRecords);
+
+private:
+    const size_t _sampleSize;
+    PseudoRandom _random;
+
+    long long _numKeys = 0;
+    std::vector<BSONObj> _sample;
+};
+
+}  // namespace mongo
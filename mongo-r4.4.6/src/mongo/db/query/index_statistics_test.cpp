@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include <limits>
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int64_t kSeed = 12345;
+
+std::shared_ptr<const IndexStatistics> buildUniform(int numValues, size_t sampleSize) {
+    IndexStatisticsBuilder builder(sampleSize, kSeed);
+    for (int i = 0; i < numValues; ++i) {
+        builder.addKey(BSON("" << i << "" << -i));
+    }
+    return builder.done(numValues);
+}
+
+TEST(IndexStatisticsTest, EmptyIndex) {
+    IndexStatisticsBuilder builder(100, kSeed);
+    auto stats = builder.done(0);
+
+    ASSERT_EQ(0, stats->numKeys());
+    ASSERT(stats->buckets().empty());
+    ASSERT_EQ(0, stats->estimateKeys(Interval(BSON("" << MINKEY << "" << MAXKEY), true, true)));
+}
+
+TEST(IndexStatisticsTest, BucketsHaveEqualDepth) {
+    auto stats = buildUniform(1000, 10000);
+
+    ASSERT_EQ(1000, stats->numKeys());
+    ASSERT_EQ(1000, stats->numRecords());
+    ASSERT_EQ(1000, stats->numDistinct());
+    ASSERT_EQ(IndexStatisticsBuilder::kMaxBuckets, stats->buckets().size());
+    for (const auto& bucket : stats->buckets()) {
+        ASSERT_EQ(10, bucket.numKeys);
+        ASSERT_EQ(10, bucket.numDistinct);
+    }
+}
+
+TEST(IndexStatisticsTest, EstimatesRange) {
+    auto stats = buildUniform(1000, 10000);
+
+    ASSERT_EQ(100, stats->estimateKeys(Interval(BSON("" << 100 << "" << 199), true, true)));
+    ASSERT_EQ(1000, stats->estimateKeys(Interval(BSON("" << MINKEY << "" << MAXKEY), true, true)));
+
+    // Buckets the interval only partly covers count for half of their keys
+    ASSERT_EQ(105, stats->estimateKeys(Interval(BSON("" << 95 << "" << 199), true, true)));
+
+    // Ranges outside of the sampled values are empty
+    ASSERT_EQ(0, stats->estimateKeys(Interval(BSON("" << 5000 << "" << 6000), true, true)));
+    ASSERT_EQ(0, stats->estimateKeys(Interval(BSON("" << -10 << "" << -1), true, true)));
+}
+
+TEST(IndexStatisticsTest, EstimatesDescendingRange) {
+    auto stats = buildUniform(1000, 10000);
+
+    ASSERT_EQ(stats->estimateKeys(Interval(BSON("" << 100 << "" << 199), true, true)),
+              stats->estimateKeys(Interval(BSON("" << 199 << "" << 100), true, true)));
+}
+
+TEST(IndexStatisticsTest, RangeOnlyCountsValuesOfItsType) {
+    IndexStatisticsBuilder builder(10000, kSeed);
+    for (int i = 0; i < 500; ++i) {
+        builder.addKey(BSON("" << i));
+        builder.addKey(BSON("" << std::to_string(i)));
+    }
+    auto stats = builder.done(1000);
+
+    const auto numbers = Interval(BSON("" << -std::numeric_limits<double>::infinity() << ""
+                                          << std::numeric_limits<double>::infinity()),
+                                  true,
+                                  true);
+    ASSERT_APPROX_EQUAL(500, stats->estimateKeys(numbers), 10);
+}
+
+TEST(IndexStatisticsTest, EstimatesPointsOfSkewedValues) {
+    IndexStatisticsBuilder builder(10000, kSeed);
+    for (int i = 0; i < 900; ++i) {
+        builder.addKey(BSON("" << 5));
+    }
+    for (int i = 0; i < 100; ++i) {
+        builder.addKey(BSON("" << 1000 + i));
+    }
+    auto stats = builder.done(1000);
+
+    ASSERT_EQ(101, stats->numDistinct());
+    ASSERT_EQ(900, stats->estimateKeys(IndexBoundsBuilder::makePointInterval(BSON("" << 5))));
+    ASSERT_EQ(1, stats->estimateKeys(IndexBoundsBuilder::makePointInterval(BSON("" << 1050))));
+    ASSERT_EQ(0, stats->estimateKeys(IndexBoundsBuilder::makePointInterval(BSON("" << 1))));
+}
+
+TEST(IndexStatisticsTest, SumsIntervalsOfList) {
+    auto stats = buildUniform(1000, 10000);
+
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(Interval(BSON("" << 0 << "" << 99), true, true));
+    oil.intervals.push_back(Interval(BSON("" << 500 << "" << 599), true, true));
+    ASSERT_EQ(200, stats->estimateKeys(oil));
+}
+
+TEST(IndexStatisticsTest, ScalesSampleToWholeIndex) {
+    auto stats = buildUniform(100000, 1000);
+
+    ASSERT_EQ(100000, stats->numKeys());
+    ASSERT_GT(stats->numDistinct(), 1000);
+    ASSERT_APPROX_EQUAL(
+        50000, stats->estimateKeys(Interval(BSON("" << 0 << "" << 49999), true, true)), 5000);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/stdx/unordered_map.h"
@@ -54,13 +55,28 @@ namespace mongo {
  * The keys of generic type K map to values of type V*. The V*
  * pointers are owned by the kv-store.
  *
+ * Besides the number of entries, the kv-store keeps track of the total "budget" of its entries,
+ * as charged by a BudgetEstimator for each (K, V) pair, typically their size in bytes. The
+ * estimator must charge the same budget for an entry for as long as it is in the kv-store. The
+ * default estimator charges nothing.
+ *
  * TODO: We could move this into the util/ directory and do any cleanup necessary to make it
  * fully general.
  */
-template <class K, class V, class KeyHasher = std::hash<K>>
+struct LRUNoBudgetEstimator {
+    template <class K, class V>
+    size_t operator()(const K&, const V&) const {
+        return 0;
+    }
+};
+
+template <class K,
+          class V,
+          class KeyHasher = std::hash<K>,
+          class BudgetEstimator = LRUNoBudgetEstimator>
 class LRUKeyValue {
 public:
-    LRUKeyValue(size_t maxSize) : _maxSize(maxSize), _currentSize(0){};
+    LRUKeyValue(size_t maxSize) : _maxSize(maxSize), _currentSize(0), _currentBudget(0){};
 
     ~LRUKeyValue() {
         clear();
@@ -95,6 +111,7 @@ public:
         KVMapConstIt i = _kvMap.find(key);
         if (i != _kvMap.end()) {
             KVListIt found = i->second;
+            _currentBudget -= _budgetEstimator(found->first, *found->second);
             delete found->second;
             _kvMap.erase(i);
             _kvList.erase(found);
@@ -104,6 +121,7 @@ public:
         _kvList.push_front(std::make_pair(key, entry));
         _kvMap[key] = _kvList.begin();
         _currentSize++;
+        _currentBudget += _budgetEstimator(key, *entry);
 
         // If the store has grown beyond its allowed size,
         // evict the least recently used entry.
@@ -111,6 +129,7 @@ public:
             V* evictedEntry = _kvList.back().second;
             invariant(evictedEntry);
 
+            _currentBudget -= _budgetEstimator(_kvList.back().first, *evictedEntry);
             _kvMap.erase(_kvList.back().first);
             _kvList.pop_back();
             _currentSize--;
@@ -124,6 +143,28 @@ public:
         return std::unique_ptr<V>();
     }
 
+    /**
+     * Evicts least recently used entries until the total budget of the entries left in the
+     * kv-store is at most 'maxBudget'.
+     *
+     * Passes ownership of the evicted entries to the caller, least recently used first.
+     */
+    std::vector<std::unique_ptr<V>> evictToBudget(size_t maxBudget) {
+        std::vector<std::unique_ptr<V>> evictedEntries;
+        while (_currentBudget > maxBudget) {
+            invariant(!_kvList.empty());
+            V* evictedEntry = _kvList.back().second;
+            invariant(evictedEntry);
+
+            _currentBudget -= _budgetEstimator(_kvList.back().first, *evictedEntry);
+            _kvMap.erase(_kvList.back().first);
+            _kvList.pop_back();
+            _currentSize--;
+            evictedEntries.emplace_back(evictedEntry);
+        }
+        return evictedEntries;
+    }
+
     /**
      * Retrieve the value associated with 'key' from
      * the kv-store. The value is returned through the
@@ -163,6 +204,7 @@ public:
             return Status(ErrorCodes::NoSuchKey, "no such key in LRU key-value store");
         }
         KVListIt found = i->second;
+        _currentBudget -= _budgetEstimator(found->first, *found->second);
         delete found->second;
         _kvMap.erase(i);
         _kvList.erase(found);
@@ -180,6 +222,7 @@ public:
         _kvList.clear();
         _kvMap.clear();
         _currentSize = 0;
+        _currentBudget = 0;
     }
 
     /**
@@ -196,6 +239,13 @@ public:
         return _currentSize;
     }
 
+    /**
+     * Returns the total budget of the entries currently in the kv-store.
+     */
+    size_t budget() const {
+        return _currentBudget;
+    }
+
     /**
      * TODO: The kv-store should implement its own iterator. Calling through to the underlying
      * iterator exposes the internals, and forces the caller to make a horrible type
@@ -216,6 +266,11 @@ private:
     // The number of entries currently in the kv-store.
     size_t _currentSize;
 
+    // The total budget of the entries currently in the kv-store.
+    size_t _currentBudget;
+
+    BudgetEstimator _budgetEstimator;
+
     // (K, V*) pairs are stored in this std::list. They are sorted in order
     // of use, where the front is the most recently used and the back is the
     // least recently used.
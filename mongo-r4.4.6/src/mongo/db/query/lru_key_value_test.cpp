@@ -195,4 +195,66 @@ TEST(LRUKeyValueTest, IterationTest) {
     ASSERT(i == cache.end());
 }
 
+/**
+ * Charges each entry its value.
+ */
+struct ValueBudgetEstimator {
+    size_t operator()(int, int value) const {
+        return value;
+    }
+};
+
+/**
+ * Test that the budget follows additions, replacements, removals and evictions.
+ */
+TEST(LRUKeyValueTest, BudgetTest) {
+    LRUKeyValue<int, int, std::hash<int>, ValueBudgetEstimator> cache(3);
+    ASSERT_EQUALS(cache.budget(), 0U);
+    cache.add(1, new int(10));
+    cache.add(2, new int(20));
+    ASSERT_EQUALS(cache.budget(), 30U);
+
+    // Replace an entry.
+    cache.add(1, new int(15));
+    ASSERT_EQUALS(cache.budget(), 35U);
+
+    // Evict the least recently used entry, the one with key 2, by number of entries.
+    cache.add(3, new int(30));
+    cache.add(4, new int(40));
+    ASSERT_EQUALS(cache.budget(), 85U);
+
+    ASSERT_OK(cache.remove(3));
+    ASSERT_EQUALS(cache.budget(), 55U);
+
+    cache.clear();
+    ASSERT_EQUALS(cache.budget(), 0U);
+}
+
+/**
+ * Test that evictToBudget() evicts least recently used entries first, and only as many as needed.
+ */
+TEST(LRUKeyValueTest, EvictToBudgetTest) {
+    LRUKeyValue<int, int, std::hash<int>, ValueBudgetEstimator> cache(10);
+    for (int i = 1; i <= 4; i++) {
+        cache.add(i, new int(i * 10));
+    }
+
+    // Promote the entry with key 1 so that the entries with keys 2 and 3 are evicted.
+    int* value = nullptr;
+    ASSERT_OK(cache.get(1, &value));
+
+    auto evicted = cache.evictToBudget(60);
+    ASSERT_EQUALS(evicted.size(), 2U);
+    ASSERT_EQUALS(*evicted[0], 20);
+    ASSERT_EQUALS(*evicted[1], 30);
+    ASSERT_EQUALS(cache.size(), 2U);
+    ASSERT_EQUALS(cache.budget(), 50U);
+    ASSERT_TRUE(cache.hasKey(1));
+    ASSERT_TRUE(cache.hasKey(4));
+
+    ASSERT_TRUE(cache.evictToBudget(50).empty());
+    ASSERT_EQUALS(cache.evictToBudget(0).size(), 2U);
+    ASSERT_EQUALS(cache.size(), 0U);
+}
+
 }  // namespace
@@ -45,6 +45,7 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/plan_ranker.h"
@@ -62,6 +63,14 @@ namespace {
 ServerStatusMetricField<Counter64> totalPlanCacheSizeEstimateBytesMetric(
     "query.planCacheTotalSizeEstimateBytes", &PlanCacheEntry::planCacheTotalSizeEstimateBytes);
 
+ServerStatusMetricField<Counter64> planCacheEntriesWithoutDebugInfoMetric(
+    "query.planCacheEntriesWithoutDebugInfo", &PlanCacheEntry::planCacheEntriesWithoutDebugInfo);
+
+// Number of plan cache entries evicted to keep the plan caches within their byte budgets
+Counter64 planCacheEntriesEvictedForSize;
+ServerStatusMetricField<Counter64> planCacheEntriesEvictedForSizeMetric(
+    "query.planCacheEntriesEvictedForSize", &planCacheEntriesEvictedForSize);
+
 // Delimiters for cache key encoding.
 const char kEncodeDiscriminatorsBegin = '<';
 const char kEncodeDiscriminatorsEnd = '>';
@@ -103,6 +112,38 @@ void encodeIndexability(const MatchExpression* tree,
     }
 }
 
+void appendParameters(const MatchExpression* expr, BSONArrayBuilder* builder) {
+    if (ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+        builder->append(static_cast<const ComparisonMatchExpression*>(expr)->getData());
+        return;
+    }
+
+    switch (expr->matchType()) {
+        case MatchExpression::REGEX: {
+            const auto* regex = static_cast<const RegexMatchExpression*>(expr);
+            builder->appendRegex(regex->getString(), regex->getFlags());
+            return;
+        }
+        case MatchExpression::MATCH_IN: {
+            const auto* in = static_cast<const InMatchExpression*>(expr);
+            BSONArrayBuilder inBuilder(builder->subarrayStart());
+            for (auto&& equality : in->getEqualities()) {
+                inBuilder.append(equality);
+            }
+            for (auto&& regex : in->getRegexes()) {
+                inBuilder.appendRegex(regex->getString(), regex->getFlags());
+            }
+            return;
+        }
+        default:
+            break;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        appendParameters(expr->getChild(i), builder);
+    }
+}
+
 }  // namespace
 
 std::ostream& operator<<(std::ostream& stream, const PlanCacheKey& key) {
@@ -166,6 +207,10 @@ bool PlanCache::shouldCacheQuery(const CanonicalQuery& query) {
 CachedSolution::CachedSolution(const PlanCacheEntry& entry)
     : plannerData(entry.plannerData->clone()), decisionWorks(entry.works) {}
 
+CachedSolution::CachedSolution(std::unique_ptr<SolutionCacheData> plannerData,
+                               size_t decisionWorks)
+    : plannerData(std::move(plannerData)), decisionWorks(decisionWorks) {}
+
 //
 // PlanCacheEntry
 //
@@ -196,8 +241,9 @@ std::unique_ptr<PlanCacheEntry> PlanCacheEntry::create(
     // plan cache to be functional. Once the cumulative plan cache size exceeds this threshold, omit
     // this debug info as a heuristic to prevent plan cache memory consumption from growing too
     // large.
-    const bool includeDebugInfo = planCacheTotalSizeEstimateBytes.get() <
-        internalQueryCacheMaxSizeBytesBeforeStripDebugInfo.load();
+    const bool includeDebugInfo = internalQueryCacheStoreDebugInfo.load() &&
+        planCacheTotalSizeEstimateBytes.get() <
+            internalQueryCacheMaxSizeBytesBeforeStripDebugInfo.load();
 
     boost::optional<DebugInfo> debugInfo;
     if (includeDebugInfo) {
@@ -235,7 +281,8 @@ PlanCacheEntry::PlanCacheEntry(std::unique_ptr<const SolutionCacheData> plannerD
                                const uint32_t planCacheKey,
                                const bool isActive,
                                const size_t works,
-                               boost::optional<DebugInfo> debugInfo)
+                               boost::optional<DebugInfo> debugInfo,
+                               std::vector<ParameterVariant> parameterVariants)
     : plannerData(std::move(plannerData)),
       timeOfCreation(timeOfCreation),
       queryHash(queryHash),
@@ -243,15 +290,22 @@ PlanCacheEntry::PlanCacheEntry(std::unique_ptr<const SolutionCacheData> plannerD
       isActive(isActive),
       works(works),
       debugInfo(std::move(debugInfo)),
+      parameterVariants(std::move(parameterVariants)),
       estimatedEntrySizeBytes(_estimateObjectSizeInBytes()) {
     invariant(this->plannerData);
     // Account for the object in the global metric for estimating the server's total plan cache
     // memory consumption.
     planCacheTotalSizeEstimateBytes.increment(estimatedEntrySizeBytes);
+    if (!this->debugInfo) {
+        planCacheEntriesWithoutDebugInfo.increment();
+    }
 }
 
 PlanCacheEntry::~PlanCacheEntry() {
     planCacheTotalSizeEstimateBytes.decrement(estimatedEntrySizeBytes);
+    if (!debugInfo) {
+        planCacheEntriesWithoutDebugInfo.decrement();
+    }
 }
 
 std::unique_ptr<PlanCacheEntry> PlanCacheEntry::clone() const {
@@ -266,7 +320,46 @@ std::unique_ptr<PlanCacheEntry> PlanCacheEntry::clone() const {
                                                               planCacheKey,
                                                               isActive,
                                                               works,
-                                                              std::move(debugInfoCopy)));
+                                                              std::move(debugInfoCopy),
+                                                              parameterVariants));
+}
+
+std::unique_ptr<PlanCacheEntry> PlanCacheEntry::cloneWithParameterVariant(
+    ParameterVariant variant, size_t maxVariants) const {
+    boost::optional<DebugInfo> debugInfoCopy;
+    if (debugInfo) {
+        debugInfoCopy.emplace(*debugInfo);
+    }
+
+    std::vector<ParameterVariant> variants;
+    for (auto&& existing : parameterVariants) {
+        if (!existing.parameters.binaryEqual(variant.parameters)) {
+            variants.push_back(existing);
+        }
+    }
+    variants.push_back(std::move(variant));
+    if (variants.size() > maxVariants) {
+        variants.erase(variants.begin(), variants.end() - maxVariants);
+    }
+
+    return std::unique_ptr<PlanCacheEntry>(new PlanCacheEntry(plannerData->clone(),
+                                                              timeOfCreation,
+                                                              queryHash,
+                                                              planCacheKey,
+                                                              isActive,
+                                                              works,
+                                                              std::move(debugInfoCopy),
+                                                              std::move(variants)));
+}
+
+const PlanCacheEntry::ParameterVariant* PlanCacheEntry::findParameterVariant(
+    const BSONObj& parameters) const {
+    for (auto&& variant : parameterVariants) {
+        if (variant.parameters.binaryEqual(parameters)) {
+            return &variant;
+        }
+    }
+    return nullptr;
 }
 
 uint64_t PlanCacheEntry::CreatedFromQuery::estimateObjectSizeInBytes() const {
@@ -293,6 +386,27 @@ PlanCacheEntry::DebugInfo& PlanCacheEntry::DebugInfo::operator=(const DebugInfo&
     return *this;
 }
 
+PlanCacheEntry::ParameterVariant::ParameterVariant(
+    BSONObj parameters, std::unique_ptr<const SolutionCacheData> plannerData, size_t works)
+    : parameters(std::move(parameters)), plannerData(std::move(plannerData)), works(works) {
+    invariant(this->plannerData);
+}
+
+PlanCacheEntry::ParameterVariant::ParameterVariant(const ParameterVariant& other)
+    : parameters(other.parameters), plannerData(other.plannerData->clone()), works(other.works) {}
+
+PlanCacheEntry::ParameterVariant& PlanCacheEntry::ParameterVariant::operator=(
+    const ParameterVariant& other) {
+    parameters = other.parameters;
+    plannerData = other.plannerData->clone();
+    works = other.works;
+    return *this;
+}
+
+uint64_t PlanCacheEntry::ParameterVariant::estimateObjectSizeInBytes() const {
+    return parameters.objsize() + plannerData->estimateObjectSizeInBytes() + sizeof(*this);
+}
+
 uint64_t PlanCacheEntry::DebugInfo::estimateObjectSizeInBytes() const {
     uint64_t size = 0;
     size += createdFromQuery.estimateObjectSizeInBytes();
@@ -308,6 +422,11 @@ uint64_t PlanCacheEntry::_estimateObjectSizeInBytes() const {
         size += debugInfo->estimateObjectSizeInBytes();
     }
 
+    size += container_size_helper::estimateObjectSizeInBytes(
+        parameterVariants,
+        [](const auto& variant) { return variant.estimateObjectSizeInBytes(); },
+        false);
+
     return size;
 }
 
@@ -335,14 +454,14 @@ std::string PlanCacheEntry::debugString() const {
 //
 
 void PlanCacheIndexTree::setIndexEntry(const IndexEntry& ie) {
-    entry.reset(new IndexEntry(ie));
+    entryId = ie.identifier;
 }
 
 PlanCacheIndexTree* PlanCacheIndexTree::clone() const {
     PlanCacheIndexTree* root = new PlanCacheIndexTree();
-    if (nullptr != entry.get()) {
+    if (entryId) {
         root->index_pos = index_pos;
-        root->setIndexEntry(*entry.get());
+        root->entryId = entryId;
         root->canCombineBounds = canCombineBounds;
     }
     root->orPushdowns = orPushdowns;
@@ -369,8 +488,8 @@ std::string PlanCacheIndexTree::toString(int indents) const {
         return result.str();
     } else {
         result << std::string(3 * indents, '-') << "Leaf ";
-        if (nullptr != entry.get()) {
-            result << entry->identifier << ", pos: " << index_pos << ", can combine? "
+        if (entryId) {
+            result << *entryId << ", pos: " << index_pos << ", can combine? "
                    << canCombineBounds;
         }
         for (const auto& orPushdown : orPushdowns) {
@@ -417,6 +536,10 @@ std::string SolutionCacheData::toString() const {
                                  << "tree=" << this->tree->toString() << ")";
         case COLLSCAN_SOLN:
             return "(collection scan)";
+        case SKIP_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
         case USE_INDEX_TAGS_SOLN:
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
@@ -435,8 +558,9 @@ PlanCache::PlanCache(size_t size) : _cache(size) {}
 
 PlanCache::~PlanCache() {}
 
-std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(const PlanCacheKey& key) const {
-    PlanCache::GetResult res = get(key);
+std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(
+    const PlanCacheKey& key, const CanonicalQuery* query) const {
+    PlanCache::GetResult res = get(key, query);
     if (res.state == PlanCache::CacheEntryState::kPresentInactive) {
         LOGV2_DEBUG(20936,
                     2,
@@ -625,6 +749,7 @@ Status PlanCache::set(const CanonicalQuery& query,
 
     auto newEntry(PlanCacheEntry::create(
         solns, std::move(why), query, queryHash, planCacheKey, now, isNewEntryActive, newWorks));
+    const size_t newEntryBytes = PlanCacheEntryBudgetEstimator{}(key, *newEntry);
 
     std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
 
@@ -638,9 +763,87 @@ Status PlanCache::set(const CanonicalQuery& query,
                     "evictedEntry"_attr = redact(evictedEntry->debugString()));
     }
 
+    evictToBudget(query, newEntryBytes);
     return Status::OK();
 }
 
+Status PlanCache::setParameterVariant(const CanonicalQuery& query,
+                                      const std::vector<QuerySolution*>& solns,
+                                      std::unique_ptr<PlanRankingDecision> why,
+                                      Date_t now) {
+    invariant(why);
+
+    if (solns.empty() || why->stats.empty()) {
+        return Status(ErrorCodes::BadValue, "no solutions provided");
+    }
+
+    const size_t maxVariants = internalQueryCacheMaxParameterVariantsPerEntry.load();
+    const auto key = computeKey(query);
+    if (maxVariants > 0 && solns[0]->cacheData) {
+        BSONObj parameters = computeParameters(query);
+        const size_t newWorks = why->stats[0]->common.works;
+
+        stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+        PlanCacheEntry* oldEntry = nullptr;
+        Status cacheStatus = _cache.get(key, &oldEntry);
+        invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
+        // If replanning chose the entry's own plan again, it is the entry's works which were too
+        // low, so the entry is updated the usual way rather than through a copy of its plan.
+        if (oldEntry && oldEntry->isActive &&
+            oldEntry->plannerData->toString() != solns[0]->cacheData->toString() &&
+            (oldEntry->parameterVariants.size() < maxVariants ||
+             oldEntry->findParameterVariant(parameters))) {
+            auto newEntry = oldEntry->cloneWithParameterVariant(
+                {std::move(parameters), solns[0]->cacheData->clone(), newWorks}, maxVariants);
+            LOGV2_DEBUG(5023423,
+                        1,
+                        "Caching plan for the parameters of the query as a variant of the active "
+                        "cache entry",
+                        "query"_attr = redact(query.toStringShort()),
+                        "queryHash"_attr = unsignedIntToFixedLengthHex(newEntry->queryHash),
+                        "planCacheKey"_attr = unsignedIntToFixedLengthHex(newEntry->planCacheKey),
+                        "numVariants"_attr = newEntry->parameterVariants.size(),
+                        "newWorks"_attr = newWorks);
+            const size_t newEntryBytes = PlanCacheEntryBudgetEstimator{}(key, *newEntry);
+
+            // Replacing the entry under the same key cannot evict another one.
+            _cache.add(key, newEntry.release());
+            evictToBudget(query, newEntryBytes);
+            return Status::OK();
+        }
+    }
+
+    deactivate(query);
+    return set(query, solns, std::move(why), now);
+}
+
+void PlanCache::evictToBudget(const CanonicalQuery& query, size_t newEntryBytes) {
+    size_t maxBytes = internalQueryCacheMaxSizeBytesPerCollection.load();
+
+    // Only this collection's cache can be evicted from here, so it makes up for all of the excess
+    // across collections, but keeps the new entry so that caches which are no longer written to
+    // cannot starve it.
+    const long long totalBytes = PlanCacheEntry::planCacheTotalSizeEstimateBytes.get();
+    const long long maxTotalBytes = internalQueryCacheMaxTotalSizeBytes.load();
+    if (totalBytes > maxTotalBytes) {
+        const size_t excessBytes = totalBytes - maxTotalBytes;
+        const size_t cacheBytes = _cache.budget();
+        maxBytes = std::min(
+            maxBytes,
+            std::max(cacheBytes > excessBytes ? cacheBytes - excessBytes : 0, newEntryBytes));
+    }
+
+    for (auto&& evictedEntry : _cache.evictToBudget(maxBytes)) {
+        planCacheEntriesEvictedForSize.increment();
+        LOGV2_DEBUG(5023422,
+                    1,
+                    "Plan cache maximum size in bytes exceeded - removed least recently used entry",
+                    "namespace"_attr = query.nss(),
+                    "maxSizeBytes"_attr = maxBytes,
+                    "evictedEntry"_attr = redact(evictedEntry->debugString()));
+    }
+}
+
 void PlanCache::deactivate(const CanonicalQuery& query) {
     if (internalQueryCacheDisableInactiveEntries.load()) {
         // This is a noop if inactive entries are disabled.
@@ -661,10 +864,10 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
 
 PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
-    return get(key);
+    return get(key, &query);
 }
 
-PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
+PlanCache::GetResult PlanCache::get(const PlanCacheKey& key, const CanonicalQuery* query) const {
     stdx::lock_guard<Latch> cacheLock(_cacheMutex);
     PlanCacheEntry* entry = nullptr;
     Status cacheStatus = _cache.get(key, &entry);
@@ -676,6 +879,15 @@ PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
 
     auto state =
         entry->isActive ? CacheEntryState::kPresentActive : CacheEntryState::kPresentInactive;
+
+    // Only pay for computing the parameters of the query when the entry has variants.
+    if (query && !entry->parameterVariants.empty()) {
+        if (const auto* variant = entry->findParameterVariant(computeParameters(*query))) {
+            return {state,
+                    std::make_unique<CachedSolution>(variant->plannerData->clone(),
+                                                     variant->works)};
+        }
+    }
     return {state, std::make_unique<CachedSolution>(*entry)};
 }
 
@@ -697,6 +909,12 @@ PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
     return PlanCacheKey(std::move(shapeString), indexabilityKeyBuilder.str());
 }
 
+BSONObj PlanCache::computeParameters(const CanonicalQuery& query) {
+    BSONArrayBuilder builder;
+    appendParameters(query.root(), &builder);
+    return builder.arr();
+}
+
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
 
@@ -728,6 +946,11 @@ size_t PlanCache::size() const {
     return _cache.size();
 }
 
+size_t PlanCache::sizeBytes() const {
+    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    return _cache.budget();
+}
+
 void PlanCache::notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores) {
     _indexabilityState.updateDiscriminators(indexCores);
 }
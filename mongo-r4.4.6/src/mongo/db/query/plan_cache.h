@@ -130,6 +130,11 @@ struct QuerySolutionNode;
  *   recreate index assignments. Specifically, a raw MatchExpression
  *   is tagged according to the index tags in the PlanCacheIndexTree.
  *   This is done by QueryPlanner::tagAccordingToCache.
+ *
+ * Only the identifiers of the assigned indices are kept, rather than
+ * whole IndexEntry(s), so that cache entries stay small. The planner
+ * looks the indices up among the current ones when planning from the
+ * cache.
  */
 struct PlanCacheIndexTree {
 
@@ -154,7 +159,7 @@ struct PlanCacheIndexTree {
         std::deque<size_t> route;
     };
 
-    PlanCacheIndexTree() : entry(nullptr), index_pos(0), canCombineBounds(true) {}
+    PlanCacheIndexTree() : index_pos(0), canCombineBounds(true) {}
 
     ~PlanCacheIndexTree() {
         for (std::vector<PlanCacheIndexTree*>::const_iterator it = children.begin();
@@ -165,7 +170,7 @@ struct PlanCacheIndexTree {
     }
 
     /**
-     * Clone 'ie' and set 'this->entry' to be the clone.
+     * Set 'this->entryId' to the identifier of 'ie'.
      */
     void setIndexEntry(const IndexEntry& ie);
 
@@ -190,16 +195,17 @@ struct PlanCacheIndexTree {
                 orPushdowns,
                 [](const auto& orPushdown) { return orPushdown.estimateObjectSizeInBytes(); },
                 false) +
-            // Add size of 'entry' if present.
-            (entry ? entry->estimateObjectSizeInBytes() : 0) +
+            // Add size of 'entryId' if present, the static size of which is already included in
+            // 'sizeof(*this)'.
+            (entryId ? entryId->estimateObjectSizeInBytes() - sizeof(*entryId) : 0) +
             // Add size of the object.
             sizeof(*this);
     }
     // Children owned here.
     std::vector<PlanCacheIndexTree*> children;
 
-    // Owned here.
-    std::unique_ptr<IndexEntry> entry;
+    // Identifier of the index assigned to this node, if any.
+    boost::optional<IndexEntry::Identifier> entryId;
 
     size_t index_pos;
 
@@ -235,7 +241,8 @@ struct SolutionCacheData {
 
     // Owned here. If 'wholeIXSoln' is false, then 'tree'
     // can be used to tag an isomorphic match expression. If 'wholeIXSoln'
-    // is true, then 'tree' is used to store the relevant IndexEntry.
+    // is true, then 'tree' is used to store the identifier of the relevant
+    // index.
     // If 'collscanSoln' is true, then 'tree' should be NULL.
     std::unique_ptr<PlanCacheIndexTree> tree;
 
@@ -248,6 +255,11 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // Indicates that the plan should skip
+        // scan the index in 'tree', seeking to
+        // each value of its leading field.
+        SKIP_SCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -275,6 +287,8 @@ private:
 public:
     CachedSolution(const PlanCacheEntry& entry);
 
+    CachedSolution(std::unique_ptr<SolutionCacheData> plannerData, size_t decisionWorks);
+
     // Information that can be used by the QueryPlanner to reconstitute the complete execution plan.
     std::unique_ptr<SolutionCacheData> plannerData;
 
@@ -342,6 +356,38 @@ public:
         std::unique_ptr<const PlanRankingDecision> decision;
     };
 
+    /**
+     * A plan which is used instead of the entry's plan for queries whose constants are equal to
+     * 'parameters'. Variants are added when the entry's plan performs poorly for some values of
+     * the constants of the query shape, and the replanned query picks another plan.
+     */
+    struct ParameterVariant {
+        ParameterVariant(BSONObj parameters,
+                         std::unique_ptr<const SolutionCacheData> plannerData,
+                         size_t works);
+
+        ParameterVariant(const ParameterVariant&);
+        ParameterVariant& operator=(const ParameterVariant&);
+        ParameterVariant(ParameterVariant&&) = default;
+        ParameterVariant& operator=(ParameterVariant&&) = default;
+
+        /**
+         * Returns an estimate of the size of this object, including the memory allocated elsewhere
+         * that it owns, in bytes.
+         */
+        uint64_t estimateObjectSizeInBytes() const;
+
+        // The constants of the query for which this plan was chosen, as computed by
+        // PlanCache::computeParameters().
+        BSONObj parameters;
+
+        // Never nullptr.
+        std::unique_ptr<const SolutionCacheData> plannerData;
+
+        // The number of works it took to pick this plan.
+        size_t works;
+    };
+
     /**
      * Create a new PlanCacheEntry.
      * Grabs any planner-specific data required from the solutions.
@@ -363,6 +409,19 @@ public:
      */
     std::unique_ptr<PlanCacheEntry> clone() const;
 
+    /**
+     * Make a deep copy with 'variant' added to the parameter variants, replacing the variant for
+     * the same parameters if there is one. The oldest variants are dropped to keep at most
+     * 'maxVariants' of them.
+     */
+    std::unique_ptr<PlanCacheEntry> cloneWithParameterVariant(ParameterVariant variant,
+                                                              size_t maxVariants) const;
+
+    /**
+     * Returns the variant of this entry for 'parameters', or nullptr if there is none.
+     */
+    const ParameterVariant* findParameterVariant(const BSONObj& parameters) const;
+
     std::string debugString() const;
 
     // Data provided to the planner to allow it to recreate the solution this entry represents. In
@@ -397,6 +456,9 @@ public:
     // debug info is omitted from new plan cache entries.
     const boost::optional<DebugInfo> debugInfo;
 
+    // Plans for specific values of the constants of the query shape, oldest first.
+    const std::vector<ParameterVariant> parameterVariants;
+
     // An estimate of the size in bytes of this plan cache entry. This is the "deep size",
     // calculated by recursively incorporating the size of owned objects, the objects that they in
     // turn own, and so on.
@@ -407,6 +469,12 @@ public:
      */
     inline static Counter64 planCacheTotalSizeEstimateBytes;
 
+    /**
+     * Counts the plan cache entries across all the collections which were created without debug
+     * info.
+     */
+    inline static Counter64 planCacheEntriesWithoutDebugInfo;
+
 private:
     /**
      * All arguments constructor.
@@ -417,7 +485,8 @@ private:
                    uint32_t planCacheKey,
                    bool isActive,
                    size_t works,
-                   boost::optional<DebugInfo> debugInfo);
+                   boost::optional<DebugInfo> debugInfo,
+                   std::vector<ParameterVariant> parameterVariants = {});
 
     // Ensure that PlanCacheEntry is non-copyable.
     PlanCacheEntry(const PlanCacheEntry&) = delete;
@@ -426,6 +495,15 @@ private:
     uint64_t _estimateObjectSizeInBytes() const;
 };
 
+/**
+ * Charges a plan cache entry and its key against the byte budget of the plan cache.
+ */
+struct PlanCacheEntryBudgetEstimator {
+    size_t operator()(const PlanCacheKey& key, const PlanCacheEntry& entry) const {
+        return key.toString().size() + entry.estimatedEntrySizeBytes;
+    }
+};
+
 /**
  * Caches the best solution to a query.  Aside from the (CanonicalQuery -> QuerySolution)
  * mapping, the cache contains information on why that mapping was made and statistics on the
@@ -500,6 +578,18 @@ public:
                Date_t now,
                boost::optional<double> worksGrowthCoefficient = boost::none);
 
+    /**
+     * Record the best of 'solns' as the plan of the active cache entry for the shape of 'query'
+     * when its constants have the values they have in 'query'. Used when the plan of the entry
+     * performed poorly for these values. If there is no active entry, the best plan is the plan of
+     * the entry, or the entry already holds 'internalQueryCacheMaxParameterVariantsPerEntry'
+     * variants for other values, the entry is deactivated and set() is called instead.
+     */
+    Status setParameterVariant(const CanonicalQuery& query,
+                               const std::vector<QuerySolution*>& solns,
+                               std::unique_ptr<PlanRankingDecision> why,
+                               Date_t now);
+
     /**
      * Set a cache entry back to the 'inactive' state. Rather than completely evicting an entry
      * when the associated plan starts to perform poorly, we deactivate it, so that plans which
@@ -521,15 +611,17 @@ public:
      * of a plan cache key.
      *
      * The return value will provide the "state" of the cache entry, as well as the CachedSolution
-     * for the query (if there is one).
+     * for the query (if there is one). If 'query' is provided and the entry has a variant for its
+     * parameters, the CachedSolution holds the plan of that variant.
      */
-    GetResult get(const PlanCacheKey& key) const;
+    GetResult get(const PlanCacheKey& key, const CanonicalQuery* query = nullptr) const;
 
     /**
      * If the cache entry exists and is active, return a CachedSolution. If the cache entry is
      * inactive, log a message and return a nullptr. If no cache entry exists, return a nullptr.
      */
-    std::unique_ptr<CachedSolution> getCacheEntryIfActive(const PlanCacheKey& key) const;
+    std::unique_ptr<CachedSolution> getCacheEntryIfActive(
+        const PlanCacheKey& key, const CanonicalQuery* query = nullptr) const;
 
     /**
      * Remove the entry corresponding to 'ck' from the cache.  Returns Status::OK() if the plan
@@ -553,6 +645,13 @@ public:
      */
     PlanCacheKey computeKey(const CanonicalQuery&) const;
 
+    /**
+     * Returns the constants of the predicates of 'query', in the canonical order of its match
+     * expression. Queries of the same shape whose parameters are binary equal can share a plan
+     * chosen for these values.
+     */
+    static BSONObj computeParameters(const CanonicalQuery& query);
+
     /**
      * Returns a copy of a cache entry, looked up by CanonicalQuery.
      *
@@ -572,6 +671,11 @@ public:
      */
     size_t size() const;
 
+    /**
+     * Returns the estimated number of bytes taken by the keys and entries in the cache.
+     */
+    size_t sizeBytes() const;
+
     /**
      * Updates internal state kept about the collection's indexes.  Must be called when the set
      * of indexes on the associated collection have changed.
@@ -601,7 +705,15 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    /**
+     * Evicts least recently used entries to bring the cache within the byte budget of a single
+     * collection, and to bring the plan caches of all collections within their total budget
+     * without evicting the entry just added, which is charged 'newEntryBytes'.
+     */
+    void evictToBudget(const CanonicalQuery& query, size_t newEntryBytes);
+
+    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher, PlanCacheEntryBudgetEstimator>
+        _cache;
 
     // Protects _cache.
     mutable Mutex _cacheMutex = MONGO_MAKE_LATCH("PlanCache::_cacheMutex");
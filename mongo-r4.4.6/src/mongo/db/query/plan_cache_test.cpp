@@ -1257,6 +1257,32 @@ TEST_F(CachePlanSelectionTest, EqualityIndexScanWithTrailingFields) {
         BSON("x" << 5), "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
 }
 
+TEST_F(CachePlanSelectionTest, CachedIndexScanIsRebuiltForOtherConstants) {
+    addIndex(BSON("x" << 1 << "y" << 1), "x_1_y_1");
+    runQuery(fromjson("{x: 5, y: {$gt: 1}}"));
+
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
+    auto planSoln = planQueryFromCache(
+        fromjson("{x: 7, y: {$gt: 3}}"), BSONObj(), BSONObj(), BSONObj(), *bestSoln);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}, "
+                          "bounds: {x: [[7, 7, true, true]], y: [[3, Infinity, false, true]]}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, RebuiltIndexScanFetchesForUnassignedPredicates) {
+    addIndex(BSON("x" << 1), "x_1");
+    runQuery(fromjson("{x: {$gt: 1}, z: 2}"));
+
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: {z: 2}, node: {ixscan: {pattern: {x: 1}}}}}");
+    auto planSoln = planQueryFromCache(
+        fromjson("{x: {$gt: 4}, z: 3}"), BSONObj(), BSONObj(), BSONObj(), *bestSoln);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: {z: 3}, node: {ixscan: {pattern: {x: 1}, "
+                          "bounds: {x: [[4, Infinity, false, true]]}}}}}");
+}
+
 //
 // Geo
 //
@@ -2473,4 +2499,211 @@ TEST(PlanCacheTest, PlanCacheSizeWithMultiplePlanCaches) {
     // Verify that size is reset to the original size after removing all entries.
     ASSERT_EQ(PlanCacheEntry::planCacheTotalSizeEstimateBytes.get(), originalSize);
 }
+
+TEST(PlanCacheTest, PlanCacheEvictsLeastRecentlyUsedEntriesToStayWithinByteBudget) {
+    PlanCache planCache;
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    // All the queries below have entries and keys of the same size.
+    unique_ptr<CanonicalQuery> cq(canonicalize("{z: 1, c: 1}"));
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U), Date_t{}));
+    const size_t entryBytes = planCache.sizeBytes();
+    ASSERT_GT(entryBytes, 0U);
+    planCache.clear();
+    ASSERT_EQ(planCache.sizeBytes(), 0U);
+
+    const long long oldMaxSizeBytes = internalQueryCacheMaxSizeBytesPerCollection.load();
+    ON_BLOCK_EXIT([oldMaxSizeBytes] {
+        internalQueryCacheMaxSizeBytesPerCollection.store(oldMaxSizeBytes);
+    });
+    internalQueryCacheMaxSizeBytesPerCollection.store(3 * entryBytes + entryBytes / 2);
+
+    std::string queryString = "{a: 1, c: 1}";
+    for (int i = 0; i < 5; ++i) {
+        queryString[1] = 'b' + i;
+        unique_ptr<CanonicalQuery> query(canonicalize(queryString));
+        ASSERT_OK(planCache.set(*query, solns, createDecision(1U), Date_t{}));
+        ASSERT_LTE(planCache.size(), 3U);
+        ASSERT_LTE(planCache.sizeBytes(), 3 * entryBytes + entryBytes / 2);
+    }
+
+    // The entries of the first two queries were evicted.
+    for (int i = 0; i < 5; ++i) {
+        queryString[1] = 'b' + i;
+        unique_ptr<CanonicalQuery> query(canonicalize(queryString));
+        ASSERT_EQ(planCache.getEntry(*query).isOK(), i >= 2);
+    }
+
+    // An entry which is larger than the whole budget is not kept.
+    internalQueryCacheMaxSizeBytesPerCollection.store(entryBytes / 2);
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U), Date_t{}));
+    ASSERT_EQ(planCache.size(), 0U);
+    ASSERT_EQ(planCache.sizeBytes(), 0U);
+}
+
+TEST(PlanCacheTest, PlanCacheKeepsNewEntryWhenOverTotalByteBudget) {
+    PlanCache planCache;
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    const long long oldMaxTotalSizeBytes = internalQueryCacheMaxTotalSizeBytes.load();
+    ON_BLOCK_EXIT([oldMaxTotalSizeBytes] {
+        internalQueryCacheMaxTotalSizeBytes.store(oldMaxTotalSizeBytes);
+    });
+    internalQueryCacheMaxTotalSizeBytes.store(
+        PlanCacheEntry::planCacheTotalSizeEstimateBytes.get());
+
+    // Every new entry takes the total over the budget, so it evicts the previous one.
+    std::string queryString = "{a: 1, c: 1}";
+    for (int i = 0; i < 3; ++i) {
+        queryString[1] = 'b' + i;
+        unique_ptr<CanonicalQuery> query(canonicalize(queryString));
+        ASSERT_OK(planCache.set(*query, solns, createDecision(1U), Date_t{}));
+        ASSERT_EQ(planCache.size(), 1U);
+        ASSERT_OK(planCache.getEntry(*query).getStatus());
+    }
+}
+
+TEST(PlanCacheTest, PlanCacheEntryWithoutDebugInfo) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1, b: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U), Date_t{}));
+    auto entryWithDebugInfo = assertGet(planCache.getEntry(*cq));
+    ASSERT(entryWithDebugInfo->debugInfo);
+
+    internalQueryCacheStoreDebugInfo.store(false);
+    ON_BLOCK_EXIT([] { internalQueryCacheStoreDebugInfo.store(true); });
+
+    const long long entriesWithoutDebugInfo =
+        PlanCacheEntry::planCacheEntriesWithoutDebugInfo.get();
+    ASSERT_OK(planCache.remove(*cq));
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U), Date_t{}));
+    ASSERT_EQ(PlanCacheEntry::planCacheEntriesWithoutDebugInfo.get(), entriesWithoutDebugInfo + 1);
+
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_FALSE(entry->debugInfo);
+    ASSERT_LT(entry->estimatedEntrySizeBytes, entryWithDebugInfo->estimatedEntrySizeBytes);
+    entry.reset();
+
+    ASSERT_OK(planCache.remove(*cq));
+    ASSERT_EQ(PlanCacheEntry::planCacheEntriesWithoutDebugInfo.get(), entriesWithoutDebugInfo);
+}
+TEST(PlanCacheTest, ComputeParametersDependsOnlyOnConstants) {
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1, b: {$in: [2, 3]}, c: {$gt: 4}}"));
+    unique_ptr<CanonicalQuery> reordered(canonicalize("{c: {$gt: 4}, b: {$in: [3, 2]}, a: 1}"));
+    unique_ptr<CanonicalQuery> other(canonicalize("{a: 1, b: {$in: [2, 3]}, c: {$gt: 5}}"));
+
+    const BSONObj parameters = PlanCache::computeParameters(*cq);
+    ASSERT_TRUE(parameters.binaryEqual(PlanCache::computeParameters(*reordered)));
+    ASSERT_FALSE(parameters.binaryEqual(PlanCache::computeParameters(*other)));
+}
+
+TEST(PlanCacheTest, PlanCacheKeepsReplannedPlanAsParameterVariant) {
+    const int oldMaxVariants = internalQueryCacheMaxParameterVariantsPerEntry.load();
+    ON_BLOCK_EXIT([oldMaxVariants] {
+        internalQueryCacheMaxParameterVariantsPerEntry.store(oldMaxVariants);
+    });
+    internalQueryCacheMaxParameterVariantsPerEntry.store(4);
+
+    PlanCache planCache;
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+    auto collscanQs = getQuerySolutionForCaching();
+    collscanQs->cacheData->solnType = SolutionCacheData::COLLSCAN_SOLN;
+    std::vector<QuerySolution*> collscanSolns = {collscanQs.get()};
+
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1, b: {$gt: 2}}"));
+    unique_ptr<CanonicalQuery> skewed(canonicalize("{a: 3, b: {$gt: 2}}"));
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+    const size_t shapeBytes = planCache.sizeBytes();
+
+    ASSERT_OK(
+        planCache.setParameterVariant(*skewed, collscanSolns, createDecision(1U, 50), Date_t{}));
+    ASSERT_EQ(planCache.size(), 1U);
+    ASSERT_GT(planCache.sizeBytes(), shapeBytes);
+
+    // Only the query with the same constants gets the variant.
+    auto result = planCache.get(*skewed);
+    ASSERT_EQ(result.state, PlanCache::CacheEntryState::kPresentActive);
+    ASSERT_EQ(result.cachedSolution->plannerData->solnType, SolutionCacheData::COLLSCAN_SOLN);
+    ASSERT_EQ(result.cachedSolution->decisionWorks, 50U);
+
+    result = planCache.get(*cq);
+    ASSERT_EQ(result.state, PlanCache::CacheEntryState::kPresentActive);
+    ASSERT_EQ(result.cachedSolution->plannerData->solnType,
+              SolutionCacheData::USE_INDEX_TAGS_SOLN);
+    ASSERT_EQ(result.cachedSolution->decisionWorks, 10U);
+
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->parameterVariants.size(), 1U);
+    ASSERT_TRUE(entry->findParameterVariant(PlanCache::computeParameters(*skewed)));
+}
+
+TEST(PlanCacheTest, PlanCacheDeactivatesEntryWhenParameterVariantsAreFull) {
+    const int oldMaxVariants = internalQueryCacheMaxParameterVariantsPerEntry.load();
+    ON_BLOCK_EXIT([oldMaxVariants] {
+        internalQueryCacheMaxParameterVariantsPerEntry.store(oldMaxVariants);
+    });
+    internalQueryCacheMaxParameterVariantsPerEntry.store(1);
+
+    PlanCache planCache;
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+    auto collscanQs = getQuerySolutionForCaching();
+    collscanQs->cacheData->solnType = SolutionCacheData::COLLSCAN_SOLN;
+    std::vector<QuerySolution*> collscanSolns = {collscanQs.get()};
+
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1, b: {$gt: 2}}"));
+    unique_ptr<CanonicalQuery> skewed(canonicalize("{a: 3, b: {$gt: 2}}"));
+    unique_ptr<CanonicalQuery> otherSkewed(canonicalize("{a: 4, b: {$gt: 2}}"));
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_OK(
+        planCache.setParameterVariant(*skewed, collscanSolns, createDecision(1U, 50), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+
+    // Replanning a variant replaces it.
+    ASSERT_OK(
+        planCache.setParameterVariant(*skewed, collscanSolns, createDecision(1U, 40), Date_t{}));
+    ASSERT_EQ(planCache.get(*skewed).cachedSolution->decisionWorks, 40U);
+
+    // There is no room for a variant for other constants, so the entry is replanned as a whole.
+    ASSERT_OK(planCache.setParameterVariant(
+        *otherSkewed, collscanSolns, createDecision(1U, 50), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->parameterVariants.size(), 1U);
+    ASSERT_FALSE(entry->findParameterVariant(PlanCache::computeParameters(*otherSkewed)));
+}
+
+TEST(PlanCacheTest, PlanCacheUpdatesEntryWhenReplanningChoosesItsPlan) {
+    const int oldMaxVariants = internalQueryCacheMaxParameterVariantsPerEntry.load();
+    ON_BLOCK_EXIT([oldMaxVariants] {
+        internalQueryCacheMaxParameterVariantsPerEntry.store(oldMaxVariants);
+    });
+    internalQueryCacheMaxParameterVariantsPerEntry.store(4);
+
+    PlanCache planCache;
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1, b: {$gt: 2}}"));
+    unique_ptr<CanonicalQuery> skewed(canonicalize("{a: 3, b: {$gt: 2}}"));
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+
+    // The same plan won again, so no variant is added and the works of the entry are raised.
+    ASSERT_OK(planCache.setParameterVariant(*skewed, solns, createDecision(1U, 50), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->parameterVariants.size(), 0U);
+    ASSERT_EQ(entry->works, 20U);
+}
 }  // namespace
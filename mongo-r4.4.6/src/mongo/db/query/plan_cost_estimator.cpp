@@ -0,0 +1,259 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mongo {
+namespace {
+
+// Relative costs of the unit of work of each kind of stage. Fetching a document is a random read,
+// while a collection scan reads documents in storage order.
+constexpr double kIndexKeyCost = 1.0;
+constexpr double kIndexSeekCost = 10.0;
+constexpr double kFetchCost = 10.0;
+constexpr double kCollScanDocCost = 2.0;
+constexpr double kSortKeyCost = 1.0;
+constexpr double kBitmapInsertCost = 0.1;
+
+// Fraction of its input a residual filter is assumed to let through
+constexpr double kFilterSelectivity = 0.5;
+
+// Fraction of the keys under each value of the leading field of an index which a skip scan is
+// assumed to examine, for each other field the bounds constrain
+constexpr double kSkipScanFieldSelectivity = 0.1;
+
+double applyFilter(const QuerySolutionNode* node, double numResults) {
+    return node->filter ? numResults * kFilterSelectivity : numResults;
+}
+
+bool scansAllValues(const OrderedIntervalList& oil) {
+    return oil.intervals.size() == 1 &&
+        (oil.intervals[0].isMinToMax() || oil.intervals[0].reverseClone().isMinToMax());
+}
+
+}  // namespace
+
+PlanCostEstimator::PlanCostEstimator(long long numRecords, IndexStatisticsFn getIndexStatistics)
+    : _numRecords(numRecords), _getIndexStatistics(std::move(getIndexStatistics)) {}
+
+boost::optional<double> PlanCostEstimator::estimateCost(const QuerySolutionNode* root) const {
+    auto estimate = _estimate(root);
+    if (!estimate) {
+        return boost::none;
+    }
+    return estimate->cost;
+}
+
+boost::optional<size_t> PlanCostEstimator::chooseSolution(
+    const std::vector<std::unique_ptr<QuerySolution>>& solutions, double confidenceRatio) const {
+    if (solutions.size() < 2) {
+        return boost::none;
+    }
+
+    std::vector<double> costs;
+    for (const auto& solution : solutions) {
+        auto cost = estimateCost(solution->root.get());
+        if (!cost) {
+            return boost::none;
+        }
+        costs.push_back(*cost);
+    }
+
+    const size_t best = std::min_element(costs.begin(), costs.end()) - costs.begin();
+    double runnerUpCost = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < costs.size(); ++i) {
+        if (i != best) {
+            runnerUpCost = std::min(runnerUpCost, costs[i]);
+        }
+    }
+
+    if (runnerUpCost == costs[best] || runnerUpCost < costs[best] * confidenceRatio) {
+        return boost::none;
+    }
+    return best;
+}
+
+boost::optional<PlanCostEstimator::Estimate> PlanCostEstimator::_estimate(
+    const QuerySolutionNode* node) const {
+    std::vector<Estimate> children;
+    for (const auto* child : node->children) {
+        auto estimate = _estimate(child);
+        if (!estimate) {
+            return boost::none;
+        }
+        children.push_back(*estimate);
+    }
+
+    switch (node->getType()) {
+        case STAGE_COLLSCAN:
+            return Estimate{_numRecords * kCollScanDocCost, applyFilter(node, _numRecords), false};
+
+        case STAGE_IXSCAN: {
+            const auto* ixn = static_cast<const IndexScanNode*>(node);
+            if (ixn->index.type != INDEX_BTREE || ixn->bounds.isSimpleRange) {
+                return boost::none;
+            }
+
+            const auto stats = _getIndexStatistics(ixn->index);
+            if (!stats || (stats->numRecords() == 0 && _numRecords > 0)) {
+                return boost::none;
+            }
+
+            // Assume the distribution of values has not changed since the statistics were
+            // collected and scale them by the growth of the collection
+            const double growth =
+                stats->numRecords() ? static_cast<double>(_numRecords) / stats->numRecords() : 1;
+            const auto& leadingField = ixn->bounds.fields[0];
+            double numKeys = stats->estimateKeys(leadingField) * growth;
+            double numSeeks = leadingField.intervals.size();
+
+            // A scan over every value of the leading field which is constrained on other fields
+            // seeks to the intervals of those fields under each distinct leading value.
+            if (scansAllValues(leadingField)) {
+                bool skipsKeys = false;
+                double intervalsPerValue = 1;
+                for (size_t i = 1; i < ixn->bounds.fields.size(); ++i) {
+                    if (!scansAllValues(ixn->bounds.fields[i])) {
+                        skipsKeys = true;
+                        intervalsPerValue *= ixn->bounds.fields[i].intervals.size();
+                        numKeys *= kSkipScanFieldSelectivity;
+                    }
+                }
+                if (skipsKeys) {
+                    numSeeks = stats->numDistinct() * intervalsPerValue;
+                }
+            }
+
+            const double cost = numKeys * kIndexKeyCost + numSeeks * kIndexSeekCost;
+            return Estimate{cost, applyFilter(node, numKeys), false};
+        }
+
+        case STAGE_FETCH: {
+            auto estimate = children[0];
+            estimate.cost += estimate.numResults * kFetchCost;
+            estimate.numResults = applyFilter(node, estimate.numResults);
+            return estimate;
+        }
+
+        case STAGE_AND_BITMAP: {
+            // Assume the children's predicates are independent. The RecordIds of every child but
+            // the last are added to a bitmap.
+            Estimate estimate{0, static_cast<double>(_numRecords), true};
+            for (size_t i = 0; i < children.size(); ++i) {
+                estimate.cost += children[i].cost;
+                if (i + 1 < children.size()) {
+                    estimate.cost += children[i].numResults * kBitmapInsertCost;
+                }
+                estimate.numResults *=
+                    _numRecords ? std::min(1.0, children[i].numResults / _numRecords) : 0;
+            }
+            return estimate;
+        }
+
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED: {
+            Estimate estimate{0, std::numeric_limits<double>::infinity(), false};
+            for (const auto& child : children) {
+                estimate.cost += child.cost;
+                estimate.numResults = std::min(estimate.numResults, child.numResults);
+                estimate.blocking |= child.blocking;
+            }
+            estimate.blocking |= node->getType() == STAGE_AND_HASH;
+            return estimate;
+        }
+
+        case STAGE_OR:
+        case STAGE_SORT_MERGE: {
+            Estimate estimate{0, 0, false};
+            for (const auto& child : children) {
+                estimate.cost += child.cost;
+                estimate.numResults += child.numResults;
+                estimate.blocking |= child.blocking;
+            }
+            if (node->getType() == STAGE_SORT_MERGE) {
+                estimate.cost += estimate.numResults * std::log2(children.size()) * kSortKeyCost;
+            }
+            estimate.numResults = applyFilter(node, estimate.numResults);
+            return estimate;
+        }
+
+        case STAGE_SORT_DEFAULT:
+        case STAGE_SORT_SIMPLE: {
+            const auto* sn = static_cast<const SortNode*>(node);
+            auto estimate = children[0];
+            const double numResults = sn->limit
+                ? std::min(estimate.numResults, static_cast<double>(sn->limit))
+                : estimate.numResults;
+            estimate.cost +=
+                estimate.numResults * std::log2(std::max(numResults, 2.0)) * kSortKeyCost;
+            estimate.numResults = numResults;
+            estimate.blocking = true;
+            return estimate;
+        }
+
+        case STAGE_LIMIT: {
+            const double limit = static_cast<const LimitNode*>(node)->limit;
+            auto estimate = children[0];
+            if (estimate.numResults > limit) {
+                // A pipelined plan stops as soon as it has produced enough results
+                if (!estimate.blocking) {
+                    estimate.cost *= limit / estimate.numResults;
+                }
+                estimate.numResults = limit;
+            }
+            return estimate;
+        }
+
+        case STAGE_SKIP: {
+            auto estimate = children[0];
+            estimate.numResults = std::max(
+                estimate.numResults - static_cast<const SkipNode*>(node)->skip, 0.0);
+            return estimate;
+        }
+
+        case STAGE_PROJECTION_COVERED:
+        case STAGE_PROJECTION_DEFAULT:
+        case STAGE_PROJECTION_SIMPLE:
+        case STAGE_RETURN_KEY:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SORT_KEY_GENERATOR:
+            return children[0];
+
+        default:
+            return boost::none;
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+/**
+ * Estimates the cost of executing a QuerySolution from the statistics of the indexes it scans, in
+ * abstract units where examining one index key costs 1. Lets the planner pick a plan without
+ * racing the candidates in a MultiPlanStage when one of them is clearly cheaper.
+ *
+ * The estimate only accounts for the leading field of each index scan, apart from the seeks of a
+ * skip scan, and treats every residual filter as keeping a fixed fraction of its input, so it is
+ * only trusted when it separates the best plan from the runner-up by a wide margin.
+ */
+class PlanCostEstimator {
+public:
+    // Returns the statistics of an index, or nullptr if there are none
+    using IndexStatisticsFn =
+        std::function<std::shared_ptr<const IndexStatistics>(const IndexEntry& index)>;
+
+    PlanCostEstimator(long long numRecords, IndexStatisticsFn getIndexStatistics);
+
+    /**
+     * Returns the estimated cost of executing the plan rooted at 'root', or boost::none if the plan
+     * contains a stage which cannot be costed or scans an index without statistics.
+     */
+    boost::optional<double> estimateCost(const QuerySolutionNode* root) const;
+
+    /**
+     * Returns the index in 'solutions' of the plan with the lowest estimated cost if every plan
+     * could be costed and the cost of every other plan is at least 'confidenceRatio' times higher.
+     * Otherwise returns boost::none, meaning the plans have to be ranked by trial runs.
+     */
+    boost::optional<size_t> chooseSolution(
+        const std::vector<std::unique_ptr<QuerySolution>>& solutions,
+        double confidenceRatio) const;
+
+private:
+    struct Estimate {
+        double cost;
+
+        // Estimated number of results produced
+        double numResults;
+
+        // Whether the stage has to consume its whole input before producing any result
+        bool blocking;
+    };
+
+    boost::optional<Estimate> _estimate(const QuerySolutionNode* node) const;
+
+    const long long _numRecords;
+    const IndexStatisticsFn _getIndexStatistics;
+};
+
+}  // namespace mongo
@@ -0,0 +1,221 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_estimator.h"
+
+#include "mongo/db/index_names.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+const long long kNumRecords = 1000;
+
+IndexEntry buildIndexEntry(const BSONObj& kp, const std::string& name) {
+    return {kp,
+            IndexNames::nameToType(IndexNames::findPluginName(kp)),
+            false,
+            {},
+            {},
+            false,
+            false,
+            CoreIndexInfo::Identifier(name),
+            nullptr,
+            {},
+            nullptr,
+            nullptr};
+}
+
+std::unique_ptr<QuerySolutionNode> makeIndexScan(const std::string& field, Interval interval) {
+    auto ixn = std::make_unique<IndexScanNode>(buildIndexEntry(BSON(field << 1), field + "_1"));
+    OrderedIntervalList oil(field);
+    oil.intervals.push_back(std::move(interval));
+    ixn->bounds.fields.push_back(std::move(oil));
+    return std::move(ixn);
+}
+
+std::unique_ptr<QuerySolutionNode> makeFetch(std::unique_ptr<QuerySolutionNode> child) {
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->children.push_back(child.release());
+    return std::move(fetch);
+}
+
+std::unique_ptr<QuerySolution> makeSolution(std::unique_ptr<QuerySolutionNode> root) {
+    auto solution = std::make_unique<QuerySolution>();
+    solution->root = std::move(root);
+    return solution;
+}
+
+class PlanCostEstimatorTest : public unittest::Test {
+protected:
+    void setUp() override {
+        // Both indexes have one key per record, with the values 0 to 999
+        for (const auto& name : {"a_1", "b_1"}) {
+            IndexStatisticsBuilder builder(10000, 0);
+            for (int i = 0; i < kNumRecords; ++i) {
+                builder.addKey(BSON("" << i));
+            }
+            _stats[std::string(name)] = builder.done(kNumRecords);
+        }
+    }
+
+    PlanCostEstimator makeEstimator(long long numRecords = kNumRecords) {
+        return PlanCostEstimator(numRecords, [this](const IndexEntry& index) {
+            auto it = _stats.find(index.identifier.catalogName);
+            return it == _stats.end() ? nullptr : it->second;
+        });
+    }
+
+    StringMap<std::shared_ptr<const IndexStatistics>> _stats;
+};
+
+TEST_F(PlanCostEstimatorTest, ChoosesSelectiveIndex) {
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeSolution(
+        makeFetch(makeIndexScan("b", Interval(BSON("" << 0 << "" << 500), true, true)))));
+    solutions.push_back(makeSolution(
+        makeFetch(makeIndexScan("a", IndexBoundsBuilder::makePointInterval(BSON("" << 5))))));
+
+    auto winner = makeEstimator().chooseSolution(solutions, 4.0);
+    ASSERT(winner);
+    ASSERT_EQ(1U, *winner);
+}
+
+TEST_F(PlanCostEstimatorTest, ChoosesBitmapIntersectionOfSelectiveIndexes) {
+    auto intersection = std::make_unique<AndBitmapNode>();
+    intersection->children.push_back(
+        makeIndexScan("a", Interval(BSON("" << 0 << "" << 199), true, true)).release());
+    intersection->children.push_back(
+        makeIndexScan("b", Interval(BSON("" << 0 << "" << 199), true, true)).release());
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeSolution(
+        makeFetch(makeIndexScan("a", Interval(BSON("" << 0 << "" << 199), true, true)))));
+    solutions.push_back(makeSolution(makeFetch(std::move(intersection))));
+
+    // Both predicates match a fifth of the collection, so the intersection fetches a fifth as
+    // many documents as the single index scan.
+    auto winner = makeEstimator().chooseSolution(solutions, 2.0);
+    ASSERT(winner);
+    ASSERT_EQ(1U, *winner);
+}
+
+TEST_F(PlanCostEstimatorTest, PrefersCollectionScanToFetchingMostRecords) {
+    auto collScan = std::make_unique<CollectionScanNode>();
+    auto ixScan = makeFetch(makeIndexScan("a", Interval(BSON("" << 0 << "" << 999), true, true)));
+
+    auto estimator = makeEstimator();
+    ASSERT_LT(*estimator.estimateCost(collScan.get()), *estimator.estimateCost(ixScan.get()));
+}
+
+TEST_F(PlanCostEstimatorTest, NoChoiceWhenIndexHasNoStatistics) {
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeSolution(
+        makeFetch(makeIndexScan("c", IndexBoundsBuilder::makePointInterval(BSON("" << 5))))));
+    solutions.push_back(makeSolution(
+        makeFetch(makeIndexScan("a", Interval(BSON("" << 0 << "" << 500), true, true)))));
+
+    ASSERT_FALSE(makeEstimator().estimateCost(solutions[0]->root.get()));
+    ASSERT_FALSE(makeEstimator().chooseSolution(solutions, 4.0));
+}
+
+TEST_F(PlanCostEstimatorTest, NoChoiceWhenCostsAreClose) {
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeSolution(
+        makeFetch(makeIndexScan("a", Interval(BSON("" << 0 << "" << 99), true, true)))));
+    solutions.push_back(makeSolution(
+        makeFetch(makeIndexScan("b", Interval(BSON("" << 0 << "" << 149), true, true)))));
+
+    ASSERT_FALSE(makeEstimator().chooseSolution(solutions, 4.0));
+    ASSERT(makeEstimator().chooseSolution(solutions, 1.2));
+}
+
+TEST_F(PlanCostEstimatorTest, ScalesStatisticsByCollectionGrowth) {
+    auto ixScan = makeIndexScan("a", Interval(BSON("" << 0 << "" << 99), true, true));
+
+    const auto cost = *makeEstimator().estimateCost(ixScan.get());
+    const auto grownCost = *makeEstimator(2 * kNumRecords).estimateCost(ixScan.get());
+    ASSERT_GT(grownCost, 1.5 * cost);
+}
+
+TEST_F(PlanCostEstimatorTest, LimitOnlyShortensPipelinedPlans) {
+    auto limit = std::make_unique<LimitNode>();
+    limit->limit = 10;
+    limit->children.push_back(
+        makeFetch(makeIndexScan("a", Interval(BSON("" << 0 << "" << 999), true, true)))
+            .release());
+
+    auto sort = std::make_unique<SortNodeDefault>();
+    sort->pattern = BSON("b" << 1);
+    sort->children.push_back(
+        makeFetch(makeIndexScan("a", Interval(BSON("" << 0 << "" << 999), true, true)))
+            .release());
+    auto sortLimit = std::make_unique<LimitNode>();
+    sortLimit->limit = 10;
+    sortLimit->children.push_back(sort.release());
+
+    auto estimator = makeEstimator();
+    ASSERT_LT(*estimator.estimateCost(limit.get()), 200);
+    ASSERT_GT(*estimator.estimateCost(sortLimit.get()), 10000);
+}
+
+TEST_F(PlanCostEstimatorTest, SkipScanCostsSeeksPerDistinctLeadingValue) {
+    // The leading field of {c: 1, d: 1} has 5 distinct values
+    IndexStatisticsBuilder builder(10000, 0);
+    for (int i = 0; i < kNumRecords; ++i) {
+        builder.addKey(BSON("" << i % 5 << "" << i));
+    }
+    _stats["c_1_d_1"] = builder.done(kNumRecords);
+
+    auto makeCompoundScan = [](Interval trailingInterval) {
+        auto ixn = std::make_unique<IndexScanNode>(
+            buildIndexEntry(BSON("c" << 1 << "d" << 1), "c_1_d_1"));
+        ixn->bounds.fields.resize(2);
+        IndexBoundsBuilder::allValuesForField(BSON("c" << 1).firstElement(),
+                                              &ixn->bounds.fields[0]);
+        ixn->bounds.fields[1].name = "d";
+        ixn->bounds.fields[1].intervals.push_back(std::move(trailingInterval));
+        return ixn;
+    };
+
+    auto skipScan = makeCompoundScan(IndexBoundsBuilder::makePointInterval(BSON("" << 5)));
+    auto wholeScan = makeCompoundScan(IndexBoundsBuilder::allValues());
+
+    auto estimator = makeEstimator();
+    const auto skipScanCost = *estimator.estimateCost(skipScan.get());
+    ASSERT_LT(4 * skipScanCost, *estimator.estimateCost(wholeScan.get()));
+}
+
+}  // namespace
+}  // namespace mongo
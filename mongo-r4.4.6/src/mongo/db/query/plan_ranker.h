@@ -73,7 +73,7 @@ public:
  */
 struct CandidatePlan {
     CandidatePlan(std::unique_ptr<QuerySolution> solution, PlanStage* r, WorkingSet* w)
-        : solution(std::move(solution)), root(r), ws(w), failed(false) {}
+        : solution(std::move(solution)), root(r), ws(w), failed(false), stopped(false) {}
 
     std::unique_ptr<QuerySolution> solution;
     PlanStage* root;  // Not owned here.
@@ -83,6 +83,9 @@ struct CandidatePlan {
     std::queue<WorkingSetID> results;
 
     bool failed;
+
+    // Whether the trial period stopped working this plan because it fell too far behind.
+    bool stopped;
 };
 
 }  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
@@ -1081,7 +1082,7 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
             return nullptr;
         }
 
-        // Figure out if we want AndHashNode or AndSortedNode.
+        // Figure out if we want AndHashNode, AndBitmapNode or AndSortedNode.
         bool allSortedByDiskLoc = true;
         for (size_t i = 0; i < ixscanNodes.size(); ++i) {
             if (!ixscanNodes[i]->sortedByDiskLoc()) {
@@ -1093,16 +1094,22 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
             auto asn = std::make_unique<AndSortedNode>();
             asn->addChildren(std::move(ixscanNodes));
             andResult = std::move(asn);
-        } else if (internalQueryPlannerEnableHashIntersection.load()) {
-            {
+        } else if (internalQueryPlannerEnableHashIntersection.load() ||
+                   internalQueryPlannerEnableBitmapIntersection.load()) {
+            // Hash-based intersection is off by default, so enabling it takes precedence.
+            if (internalQueryPlannerEnableHashIntersection.load()) {
                 auto ahn = std::make_unique<AndHashNode>();
                 ahn->addChildren(std::move(ixscanNodes));
                 andResult = std::move(ahn);
+            } else {
+                auto abn = std::make_unique<AndBitmapNode>();
+                abn->addChildren(std::move(ixscanNodes));
+                andResult = std::move(abn);
             }
 
-            // The AndHashNode provides the sort order of its last child.  If any of the
-            // possible subnodes of AndHashNode provides the sort order we care about, we put
-            // that one last.
+            // The AndHashNode and AndBitmapNode provide the sort order of their last child.  If
+            // any of the possible subnodes provides the sort order we care about, we put that one
+            // last.
             for (size_t i = 0; i < andResult->children.size(); ++i) {
                 andResult->children[i]->computeProperties();
                 const BSONObjSet& sorts = andResult->children[i]->getSort();
@@ -1112,12 +1119,12 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
                 }
             }
         } else {
-            // We can't use sort-based intersection, and hash-based intersection is disabled.
-            // Clean up the index scans and bail out by returning NULL.
+            // We can't use sort-based intersection, and hash- and bitmap-based intersection are
+            // disabled. Clean up the index scans and bail out by returning NULL.
             LOGV2_DEBUG(20947,
                         5,
                         "Can't build index intersection solution: AND_SORTED is not possible and "
-                        "AND_HASH is disabled");
+                        "AND_HASH and AND_BITMAP are disabled");
             return nullptr;
         }
     }
@@ -1127,7 +1134,8 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
         return andResult;
     }
 
-    if (andResult->getType() == STAGE_AND_HASH || andResult->getType() == STAGE_AND_SORTED) {
+    if (andResult->getType() == STAGE_AND_HASH || andResult->getType() == STAGE_AND_SORTED ||
+        andResult->getType() == STAGE_AND_BITMAP) {
         // We got an index intersection solution, so we aren't allowed to answer predicates exactly
         // using the index. This is because the index intersection stage finds documents that match
         // each index's predicate, but the document isn't guaranteed to be in a state where it
@@ -1372,6 +1380,147 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanWholeIndex(
     return solnRoot;
 }
 
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::skipScanIndex(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    // The bounds of a multikey or sparse index, or of a partial index, do not cover every
+    // document, and strings can only be bounded when the index and query collations agree.
+    if (index.type != INDEX_BTREE || index.keyPattern.nFields() < 2 || index.multikey ||
+        index.sparse || index.filterExpr ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> predicates;
+    if (MatchExpression::AND == query.root()->matchType()) {
+        for (size_t i = 0; i < query.root()->numChildren(); ++i) {
+            predicates.push_back(query.root()->getChild(i));
+        }
+    } else {
+        predicates.push_back(query.root());
+    }
+
+    auto isn = std::make_unique<IndexScanNode>(index);
+    isn->addKeyMetadata = query.metadataDeps()[DocumentMetadataFields::kIndexKey];
+    isn->queryCollator = query.getCollator();
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    bool constrainsTrailingField = false;
+    size_t pos = 0;
+    for (auto&& keyElt : index.keyPattern) {
+        auto& oil = isn->bounds.fields[pos];
+        IndexBoundsBuilder::allValuesForField(keyElt, &oil);
+
+        for (const auto* pred : predicates) {
+            if (pred->path() != keyElt.fieldNameStringData()) {
+                continue;
+            }
+            switch (pred->matchType()) {
+                case MatchExpression::EQ:
+                case MatchExpression::LT:
+                case MatchExpression::LTE:
+                case MatchExpression::GT:
+                case MatchExpression::GTE:
+                case MatchExpression::MATCH_IN:
+                    break;
+                default:
+                    continue;
+            }
+
+            // A predicate on the leading field lets the index be used without skipping.
+            if (pos == 0) {
+                return nullptr;
+            }
+
+            // The whole query is applied after the fetch, so the tightness of the bounds does
+            // not matter.
+            IndexBoundsBuilder::BoundsTightness tightness;
+            IndexBoundsBuilder::translateAndIntersect(pred, keyElt, index, &oil, &tightness);
+            constrainsTrailingField = true;
+        }
+        ++pos;
+    }
+
+    if (!constrainsTrailingField) {
+        return nullptr;
+    }
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return std::move(fetch);
+}
+
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanIndexWithAssignedPredicates(
+    const IndexEntry& index,
+    const CanonicalQuery& query,
+    const std::vector<const MatchExpression*>& predicates,
+    const std::vector<boost::optional<size_t>>& keyPositions) {
+    invariant(predicates.size() == keyPositions.size());
+
+    // The bounds of all the predicates assigned to a multikey index may not be intersected or
+    // compounded, and sparse and partial indexes constrain which predicates they may answer.
+    if (index.type != INDEX_BTREE || index.multikey || index.sparse || index.filterExpr ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    std::vector<BSONElement> keyElts(index.keyPattern.begin(), index.keyPattern.end());
+    auto isn = std::make_unique<IndexScanNode>(index);
+    isn->addKeyMetadata = query.metadataDeps()[DocumentMetadataFields::kIndexKey];
+    isn->queryCollator = query.getCollator();
+    isn->bounds.fields.resize(keyElts.size());
+    for (size_t pos = 0; pos < keyElts.size(); ++pos) {
+        IndexBoundsBuilder::allValuesForField(keyElts[pos], &isn->bounds.fields[pos]);
+    }
+
+    auto residual = std::make_unique<AndMatchExpression>();
+    for (size_t i = 0; i < predicates.size(); ++i) {
+        const auto* pred = predicates[i];
+        if (!keyPositions[i]) {
+            residual->add(pred->shallowClone().release());
+            continue;
+        }
+
+        const size_t pos = *keyPositions[i];
+        if (pos >= keyElts.size() || pred->path() != keyElts[pos].fieldNameStringData()) {
+            return nullptr;
+        }
+        switch (pred->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+            case MatchExpression::MATCH_IN:
+                break;
+            default:
+                return nullptr;
+        }
+
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translateAndIntersect(
+            pred, keyElts[pos], index, &isn->bounds.fields[pos], &tightness);
+        if (tightness != IndexBoundsBuilder::EXACT) {
+            residual->add(pred->shallowClone().release());
+        }
+    }
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    if (residual->numChildren() == 0) {
+        return std::move(isn);
+    }
+
+    auto fetch = std::make_unique<FetchNode>();
+    if (residual->numChildren() == 1) {
+        fetch->filter = residual->getChild(0)->shallowClone();
+    } else {
+        fetch->filter = std::move(residual);
+    }
+    fetch->children.push_back(isn.release());
+    return std::move(fetch);
+}
+
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
                                                  MatchExpression::MatchType type) {
@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <vector>
+
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_planner_params.h"
@@ -110,6 +113,32 @@ public:
                                                              const QueryPlannerParams& params,
                                                              int direction = 1);
 
+    /**
+     * Return a plan that skip scans the provided compound index: every value of the leading field
+     * is scanned, and the bounds of the other fields are built from the predicates of 'query' on
+     * them, so that the index scan seeks from one distinct leading value to the next. Returns
+     * nullptr if the index cannot be skip scanned, or if the query constrains its leading field
+     * or none of its other fields.
+     */
+    static std::unique_ptr<QuerySolutionNode> skipScanIndex(const IndexEntry& index,
+                                                            const CanonicalQuery& query,
+                                                            const QueryPlannerParams& params);
+
+    /**
+     * Return a plan that scans 'index' with the bounds of 'predicates', the i-th of which is
+     * assigned to the field at position 'keyPositions[i]' of the index, if any. Predicates which
+     * are not assigned, or whose bounds are not exact, are applied by a FETCH above the scan.
+     * Returns nullptr if the index or one of the predicates cannot be handled this way.
+     *
+     * Used to rebuild a cached plan for the constants of a query in time linear in the number of
+     * its predicates.
+     */
+    static std::unique_ptr<QuerySolutionNode> scanIndexWithAssignedPredicates(
+        const IndexEntry& index,
+        const CanonicalQuery& query,
+        const std::vector<const MatchExpression*>& predicates,
+        const std::vector<boost::optional<size_t>>& keyPositions);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
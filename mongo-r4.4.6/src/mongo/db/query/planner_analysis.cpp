@@ -40,6 +40,7 @@
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/logv2/log.h"
@@ -493,6 +494,39 @@ bool canUseSimpleSort(const QuerySolutionNode& solnRoot,
         && !splitLimitedSortEligible;
 }
 
+/**
+ * Returns the longest proper prefix of 'sortObj' whose order is provided by 'solnRoot', reversing
+ * the scans of 'solnRoot' if that is what provides it, or an empty object if there is none.
+ */
+BSONObj providedSortPrefix(const BSONObj& sortObj, QuerySolutionNode* solnRoot) {
+    if (!internalQueryPlannerEnablePartialSort.load()) {
+        return BSONObj();
+    }
+
+    // Only the leading fields sorted in ascending or descending order can be provided by an index.
+    std::vector<BSONObj> candidates;
+    BSONObjBuilder prefixBob;
+    for (auto&& elem : sortObj) {
+        if (!elem.isNumber() || candidates.size() + 1 == static_cast<size_t>(sortObj.nFields())) {
+            break;
+        }
+        prefixBob.append(elem);
+        candidates.push_back(prefixBob.asTempObj().getOwned());
+    }
+
+    const BSONObjSet sorts = solnRoot->getSort();
+    for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+        if (sorts.find(*it) != sorts.end()) {
+            return *it;
+        }
+        if (sorts.find(QueryPlannerCommon::reverseSortObj(*it)) != sorts.end()) {
+            QueryPlannerCommon::reverseScans(solnRoot);
+            return *it;
+        }
+    }
+    return BSONObj();
+}
+
 }  // namespace
 
 // static
@@ -742,7 +776,16 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         return solnRoot;
     }
 
-    // If we're here, we need to add a sort stage.
+    // If we're here, we need to add a sort stage. If the leading fields of the sort are provided
+    // already, it only has to sort the results with equal values of these fields together.
+    const BSONObj sortPrefix = providedSortPrefix(sortObj, solnRoot);
+    if (!sortPrefix.isEmpty()) {
+        LOGV2_DEBUG(5023426,
+                    5,
+                    "Sorting only within runs of a provided sort prefix",
+                    "sortPrefix"_attr = sortPrefix,
+                    "plan"_attr = redact(solnRoot->toString()));
+    }
 
     if (!solnRoot->fetched()) {
         const bool sortIsCovered =
@@ -768,6 +811,7 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sortNode = std::make_unique<SortNodeDefault>();
     }
     sortNode->pattern = sortObj;
+    sortNode->prefix = sortPrefix;
     sortNode->children.push_back(solnRoot);
     sortNode->addSortKeyMetadata = query.metadataDeps()[DocumentMetadataFields::kSortKey];
     solnRoot = sortNode.release();
@@ -907,9 +951,10 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
     }
 
     // A solution can be blocking if it has a blocking sort stage or
-    // a hashed AND stage.
+    // a hashed or bitmap AND stage.
     bool hasAndHashStage = hasNode(solnRoot.get(), STAGE_AND_HASH);
-    soln->hasBlockingStage = hasSortStage || hasAndHashStage;
+    bool hasAndBitmapStage = hasNode(solnRoot.get(), STAGE_AND_BITMAP);
+    soln->hasBlockingStage = hasSortStage || hasAndHashStage || hasAndBitmapStage;
 
     const QueryRequest& qr = query.getQueryRequest();
 
@@ -33,6 +33,7 @@
 
 #include "mongo/db/query/query_planner.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <vector>
 
@@ -293,6 +294,89 @@ std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+std::unique_ptr<QuerySolution> buildSkipScanSoln(const IndexEntry& index,
+                                                 const CanonicalQuery& query,
+                                                 const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::skipScanIndex(index, query, params));
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
+/**
+ * Builds the solution of a cached plan which scans a single index for a conjunction of leaf
+ * predicates straight from the constants of 'query', without expanding the indexes or tagging a
+ * copy of the query. Returns nullptr if the cached plan is not of this form.
+ */
+std::unique_ptr<QuerySolution> buildReboundSoln(const CanonicalQuery& query,
+                                                const QueryPlannerParams& params,
+                                                const PlanCacheIndexTree& cacheTree) {
+    const MatchExpression* root = query.root();
+    std::vector<const MatchExpression*> predicates;
+    std::vector<const PlanCacheIndexTree*> assignments;
+    if (MatchExpression::AND == root->matchType()) {
+        if (cacheTree.entryId || !cacheTree.orPushdowns.empty() ||
+            cacheTree.children.size() != root->numChildren()) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+            assignments.push_back(cacheTree.children[i]);
+        }
+    } else {
+        predicates.push_back(root);
+        assignments.push_back(&cacheTree);
+    }
+
+    const IndexEntry::Identifier* entryId = nullptr;
+    std::vector<boost::optional<size_t>> keyPositions;
+    for (const auto* assignment : assignments) {
+        if (!assignment->children.empty() || !assignment->orPushdowns.empty() ||
+            !assignment->canCombineBounds) {
+            return nullptr;
+        }
+        if (!assignment->entryId) {
+            keyPositions.push_back(boost::none);
+            continue;
+        }
+        if (entryId && !(*entryId == *assignment->entryId)) {
+            return nullptr;
+        }
+        entryId = &*assignment->entryId;
+        keyPositions.push_back(assignment->index_pos);
+    }
+    if (!entryId) {
+        return nullptr;
+    }
+
+    // Expanded wildcard indexes have identifiers of their own, so they are not found here.
+    auto it = std::find_if(params.indices.begin(),
+                           params.indices.end(),
+                           [&](const IndexEntry& index) { return index.identifier == *entryId; });
+    if (it == params.indices.end()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::scanIndexWithAssignedPredicates(*it, query, predicates, keyPositions));
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
+/**
+ * Returns true if the statistics of 'index' show few enough distinct values of its leading field
+ * for a skip scan, which seeks once or twice per distinct value, to be worth considering.
+ */
+bool isSkipScanCandidate(const IndexEntry& index, const QueryPlannerParams& params) {
+    auto it = params.leadingFieldDistinctRatios.find(index.identifier.catalogName);
+    return it != params.leadingFieldDistinctRatios.end() &&
+        it->second <= internalQueryPlannerSkipScanMaxLeadingDistinctRatio.load();
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp, SimpleBSONElementComparator::kInstance);
 }
@@ -328,8 +412,7 @@ StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTagge
             return Status(ErrorCodes::BadValue, "can't cache '2d' index");
         }
 
-        IndexEntry* ientry = new IndexEntry(relevantIndices[itag->index]);
-        indexTree->entry.reset(ientry);
+        indexTree->setIndexEntry(relevantIndices[itag->index]);
         indexTree->index_pos = itag->pos;
         indexTree->canCombineBounds = itag->canCombineBounds;
     } else if (taggedTree->getTag() &&
@@ -343,9 +426,7 @@ StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTagge
                 return Status(ErrorCodes::BadValue, "can't cache '2d' index");
             }
 
-            std::unique_ptr<IndexEntry> indexEntry =
-                std::make_unique<IndexEntry>(relevantIndices[itag->index]);
-            indexTree->entry.reset(indexEntry.release());
+            indexTree->setIndexEntry(relevantIndices[itag->index]);
             indexTree->index_pos = itag->pos;
             indexTree->canCombineBounds = itag->canCombineBounds;
         }
@@ -420,11 +501,11 @@ Status QueryPlanner::tagAccordingToCache(MatchExpression* filter,
         }
     }
 
-    if (indexTree->entry.get()) {
-        const auto got = indexMap.find(indexTree->entry->identifier);
+    if (indexTree->entryId) {
+        const auto got = indexMap.find(*indexTree->entryId);
         if (got == indexMap.end()) {
             str::stream ss;
-            ss << "Did not find index with name: " << indexTree->entry->identifier.catalogName;
+            ss << "Did not find index with name: " << indexTree->entryId->catalogName;
             return Status(ErrorCodes::NoQueryExecutionPlans, ss);
         }
         if (filter->getTag()) {
@@ -452,16 +533,43 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
     // Look up winning solution in cached solution's array.
     const auto& winnerCacheData = *cachedSoln.plannerData;
 
+    // The cache only keeps the identifier of the index scanned by a whole index scan or skip scan
+    // solution, so look it up among the current indexes.
+    const IndexEntry* cachedIndex = nullptr;
+    if (SolutionCacheData::WHOLE_IXSCAN_SOLN == winnerCacheData.solnType ||
+        SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        invariant(winnerCacheData.tree && winnerCacheData.tree->entryId);
+        auto it = std::find_if(
+            params.indices.begin(), params.indices.end(), [&](const IndexEntry& index) {
+                return index.identifier == *winnerCacheData.tree->entryId;
+            });
+        if (it == params.indices.end()) {
+            return Status(ErrorCodes::NoQueryExecutionPlans,
+                          str::stream() << "plan cache error: did not find index "
+                                        << *winnerCacheData.tree->entryId);
+        }
+        cachedIndex = &*it;
+    }
+
     if (SolutionCacheData::WHOLE_IXSCAN_SOLN == winnerCacheData.solnType) {
         // The solution can be constructed by a scan over the entire index.
-        auto soln = buildWholeIXSoln(
-            *winnerCacheData.tree->entry, query, params, winnerCacheData.wholeIXSolnDir);
+        auto soln =
+            buildWholeIXSoln(*cachedIndex, query, params, winnerCacheData.wholeIXSolnDir);
         if (!soln) {
             return Status(ErrorCodes::NoQueryExecutionPlans,
                           "plan cache error: soln that uses index to provide sort");
         } else {
             return {std::move(soln)};
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        // The solution skip scans an index whose leading field the query does not constrain.
+        auto soln = buildSkipScanSoln(*cachedIndex, query, params);
+        if (!soln) {
+            return Status(ErrorCodes::NoQueryExecutionPlans,
+                          "plan cache error: soln that skip scans index");
+        } else {
+            return {std::move(soln)};
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -476,7 +584,17 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
 
     // SolutionCacheData::USE_TAGS_SOLN == cacheData->solnType
     // If we're here then this is neither the whole index scan or collection scan
-    // cases, and we proceed by using the PlanCacheIndexTree to tag the query tree.
+    // cases. A plan scanning a single index is rebuilt from the constants of the query if
+    // possible, otherwise we proceed by using the PlanCacheIndexTree to tag the query tree.
+    if (internalQueryCacheEnableParameterRebinding.load() && winnerCacheData.tree) {
+        if (auto soln = buildReboundSoln(query, params, *winnerCacheData.tree)) {
+            LOGV2_DEBUG(5023424,
+                        5,
+                        "Planner: solution rebuilt from the constants of the query",
+                        "solution"_attr = redact(soln->toString()));
+            return {std::move(soln)};
+        }
+    }
 
     // Create a copy of the expression tree.  We use cachedSoln to annotate this with indices.
     unique_ptr<MatchExpression> clone = query.root()->shallowClone();
@@ -932,6 +1050,16 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
                 ErrorCodes::NoQueryExecutionPlans,
                 "$hint: refusing to build whole-index solution, because it's a wildcard index");
         }
+        // Seeking past the values of the leading field beats scanning the whole index when they
+        // are few.
+        if (isSkipScanCandidate(relevantIndices.front(), params)) {
+            if (auto soln = buildSkipScanSoln(relevantIndices.front(), query, params)) {
+                LOGV2_DEBUG(5023420, 5, "Planner: outputting soln that skip scans hinted index");
+                std::vector<std::unique_ptr<QuerySolution>> out;
+                out.push_back(std::move(soln));
+                return {std::move(out)};
+            }
+        }
         // Return hinted index solution if found.
         auto soln = buildWholeIXSoln(relevantIndices.front(), query, params);
         if (!soln) {
@@ -944,6 +1072,37 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         return {std::move(out)};
     }
 
+    // An index whose leading field is not constrained by the query can still be used if the query
+    // constrains its other fields, by seeking to each distinct value of the leading field in turn.
+    if (hintedIndex.isEmpty() &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        for (const auto& index : fullIndexList) {
+            if (out.size() >= params.maxIndexedSolutions) {
+                break;
+            }
+            if (!isSkipScanCandidate(index, params)) {
+                continue;
+            }
+
+            auto soln = buildSkipScanSoln(index, query, params);
+            if (soln) {
+                LOGV2_DEBUG(5023421,
+                            5,
+                            "Planner: outputting soln that skip scans index",
+                            "index"_attr = index.toString());
+                PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+                indexTree->setIndexEntry(index);
+                SolutionCacheData* scd = new SolutionCacheData();
+                scd->tree.reset(indexTree);
+                scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+
+                soln->cacheData.reset(scd);
+                out.push_back(std::move(soln));
+            }
+        }
+    }
+
     // If a sort order is requested, there may be an index that provides it, even if that
     // index is not over any predicates in the query.
     //
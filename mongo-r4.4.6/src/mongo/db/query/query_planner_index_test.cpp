@@ -34,6 +34,7 @@
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -845,6 +846,80 @@ TEST_F(QueryPlannerTest, IntersectDisableAndHash) {
     internalQueryPlannerEnableHashIntersection.store(oldEnableHashIntersection);
 }
 
+// Ensure that AND_BITMAP replaces AND_HASH when hash-based intersection is disabled.
+TEST_F(QueryPlannerTest, IntersectAndBitmapWhenAndHashDisabled) {
+    bool oldEnableHashIntersection = internalQueryPlannerEnableHashIntersection.load();
+    bool oldEnableBitmapIntersection = internalQueryPlannerEnableBitmapIntersection.load();
+    ON_BLOCK_EXIT([oldEnableHashIntersection, oldEnableBitmapIntersection] {
+        internalQueryPlannerEnableHashIntersection.store(oldEnableHashIntersection);
+        internalQueryPlannerEnableBitmapIntersection.store(oldEnableBitmapIntersection);
+    });
+
+    internalQueryPlannerEnableHashIntersection.store(false);
+    internalQueryPlannerEnableBitmapIntersection.store(true);
+    params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::INDEX_INTERSECTION;
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuery(fromjson("{a: {$gt: 1}, b: {$lt: 5}}"));
+
+    assertNumSolutions(3U);
+    assertSolutionExists(
+        "{fetch: {filter: {a: {$gt: 1}, b: {$lt: 5}}, node: {andBitmap: {nodes: ["
+        "{ixscan: {filter: null, pattern: {a:1}}},"
+        "{ixscan: {filter: null, pattern: {b:1}}}]}}}}");
+}
+
+//
+// Skip scans of indexes whose leading field the query does not constrain
+//
+
+TEST_F(QueryPlannerTest, SkipScanIndexWhenLeadingFieldHasFewValues) {
+    addIndex(BSON("a" << 1 << "b" << 1), nullptr, "a_1_b_1");
+    params.leadingFieldDistinctRatios["a_1_b_1"] = 0.001;
+
+    runQuery(fromjson("{b: {$gte: 5, $lt: 10}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gte: 5, $lt: 10}}, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,10,true,false]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanWhenLeadingFieldHasManyValues) {
+    addIndex(BSON("a" << 1 << "b" << 1), nullptr, "a_1_b_1");
+    params.leadingFieldDistinctRatios["a_1_b_1"] = 0.5;
+
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanOfMultikeyIndex) {
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    params.leadingFieldDistinctRatios["hari_king_of_the_stove"] = 0.001;
+
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanHintedIndexWithDescendingTrailingField) {
+    addIndex(BSON("a" << 1 << "b" << -1), nullptr, "a_1_b_-1");
+    params.leadingFieldDistinctRatios["a_1_b_-1"] = 0.001;
+
+    runQueryHint(fromjson("{b: {$in: [1, 5]}}"), BSON("a" << 1 << "b" << -1));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$in: [1, 5]}}, node: {ixscan: {pattern: {a: 1, b: -1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true],[1,1,true,true]]}}}}}");
+}
+
 //
 // Index intersection cases for SERVER-12825: make sure that
 // we don't generate an ixisect plan if a compound index is
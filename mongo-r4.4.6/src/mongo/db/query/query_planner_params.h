@@ -34,6 +34,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_entry.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -138,6 +139,12 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // Ratio of the number of distinct values of the leading field of an index to the number of
+    // records, keyed by index name, for the indexes with statistics collected by the 'analyze'
+    // command. Indexes with few distinct leading values can be skip scanned by queries which do
+    // not constrain the leading field.
+    StringMap<double> leadingFieldDistinctRatios;
 };
 
 }  // namespace mongo
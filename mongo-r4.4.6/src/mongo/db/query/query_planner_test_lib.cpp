@@ -518,6 +518,16 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
         }
         BSONObj orObj = el.Obj();
         return childrenMatch(orObj, orn, relaxBoundsCheck);
+    } else if (STAGE_AND_BITMAP == trueSoln->getType()) {
+        const AndBitmapNode* abn = static_cast<const AndBitmapNode*>(trueSoln);
+        BSONElement el = testSoln["andBitmap"];
+        if (el.eoo() || !el.isABSONObj()) {
+            return false;
+        }
+        BSONObj andBitmapObj = el.Obj();
+        invariant(bsonObjFieldsAreInSet(andBitmapObj, {"nodes"}));
+
+        return childrenMatch(andBitmapObj, abn, relaxBoundsCheck);
     } else if (STAGE_AND_HASH == trueSoln->getType()) {
         const AndHashNode* ahn = static_cast<const AndHashNode*>(trueSoln);
         BSONElement el = testSoln["andHash"];
@@ -637,7 +647,7 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             return false;
         }
         BSONObj sortObj = el.Obj();
-        invariant(bsonObjFieldsAreInSet(sortObj, {"pattern", "limit", "type", "node"}));
+        invariant(bsonObjFieldsAreInSet(sortObj, {"pattern", "prefix", "limit", "type", "node"}));
 
         BSONElement patternEl = sortObj["pattern"];
         if (patternEl.eoo() || !patternEl.isABSONObj()) {
@@ -672,6 +682,13 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             }
         }
 
+        BSONElement prefixEl = sortObj["prefix"];
+        if (prefixEl &&
+            (!prefixEl.isABSONObj() ||
+             SimpleBSONObjComparator::kInstance.evaluate(prefixEl.Obj() != sn->prefix))) {
+            return false;
+        }
+
         BSONElement child = sortObj["node"];
         if (child.eoo() || !child.isABSONObj()) {
             return false;
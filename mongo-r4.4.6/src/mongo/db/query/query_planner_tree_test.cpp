@@ -30,9 +30,11 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -1186,6 +1188,45 @@ TEST_F(QueryPlannerTest, ReverseScanForSort) {
         "{filter: null, pattern: {_id: 1}}}}}");
 }
 
+TEST_F(QueryPlannerTest, IndexProvidingSortPrefixOnlySortsWithinRuns) {
+    addIndex(BSON("a" << 1));
+    runQuerySortProj(fromjson("{a: {$gt: 0}}"), fromjson("{a: 1, b: 1}"), BSONObj());
+
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists(
+        "{sort: {pattern: {a: 1, b: 1}, prefix: {}, limit: 0, type: 'simple', node: "
+        "{cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{sort: {pattern: {a: 1, b: 1}, prefix: {a: 1}, limit: 0, type: 'simple', node: "
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1}, dir: 1}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ReverseScanForSortPrefix) {
+    addIndex(BSON("a" << 1));
+    runQuerySortProj(fromjson("{a: {$gt: 0}}"), fromjson("{a: -1, b: 1}"), BSONObj());
+
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists(
+        "{sort: {pattern: {a: -1, b: 1}, prefix: {a: -1}, limit: 0, type: 'simple', node: "
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1}, dir: -1}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSortPrefixWhenPartialSortDisabled) {
+    const bool oldEnablePartialSort = internalQueryPlannerEnablePartialSort.load();
+    ON_BLOCK_EXIT([oldEnablePartialSort] {
+        internalQueryPlannerEnablePartialSort.store(oldEnablePartialSort);
+    });
+    internalQueryPlannerEnablePartialSort.store(false);
+
+    addIndex(BSON("a" << 1));
+    runQuerySortProj(fromjson("{a: {$gt: 0}}"), fromjson("{a: 1, b: 1}"), BSONObj());
+
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists(
+        "{sort: {pattern: {a: 1, b: 1}, prefix: {}, limit: 0, type: 'simple', node: "
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1}}}}}}}");
+}
+
 TEST_F(QueryPlannerTest, MergeSortReverseScans) {
     addIndex(BSON("a" << 1));
     runQueryAsCommand(
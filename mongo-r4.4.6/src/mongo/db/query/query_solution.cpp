@@ -260,6 +260,31 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     return copy;
 }
 
+//
+// AndBitmapNode
+//
+
+AndBitmapNode::AndBitmapNode() {}
+
+AndBitmapNode::~AndBitmapNode() {}
+
+void AndBitmapNode::appendToString(str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "AND_BITMAP\n";
+    addCommon(ss, indent);
+    for (size_t i = 0; i < children.size(); ++i) {
+        addIndent(ss, indent + 1);
+        *ss << "Child " << i << ":\n";
+        children[i]->appendToString(ss, indent + 1);
+    }
+}
+
+QuerySolutionNode* AndBitmapNode::clone() const {
+    AndBitmapNode* copy = new AndBitmapNode();
+    cloneBaseData(copy);
+    return copy;
+}
+
 //
 // AndHashNode
 //
@@ -1097,6 +1122,10 @@ void SortNode::appendToString(str::stream* ss, int indent) const {
     *ss << "type = " << sortImplementationTypeToString() << '\n';
     addIndent(ss, indent + 1);
     *ss << "pattern = " << pattern.toString() << '\n';
+    if (!prefix.isEmpty()) {
+        addIndent(ss, indent + 1);
+        *ss << "prefix = " << prefix.toString() << '\n';
+    }
     addIndent(ss, indent + 1);
     *ss << "limit = " << limit << '\n';
     addCommon(ss, indent);
@@ -1109,6 +1138,7 @@ void SortNode::cloneSortData(SortNode* copy) const {
     cloneBaseData(copy);
     copy->_sorts = this->_sorts;
     copy->pattern = this->pattern;
+    copy->prefix = this->prefix;
     copy->limit = this->limit;
     copy->addSortKeyMetadata = this->addSortKeyMetadata;
 }
@@ -380,6 +380,36 @@ struct CollectionScanNode : public QuerySolutionNode {
     bool stopApplyingFilterAfterFirstMatch = false;
 };
 
+/**
+ * Intersects the RecordIds of its children with compressed bitmaps, and outputs the results of
+ * its last child which every other child also produced.
+ */
+struct AndBitmapNode : public QuerySolutionNode {
+    AndBitmapNode();
+    virtual ~AndBitmapNode();
+
+    virtual StageType getType() const {
+        return STAGE_AND_BITMAP;
+    }
+
+    virtual void appendToString(str::stream* ss, int indent) const;
+
+    bool fetched() const {
+        return children.back()->fetched();
+    }
+    FieldAvailability getFieldAvailability(const std::string& field) const {
+        return children.back()->getFieldAvailability(field);
+    }
+    bool sortedByDiskLoc() const {
+        return children.back()->sortedByDiskLoc();
+    }
+    const BSONObjSet& getSort() const {
+        return children.back()->getSort();
+    }
+
+    QuerySolutionNode* clone() const;
+};
+
 struct AndHashNode : public QuerySolutionNode {
     AndHashNode();
     virtual ~AndHashNode();
@@ -793,6 +823,10 @@ struct SortNode : public QuerySolutionNode {
 
     BSONObj pattern;
 
+    // Leading fields of 'pattern' by which the child already sorts its results. If not empty,
+    // only the results with equal values of these fields are sorted together.
+    BSONObj prefix;
+
     // Sum of both limit and skip count in the parsed query.
     size_t limit;
 
@@ -39,6 +39,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
+#include "mongo/db/exec/and_bitmap.h"
 #include "mongo/db/exec/and_hash.h"
 #include "mongo/db/exec/and_sorted.h"
 #include "mongo/db/exec/collection_scan.h"
@@ -133,7 +134,10 @@ std::unique_ptr<PlanStage> buildStages(OperationContext* opCtx,
                 snDefault->limit,
                 internalQueryMaxBlockingSortMemoryUsageBytes.load(),
                 snDefault->addSortKeyMetadata,
-                std::move(childStage));
+                std::move(childStage),
+                snDefault->prefix.isEmpty()
+                    ? boost::none
+                    : boost::make_optional(SortPattern{snDefault->prefix, cq.getExpCtx()}));
         }
         case STAGE_SORT_SIMPLE: {
             auto snSimple = static_cast<const SortNodeSimple*>(root);
@@ -145,7 +149,10 @@ std::unique_ptr<PlanStage> buildStages(OperationContext* opCtx,
                 snSimple->limit,
                 internalQueryMaxBlockingSortMemoryUsageBytes.load(),
                 snSimple->addSortKeyMetadata,
-                std::move(childStage));
+                std::move(childStage),
+                snSimple->prefix.isEmpty()
+                    ? boost::none
+                    : boost::make_optional(SortPattern{snSimple->prefix, cq.getExpCtx()}));
         }
         case STAGE_SORT_KEY_GENERATOR: {
             const SortKeyGeneratorNode* keyGenNode = static_cast<const SortKeyGeneratorNode*>(root);
@@ -201,6 +208,15 @@ std::unique_ptr<PlanStage> buildStages(OperationContext* opCtx,
             auto childStage = buildStages(opCtx, collection, cq, qsol, sn->children[0], ws);
             return std::make_unique<SkipStage>(expCtx, sn->skip, ws, std::move(childStage));
         }
+        case STAGE_AND_BITMAP: {
+            const AndBitmapNode* abn = static_cast<const AndBitmapNode*>(root);
+            auto ret = std::make_unique<AndBitmapStage>(expCtx, ws);
+            for (size_t i = 0; i < abn->children.size(); ++i) {
+                auto childStage = buildStages(opCtx, collection, cq, qsol, abn->children[i], ws);
+                ret->addChild(std::move(childStage));
+            }
+            return ret;
+        }
         case STAGE_AND_HASH: {
             const AndHashNode* ahn = static_cast<const AndHashNode*>(root);
             auto ret = std::make_unique<AndHashStage>(expCtx, ws);
@@ -38,11 +38,13 @@
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 #include "mongo/db/repl/oplog_buffer_collection.h"
 #include "mongo/db/repl/oplog_buffer_proxy.h"
+#include "mongo/db/repl/oplog_buffer_ring_file.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_external_state.h"
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/logv2/log.h"
 
 namespace mongo {
@@ -51,10 +53,12 @@ namespace {
 
 const char kCollectionOplogBufferName[] = "collection";
 const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kRingFileOplogBufferName[] = "ringFile";
 
 MONGO_INITIALIZER(initialSyncOplogBuffer)(InitializerContext*) {
     if ((initialSyncOplogBuffer != kCollectionOplogBufferName) &&
-        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName)) {
+        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (initialSyncOplogBuffer != kRingFileOplogBufferName)) {
         return Status(ErrorCodes::BadValue,
                       "unsupported initial sync oplog buffer option: " + initialSyncOplogBuffer);
     }
@@ -126,6 +130,12 @@ std::unique_ptr<OplogBuffer> DataReplicatorExternalStateImpl::makeInitialSyncOpl
         options.peekCacheSize = std::size_t(initialSyncOplogBufferPeekCacheSize);
         return std::make_unique<OplogBufferProxy>(
             std::make_unique<OplogBufferCollection>(StorageInterface::get(opCtx), options));
+    } else if (initialSyncOplogBuffer == kRingFileOplogBufferName) {
+        OplogBufferRingFile::Options options;
+        options.path = storageGlobalParams.dbpath + "/_tmp/initialSyncOplogBuffer.ring";
+        options.fileSizeBytes = std::size_t(oplogBufferRingFileSizeMB) * 1024 * 1024;
+        options.memorySizeBytes = std::size_t(oplogBufferRingFileMemorySizeMB) * 1024 * 1024;
+        return std::make_unique<OplogBufferRingFile>(options);
     } else {
         return std::make_unique<OplogBufferBlockingQueue>();
     }
@@ -43,7 +43,9 @@
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/repl/apply_ops.h"
 #include "mongo/db/repl/insert_group.h"
+#include "mongo/db/repl/oplog_batch_size_controller.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
+#include "mongo/db/repl/update_delete_group.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/control/journal_flusher.h"
 #include "mongo/logv2/log.h"
@@ -399,7 +401,10 @@ void ApplyBatchFinalizerForJournal::_run() {
         }
 
         auto opCtx = cc().makeOperationContext();
+        Timer journalFlushTimer;
         JournalFlusher::get(opCtx.get())->waitForJournalFlush();
+        OplogBatchSizeController::get(opCtx->getServiceContext())
+            ->recordJournalFlush(Milliseconds(journalFlushTimer.millis()));
         _recordDurable(latestOpTimeAndWallTime);
     }
 }
@@ -501,6 +506,17 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
         // Don't allow the fsync+lock thread to see intermediate states of batch application.
         stdx::lock_guard<SimpleMutex> fsynclk(filesLockedFsync);
 
+        // Collected for adaptive batch sizing, see OplogBatchSizeController.
+        const auto sizeControllerSettings = ops.sizeControllerSettings();
+        OplogBatchSizeController::BatchObservation batchObservation;
+        if (sizeControllerSettings) {
+            batchObservation.ops = ops.getBatch().size();
+            for (const auto& op : ops.getBatch()) {
+                batchObservation.bytes += op.getRawObjSizeBytes();
+            }
+        }
+        Timer batchApplyTimer;
+
         // Apply the operations in this batch. '_applyOplogBatch' returns the optime of the
         // last op that was applied, which should be the last optime in the batch.
         auto swLastOpTimeAppliedInBatch = _applyOplogBatch(&opCtx, ops.releaseBatch());
@@ -544,6 +560,18 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
 
         // The finalizer advances the global timestamp to lastOpTimeInBatch.
         finalizer->record({lastOpTimeInBatch, lastWallTimeInBatch}, consistency);
+
+        // Let the controller pick the limits for upcoming batches, within the settings the
+        // batcher chose the limits of this batch with. The lag is measured against the wall clock
+        // time the last entry in the batch was written on the primary.
+        if (sizeControllerSettings) {
+            batchObservation.applyDuration = Microseconds(batchApplyTimer.micros());
+            batchObservation.replicationLag = std::max(
+                Milliseconds(0),
+                opCtx.getServiceContext()->getFastClockSource()->now() - lastWallTimeInBatch);
+            OplogBatchSizeController::get(opCtx.getServiceContext())
+                ->recordBatchApplied(*sizeControllerSettings, batchObservation);
+        }
     }
 }
 
@@ -1026,6 +1054,55 @@ Status applyOplogEntryOrGroupedInserts(OperationContext* opCtx,
     MONGO_UNREACHABLE;
 }
 
+Status applyGroupedUpdatesAndDeletes(OperationContext* opCtx,
+                                     std::vector<const OplogEntry*>::const_iterator begin,
+                                     std::vector<const OplogEntry*>::const_iterator end,
+                                     OplogApplication::Mode oplogApplicationMode) {
+    // Same context requirements as applyOplogEntryOrGroupedInserts.
+    invariant(!opCtx->writesAreReplicated());
+    invariant(documentValidationDisabled(opCtx));
+    invariant(begin != end);
+
+    const auto& firstOp = **begin;
+    CurOp individualOp(opCtx);
+
+    const NamespaceString nss(firstOp.getNss());
+
+    // See applyOplogEntryOrGroupedInserts.
+    bool shouldAlwaysUpsert = (oplogApplicationMode != OplogApplication::Mode::kInitialSync);
+
+    auto status = writeConflictRetry(opCtx, "applyGroupedUpdatesAndDeletes", nss.ns(), [&] {
+        AutoGetCollection autoColl(
+            opCtx, getNsOrUUID(nss, firstOp), fixLockModeForSystemDotViewsChanges(nss, MODE_IX));
+        auto db = autoColl.getDb();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "missing database (" << nss.db() << ")",
+                db);
+        OldClientContext ctx(opCtx, autoColl.getNss().ns(), db);
+
+        // Committing the whole group at once saves a storage transaction commit per operation.
+        // applyOperation_inlock() does not timestamp writes that are made inside a wrapping
+        // WriteUnitOfWork, so each operation's timestamp is set here, in oplog order.
+        WriteUnitOfWork wuow(opCtx);
+        for (auto it = begin; it != end; ++it) {
+            const OplogEntry& op = **it;
+            uassertStatusOK(opCtx->recoveryUnit()->setTimestamp(op.getTimestamp()));
+            Status status =
+                applyOperation_inlock(opCtx, db, &op, shouldAlwaysUpsert, oplogApplicationMode);
+            if (status.code() == ErrorCodes::WriteConflict) {
+                throw WriteConflictException();
+            }
+            uassertStatusOK(status);
+        }
+        wuow.commit();
+        return Status::OK();
+    });
+
+    if (status.isOK()) {
+        opsAppliedStats.increment(std::distance(begin, end));
+    }
+    return status;
+}
 
 Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
                                                   std::vector<const OplogEntry*>* ops,
@@ -1056,6 +1133,7 @@ Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
     const auto oplogApplicationMode = getOptions().mode;
 
     InsertGroup insertGroup(ops, opCtx, oplogApplicationMode);
+    UpdateDeleteGroup updateDeleteGroup(ops, opCtx, oplogApplicationMode);
 
     {  // Ensure that the MultikeyPathTracker stops tracking paths.
         ON_BLOCK_EXIT([opCtx] { MultikeyPathTracker::get(opCtx).stopTrackingMultikeyPathInfo(); });
@@ -1072,6 +1150,13 @@ Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
                 continue;
             }
 
+            // Likewise for runs of updates and deletes.
+            groupResult = updateDeleteGroup.groupAndApplyUpdatesAndDeletes(it);
+            if (groupResult.isOK()) {
+                it = groupResult.getValue();
+                continue;
+            }
+
             // If we didn't create a group, try to apply the op individually.
             try {
                 const Status status =
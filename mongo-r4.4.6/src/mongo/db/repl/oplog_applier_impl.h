@@ -146,5 +146,14 @@ Status applyOplogEntryOrGroupedInserts(OperationContext* opCtx,
                                        const OplogEntryOrGroupedInserts& entryOrGroupedInserts,
                                        OplogApplication::Mode oplogApplicationMode);
 
+/**
+ * Applies a run of update and delete operations on the same collection in a single
+ * WriteUnitOfWork. Each write is timestamped with the timestamp of its own oplog entry.
+ */
+Status applyGroupedUpdatesAndDeletes(OperationContext* opCtx,
+                                     std::vector<const OplogEntry*>::const_iterator begin,
+                                     std::vector<const OplogEntry*>::const_iterator end,
+                                     OplogApplication::Mode oplogApplicationMode);
+
 }  // namespace repl
 }  // namespace mongo
@@ -100,6 +100,13 @@ OplogEntry makeOplogEntry(OpTypeEnum opType, NamespaceString nss, OptionalCollec
                       boost::none);  // post-image optime
 }
 
+/**
+ * Returns a copy of 'entry' that refers to its collection by 'uuid'.
+ */
+OplogEntry makeOplogEntryWithUuid(const OplogEntry& entry, const UUID& uuid) {
+    return OplogEntry(entry.toBSON().addField(BSON("ui" << uuid).firstElement()));
+}
+
 /**
  * Creates collection options suitable for oplog.
  */
@@ -1813,6 +1820,183 @@ TEST_F(OplogApplierImplTest, ApplyGroupIgnoresUpdateOperationIfDocumentIsMissing
     ASSERT_FALSE(AutoGetCollectionForReadCommand(_opCtx.get(), nss).getCollection());
 }
 
+TEST_F(OplogApplierImplTest, OplogApplicationThreadFuncAppliesGroupedUpdatesAndDeletes) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollection(_opCtx.get(), nss, {});
+
+    auto insertOp1 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1 << "x" << 0));
+    auto insertOp2 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2 << "x" << 0));
+    auto insertOp3 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(3), 0), 1LL}, nss, BSON("_id" << 3 << "x" << 0));
+    auto updateOp1 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(4), 0), 1LL}, nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1));
+    auto deleteOp3 =
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(5), 0), 1LL}, nss, BSON("_id" << 3));
+    auto updateOp2 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(6), 0), 1LL}, nss, BSON("_id" << 2), BSON("_id" << 2 << "x" << 2));
+
+    TestApplyOplogGroupApplier oplogApplier(
+        nullptr, nullptr, OplogApplier::Options(OplogApplication::Mode::kSecondary));
+    std::vector<const OplogEntry*> ops = {
+        &insertOp1, &insertOp2, &insertOp3, &updateOp1, &deleteOp3, &updateOp2};
+    WorkerMultikeyPathInfo pathInfo;
+    ASSERT_OK(oplogApplier.applyOplogBatchPerWorker(_opCtx.get(), &ops, &pathInfo));
+
+    CollectionReader collectionReader(_opCtx.get(), nss);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1 << "x" << 1), unittest::assertGet(collectionReader.next()));
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2 << "x" << 2), unittest::assertGet(collectionReader.next()));
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, collectionReader.next().getStatus());
+}
+
+TEST_F(OplogApplierImplTest,
+       OplogApplicationThreadFuncFallsBackOnApplyingUpdatesAndDeletesIndividuallyWhenGroupFails) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollection(_opCtx.get(), nss, {});
+
+    auto insertOp1 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1 << "x" << 0));
+    auto insertOp2 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2 << "x" << 0));
+    auto insertOp3 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(3), 0), 1LL}, nss, BSON("_id" << 3 << "x" << 0));
+    auto updateOp1 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(4), 0), 1LL}, nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1));
+    auto deleteOp3 =
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(5), 0), 1LL}, nss, BSON("_id" << 3));
+    auto updateOp2 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(6), 0), 1LL}, nss, BSON("_id" << 2), BSON("_id" << 2 << "x" << 2));
+
+    // Reject the first delete, which is applied as part of the group of updates and deletes.
+    std::size_t numDeletes = 0;
+    _opObserver->onDeleteFn = [&](OperationContext*,
+                                  const NamespaceString&,
+                                  OptionalCollectionUUID,
+                                  StmtId,
+                                  bool,
+                                  const boost::optional<BSONObj>&) {
+        if (numDeletes++ == 0) {
+            uasserted(ErrorCodes::OperationFailed, "grouped delete not supported");
+        }
+    };
+
+    TestApplyOplogGroupApplier oplogApplier(
+        nullptr, nullptr, OplogApplier::Options(OplogApplication::Mode::kSecondary));
+    std::vector<const OplogEntry*> ops = {
+        &insertOp1, &insertOp2, &insertOp3, &updateOp1, &deleteOp3, &updateOp2};
+    WorkerMultikeyPathInfo pathInfo;
+    ASSERT_OK(oplogApplier.applyOplogBatchPerWorker(_opCtx.get(), &ops, &pathInfo));
+
+    // The failed group was rolled back and its operations applied individually, with the same
+    // outcome as applying them as a group. The remaining operations of the failed group were not
+    // grouped again, so the delete was attempted once in the group and once on its own.
+    ASSERT_EQUALS(2U, numDeletes);
+    CollectionReader collectionReader(_opCtx.get(), nss);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1 << "x" << 1), unittest::assertGet(collectionReader.next()));
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2 << "x" << 2), unittest::assertGet(collectionReader.next()));
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, collectionReader.next().getStatus());
+}
+
+TEST_F(OplogApplierImplTest,
+       OplogApplicationThreadFuncIgnoresGroupedDeletesOnMissingCollectionInSteadyState) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    NamespaceString badNss("test." + _agent.getSuiteName() + "_" + _agent.getTestName() + "bad");
+    createCollection(_opCtx.get(), nss, {});
+
+    auto insertOp = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1 << "x" << 0));
+    auto updateOp = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1));
+    auto deleteOp1 = makeOplogEntryWithUuid(
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, badNss, BSON("_id" << 1)),
+        UUID::gen());
+    auto deleteOp2 = makeOplogEntryWithUuid(
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL}, badNss, BSON("_id" << 2)),
+        *deleteOp1.getUuid());
+
+    // The group of deletes fails on the missing collection. Applied individually, deletes on a
+    // missing collection succeed, so the batch succeeds as if the group had been applied.
+    TestApplyOplogGroupApplier oplogApplier(
+        nullptr, nullptr, OplogApplier::Options(OplogApplication::Mode::kSecondary));
+    std::vector<const OplogEntry*> ops = {&insertOp, &updateOp, &deleteOp1, &deleteOp2};
+    WorkerMultikeyPathInfo pathInfo;
+    ASSERT_OK(oplogApplier.applyOplogBatchPerWorker(_opCtx.get(), &ops, &pathInfo));
+
+    CollectionReader collectionReader(_opCtx.get(), nss);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1 << "x" << 1), unittest::assertGet(collectionReader.next()));
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, collectionReader.next().getStatus());
+    ASSERT_FALSE(AutoGetCollectionForReadCommand(_opCtx.get(), badNss).getCollection());
+}
+
+TEST_F(OplogApplierImplTest,
+       OplogApplicationThreadFuncFailsGroupedUpdatesOnMissingCollectionInSteadyState) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createDatabase(_opCtx.get(), nss.db());
+
+    const auto uuid = UUID::gen();
+    auto updateOp = makeOplogEntryWithUuid(
+        makeUpdateDocumentOplogEntry(
+            {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1)),
+        uuid);
+    auto deleteOp = makeOplogEntryWithUuid(
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2)),
+        uuid);
+
+    // An update on a missing collection fails in steady state whether or not it is grouped, so
+    // falling back to applying the operations individually surfaces the same error.
+    TestApplyOplogGroupApplier oplogApplier(
+        nullptr, nullptr, OplogApplier::Options(OplogApplication::Mode::kSecondary));
+    std::vector<const OplogEntry*> ops = {&updateOp, &deleteOp};
+    WorkerMultikeyPathInfo pathInfo;
+    ASSERT_EQUALS(ErrorCodes::NamespaceNotFound,
+                  oplogApplier.applyOplogBatchPerWorker(_opCtx.get(), &ops, &pathInfo));
+    ASSERT_FALSE(collectionExists(_opCtx.get(), nss));
+}
+
+TEST_F(OplogApplierImplTest,
+       OplogApplicationThreadFuncSkipsUpdatesAndDeletesOnMissingCollectionOutsideSteadyState) {
+    for (auto mode : {OplogApplication::Mode::kRecovering, OplogApplication::Mode::kInitialSync}) {
+        const std::string suffix = mode == OplogApplication::Mode::kRecovering ? "_r" : "_i";
+        NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName() + suffix);
+        NamespaceString badNss(nss.ns() + "bad");
+        createCollection(_opCtx.get(), nss, {});
+
+        const auto badUuid = UUID::gen();
+        auto insertOp1 = makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1 << "x" << 0));
+        auto insertOp2 = makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2 << "x" << 0));
+        auto updateOp1 = makeUpdateDocumentOplogEntry(
+            {Timestamp(Seconds(3), 0), 1LL}, nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1));
+        auto badUpdateOp = makeOplogEntryWithUuid(
+            makeUpdateDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL},
+                                         badNss,
+                                         BSON("_id" << 1),
+                                         BSON("_id" << 1 << "x" << 1)),
+            badUuid);
+        auto badDeleteOp = makeOplogEntryWithUuid(
+            makeDeleteDocumentOplogEntry({Timestamp(Seconds(5), 0), 1LL}, badNss, BSON("_id" << 2)),
+            badUuid);
+        auto deleteOp2 =
+            makeDeleteDocumentOplogEntry({Timestamp(Seconds(6), 0), 1LL}, nss, BSON("_id" << 2));
+
+        // Updates and deletes are not grouped outside of steady state. Each operation on the
+        // missing collection is skipped on its own and the others are applied.
+        TestApplyOplogGroupApplier oplogApplier(nullptr, nullptr, OplogApplier::Options(mode));
+        std::vector<const OplogEntry*> ops = {
+            &insertOp1, &insertOp2, &updateOp1, &badUpdateOp, &badDeleteOp, &deleteOp2};
+        WorkerMultikeyPathInfo pathInfo;
+        ASSERT_OK(oplogApplier.applyOplogBatchPerWorker(_opCtx.get(), &ops, &pathInfo));
+
+        CollectionReader collectionReader(_opCtx.get(), nss);
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 1 << "x" << 1),
+                          unittest::assertGet(collectionReader.next()));
+        ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, collectionReader.next().getStatus());
+        ASSERT_FALSE(AutoGetCollectionForReadCommand(_opCtx.get(), badNss).getCollection());
+    }
+}
+
 TEST_F(OplogApplierImplTest,
        OplogApplicationThreadFuncSkipsDocumentOnNamespaceNotFoundDuringInitialSync) {
     BSONObj emptyDoc;
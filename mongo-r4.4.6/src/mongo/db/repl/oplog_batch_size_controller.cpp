@@ -0,0 +1,246 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_batch_size_controller.h"
+
+#include <algorithm>
+
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const auto getOplogBatchSizeController =
+    ServiceContext::declareDecoration<OplogBatchSizeController>();
+
+// Weight given to the newest sample in the moving averages.
+constexpr double kSmoothingFactor = 0.2;
+
+// The target batch apply time is at least this multiple of the journal flush latency, so that the
+// per-batch flush does not dominate the time spent applying.
+constexpr double kJournalAmortizationFactor = 4.0;
+
+// While lagging, batches are allowed to take this much longer than the target apply time.
+constexpr double kLaggingTargetMultiplier = 4.0;
+
+// The ops limit moves by at most this factor per batch.
+constexpr double kMaxStepFactor = 2.0;
+
+// The bytes limit leaves this much room over the average entry size times the ops limit, so that
+// it only cuts batches short when entries are unusually large.
+constexpr double kBytesHeadroomFactor = 2.0;
+
+// Guards against dividing by a zero apply time when batches complete faster than the clock
+// resolution.
+constexpr double kMinApplyMicrosPerOp = 0.01;
+
+double updateAverage(double average, double sample) {
+    if (average < 0) {
+        return sample;
+    }
+    return kSmoothingFactor * sample + (1 - kSmoothingFactor) * average;
+}
+
+class OplogBatchSizeControllerSSM : public ServerStatusMetric {
+public:
+    OplogBatchSizeControllerSSM() : ServerStatusMetric("repl.apply.batchLimits") {}
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        BSONObjBuilder subBuilder(b.subobjStart(_leafName));
+        OplogBatchSizeController::get(getGlobalServiceContext())->appendStats(&subBuilder);
+    }
+} oplogBatchSizeControllerSSM;
+
+}  // namespace
+
+constexpr StringData OplogBatchSizeController::kReasonStatic;
+constexpr StringData OplogBatchSizeController::kReasonApplyLatency;
+constexpr StringData OplogBatchSizeController::kReasonJournalLatency;
+constexpr StringData OplogBatchSizeController::kReasonReplicationLag;
+constexpr StringData OplogBatchSizeController::kReasonBatchNotFull;
+constexpr StringData OplogBatchSizeController::kReasonMinimum;
+constexpr StringData OplogBatchSizeController::kReasonMaximum;
+
+OplogBatchSizeController::Settings OplogBatchSizeController::Settings::fromServerParameters(
+    std::size_t maxOps, std::size_t maxBytes) {
+    Settings settings;
+    settings.enabled = replBatchLimitAdaptive.load();
+    settings.maxOps = maxOps;
+    settings.maxBytes = maxBytes;
+    settings.minOps = std::min(std::size_t(replBatchLimitOperationsMin.load()), maxOps);
+    settings.minBytes = std::min(std::size_t(replBatchLimitBytesMin.load()), maxBytes);
+    settings.targetApplyTime = Milliseconds(replBatchTargetApplyMillis.load());
+    settings.lagThreshold = Milliseconds(replBatchLagThresholdMillis.load());
+    return settings;
+}
+
+OplogBatchSizeController* OplogBatchSizeController::get(ServiceContext* service) {
+    return &getOplogBatchSizeController(service);
+}
+
+OplogBatchSizeController::Limits OplogBatchSizeController::getLimits(
+    const Settings& settings) const {
+    if (!settings.enabled) {
+        return {settings.maxOps, settings.maxBytes, kReasonStatic};
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (!_opsLimit) {
+        return {settings.maxOps, settings.maxBytes, _reason};
+    }
+    return {std::clamp(_opsLimit, settings.minOps, settings.maxOps),
+            std::clamp(_bytesLimit, settings.minBytes, settings.maxBytes),
+            _reason};
+}
+
+void OplogBatchSizeController::recordBatchApplied(const Settings& settings,
+                                                  const BatchObservation& batch) {
+    if (!settings.enabled || batch.ops == 0) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    const auto currentOps =
+        _opsLimit ? std::clamp(_opsLimit, settings.minOps, settings.maxOps) : settings.maxOps;
+    const auto currentBytes = _bytesLimit
+        ? std::clamp(_bytesLimit, settings.minBytes, settings.maxBytes)
+        : settings.maxBytes;
+
+    _applyMicrosPerOp = updateAverage(
+        _applyMicrosPerOp, double(durationCount<Microseconds>(batch.applyDuration)) / batch.ops);
+    _bytesPerOp = updateAverage(_bytesPerOp, double(batch.bytes) / batch.ops);
+    _lastReplicationLag = batch.replicationLag;
+
+    // Pick how long a batch should take to apply. By default this is the operator's target, but
+    // it is stretched when journal flushes are slow so that their cost stays amortized, and again
+    // while we are lagging so that throughput wins over commit point latency.
+    StringData reason = kReasonApplyLatency;
+    double targetMillis = durationCount<Milliseconds>(settings.targetApplyTime);
+    if (_journalFlushMillis > 0 && kJournalAmortizationFactor * _journalFlushMillis > targetMillis) {
+        targetMillis = kJournalAmortizationFactor * _journalFlushMillis;
+        reason = kReasonJournalLatency;
+    }
+    if (batch.replicationLag >= settings.lagThreshold) {
+        targetMillis *= kLaggingTargetMultiplier;
+        reason = kReasonReplicationLag;
+    }
+
+    double desiredOps = targetMillis * 1000 / std::max(_applyMicrosPerOp, kMinApplyMicrosPerOp);
+
+    // A batch that did not fill its limits was cut short because the buffer ran dry, so it says
+    // nothing about whether larger limits would help. Never grow on such a batch.
+    const bool batchWasFull = batch.ops >= currentOps ||
+        batch.bytes + batch.bytes / batch.ops >= currentBytes;
+    if (desiredOps > currentOps && !batchWasFull) {
+        desiredOps = currentOps;
+        reason = kReasonBatchNotFull;
+    }
+
+    // Likewise, a batch that was applied within the target is no reason to shrink, even if the
+    // average apply time suggests it.
+    if (desiredOps < currentOps &&
+        durationCount<Microseconds>(batch.applyDuration) <= targetMillis * 1000) {
+        desiredOps = currentOps;
+    }
+
+    // Move gradually so that a single outlier batch cannot swing the limits.
+    desiredOps = std::clamp(desiredOps, currentOps / kMaxStepFactor, currentOps * kMaxStepFactor);
+
+    std::size_t newOps;
+    std::size_t newBytes;
+    if (desiredOps >= settings.maxOps) {
+        newOps = settings.maxOps;
+        newBytes = settings.maxBytes;
+        reason = kReasonMaximum;
+    } else {
+        if (desiredOps <= settings.minOps) {
+            newOps = settings.minOps;
+            reason = kReasonMinimum;
+        } else {
+            newOps = static_cast<std::size_t>(desiredOps);
+        }
+        const double desiredBytes = newOps * _bytesPerOp * kBytesHeadroomFactor;
+        newBytes = desiredBytes >= settings.maxBytes
+            ? settings.maxBytes
+            : std::max(static_cast<std::size_t>(desiredBytes), settings.minBytes);
+    }
+
+    if (newOps > currentOps) {
+        ++_numIncreases;
+    } else if (newOps < currentOps) {
+        ++_numDecreases;
+    }
+
+    if (newOps != currentOps || reason != _reason) {
+        LOGV2_DEBUG(5023401,
+                    2,
+                    "Adjusted oplog application batch limits",
+                    "ops"_attr = newOps,
+                    "bytes"_attr = newBytes,
+                    "previousOps"_attr = currentOps,
+                    "reason"_attr = reason,
+                    "applyMicrosPerOp"_attr = _applyMicrosPerOp,
+                    "journalFlushMillis"_attr = _journalFlushMillis,
+                    "replicationLag"_attr = batch.replicationLag);
+    }
+
+    _opsLimit = newOps;
+    _bytesLimit = newBytes;
+    _reason = reason;
+}
+
+void OplogBatchSizeController::recordJournalFlush(Milliseconds duration) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _journalFlushMillis = updateAverage(_journalFlushMillis, durationCount<Milliseconds>(duration));
+}
+
+void OplogBatchSizeController::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    builder->append("ops", static_cast<long long>(_opsLimit));
+    builder->append("bytes", static_cast<long long>(_bytesLimit));
+    builder->append("reason", _reason);
+    builder->append("applyMicrosPerOp", std::max(_applyMicrosPerOp, 0.0));
+    builder->append("bytesPerOp", std::max(_bytesPerOp, 0.0));
+    builder->append("journalFlushMillis", std::max(_journalFlushMillis, 0.0));
+    builder->append("replicationLagMillis", durationCount<Milliseconds>(_lastReplicationLag));
+    builder->append("increases", _numIncreases);
+    builder->append("decreases", _numDecreases);
+}
+
+}  // namespace repl
+}  // namespace mongo
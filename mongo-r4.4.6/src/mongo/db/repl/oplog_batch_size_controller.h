@@ -0,0 +1,156 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+namespace repl {
+
+/**
+ * Chooses the operation and byte limits that the OplogBatcher uses for each batch in steady state
+ * replication.
+ *
+ * Every batch pays a fixed cost (writing the oplog truncate point and minValid, waiting for the
+ * writer pool, and the journal flush done by the batch finalizer), so small batches waste
+ * throughput. Large batches delay the point at which the applied optime, and therefore the
+ * majority commit point, advances. The controller keeps the expected apply time of a batch near a
+ * target derived from 'replBatchTargetApplyMillis' and the observed journal flush latency, and lets
+ * batches grow towards the configured maximums while this node is lagging behind.
+ *
+ * When 'replBatchLimitAdaptive' is disabled, the limits are always the configured maximums.
+ *
+ * This class is thread-safe.
+ */
+class OplogBatchSizeController {
+    OplogBatchSizeController(const OplogBatchSizeController&) = delete;
+    OplogBatchSizeController& operator=(const OplogBatchSizeController&) = delete;
+
+public:
+    // Reasons reported for the current limits.
+    static constexpr StringData kReasonStatic = "static"_sd;
+    static constexpr StringData kReasonApplyLatency = "applyLatencyTarget"_sd;
+    static constexpr StringData kReasonJournalLatency = "journalLatency"_sd;
+    static constexpr StringData kReasonReplicationLag = "replicationLag"_sd;
+    static constexpr StringData kReasonBatchNotFull = "batchNotFull"_sd;
+    static constexpr StringData kReasonMinimum = "minimum"_sd;
+    static constexpr StringData kReasonMaximum = "maximum"_sd;
+
+    /**
+     * The operator-set bounds and targets the controller works within.
+     */
+    struct Settings {
+        /**
+         * Reads the settings from the server parameters. 'maxBytes' is passed in because the
+         * configured byte limit is further capped by the size of the oplog.
+         */
+        static Settings fromServerParameters(std::size_t maxOps, std::size_t maxBytes);
+
+        bool enabled = false;
+        std::size_t minOps = 1;
+        std::size_t maxOps = 1;
+        std::size_t minBytes = 1;
+        std::size_t maxBytes = 1;
+        Milliseconds targetApplyTime{0};
+        Milliseconds lagThreshold{0};
+    };
+
+    struct Limits {
+        std::size_t ops;
+        std::size_t bytes;
+        StringData reason;
+    };
+
+    /**
+     * Describes a batch that was just applied.
+     */
+    struct BatchObservation {
+        std::size_t ops = 0;
+        std::size_t bytes = 0;
+        Microseconds applyDuration{0};
+        Milliseconds replicationLag{0};
+    };
+
+    static OplogBatchSizeController* get(ServiceContext* service);
+
+    OplogBatchSizeController() = default;
+
+    /**
+     * Returns the limits to use for the next batch, clamped to the bounds in 'settings' in case
+     * they were changed at runtime.
+     */
+    Limits getLimits(const Settings& settings) const;
+
+    /**
+     * Adjusts the limits for subsequent batches based on how a batch was applied.
+     */
+    void recordBatchApplied(const Settings& settings, const BatchObservation& batch);
+
+    /**
+     * Records how long the batch finalizer waited for the journal to be flushed.
+     */
+    void recordJournalFlush(Milliseconds duration);
+
+    /**
+     * Appends the current limits, the reason for the last change and the inputs used to compute
+     * them.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("OplogBatchSizeController::_mutex");
+
+    // The current limits. Zero until the first batch has been observed, in which case the
+    // configured maximums are used.
+    std::size_t _opsLimit = 0;
+    std::size_t _bytesLimit = 0;
+    StringData _reason = kReasonStatic;
+
+    // Moving averages of the controller inputs. Negative until the first sample is recorded.
+    double _applyMicrosPerOp = -1;
+    double _bytesPerOp = -1;
+    double _journalFlushMillis = -1;
+    Milliseconds _lastReplicationLag{0};
+
+    long long _numIncreases = 0;
+    long long _numDecreases = 0;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,217 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_batch_size_controller.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+OplogBatchSizeController::Settings makeSettings() {
+    OplogBatchSizeController::Settings settings;
+    settings.enabled = true;
+    settings.minOps = 10;
+    settings.maxOps = 1000;
+    settings.minBytes = 1024;
+    settings.maxBytes = 1024 * 1024;
+    settings.targetApplyTime = Milliseconds(100);
+    settings.lagThreshold = Seconds(10);
+    return settings;
+}
+
+OplogBatchSizeController::BatchObservation makeBatch(std::size_t ops,
+                                                     Milliseconds applyDuration,
+                                                     Milliseconds replicationLag = Milliseconds(0)) {
+    OplogBatchSizeController::BatchObservation batch;
+    batch.ops = ops;
+    batch.bytes = ops * 100;
+    batch.applyDuration = applyDuration;
+    batch.replicationLag = replicationLag;
+    return batch;
+}
+
+TEST(OplogBatchSizeControllerTest, DisabledControllerUsesConfiguredMaximums) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+    settings.enabled = false;
+
+    controller.recordBatchApplied(settings, makeBatch(1000, Seconds(10)));
+
+    auto limits = controller.getLimits(settings);
+    ASSERT_EQUALS(settings.maxOps, limits.ops);
+    ASSERT_EQUALS(settings.maxBytes, limits.bytes);
+    ASSERT_EQUALS(OplogBatchSizeController::kReasonStatic, limits.reason);
+}
+
+TEST(OplogBatchSizeControllerTest, StartsAtConfiguredMaximums) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+
+    auto limits = controller.getLimits(settings);
+    ASSERT_EQUALS(settings.maxOps, limits.ops);
+    ASSERT_EQUALS(settings.maxBytes, limits.bytes);
+}
+
+TEST(OplogBatchSizeControllerTest, SlowBatchesShrinkLimitsGradually) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+
+    // 1ms per op puts the target at 100 ops, but the limit may only halve per batch.
+    controller.recordBatchApplied(settings, makeBatch(1000, Seconds(1)));
+    auto limits = controller.getLimits(settings);
+    ASSERT_EQUALS(500U, limits.ops);
+    ASSERT_EQUALS(OplogBatchSizeController::kReasonApplyLatency, limits.reason);
+    ASSERT_LESS_THAN(limits.bytes, settings.maxBytes);
+
+    controller.recordBatchApplied(settings, makeBatch(500, Milliseconds(500)));
+    ASSERT_EQUALS(250U, controller.getLimits(settings).ops);
+}
+
+TEST(OplogBatchSizeControllerTest, LimitsStopAtConfiguredMinimum) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+
+    for (int i = 0; i < 20; ++i) {
+        auto ops = controller.getLimits(settings).ops;
+        controller.recordBatchApplied(
+            settings, makeBatch(ops, Milliseconds(static_cast<long long>(100 * ops))));
+    }
+
+    auto limits = controller.getLimits(settings);
+    ASSERT_EQUALS(settings.minOps, limits.ops);
+    ASSERT_EQUALS(OplogBatchSizeController::kReasonMinimum, limits.reason);
+}
+
+TEST(OplogBatchSizeControllerTest, BatchesThatDoNotFillTheLimitDoNotGrowIt) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+
+    controller.recordBatchApplied(settings, makeBatch(1000, Seconds(1)));
+    ASSERT_EQUALS(500U, controller.getLimits(settings).ops);
+
+    // Very fast, but the buffer only ever had 20 entries.
+    for (int i = 0; i < 20; ++i) {
+        controller.recordBatchApplied(settings, makeBatch(20, Milliseconds(0)));
+    }
+    auto limits = controller.getLimits(settings);
+    ASSERT_EQUALS(500U, limits.ops);
+    ASSERT_EQUALS(OplogBatchSizeController::kReasonBatchNotFull, limits.reason);
+}
+
+TEST(OplogBatchSizeControllerTest, FastFullBatchesGrowBackToMaximum) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+
+    controller.recordBatchApplied(settings, makeBatch(1000, Seconds(1)));
+    controller.recordBatchApplied(settings, makeBatch(500, Milliseconds(500)));
+    ASSERT_EQUALS(250U, controller.getLimits(settings).ops);
+
+    for (int i = 0; i < 20; ++i) {
+        auto ops = controller.getLimits(settings).ops;
+        controller.recordBatchApplied(settings, makeBatch(ops, Milliseconds(0)));
+    }
+
+    auto limits = controller.getLimits(settings);
+    ASSERT_EQUALS(settings.maxOps, limits.ops);
+    ASSERT_EQUALS(settings.maxBytes, limits.bytes);
+    ASSERT_EQUALS(OplogBatchSizeController::kReasonMaximum, limits.reason);
+}
+
+TEST(OplogBatchSizeControllerTest, ReplicationLagAllowsLongerBatches) {
+    OplogBatchSizeController caughtUp;
+    OplogBatchSizeController lagging;
+    auto settings = makeSettings();
+
+    caughtUp.recordBatchApplied(settings, makeBatch(1000, Milliseconds(400)));
+    lagging.recordBatchApplied(settings, makeBatch(1000, Milliseconds(400), Seconds(30)));
+
+    ASSERT_EQUALS(500U, caughtUp.getLimits(settings).ops);
+    ASSERT_EQUALS(settings.maxOps, lagging.getLimits(settings).ops);
+
+    OplogBatchSizeController slowLagging;
+    slowLagging.recordBatchApplied(settings, makeBatch(1000, Milliseconds(800), Seconds(30)));
+    auto limits = slowLagging.getLimits(settings);
+    ASSERT_EQUALS(500U, limits.ops);
+    ASSERT_EQUALS(OplogBatchSizeController::kReasonReplicationLag, limits.reason);
+}
+
+TEST(OplogBatchSizeControllerTest, SlowJournalFlushesRaiseTheTarget) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+
+    // A 200ms flush puts the target at 800ms per batch, or 500 ops at 1.6ms per op.
+    controller.recordJournalFlush(Milliseconds(200));
+    controller.recordBatchApplied(settings, makeBatch(1000, Milliseconds(1600)));
+
+    auto limits = controller.getLimits(settings);
+    ASSERT_EQUALS(500U, limits.ops);
+    ASSERT_EQUALS(OplogBatchSizeController::kReasonJournalLatency, limits.reason);
+}
+
+TEST(OplogBatchSizeControllerTest, LimitsAreClampedToBoundsChangedAtRuntime) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+
+    controller.recordBatchApplied(settings, makeBatch(1000, Seconds(1)));
+    ASSERT_EQUALS(500U, controller.getLimits(settings).ops);
+
+    settings.maxOps = 100;
+    ASSERT_EQUALS(100U, controller.getLimits(settings).ops);
+
+    settings.maxOps = 1000;
+    settings.minOps = 800;
+    ASSERT_EQUALS(800U, controller.getLimits(settings).ops);
+}
+
+TEST(OplogBatchSizeControllerTest, AppendStatsReportsLimitsAndReason) {
+    OplogBatchSizeController controller;
+    auto settings = makeSettings();
+
+    controller.recordJournalFlush(Milliseconds(10));
+    controller.recordBatchApplied(settings, makeBatch(1000, Seconds(1), Milliseconds(5)));
+
+    BSONObjBuilder builder;
+    controller.appendStats(&builder);
+    auto stats = builder.obj();
+    ASSERT_EQUALS(500, stats["ops"].numberLong());
+    ASSERT_EQUALS(OplogBatchSizeController::kReasonApplyLatency, stats["reason"].valueStringData());
+    ASSERT_EQUALS(1000.0, stats["applyMicrosPerOp"].numberDouble());
+    ASSERT_EQUALS(10.0, stats["journalFlushMillis"].numberDouble());
+    ASSERT_EQUALS(5, stats["replicationLagMillis"].numberLong());
+    ASSERT_EQUALS(0, stats["increases"].numberLong());
+    ASSERT_EQUALS(1, stats["decreases"].numberLong());
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/repl/oplog_applier.h"
+#include "mongo/db/repl/oplog_batch_size_controller.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/logv2/log.h"
 
@@ -289,6 +290,20 @@ void OplogBatcher::_run(StorageInterface* storageInterface) {
             // Locks the oplog to check its max size, do this in the UninterruptibleLockGuard.
             batchLimits.bytes = getBatchLimitOplogBytes(opCtx.get(), storageInterface);
 
+            // The configured limits are upper bounds. With adaptive batch sizing enabled, the
+            // controller may choose smaller batches based on how previous batches were applied.
+            // The applier reports how the batch was applied with the same settings.
+            const auto sizeControllerSettings =
+                OplogBatchSizeController::Settings::fromServerParameters(batchLimits.ops,
+                                                                         batchLimits.bytes);
+            if (sizeControllerSettings.enabled) {
+                auto limits = OplogBatchSizeController::get(opCtx->getServiceContext())
+                                  ->getLimits(sizeControllerSettings);
+                batchLimits.ops = limits.ops;
+                batchLimits.bytes = limits.bytes;
+                ops.setSizeControllerSettings(sizeControllerSettings);
+            }
+
             auto oplogEntries =
                 fassertNoTrace(31004, getNextApplierBatch(opCtx.get(), batchLimits));
             for (const auto& oplogEntry : oplogEntries) {
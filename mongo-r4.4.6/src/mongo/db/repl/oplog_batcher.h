@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/repl/oplog_batch_size_controller.h"
 #include "mongo/db/repl/oplog_buffer.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/storage_interface.h"
@@ -98,6 +99,17 @@ public:
         _termWhenExhausted = term;
     }
 
+    /**
+     * The settings the OplogBatchSizeController chose the limits of this batch with. Only set when
+     * adaptive batch sizing was enabled for the batch.
+     */
+    const boost::optional<OplogBatchSizeController::Settings>& sizeControllerSettings() const {
+        return _sizeControllerSettings;
+    }
+    void setSizeControllerSettings(const OplogBatchSizeController::Settings& settings) {
+        _sizeControllerSettings = settings;
+    }
+
     /**
      * Leaves this object in an unspecified state. Only assignment and destruction are valid.
      */
@@ -109,6 +121,7 @@ private:
     std::vector<OplogEntry> _batch;
     bool _mustShutdown = false;
     boost::optional<long long> _termWhenExhausted;
+    boost::optional<OplogBatchSizeController::Settings> _sizeControllerSettings;
 };
 
 /**
@@ -0,0 +1,380 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_ring_file.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "mongo/base/data_view.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+std::size_t getDocumentSize(const BSONObj& o) {
+    // SERVER-9808 Avoid Fortify complaint about implicit signed->unsigned conversion
+    return static_cast<std::size_t>(o.objsize());
+}
+
+}  // namespace
+
+OplogBufferRingFile::OplogBufferRingFile(Options options, Counters* counters)
+    : _options(std::move(options)), _counters(counters) {}
+
+void OplogBufferRingFile::startup(OperationContext*) {
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    if (!_options.path.empty() && _options.fileSizeBytes > 0) {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(
+            boost::filesystem::path(_options.path).parent_path(), ec);
+
+        _file = std::make_unique<File>();
+        _file->open(_options.path.c_str());
+        if (_file->is_open() && !_file->bad()) {
+            // Entries left over from a previous process are never read back.
+            _file->truncate(0);
+        }
+        if (!_file->is_open() || _file->bad()) {
+            LOGV2_WARNING(5023403,
+                          "Unable to create oplog buffer ring file, buffering oplog entries in "
+                          "memory only",
+                          "path"_attr = _options.path);
+            _file.reset();
+        }
+        _fileWritable = bool(_file);
+    }
+
+    // Update server status metric to reflect the current oplog buffer's max size.
+    if (_counters) {
+        _counters->setMaxSize(_getMaxSize_inlock());
+    }
+}
+
+void OplogBufferRingFile::shutdown(OperationContext*) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _clear_inlock();
+
+    if (_file) {
+        _file.reset();
+        boost::system::error_code ec;
+        boost::filesystem::remove(_options.path, ec);
+    }
+}
+
+void OplogBufferRingFile::push(OperationContext*,
+                               Batch::const_iterator begin,
+                               Batch::const_iterator end) {
+    if (begin == end) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(!_drainMode);
+
+    for (auto i = begin; i != end; ++i) {
+        _push_inlock(*i);
+        _count++;
+        _size += getDocumentSize(*i);
+        if (_counters) {
+            _counters->increment(*i);
+        }
+    }
+    _lastPushed = (end - 1)->getOwned();
+
+    _notEmptyCv.notify_one();
+}
+
+void OplogBufferRingFile::waitForSpace(OperationContext*, std::size_t size) {
+    stdx::unique_lock<Latch> lk(_mutex);
+    _notFullCv.wait(lk, [&] {
+        // An empty buffer always accepts a batch, however large, so the fetcher cannot stall.
+        return _size == 0 || _size + size <= _getMaxSize_inlock();
+    });
+}
+
+bool OplogBufferRingFile::isEmpty() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _count == 0;
+}
+
+std::size_t OplogBufferRingFile::getMaxSize() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _getMaxSize_inlock();
+}
+
+std::size_t OplogBufferRingFile::getSize() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _size;
+}
+
+std::size_t OplogBufferRingFile::getCount() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _count;
+}
+
+void OplogBufferRingFile::clear(OperationContext*) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _clear_inlock();
+}
+
+bool OplogBufferRingFile::tryPop(OperationContext*, Value* value) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_head.empty()) {
+        _refillHead_inlock();
+    }
+    if (_head.empty()) {
+        return false;
+    }
+
+    *value = std::move(_head.front());
+    _head.pop_front();
+    _headSize -= getDocumentSize(*value);
+    _count--;
+    _size -= getDocumentSize(*value);
+    if (_counters) {
+        _counters->decrement(*value);
+    }
+
+    _notFullCv.notify_all();
+    return true;
+}
+
+bool OplogBufferRingFile::waitForData(Seconds waitDuration) {
+    stdx::unique_lock<Latch> lk(_mutex);
+    _notEmptyCv.wait_for(
+        lk, waitDuration.toSystemDuration(), [&] { return _drainMode || _count > 0; });
+    return _count > 0;
+}
+
+bool OplogBufferRingFile::peek(OperationContext*, Value* value) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_head.empty()) {
+        _refillHead_inlock();
+    }
+    if (_head.empty()) {
+        return false;
+    }
+    *value = _head.front();
+    return true;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferRingFile::lastObjectPushed(OperationContext*) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_count == 0) {
+        return boost::none;
+    }
+    return _lastPushed;
+}
+
+void OplogBufferRingFile::enterDrainMode() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _drainMode = true;
+    _notEmptyCv.notify_one();
+}
+
+void OplogBufferRingFile::exitDrainMode() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _drainMode = false;
+}
+
+OplogBufferRingFile::Options OplogBufferRingFile::getOptions() const {
+    return _options;
+}
+
+bool OplogBufferRingFile::isUsingFile() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _fileWritable;
+}
+
+std::size_t OplogBufferRingFile::getFileCount() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _fileCount;
+}
+
+void OplogBufferRingFile::_push_inlock(const Value& value) {
+    if (_fileCount == 0 && _overflow.empty() && _headSize < _options.memorySizeBytes) {
+        _head.push_back(value.getOwned());
+        _headSize += getDocumentSize(value);
+        return;
+    }
+
+    if (_overflow.empty() && _appendToFile_inlock(value)) {
+        return;
+    }
+
+    _overflow.push_back(value.getOwned());
+}
+
+bool OplogBufferRingFile::_appendToFile_inlock(const Value& value) {
+    if (!_fileWritable) {
+        return false;
+    }
+
+    const auto size = static_cast<fileofs>(getDocumentSize(value));
+    const auto capacity = static_cast<fileofs>(_options.fileSizeBytes);
+
+    fileofs offset;
+    if (!_fileWrapped && _fileEnd + size <= capacity) {
+        offset = _fileEnd;
+    } else if (!_fileWrapped && size <= _fileBegin) {
+        // Not enough room left at the end of the file, continue from the beginning.
+        offset = 0;
+    } else if (_fileWrapped && _fileEnd + size <= _fileBegin) {
+        offset = _fileEnd;
+    } else {
+        return false;
+    }
+
+    _file->write(offset, value.objdata(), static_cast<unsigned>(size));
+    if (_file->bad()) {
+        LOGV2_WARNING(5023404,
+                      "Failed to write to oplog buffer ring file, buffering further oplog "
+                      "entries in memory",
+                      "path"_attr = _options.path);
+        _fileWritable = false;
+
+        // File's error state is sticky. Entries already in the ring file stay readable through
+        // a fresh handle.
+        _file = std::make_unique<File>();
+        _file->open(_options.path.c_str(), true /* readOnly */);
+        if (_fileCount > 0 && _file->bad()) {
+            fassertFailedWithStatus(
+                5023407,
+                Status(ErrorCodes::FileOpenFailed,
+                       str::stream()
+                           << "Failed to reopen oplog buffer ring file " << _options.path));
+        }
+        return false;
+    }
+
+    if (offset == 0 && _fileEnd != 0) {
+        _fileWrapOffset = _fileEnd;
+        _fileWrapped = true;
+    }
+    _fileEnd = offset + size;
+    _fileCount++;
+    return true;
+}
+
+OplogBuffer::Value OplogBufferRingFile::_readFromFile_inlock() {
+    invariant(_fileCount > 0);
+
+    if (_fileWrapped && _fileBegin == _fileWrapOffset) {
+        _fileBegin = 0;
+        _fileWrapped = false;
+    }
+
+    char sizeBuf[sizeof(int32_t)];
+    _file->read(_fileBegin, sizeBuf, sizeof(sizeBuf));
+    const auto size = ConstDataView(sizeBuf).read<LittleEndian<int32_t>>();
+    if (_file->bad() || size < BSONObj::kMinBSONLength || size > BSONObjMaxInternalSize) {
+        fassertFailedWithStatus(5023405,
+                                Status(ErrorCodes::UnknownError,
+                                       str::stream()
+                                           << "Invalid entry size " << size << " at offset "
+                                           << _fileBegin << " of oplog buffer ring file "
+                                           << _options.path));
+    }
+
+    auto buf = SharedBuffer::allocate(size);
+    _file->read(_fileBegin, buf.get(), static_cast<unsigned>(size));
+    if (_file->bad()) {
+        fassertFailedWithStatus(5023406,
+                                Status(ErrorCodes::UnknownError,
+                                       str::stream() << "Failed to read entry at offset "
+                                                     << _fileBegin << " of oplog buffer ring file "
+                                                     << _options.path));
+    }
+
+    _fileBegin += size;
+    if (--_fileCount == 0) {
+        _fileBegin = _fileEnd = _fileWrapOffset = 0;
+        _fileWrapped = false;
+    } else if (_fileWrapped && _fileBegin == _fileWrapOffset) {
+        _fileBegin = 0;
+        _fileWrapped = false;
+    }
+
+    return BSONObj(std::move(buf));
+}
+
+void OplogBufferRingFile::_refillHead_inlock() {
+    invariant(_head.empty());
+
+    while (_fileCount > 0 && (_head.empty() || _headSize < _options.memorySizeBytes)) {
+        auto value = _readFromFile_inlock();
+        _headSize += getDocumentSize(value);
+        _head.push_back(std::move(value));
+    }
+
+    if (_fileCount == 0 && !_overflow.empty()) {
+        // The overflow is already in memory. Once it moves to the head, new entries can be
+        // spilled to the ring file again.
+        for (auto&& value : _overflow) {
+            _headSize += getDocumentSize(value);
+            _head.push_back(std::move(value));
+        }
+        _overflow.clear();
+    }
+}
+
+std::size_t OplogBufferRingFile::_getMaxSize_inlock() const {
+    return _fileWritable ? _options.memorySizeBytes + _options.fileSizeBytes
+                         : _options.memorySizeBytes;
+}
+
+void OplogBufferRingFile::_clear_inlock() {
+    _head.clear();
+    _headSize = 0;
+    _overflow.clear();
+    _fileBegin = _fileEnd = _fileWrapOffset = 0;
+    _fileWrapped = false;
+    _fileCount = 0;
+    _count = 0;
+    _size = 0;
+    _lastPushed = boost::none;
+    if (_counters) {
+        _counters->clear();
+    }
+    _notFullCv.notify_all();
+}
+
+}  // namespace repl
+}  // namespace mongo
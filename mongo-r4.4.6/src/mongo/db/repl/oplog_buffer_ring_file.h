@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/file.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer that keeps a bounded window of entries in memory and spills the rest to a ring
+ * file on local disk, without going through the storage engine. Entries are held in three
+ * segments, in order:
+ * 1) the in-memory head, which peek() and tryPop() read from and which is refilled from the ring
+ *    file as it drains,
+ * 2) the ring file, which push() appends to once the head holds "memorySizeBytes" of entries,
+ * 3) the in-memory overflow, for entries that do not fit in the ring file.
+ *
+ * push() never blocks: if the ring file is full, or cannot be created or written, entries go to
+ * the overflow and the buffer degrades to an in-memory queue instead of stopping the fetcher.
+ * waitForSpace() bounds the total size by the in-memory limit plus the ring file size.
+ *
+ * The ring file is scratch space: it is truncated in startup(), removed in shutdown() and its
+ * contents are not meaningful across restarts.
+ */
+class OplogBufferRingFile final : public OplogBuffer {
+public:
+    /**
+     * Structure used to configure an instance of OplogBufferRingFile.
+     */
+    struct Options {
+        // Path of the ring file. If empty, the buffer only holds entries in memory.
+        std::string path;
+        // Maximum size of the ring file.
+        std::size_t fileSizeBytes = 0;
+        // Size of the entries held in memory before spilling to the ring file.
+        std::size_t memorySizeBytes = 0;
+        Options() {}
+    };
+
+    explicit OplogBufferRingFile(Options options, Counters* counters = nullptr);
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void push(OperationContext* opCtx,
+              Batch::const_iterator begin,
+              Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+    // In drain mode, the buffer does not block. It is the responsibility of the caller to ensure
+    // that no items are added to the buffer while in drain mode; this is enforced by invariant().
+    void enterDrainMode() final;
+    void exitDrainMode() final;
+
+    /**
+     * Returns the options used to configure this OplogBufferRingFile.
+     */
+    Options getOptions() const;
+
+    /**
+     * Returns true if entries may be spilled to the ring file.
+     */
+    bool isUsingFile() const;
+
+    /**
+     * Returns the number of entries currently stored in the ring file.
+     */
+    std::size_t getFileCount() const;
+
+private:
+    /**
+     * Stores "value" in the head, the ring file or the overflow, preserving the order of entries.
+     */
+    void _push_inlock(const Value& value);
+
+    /**
+     * Returns false if "value" does not fit in the ring file or the ring file cannot be written.
+     */
+    bool _appendToFile_inlock(const Value& value);
+
+    /**
+     * Removes and returns the oldest entry in the ring file.
+     */
+    Value _readFromFile_inlock();
+
+    /**
+     * Moves entries from the ring file (or the overflow, once the ring file is empty) into the
+     * in-memory head. Called when the head is empty.
+     */
+    void _refillHead_inlock();
+
+    std::size_t _getMaxSize_inlock() const;
+
+    void _clear_inlock();
+
+    const Options _options;
+    Counters* const _counters;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("OplogBufferRingFile::_mutex");
+    stdx::condition_variable _notEmptyCv;
+    stdx::condition_variable _notFullCv;
+    bool _drainMode = false;
+
+    // Total count and size (as measured by BSONObj::objsize()) of the entries in all segments.
+    std::size_t _count = 0;
+    std::size_t _size = 0;
+
+    std::deque<Value> _head;
+    std::size_t _headSize = 0;
+
+    std::deque<Value> _overflow;
+
+    // Null if the ring file could not be created.
+    std::unique_ptr<File> _file;
+
+    // False if the ring file could not be created or an I/O error occurred writing to it. Entries
+    // already in the ring file can still be read.
+    bool _fileWritable = false;
+
+    // Entries live in [_fileBegin, _fileEnd) or, once the writer has wrapped around, in
+    // [_fileBegin, _fileWrapOffset) followed by [0, _fileEnd).
+    fileofs _fileBegin = 0;
+    fileofs _fileEnd = 0;
+    fileofs _fileWrapOffset = 0;
+    bool _fileWrapped = false;
+    std::size_t _fileCount = 0;
+
+    boost::optional<Value> _lastPushed;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,220 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_ring_file.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+class OplogBufferRingFileTest : public unittest::Test {
+protected:
+    /**
+     * Returns options for a buffer that holds "memoryEntries" entries in memory and roughly
+     * "fileEntries" entries in its ring file.
+     */
+    OplogBufferRingFile::Options makeOptions(std::size_t memoryEntries, std::size_t fileEntries) {
+        OplogBufferRingFile::Options options;
+        options.path = _tempDir.path() + "/oplogBuffer.ring";
+        options.memorySizeBytes = memoryEntries * makeEntry(0).objsize();
+        options.fileSizeBytes = fileEntries * makeEntry(0).objsize();
+        return options;
+    }
+
+    static BSONObj makeEntry(int i) {
+        return BSON("_id" << i << "padding" << std::string(100, 'x'));
+    }
+
+    static void pushEntries(OplogBufferRingFile* buffer, int begin, int end) {
+        OplogBuffer::Batch batch;
+        for (int i = begin; i < end; ++i) {
+            batch.push_back(makeEntry(i));
+        }
+        buffer->push(nullptr, batch.cbegin(), batch.cend());
+    }
+
+    static void popAndAssertEntries(OplogBufferRingFile* buffer, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            OplogBuffer::Value value;
+            ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+            ASSERT_BSONOBJ_EQ(makeEntry(i), value);
+        }
+    }
+
+private:
+    unittest::TempDir _tempDir{"oplog_buffer_ring_file_test"};
+};
+
+TEST_F(OplogBufferRingFileTest, StartupCreatesRingFileAndShutdownRemovesIt) {
+    OplogBufferRingFile buffer(makeOptions(10, 100));
+    buffer.startup(nullptr);
+    ASSERT_TRUE(buffer.isUsingFile());
+    ASSERT_TRUE(boost::filesystem::exists(buffer.getOptions().path));
+    ASSERT_EQUALS(buffer.getOptions().memorySizeBytes + buffer.getOptions().fileSizeBytes,
+                  buffer.getMaxSize());
+
+    buffer.shutdown(nullptr);
+    ASSERT_FALSE(boost::filesystem::exists(buffer.getOptions().path));
+}
+
+TEST_F(OplogBufferRingFileTest, EntriesStayInMemoryUntilMemoryLimitIsReached) {
+    OplogBufferRingFile buffer(makeOptions(10, 100));
+    buffer.startup(nullptr);
+
+    pushEntries(&buffer, 0, 10);
+    ASSERT_EQUALS(10U, buffer.getCount());
+    ASSERT_EQUALS(0U, buffer.getFileCount());
+
+    pushEntries(&buffer, 10, 11);
+    ASSERT_EQUALS(11U, buffer.getCount());
+    ASSERT_EQUALS(1U, buffer.getFileCount());
+
+    popAndAssertEntries(&buffer, 0, 11);
+    ASSERT_TRUE(buffer.isEmpty());
+    buffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferRingFileTest, SpilledEntriesArePoppedInOrder) {
+    OplogBufferRingFile buffer(makeOptions(5, 100));
+    buffer.startup(nullptr);
+
+    pushEntries(&buffer, 0, 80);
+    ASSERT_EQUALS(75U, buffer.getFileCount());
+    ASSERT_EQUALS(80U * makeEntry(0).objsize(), buffer.getSize());
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.peek(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(makeEntry(0), value);
+    ASSERT_BSONOBJ_EQ(makeEntry(79), *buffer.lastObjectPushed(nullptr));
+
+    popAndAssertEntries(&buffer, 0, 80);
+    ASSERT_FALSE(buffer.tryPop(nullptr, &value));
+    ASSERT_EQUALS(0U, buffer.getSize());
+    ASSERT_FALSE(buffer.lastObjectPushed(nullptr));
+    buffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferRingFileTest, RingFileWrapsAround) {
+    OplogBufferRingFile buffer(makeOptions(2, 10));
+    buffer.startup(nullptr);
+
+    // Keep the ring file partially full while the writer wraps around it many times.
+    int pushed = 0;
+    int popped = 0;
+    for (int round = 0; round < 20; ++round) {
+        pushEntries(&buffer, pushed, pushed + 7);
+        pushed += 7;
+        popAndAssertEntries(&buffer, popped, popped + 5);
+        popped += 5;
+    }
+    ASSERT_EQUALS(std::size_t(pushed - popped), buffer.getCount());
+
+    popAndAssertEntries(&buffer, popped, pushed);
+    ASSERT_TRUE(buffer.isEmpty());
+    buffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferRingFileTest, EntriesThatDoNotFitInRingFileAreKeptInMemory) {
+    OplogBufferRingFile buffer(makeOptions(2, 5));
+    buffer.startup(nullptr);
+
+    // push() does not block even though the batch is larger than the buffer's maximum size.
+    pushEntries(&buffer, 0, 50);
+    ASSERT_EQUALS(50U, buffer.getCount());
+    ASSERT_EQUALS(5U, buffer.getFileCount());
+
+    popAndAssertEntries(&buffer, 0, 20);
+
+    // Once the ring file has been drained, new entries are spilled to it again.
+    pushEntries(&buffer, 50, 55);
+    ASSERT_EQUALS(5U, buffer.getFileCount());
+
+    popAndAssertEntries(&buffer, 20, 55);
+    ASSERT_TRUE(buffer.isEmpty());
+    buffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferRingFileTest, BufferFallsBackToMemoryIfRingFileCannotBeCreated) {
+    // Make the parent of the ring file a regular file so the ring file cannot be created.
+    auto options = makeOptions(2, 100);
+    std::ofstream(options.path) << "x";
+    options.path += "/oplogBuffer.ring";
+
+    OplogBufferRingFile buffer(options);
+    buffer.startup(nullptr);
+    ASSERT_FALSE(buffer.isUsingFile());
+    ASSERT_EQUALS(options.memorySizeBytes, buffer.getMaxSize());
+
+    pushEntries(&buffer, 0, 10);
+    ASSERT_EQUALS(0U, buffer.getFileCount());
+    popAndAssertEntries(&buffer, 0, 10);
+    buffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferRingFileTest, ClearRemovesAllEntries) {
+    OplogBufferRingFile buffer(makeOptions(2, 100));
+    buffer.startup(nullptr);
+
+    pushEntries(&buffer, 0, 10);
+    buffer.clear(nullptr);
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_EQUALS(0U, buffer.getSize());
+    ASSERT_EQUALS(0U, buffer.getFileCount());
+
+    pushEntries(&buffer, 10, 20);
+    popAndAssertEntries(&buffer, 10, 20);
+    buffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferRingFileTest, WaitForDataReturnsWhenEntriesArePushedOrInDrainMode) {
+    OplogBufferRingFile buffer(makeOptions(2, 100));
+    buffer.startup(nullptr);
+
+    ASSERT_FALSE(buffer.waitForData(Seconds(0)));
+    pushEntries(&buffer, 0, 1);
+    ASSERT_TRUE(buffer.waitForData(Seconds(0)));
+    popAndAssertEntries(&buffer, 0, 1);
+
+    buffer.enterDrainMode();
+    ASSERT_FALSE(buffer.waitForData(Seconds(10)));
+    buffer.exitDrainMode();
+    buffer.shutdown(nullptr);
+}
+
+}  // namespace
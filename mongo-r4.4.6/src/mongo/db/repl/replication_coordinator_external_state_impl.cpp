@@ -37,6 +37,7 @@
 #include <memory>
 #include <string>
 
+#include "mongo/base/init.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/oid.h"
 #include "mongo/bson/util/bson_extract.h"
@@ -71,6 +72,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_applier_impl.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/oplog_buffer_ring_file.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -82,6 +84,7 @@
 #include "mongo/db/s/config/sharding_catalog_manager.h"
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/periodic_balancer_config_refresher.h"
+#include "mongo/db/s/periodic_chunk_statistics_reporter.h"
 #include "mongo/db/s/periodic_sharded_index_consistency_checker.h"
 #include "mongo/db/s/sharding_initialization_mongod.h"
 #include "mongo/db/s/sharding_state_recovery.h"
@@ -92,6 +95,7 @@
 #include "mongo/db/storage/control/journal_flusher.h"
 #include "mongo/db/storage/flow_control.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/db/system_index.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface.h"
@@ -128,6 +132,18 @@ const char meCollectionName[] = "local.me";
 const auto meDatabaseName = localDbName;
 const char tsFieldName[] = "ts";
 
+const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kRingFileOplogBufferName[] = "ringFile";
+
+MONGO_INITIALIZER(steadyStateOplogBuffer)(InitializerContext*) {
+    if ((steadyStateOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (steadyStateOplogBuffer != kRingFileOplogBufferName)) {
+        return Status(ErrorCodes::BadValue,
+                      "unsupported steady state oplog buffer option: " + steadyStateOplogBuffer);
+    }
+    return Status::OK();
+}
+
 MONGO_FAIL_POINT_DEFINE(dropPendingCollectionReaperHang);
 
 // The count of items in the buffer
@@ -216,10 +232,18 @@ void ReplicationCoordinatorExternalStateImpl::startSteadyStateReplication(
         return;
 
     invariant(replCoord);
-    _oplogBuffer = std::make_unique<OplogBufferBlockingQueue>(&bufferGauge);
+    if (steadyStateOplogBuffer == kRingFileOplogBufferName) {
+        OplogBufferRingFile::Options options;
+        options.path = storageGlobalParams.dbpath + "/_tmp/oplogBuffer.ring";
+        options.fileSizeBytes = std::size_t(oplogBufferRingFileSizeMB) * 1024 * 1024;
+        options.memorySizeBytes = std::size_t(oplogBufferRingFileMemorySizeMB) * 1024 * 1024;
+        _oplogBuffer = std::make_unique<OplogBufferRingFile>(options, &bufferGauge);
+    } else {
+        _oplogBuffer = std::make_unique<OplogBufferBlockingQueue>(&bufferGauge);
+    }
 
-    // No need to log OplogBuffer::startup because the blocking queue implementation
-    // does not start any threads or access the storage layer.
+    // No need to log OplogBuffer::startup because neither implementation starts any threads or
+    // accesses the storage layer.
     _oplogBuffer->startup(opCtx);
 
     invariant(!_oplogApplier);
@@ -767,6 +791,7 @@ void ReplicationCoordinatorExternalStateImpl::shardingOnStepDownHook() {
         ChunkSplitter::get(_service).onStepDown();
         CatalogCacheLoader::get(_service).onStepDown();
         PeriodicBalancerConfigRefresher::get(_service).onStepDown();
+        PeriodicChunkStatisticsReporter::get(_service).onStepDown();
         TransactionCoordinatorService::get(_service)->onStepDown();
     }
 
@@ -889,6 +914,7 @@ void ReplicationCoordinatorExternalStateImpl::_shardingOnTransitionToPrimaryHook
         CatalogCacheLoader::get(_service).onStepUp();
         ChunkSplitter::get(_service).onStepUp();
         PeriodicBalancerConfigRefresher::get(_service).onStepUp(_service);
+        PeriodicChunkStatisticsReporter::get(_service).onStepUp(_service);
         TransactionCoordinatorService::get(_service)->onStepUp(opCtx);
 
         // Note, these must be done after the configOpTime is recovered via
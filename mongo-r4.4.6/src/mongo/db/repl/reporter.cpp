@@ -33,6 +33,8 @@
 
 #include "mongo/db/repl/reporter.h"
 
+#include <algorithm>
+
 #include "mongo/base/counter.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/commands/server_status_metric.h"
@@ -54,6 +56,12 @@ Counter64 numUpdatePosition;
 ServerStatusMetricField<Counter64> displayNumUpdatePosition(
     "repl.network.replSetUpdatePosition.num", &numUpdatePosition);
 
+// The number of replSetUpdatePosition commands a node sent to its sync source while an earlier
+// command was still awaiting a response.
+Counter64 numPipelinedUpdatePosition;
+ServerStatusMetricField<Counter64> displayNumPipelinedUpdatePosition(
+    "repl.network.replSetUpdatePosition.numPipelined", &numPipelinedUpdatePosition);
+
 /**
  * Returns configuration version in update command object.
  * Returns -1 on failure.
@@ -97,12 +105,14 @@ Reporter::Reporter(executor::TaskExecutor* executor,
                    PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
                    const HostAndPort& target,
                    Milliseconds keepAliveInterval,
-                   Milliseconds updatePositionTimeout)
+                   Milliseconds updatePositionTimeout,
+                   size_t maxInFlightUpdates)
     : _executor(executor),
       _prepareReplSetUpdatePositionCommandFn(prepareReplSetUpdatePositionCommandFn),
       _target(target),
       _keepAliveInterval(keepAliveInterval),
-      _updatePositionTimeout(updatePositionTimeout) {
+      _updatePositionTimeout(updatePositionTimeout),
+      _maxInFlightUpdates(maxInFlightUpdates) {
     uassert(ErrorCodes::BadValue, "null task executor", executor);
     uassert(ErrorCodes::BadValue,
             "null function to create replSetUpdatePosition command object",
@@ -114,6 +124,9 @@ Reporter::Reporter(executor::TaskExecutor* executor,
     uassert(ErrorCodes::BadValue,
             "update position timeout must be positive",
             updatePositionTimeout > Milliseconds(0));
+    uassert(ErrorCodes::BadValue,
+            "max number of in-flight updates must be positive",
+            maxInFlightUpdates > 0);
 }
 
 Reporter::~Reporter() {
@@ -145,17 +158,12 @@ void Reporter::shutdown() {
 
     _isWaitingToSendReporter = false;
 
-    executor::TaskExecutor::CallbackHandle handle;
-    if (_remoteCommandCallbackHandle.isValid()) {
-        invariant(!_prepareAndSendCommandCallbackHandle.isValid());
-        handle = _remoteCommandCallbackHandle;
-    } else {
-        invariant(!_remoteCommandCallbackHandle.isValid());
-        invariant(_prepareAndSendCommandCallbackHandle.isValid());
-        handle = _prepareAndSendCommandCallbackHandle;
+    for (const auto& handle : _remoteCommandCallbackHandles) {
+        _executor->cancel(handle);
+    }
+    if (_prepareAndSendCommandCallbackHandle.isValid()) {
+        _executor->cancel(_prepareAndSendCommandCallbackHandle);
     }
-
-    _executor->cancel(handle);
 }
 
 Status Reporter::join() {
@@ -179,8 +187,12 @@ Status Reporter::trigger() {
         _executor->cancel(_prepareAndSendCommandCallbackHandle);
         return Status::OK();
     } else if (_isActive_inlock()) {
-        _isWaitingToSendReporter = true;
-        return Status::OK();
+        if (!_canSendPipelinedUpdate_inlock()) {
+            _isWaitingToSendReporter = true;
+            return Status::OK();
+        }
+        // Send the new progress now instead of after the response to the previous command.
+        numPipelinedUpdatePosition.increment(1);
     }
 
     auto scheduleResult =
@@ -257,7 +269,7 @@ void Reporter::_sendCommand_inlock(BSONObj commandRequest, Milliseconds netTimeo
 
     numUpdatePosition.increment(1);
 
-    _remoteCommandCallbackHandle = scheduleResult.getValue();
+    _remoteCommandCallbackHandles.push_back(scheduleResult.getValue());
 }
 
 void Reporter::_processResponseCallback(
@@ -265,16 +277,17 @@ void Reporter::_processResponseCallback(
     {
         stdx::lock_guard<Latch> lk(_mutex);
 
-        // If the reporter was shut down before this callback is invoked,
-        // return the canceled "_status".
+        // If the reporter was shut down, or another command in progress failed, before this
+        // callback is invoked, return the existing "_status".
         if (!_status.isOK()) {
-            invariant(_status == ErrorCodes::CallbackCanceled);
+            _removeRemoteCommandCallbackHandle_inlock(rcbd.myHandle);
             _onShutdown_inlock();
             return;
         }
 
         _status = rcbd.response.status;
         if (!_status.isOK()) {
+            _removeRemoteCommandCallbackHandle_inlock(rcbd.myHandle);
             _onShutdown_inlock();
             return;
         }
@@ -297,11 +310,19 @@ void Reporter::_processResponseCallback(
             // Do not resend update command immediately.
             _isWaitingToSendReporter = false;
         } else if (!_status.isOK()) {
+            _removeRemoteCommandCallbackHandle_inlock(rcbd.myHandle);
             _onShutdown_inlock();
             return;
         }
 
         if (!_isWaitingToSendReporter) {
+            _removeRemoteCommandCallbackHandle_inlock(rcbd.myHandle);
+
+            // The keep alive timer is only armed once every pipelined command has completed.
+            if (_isActive_inlock()) {
+                return;
+            }
+
             // Since we are also on a timer, schedule a report for that interval, or until
             // triggered.
             auto when = _executor->now() + _keepAliveInterval;
@@ -318,8 +339,6 @@ void Reporter::_processResponseCallback(
 
             _prepareAndSendCommandCallbackHandle = scheduleResult.getValue();
             _keepAliveTimeoutWhen = when;
-
-            _remoteCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
             return;
         }
     }
@@ -328,6 +347,7 @@ void Reporter::_processResponseCallback(
     auto prepareResult = _prepareCommand();
 
     stdx::lock_guard<Latch> lk(_mutex);
+    _removeRemoteCommandCallbackHandle_inlock(rcbd.myHandle);
     if (!_status.isOK()) {
         _onShutdown_inlock();
         return;
@@ -339,7 +359,7 @@ void Reporter::_processResponseCallback(
         return;
     }
 
-    invariant(_remoteCommandCallbackHandle.isValid());
+    invariant(!_remoteCommandCallbackHandles.empty());
     _isWaitingToSendReporter = false;
 }
 
@@ -348,6 +368,7 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
     {
         stdx::lock_guard<Latch> lk(_mutex);
         if (!_status.isOK()) {
+            _prepareAndSendCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
             _onShutdown_inlock();
             return;
         }
@@ -361,6 +382,7 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
         }
 
         if (!_status.isOK()) {
+            _prepareAndSendCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
             _onShutdown_inlock();
             return;
         }
@@ -370,6 +392,7 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
     auto prepareResult = _prepareCommand();
 
     stdx::lock_guard<Latch> lk(_mutex);
+    _prepareAndSendCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
     if (!_status.isOK()) {
         _onShutdown_inlock();
         return;
@@ -381,15 +404,22 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
         return;
     }
 
-    invariant(_remoteCommandCallbackHandle.isValid());
-    _prepareAndSendCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
+    invariant(!_remoteCommandCallbackHandles.empty());
     _keepAliveTimeoutWhen = Date_t();
 }
 
 void Reporter::_onShutdown_inlock() {
     _isWaitingToSendReporter = false;
-    _remoteCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
-    _prepareAndSendCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
+
+    // Callbacks that are still outstanding observe the failed "_status" and remove their own
+    // handles, so the Reporter stays active until the last of them has run.
+    for (const auto& handle : _remoteCommandCallbackHandles) {
+        _executor->cancel(handle);
+    }
+    if (_prepareAndSendCommandCallbackHandle.isValid()) {
+        _executor->cancel(_prepareAndSendCommandCallbackHandle);
+    }
+
     _keepAliveTimeoutWhen = Date_t();
     _condition.notify_all();
 }
@@ -399,8 +429,28 @@ bool Reporter::isActive() const {
     return _isActive_inlock();
 }
 
+size_t Reporter::getNumInFlightUpdates() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _remoteCommandCallbackHandles.size();
+}
+
 bool Reporter::_isActive_inlock() const {
-    return _remoteCommandCallbackHandle.isValid() || _prepareAndSendCommandCallbackHandle.isValid();
+    return !_remoteCommandCallbackHandles.empty() ||
+        _prepareAndSendCommandCallbackHandle.isValid();
+}
+
+bool Reporter::_canSendPipelinedUpdate_inlock() const {
+    return !_prepareAndSendCommandCallbackHandle.isValid() &&
+        _remoteCommandCallbackHandles.size() < _maxInFlightUpdates;
+}
+
+void Reporter::_removeRemoteCommandCallbackHandle_inlock(
+    const executor::TaskExecutor::CallbackHandle& handle) {
+    auto it = std::find(
+        _remoteCommandCallbackHandles.begin(), _remoteCommandCallbackHandles.end(), handle);
+    if (it != _remoteCommandCallbackHandles.end()) {
+        _remoteCommandCallbackHandles.erase(it);
+    }
 }
 
 bool Reporter::isWaitingToSendReport() const {
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
@@ -62,6 +63,11 @@ namespace repl {
  *
  * Calling trigger() while it is in state 3 sends a command upstream and cancels the current
  * keep alive timeout, resetting the keep alive schedule.
+ *
+ * If "maxInFlightUpdates" is greater than one, calling trigger() while in state 2 sends another
+ * command right away as long as fewer than "maxInFlightUpdates" commands are awaiting a response,
+ * so a progress update (e.g. a newer durable optime) does not wait for the round trip of the
+ * previous one. This is safe because the sync source only ever moves member optimes forward.
  */
 class Reporter {
     Reporter(const Reporter&) = delete;
@@ -80,7 +86,8 @@ public:
              PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
              const HostAndPort& target,
              Milliseconds keepAliveInterval,
-             Milliseconds updatePositionTimeout);
+             Milliseconds updatePositionTimeout,
+             size_t maxInFlightUpdates = 1);
 
     virtual ~Reporter();
 
@@ -107,6 +114,11 @@ public:
      */
     bool isActive() const;
 
+    /**
+     * Returns the number of remote commands that have been sent but not completed.
+     */
+    size_t getNumInFlightUpdates() const;
+
     /**
      * Returns true if new data is available while a remote command is in progress.
      * The reporter will schedule a subsequent remote update immediately upon successful
@@ -145,6 +157,18 @@ private:
      */
     bool _isActive_inlock() const;
 
+    /**
+     * Returns true if a triggered update may be sent without waiting for the responses to the
+     * commands that are currently in progress.
+     */
+    bool _canSendPipelinedUpdate_inlock() const;
+
+    /**
+     * Forgets about a remote command once its response has been processed.
+     */
+    void _removeRemoteCommandCallbackHandle_inlock(
+        const executor::TaskExecutor::CallbackHandle& handle);
+
     /**
      * Prepares remote command to be run by the executor.
      */
@@ -167,7 +191,7 @@ private:
                                         bool fromTrigger);
 
     /**
-     * Signals end of Reporter work and notifies waiters.
+     * Signals end of Reporter work, cancels any outstanding callbacks and notifies waiters.
      */
     void _onShutdown_inlock();
 
@@ -187,6 +211,9 @@ private:
     // The network timeout used when sending an updatePosition command to our sync source.
     const Milliseconds _updatePositionTimeout;
 
+    // The number of updatePosition commands that may be awaiting a response at the same time.
+    const size_t _maxInFlightUpdates;
+
     // Protects member data of this Reporter declared below.
     mutable Mutex _mutex = MONGO_MAKE_LATCH("Reporter::_mutex");
 
@@ -199,8 +226,8 @@ private:
     // subsequent updates have come in.
     bool _isWaitingToSendReporter = false;
 
-    // Callback handle to the scheduled remote command.
-    executor::TaskExecutor::CallbackHandle _remoteCommandCallbackHandle;
+    // Callback handles to the scheduled remote commands, in the order they were sent.
+    std::vector<executor::TaskExecutor::CallbackHandle> _remoteCommandCallbackHandles;
 
     // Callback handle to the scheduled task for preparing and sending the remote command.
     executor::TaskExecutor::CallbackHandle _prepareAndSendCommandCallbackHandle;
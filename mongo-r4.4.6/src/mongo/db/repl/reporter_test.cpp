@@ -769,4 +769,101 @@ TEST_F(ReporterTest, ShutdownImmediatelyAfterTriggerWhileKeepAliveTimeoutIsSched
     assertReporterDone();
 }
 
+TEST_F(ReporterTestNoTriggerAtSetUp,
+       TriggerWhileCommandRequestIsInProgressSendsPipelinedCommandRequestImmediately) {
+    reporter =
+        std::make_unique<Reporter>(_executorProxy.get(),
+                                   [this]() { return prepareReplSetUpdatePositionCommandFn(); },
+                                   HostAndPort("h1"),
+                                   Milliseconds(1000),
+                                   Milliseconds(5000),
+                                   2);
+
+    ASSERT_OK(reporter->trigger());
+
+    auto net = getNet();
+    net->enterNetwork();
+    auto firstRequest = net->getNextReadyRequest();
+    net->exitNetwork();
+    ASSERT_EQUALS(1U, reporter->getNumInFlightUpdates());
+
+    // The second update does not wait for the response to the first one.
+    ASSERT_OK(reporter->trigger());
+    ASSERT_FALSE(reporter->isWaitingToSendReport());
+
+    net->enterNetwork();
+    auto secondRequest = net->getNextReadyRequest();
+    net->exitNetwork();
+    ASSERT_EQUALS(2U, reporter->getNumInFlightUpdates());
+
+    // A third update has to wait for one of the two commands in progress to complete.
+    ASSERT_OK(reporter->trigger());
+    ASSERT_TRUE(reporter->isWaitingToSendReport());
+
+    net->enterNetwork();
+    net->scheduleResponse(
+        firstRequest, net->now(), RemoteCommandResponse(BSON("ok" << 1), Milliseconds(0)));
+    net->runReadyNetworkOperations();
+    auto thirdRequest = net->getNextReadyRequest();
+    net->scheduleResponse(
+        secondRequest, net->now(), RemoteCommandResponse(BSON("ok" << 1), Milliseconds(0)));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    // The keep alive timeout is not scheduled while a command is still in progress.
+    ASSERT_FALSE(reporter->isWaitingToSendReport());
+    ASSERT_EQUALS(1U, reporter->getNumInFlightUpdates());
+    ASSERT_EQUALS(Date_t(), reporter->getKeepAliveTimeoutWhen_forTest());
+
+    net->enterNetwork();
+    net->scheduleResponse(
+        thirdRequest, net->now(), RemoteCommandResponse(BSON("ok" << 1), Milliseconds(0)));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    ASSERT_EQUALS(0U, reporter->getNumInFlightUpdates());
+    ASSERT_EQUALS(getExecutor().now() + reporter->getKeepAliveInterval(),
+                  reporter->getKeepAliveTimeoutWhen_forTest());
+    ASSERT_TRUE(reporter->isActive());
+
+    reporter->shutdown();
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, reporter->join());
+    assertReporterDone();
+}
+
+TEST_F(ReporterTestNoTriggerAtSetUp, FailedPipelinedCommandStopsTheReporterAfterAllResponses) {
+    reporter =
+        std::make_unique<Reporter>(_executorProxy.get(),
+                                   [this]() { return prepareReplSetUpdatePositionCommandFn(); },
+                                   HostAndPort("h1"),
+                                   Milliseconds(1000),
+                                   Milliseconds(5000),
+                                   2);
+
+    ASSERT_OK(reporter->trigger());
+
+    auto net = getNet();
+    net->enterNetwork();
+    net->getNextReadyRequest();
+    net->exitNetwork();
+
+    ASSERT_OK(reporter->trigger());
+
+    net->enterNetwork();
+    auto secondRequest = net->getNextReadyRequest();
+    net->scheduleResponse(secondRequest,
+                          net->now(),
+                          {ErrorCodes::OperationFailed, "update failed", Milliseconds(0)});
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    // The failure cancels the first command; the Reporter is done once its callback has run.
+    net->enterNetwork();
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    ASSERT_EQUALS(ErrorCodes::OperationFailed, reporter->join());
+    assertReporterDone();
+}
+
 }  // namespace
@@ -37,9 +37,11 @@
 #include <fmt/format.h>
 
 #include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/background.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/replication_state_transition_lock_guard.h"
@@ -64,7 +66,9 @@
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/catalog/type_config_version.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -181,10 +185,20 @@ RollbackImpl::~RollbackImpl() {
     shutdown();
 }
 
+template <typename Fn>
+auto RollbackImpl::_timePhase(StringData phase, Fn&& fn) -> decltype(fn()) {
+    Timer timer;
+    ON_BLOCK_EXIT([&] {
+        _rollbackStats.phaseDurations.emplace_back(phase.toString(), Milliseconds(timer.millis()));
+    });
+    return fn();
+}
+
 Status RollbackImpl::runRollback(OperationContext* opCtx) {
     _rollbackStats.startTime = opCtx->getServiceContext()->getFastClockSource()->now();
 
-    auto status = _transitionToRollback(opCtx);
+    auto status =
+        _timePhase("transitionToRollback", [&] { return _transitionToRollback(opCtx); });
     if (!status.isOK()) {
         return status;
     }
@@ -207,7 +221,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     ON_BLOCK_EXIT([this, opCtx] { _transitionFromRollbackToSecondary(opCtx); });
     ON_BLOCK_EXIT([this, opCtx] { _summarizeRollback(opCtx); });
 
-    auto commonPointSW = _findCommonPoint(opCtx);
+    auto commonPointSW = _timePhase("findCommonPoint", [&] { return _findCommonPoint(opCtx); });
     if (!commonPointSW.isOK()) {
         return commonPointSW.getStatus();
     }
@@ -248,7 +262,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     // oplog, which should now be at the common point.
     _replicationCoordinator->resetLastOpTimesFromOplog(
         opCtx, ReplicationCoordinator::DataConsistency::Consistent);
-    status = _triggerOpObserver(opCtx);
+    status = _timePhase("triggerOpObserver", [&] { return _triggerOpObserver(opCtx); });
     if (!status.isOK()) {
         return status;
     }
@@ -465,7 +479,7 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
     OperationContext* opCtx, RollBackLocalOperations::RollbackCommonPoint commonPoint) noexcept {
     // Stop and wait for all background index builds to complete before starting the rollback
     // process.
-    _stopAndWaitForIndexBuilds(opCtx);
+    _timePhase("waitForIndexBuilds", [&] { _stopAndWaitForIndexBuilds(opCtx); });
     _listener->onBgIndexesComplete();
 
     // Before computing record store counts, abort all active transactions. This ensures that
@@ -474,14 +488,16 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
     // Before calling recoverToStableTimestamp, we must abort the storage transaction of any
     // prepared transaction. This will require us to scan all sessions and call
     // abortPreparedTransactionForRollback() on any txnParticipant with a prepared transaction.
-    killSessionsAbortAllPreparedTransactions(opCtx);
+    _timePhase("abortPreparedTransactions",
+               [&] { killSessionsAbortAllPreparedTransactions(opCtx); });
 
     // Ask the record store for the pre-rollback counts of any collections whose counts will
     // change and create a map with the adjusted counts for post-rollback. While finding the
     // common point, we keep track of how much each collection's count will change during the
     // rollback. Note: these numbers are relative to the common point, not the stable timestamp,
     // and thus must be set after recovering from the oplog.
-    auto status = _findRecordStoreCounts(opCtx);
+    auto status =
+        _timePhase("findRecordStoreCounts", [&] { return _findRecordStoreCounts(opCtx); });
     fassert(31227, status);
 
     if (shouldCreateDataFiles()) {
@@ -489,7 +505,7 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
         // rollback. We need to do this after aborting prepared transactions. Otherwise, we risk
         // unecessary prepare conflicts when trying to read documents that were modified by
         // those prepared transactions, which we know we will abort anyway.
-        status = _writeRollbackFiles(opCtx);
+        status = _timePhase("writeRollbackFiles", [&] { return _writeRollbackFiles(opCtx); });
         fassert(31228, status);
     } else {
         LOGV2(21598, "Not writing rollback files. 'createRollbackDataFiles' set to false");
@@ -503,7 +519,8 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
     }
 
     // Recover to the stable timestamp.
-    auto stableTimestamp = _recoverToStableTimestamp(opCtx);
+    auto stableTimestamp =
+        _timePhase("recoverToStableTimestamp", [&] { return _recoverToStableTimestamp(opCtx); });
 
     _rollbackStats.stableTimestamp = stableTimestamp;
     _listener->onRecoverToStableTimestamp(stableTimestamp);
@@ -548,18 +565,22 @@ void RollbackImpl::_runPhaseFromAbortToReconstructPreparedTxns(
     _resetDropPendingState(opCtx);
 
     // Run the recovery process.
-    _replicationProcess->getReplicationRecovery()->recoverFromOplog(opCtx, stableTimestamp);
+    _timePhase("recoverFromOplog", [&] {
+        _replicationProcess->getReplicationRecovery()->recoverFromOplog(opCtx, stableTimestamp);
+    });
     _listener->onRecoverFromOplog();
 
     // Sets the correct post-rollback counts on any collections whose counts changed during the
     // rollback.
-    _correctRecordStoreCounts(opCtx);
+    _timePhase("correctRecordStoreCounts", [&] { _correctRecordStoreCounts(opCtx); });
 
     // Reconstruct prepared transactions after counts have been adjusted. Since prepared
     // transactions were aborted (i.e. the in-memory counts were rolled-back) before computing
     // collection counts, reconstruct the prepared transactions now, adding on any additional counts
     // to the now corrected record store.
-    reconstructPreparedTransactions(opCtx, OplogApplication::Mode::kRecovering);
+    _timePhase("reconstructPreparedTransactions", [&] {
+        reconstructPreparedTransactions(opCtx, OplogApplication::Mode::kRecovering);
+    });
 }
 
 void RollbackImpl::_correctRecordStoreCounts(OperationContext* opCtx) {
@@ -1117,6 +1138,14 @@ boost::optional<BSONObj> RollbackImpl::_findDocumentById(OperationContext* opCtx
 Status RollbackImpl::_writeRollbackFiles(OperationContext* opCtx) {
     const auto& catalog = CollectionCatalog::get(opCtx);
     auto storageEngine = opCtx->getServiceContext()->getStorageEngine();
+
+    struct RollbackFileTask {
+        UUID uuid;
+        NamespaceString nss;
+        const SimpleBSONObjUnorderedSet* idSet;
+    };
+    std::vector<RollbackFileTask> tasks;
+
     for (auto&& entry : _observerInfo.rollbackDeletedIdsMap) {
         const auto& uuid = entry.first;
         const auto nss = catalog.lookupNSSByUUID(opCtx, uuid);
@@ -1138,10 +1167,83 @@ Status RollbackImpl::_writeRollbackFiles(OperationContext* opCtx) {
                   str::stream() << "The collection with UUID " << uuid
                                 << " is unexpectedly missing in the CollectionCatalog");
 
-        _writeRollbackFileForNamespace(opCtx, uuid, *nss, entry.second);
+        tasks.push_back({uuid, *nss, &entry.second});
     }
 
-    return Status::OK();
+    // Each namespace gets its own rollback file, so the files can be written independently. The
+    // documents are read back one _id at a time, which makes this phase dominated by storage
+    // latency when many namespaces are affected. Spread the namespaces over a small pool of
+    // threads when configured to do so. Only the _id sets already collected while finding the
+    // common point are held in memory, so the concurrency does not change the memory footprint.
+    const auto numWriters = std::min(static_cast<size_t>(gRollbackDataFileWriterThreads.load()),
+                                      tasks.size());
+    if (numWriters <= 1) {
+        for (auto&& task : tasks) {
+            _writeRollbackFileForNamespace(opCtx, task.uuid, task.nss, *task.idSet);
+        }
+        return Status::OK();
+    }
+
+    LOGV2(5023400,
+          "Writing rollback files for {numNamespaces} namespaces using {numWriters} threads",
+          "Writing rollback files concurrently",
+          "numNamespaces"_attr = tasks.size(),
+          "numWriters"_attr = numWriters);
+
+    ThreadPool::Options options;
+    options.threadNamePrefix = "RollbackFileWriter-";
+    options.poolName = "RollbackFileWriterThreadPool";
+    options.minThreads = 0;
+    options.maxThreads = numWriters;
+    options.onCreateThread = [](const std::string&) {
+        Client::initThread(getThreadName());
+        AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    // The first error of any writer is returned as the status of this phase, and the namespaces,
+    // which were not started yet, are skipped. The writers also stop once rollback is shut down or
+    // its operation is killed. Their own operations are interrupted at global shutdown, like the
+    // rollback operation itself.
+    auto errorMutex = MONGO_MAKE_LATCH("RollbackImpl::_writeRollbackFiles::errorMutex");
+    Status firstError = Status::OK();
+
+    for (auto&& task : tasks) {
+        pool.schedule([this, opCtx, &task, &errorMutex, &firstError](Status status) {
+            invariant(status);
+            {
+                stdx::lock_guard<Latch> lock(errorMutex);
+                if (!firstError.isOK()) {
+                    return;
+                }
+            }
+
+            try {
+                uassert(ErrorCodes::ShutdownInProgress, "rollback shutting down", !_isInShutdown());
+                const auto killStatus = opCtx->getKillStatus();
+                uassert(killStatus,
+                        "rollback operation was interrupted",
+                        killStatus == ErrorCodes::OK);
+
+                auto writerOpCtx = cc().makeOperationContext();
+                _writeRollbackFileForNamespace(
+                    writerOpCtx.get(), task.uuid, task.nss, *task.idSet);
+            } catch (const DBException& ex) {
+                stdx::lock_guard<Latch> lock(errorMutex);
+                if (firstError.isOK()) {
+                    firstError = ex.toStatus(str::stream() << "Failed to write the rollback file "
+                                                              "for namespace "
+                                                           << task.nss.ns());
+                }
+            }
+        });
+    }
+
+    pool.shutdown();
+    pool.join();
+
+    return firstError;
 }
 
 void RollbackImpl::_writeRollbackFileForNamespace(OperationContext* opCtx,
@@ -1169,16 +1271,20 @@ void RollbackImpl::_writeRollbackFileForNamespace(OperationContext* opCtx,
     // If this is the first data directory created, we save the full directory path in
     // _rollbackStats. Otherwise, we store the longest common prefix of the two directories.
     const auto& newDirectoryPath = removeSaver.root().generic_string();
-    if (!_rollbackStats.rollbackDataFileDirectory) {
-        _rollbackStats.rollbackDataFileDirectory = newDirectoryPath;
-    } else {
-        const auto& existingDirectoryPath = *_rollbackStats.rollbackDataFileDirectory;
-        const auto& prefixEnd = std::mismatch(newDirectoryPath.begin(),
-                                              newDirectoryPath.end(),
-                                              existingDirectoryPath.begin(),
-                                              existingDirectoryPath.end())
-                                    .first;
-        _rollbackStats.rollbackDataFileDirectory = std::string(newDirectoryPath.begin(), prefixEnd);
+    {
+        stdx::lock_guard<Latch> lk(_rollbackFilesMutex);
+        if (!_rollbackStats.rollbackDataFileDirectory) {
+            _rollbackStats.rollbackDataFileDirectory = newDirectoryPath;
+        } else {
+            const auto& existingDirectoryPath = *_rollbackStats.rollbackDataFileDirectory;
+            const auto& prefixEnd = std::mismatch(newDirectoryPath.begin(),
+                                                  newDirectoryPath.end(),
+                                                  existingDirectoryPath.begin(),
+                                                  existingDirectoryPath.end())
+                                        .first;
+            _rollbackStats.rollbackDataFileDirectory =
+                std::string(newDirectoryPath.begin(), prefixEnd);
+        }
     }
 
     for (auto&& id : idSet) {
@@ -1190,6 +1296,8 @@ void RollbackImpl::_writeRollbackFileForNamespace(OperationContext* opCtx,
             fassert(50750, removeSaver.goingToDelete(*document));
         }
     }
+
+    stdx::lock_guard<Latch> lk(_rollbackFilesMutex);
     _listener->onRollbackFileWrittenForNamespace(std::move(uuid), std::move(nss));
 }
 
@@ -1298,6 +1406,13 @@ void RollbackImpl::_summarizeRollback(OperationContext* opCtx) const {
     attrs.add("affectedNamespaces", _observerInfo.rollbackNamespaces);
     attrs.add("rollbackCommandCounts", _observerInfo.rollbackCommandCounts);
     attrs.add("totalEntriesRolledBackIncludingNoops", _observerInfo.numberOfEntriesObserved);
+
+    BSONObjBuilder phaseDurationsBuilder;
+    for (const auto& [phase, duration] : _rollbackStats.phaseDurations) {
+        phaseDurationsBuilder.append(phase, durationCount<Milliseconds>(duration));
+    }
+    auto phaseDurationsMillis = phaseDurationsBuilder.obj();
+    attrs.add("phaseDurationsMillis", phaseDurationsMillis);
     LOGV2(21612, "Rollback summary", attrs);
 }
 
@@ -30,6 +30,9 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/db/op_observer.h"
@@ -106,6 +109,12 @@ struct RollbackStats {
      * The wall clock time of the first operation after the common point, if known.
      */
     boost::optional<Date_t> firstOpWallClockTimeAfterCommonPoint;
+
+    /**
+     * The time spent in each phase of rollback, in the order the phases were run. Phases that were
+     * never reached because rollback exited early are absent.
+     */
+    std::vector<std::pair<std::string, Milliseconds>> phaseDurations;
 };
 
 /**
@@ -433,6 +442,10 @@ private:
      * Before each namespace is examined, we check for interrupt and return a non-OK status if
      * shutdown is in progress.
      *
+     * When rollbackDataFileWriterThreads allows it, the namespaces are written concurrently by a
+     * pool of writer threads, each with its own OperationContext. The first error of any writer is
+     * returned, and the writers stop once rollback shuts down or 'opCtx' is interrupted.
+     *
      * This function causes the server to terminate if an error occurs while fetching documents from
      * disk or while writing documents to the rollback file. It must be called before marking the
      * oplog truncate point, and before the storage engine recovers to the stable timestamp.
@@ -444,6 +457,12 @@ private:
      */
     void _summarizeRollback(OperationContext* opCtx) const;
 
+    /**
+     * Runs 'fn' and records the time it took in _rollbackStats under the phase name 'phase'.
+     */
+    template <typename Fn>
+    auto _timePhase(StringData phase, Fn&& fn) -> decltype(fn());
+
     /**
      * Aligns the drop pending reaper's state with the catalog.
      */
@@ -452,6 +471,10 @@ private:
     // Guards access to member variables.
     mutable Mutex _mutex = MONGO_MAKE_LATCH("RollbackImpl::_mutex");  // (S)
 
+    // Serializes the updates that concurrent rollback data file writers make to _rollbackStats and
+    // the listener notifications they send. See _writeRollbackFiles().
+    Mutex _rollbackFilesMutex = MONGO_MAKE_LATCH("RollbackImpl::_rollbackFilesMutex");  // (S)
+
     // Set to true when RollbackImpl should shut down.
     bool _inShutdown = false;  // (M)
 
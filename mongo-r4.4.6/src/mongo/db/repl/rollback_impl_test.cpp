@@ -44,6 +44,7 @@
 #include "mongo/db/repl/oplog_interface_local.h"
 #include "mongo/db/repl/oplog_interface_mock.h"
 #include "mongo/db/repl/rollback_impl.h"
+#include "mongo/db/repl/rollback_impl_gen.h"
 #include "mongo/db/repl/rollback_test_fixture.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
 #include "mongo/db/s/type_shard_identity.h"
@@ -55,6 +56,7 @@
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/uuid.h"
 
 namespace {
@@ -97,6 +99,7 @@ public:
      * represented by 'uuid', or kEmptyVector if that namespace wasn't found in '_uuidToObjsMap'.
      */
     const std::vector<BSONObj>& docsDeletedForNamespace_forTest(UUID uuid) const& final {
+        stdx::lock_guard<Latch> lk(_mutex);
         auto iter = _uuidToObjsMap.find(uuid);
         if (iter == _uuidToObjsMap.end()) {
             return kEmptyVector;
@@ -104,10 +107,19 @@ public:
         return iter->second;
     }
 
+    /**
+     * Makes writing the rollback file for 'nss' fail with 'error'.
+     */
+    void failWritingRollbackFileForNamespace(NamespaceString nss, Status error) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _failedNamespace = std::move(nss);
+        _writeError = std::move(error);
+    }
+
 protected:
     /**
      * Saves documents that would be deleted in '_uuidToObjsMap', rather than writing them out to a
-     * file.
+     * file. May be called concurrently by several rollback data file writers.
      */
     void _writeRollbackFileForNamespace(OperationContext* opCtx,
                                         UUID uuid,
@@ -117,6 +129,12 @@ protected:
               "Simulating writing a rollback file for namespace {nss_ns} with uuid {uuid}",
               "nss_ns"_attr = nss.ns(),
               "uuid"_attr = uuid);
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_failedNamespace == nss) {
+                uassertStatusOK(_writeError);
+            }
+        }
         for (auto&& id : idSet) {
             LOGV2(21648,
                   "Looking up {id_jsonString_JsonStringFormat_LegacyStrict}",
@@ -124,14 +142,20 @@ protected:
                       id.jsonString(JsonStringFormat::LegacyStrict));
             auto document = _findDocumentById(opCtx, uuid, nss, id.firstElement());
             if (document) {
+                stdx::lock_guard<Latch> lk(_mutex);
                 _uuidToObjsMap[uuid].push_back(*document);
             }
         }
+        stdx::lock_guard<Latch> lk(_mutex);
         _listener->onRollbackFileWrittenForNamespace(std::move(uuid), std::move(nss));
     }
 
 private:
+    // Guards the members below, which concurrent rollback data file writers access.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("RollbackImplForTest::_mutex");
     stdx::unordered_map<UUID, std::vector<BSONObj>, UUID::Hash> _uuidToObjsMap;
+    boost::optional<NamespaceString> _failedNamespace;
+    Status _writeError = Status::OK();
 };
 
 const std::vector<BSONObj> RollbackImplForTest::kEmptyVector;
@@ -1213,6 +1237,123 @@ TEST_F(RollbackImplTest, RollbackProperlySavesFilesWhenCreateCollAndInsertsAreRo
                                SimpleBSONObjComparator::kInstance.makeEqualTo()));
 }
 
+TEST_F(RollbackImplTest, RollbackSavesFilesForSeveralNamespacesWithConcurrentWriters) {
+    const auto oldWriterThreads = gRollbackDataFileWriterThreads.load();
+    ON_BLOCK_EXIT([oldWriterThreads] { gRollbackDataFileWriterThreads.store(oldWriterThreads); });
+    gRollbackDataFileWriterThreads.store(3);
+
+    const auto commonOp = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({commonOp});
+    ASSERT_OK(_insertOplogEntry(commonOp.first));
+    _storageInterface->setStableTimestamp(nullptr, Timestamp(1, 1));
+
+    // Use more namespaces than writer threads, so that some threads write several files.
+    std::vector<std::pair<UUID, NamespaceString>> collections;
+    for (int i = 0; i < 5; ++i) {
+        const auto uuid = UUID::gen();
+        const auto nss = NamespaceString("db.coll" + std::to_string(i));
+        _initializeCollection(_opCtx.get(), uuid, nss);
+        for (int j = 0; j <= i; ++j) {
+            _insertDocAndGenerateOplogEntry(BSON("_id" << j << "coll" << i), uuid, nss);
+        }
+        collections.emplace_back(uuid, nss);
+    }
+
+    std::set<NamespaceString> namespacesWritten;
+    _onRollbackFileWrittenForNamespaceFn = [&](UUID, NamespaceString nss) {
+        namespacesWritten.insert(std::move(nss));
+    };
+
+    ASSERT_OK(_rollback->runRollback(_opCtx.get()));
+
+    ASSERT_EQ(namespacesWritten.size(), collections.size());
+    for (int i = 0; i < static_cast<int>(collections.size()); ++i) {
+        const auto& [uuid, nss] = collections[i];
+        ASSERT_EQ(namespacesWritten.count(nss), 1UL);
+
+        std::vector<BSONObj> expectedObjs;
+        for (int j = 0; j <= i; ++j) {
+            expectedObjs.push_back(BSON("_id" << j << "coll" << i));
+        }
+        const auto& deletedObjs = _rollback->docsDeletedForNamespace_forTest(uuid);
+        ASSERT_EQ(deletedObjs.size(), expectedObjs.size());
+        ASSERT(std::is_permutation(deletedObjs.begin(),
+                                   deletedObjs.end(),
+                                   expectedObjs.begin(),
+                                   expectedObjs.end(),
+                                   SimpleBSONObjComparator::kInstance.makeEqualTo()));
+    }
+}
+
+TEST_F(RollbackImplTest, RollbackSummaryReportsPhaseDurations) {
+    const auto commonOp = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({commonOp});
+    ASSERT_OK(_insertOplogEntry(commonOp.first));
+    _storageInterface->setStableTimestamp(nullptr, Timestamp(1, 1));
+
+    const auto nss = NamespaceString("db.people");
+    const auto uuid = UUID::gen();
+    _initializeCollection(_opCtx.get(), uuid, nss);
+    _insertDocAndGenerateOplogEntry(BSON("_id" << 0), uuid, nss);
+
+    startCapturingLogMessages();
+    ASSERT_OK(_rollback->runRollback(_opCtx.get()));
+    stopCapturingLogMessages();
+
+    boost::optional<BSONObj> phaseDurations;
+    for (auto&& message : getCapturedBSONFormatLogMessages()) {
+        if (message["id"].numberInt() == 21612) {
+            phaseDurations = message["attr"]["phaseDurationsMillis"].Obj().getOwned();
+        }
+    }
+    ASSERT(phaseDurations);
+
+    // Every phase of a complete rollback is reported, in the order the phases ran.
+    const std::vector<std::string> expectedPhases{"transitionToRollback",
+                                                  "findCommonPoint",
+                                                  "waitForIndexBuilds",
+                                                  "abortPreparedTransactions",
+                                                  "findRecordStoreCounts",
+                                                  "writeRollbackFiles",
+                                                  "recoverToStableTimestamp",
+                                                  "recoverFromOplog",
+                                                  "correctRecordStoreCounts",
+                                                  "reconstructPreparedTransactions",
+                                                  "triggerOpObserver"};
+    std::vector<std::string> phases;
+    for (auto&& elem : *phaseDurations) {
+        ASSERT(elem.isNumber());
+        ASSERT_GTE(elem.numberLong(), 0);
+        phases.push_back(elem.fieldName());
+    }
+    ASSERT(phases == expectedPhases);
+}
+
+DEATH_TEST_F(RollbackImplTest,
+             RollbackFailsIfAConcurrentWriterFailsToSaveItsFile,
+             "Failed to write the rollback file for namespace db.coll2") {
+    gRollbackDataFileWriterThreads.store(3);
+
+    const auto commonOp = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({commonOp});
+    ASSERT_OK(_insertOplogEntry(commonOp.first));
+    _storageInterface->setStableTimestamp(nullptr, Timestamp(1, 1));
+
+    for (int i = 0; i < 5; ++i) {
+        const auto uuid = UUID::gen();
+        const auto nss = NamespaceString("db.coll" + std::to_string(i));
+        _initializeCollection(_opCtx.get(), uuid, nss);
+        _insertDocAndGenerateOplogEntry(BSON("_id" << i), uuid, nss);
+    }
+    _rollback->failWritingRollbackFileForNamespace(
+        NamespaceString("db.coll2"),
+        Status(ErrorCodes::OperationFailed, "simulated rollback file write failure"));
+
+    // The error of the writer is returned as the status of the phase, which is fatal.
+    auto status = _rollback->runRollback(_opCtx.get());
+    LOGV2(5023427, "mongod did not crash when expected; status: {status}", "status"_attr = status);
+}
+
 DEATH_TEST_F(RollbackImplTest,
              InvariantFailureIfNamespaceIsMissingWhenWritingRollbackFiles,
              "unexpectedly missing in the CollectionCatalog") {
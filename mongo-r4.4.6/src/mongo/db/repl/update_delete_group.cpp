@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/update_delete_group.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/db/repl/oplog_applier_impl.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Bounds the amount of work that is rolled back and retried on a write conflict.
+const auto kUpdateDeleteGroupMaxGroupSize = write_ops::insertVectorMaxBytes;
+
+// Limit number of ops in a single group.
+constexpr auto kUpdateDeleteGroupMaxOpCount = 64;
+
+bool isUpdateOrDelete(const OplogEntry& entry) {
+    return entry.getOpType() == OpTypeEnum::kUpdate || entry.getOpType() == OpTypeEnum::kDelete;
+}
+
+}  // namespace
+
+UpdateDeleteGroup::UpdateDeleteGroup(std::vector<const OplogEntry*>* ops,
+                                     OperationContext* opCtx,
+                                     UpdateDeleteGroup::Mode mode)
+    : _doNotGroupBeforePoint(ops->cbegin()), _end(ops->cend()), _opCtx(opCtx), _mode(mode) {}
+
+StatusWith<UpdateDeleteGroup::ConstIterator> UpdateDeleteGroup::groupAndApplyUpdatesAndDeletes(
+    ConstIterator it) {
+    const auto& entry = **it;
+
+    // The following conditions must be met before attempting to group the oplog entries starting
+    // at 'it':
+    // 1) We are applying in steady state replication. Initial sync and recovery expect some of
+    //    these operations to fail and handle each failure individually;
+    // 2) The CRUD operation must be an update or a delete;
+    // 3) The namespace cannot be a capped collection;
+    // 4) We have not attempted to group this operation during a previous call to this function.
+    if (_mode != Mode::kSecondary) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "Can only group update and delete operations in steady state replication.");
+    }
+    if (!isUpdateOrDelete(entry)) {
+        return Status(ErrorCodes::TypeMismatch, "Can only group update and delete operations.");
+    }
+    if (entry.isForCappedCollection) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "Cannot group update and delete operations on capped collections.");
+    }
+    if (it <= _doNotGroupBeforePoint) {
+        return Status(ErrorCodes::InvalidPath,
+                      "Cannot group an operation that we previously attempted to group.");
+    }
+
+    // Make sure to include the first op in the group size.
+    size_t groupSize = entry.getObject().objsize();
+    auto opCount = std::vector<const OplogEntry*>::size_type(1);
+    auto groupNamespace = entry.getNss();
+
+    // Search for the op that delimits this group. See InsertGroup::groupAndApplyInserts().
+    auto endOfGroupableOpsIterator =
+        std::find_if(it + 1, _end, [&](const OplogEntry* nextEntry) -> bool {
+            groupSize += nextEntry->getObject().objsize();
+            opCount += 1;
+
+            // Only add the op to this group if it passes the criteria.
+            return !isUpdateOrDelete(*nextEntry)             // Must be an update or a delete.
+                || nextEntry->getNss() != groupNamespace     // Must be in the same namespace.
+                || groupSize > kUpdateDeleteGroupMaxGroupSize  // Must not grow too large.
+                || opCount > kUpdateDeleteGroupMaxOpCount;     // Limit number of ops in a group.
+        });
+
+    // See if we were able to create a group that contains more than a single op.
+    if (std::distance(it, endOfGroupableOpsIterator) == 1) {
+        return Status(ErrorCodes::NoSuchKey,
+                      "Not able to create a group with more than a single update or delete");
+    }
+
+    try {
+        uassertStatusOK(
+            applyGroupedUpdatesAndDeletes(_opCtx, it, endOfGroupableOpsIterator, _mode));
+        // It succeeded, advance the iterator to the end of the group.
+        return endOfGroupableOpsIterator - 1;
+    } catch (...) {
+        // The group failed, log and fall through to the application of individual ops, which
+        // handle the failures that may be tolerated.
+        auto status = exceptionToStatus();
+        LOGV2_DEBUG(5023402,
+                    2,
+                    "Error applying updates and deletes as a group. Applying them individually",
+                    "firstOp"_attr = redact(entry.getRaw()),
+                    "numOps"_attr = std::distance(it, endOfGroupableOpsIterator),
+                    "error"_attr = redact(status));
+
+        // Avoid quadratic run time from a failed group by not retrying until we are beyond this
+        // group of ops.
+        _doNotGroupBeforePoint = endOfGroupableOpsIterator - 1;
+
+        return status;
+    }
+
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace repl
+}  // namespace mongo
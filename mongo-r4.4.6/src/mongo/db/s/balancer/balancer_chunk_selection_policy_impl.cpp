@@ -39,6 +39,7 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/db/s/balancer/chunk_statistics_registry.h"
 #include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/bits.h"
@@ -110,6 +111,34 @@ StatusWith<DistributionStatus> createCollectionDistributionStatus(
         }
     }
 
+    // Attach the load of each chunk for the balancer cost model, unless some chunk has not been
+    // reported yet, in which case the collection is balanced by chunk count until it is
+    if (balancerUseCostModel.load()) {
+        const auto& chunkStatistics = ChunkStatisticsRegistry::get(opCtx);
+        const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+
+        auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+        bool allChunksReported = true;
+
+        for (const auto& chunkEntry : chunkMgr->chunks()) {
+            const auto load = chunkStatistics.getChunkLoad(chunkEntry.getShardId(),
+                                                           chunkMgr->getns(),
+                                                           chunkEntry.getMin(),
+                                                           chunkEntry.getMax(),
+                                                           now);
+            if (!load) {
+                allChunksReported = false;
+                break;
+            }
+
+            chunkLoads.emplace(chunkEntry.getMin(), *load);
+        }
+
+        if (allChunksReported) {
+            distribution.setChunkLoads(std::move(chunkLoads));
+        }
+    }
+
     return {std::move(distribution)};
 }
 
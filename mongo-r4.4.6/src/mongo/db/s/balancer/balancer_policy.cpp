@@ -33,9 +33,11 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include <cmath>
 #include <random>
 
 #include "mongo/db/s/balancer/type_migration.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
@@ -112,6 +114,18 @@ const vector<ChunkType>& DistributionStatus::getChunks(const ShardId& shardId) c
     return i->second;
 }
 
+void DistributionStatus::setChunkLoads(BSONObjIndexedMap<ChunkLoad> chunkLoads) {
+    _chunkLoads.emplace(std::move(chunkLoads));
+}
+
+const ChunkLoad& DistributionStatus::getChunkLoad(const ChunkType& chunk) const {
+    invariant(_chunkLoads);
+    const auto it = _chunkLoads->find(chunk.getMin());
+    invariant(it != _chunkLoads->end());
+
+    return it->second;
+}
+
 Status DistributionStatus::addRangeToZone(const ZoneRange& range) {
     const auto minIntersect = _zoneRanges.upper_bound(range.min);
     const auto maxIntersect = _zoneRanges.upper_bound(range.max);
@@ -524,6 +538,22 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             continue;
         }
 
+        if (distribution.hasChunkLoads()) {
+            const double writeWeight = balancerCostModelWriteWeight.load();
+
+            while (_singleZoneBalanceByCost(shardStats,
+                                            distribution,
+                                            tag,
+                                            writeWeight,
+                                            &migrations,
+                                            usedShards,
+                                            forceJumbo
+                                                ? MoveChunkRequest::ForceJumbo::kForceBalancer
+                                                : MoveChunkRequest::ForceJumbo::kDoNotForce))
+                ;
+            continue;
+        }
+
         // Calculate the rounded optimal number of chunks per shard
         const size_t idealNumberOfChunksPerShardForTag =
             (size_t)std::roundf(totalNumberOfChunksWithTag / (float)totalNumberOfShardsWithTag);
@@ -648,6 +678,153 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleZoneBalanceByCost(const ShardStatisticsVector& shardStats,
+                                              const DistributionStatus& distribution,
+                                              const string& tag,
+                                              double writeWeight,
+                                              vector<MigrateInfo>* migrations,
+                                              set<ShardId>* usedShards,
+                                              MoveChunkRequest::ForceJumbo forceJumbo) {
+    // Totals of the zone, which normalize the data size and the write rate of its chunks
+    double totalBytes = 0;
+    double totalWrites = 0;
+
+    for (const auto& stat : shardStats) {
+        for (const auto& chunk : distribution.getChunks(stat.shardId)) {
+            if (distribution.getTagForChunk(chunk) != tag)
+                continue;
+
+            const auto& load = distribution.getChunkLoad(chunk);
+            totalBytes += load.dataSizeBytes;
+            totalWrites += load.writesPerSecond;
+        }
+    }
+
+    const auto chunkCost = [&](const ChunkLoad& load) {
+        return (totalBytes > 0 ? load.dataSizeBytes / totalBytes : 0) +
+            writeWeight * (totalWrites > 0 ? load.writesPerSecond / totalWrites : 0);
+    };
+
+    const auto shardCost = [&](const ShardId& shardId) {
+        double cost = 0;
+        for (const auto& chunk : distribution.getChunks(shardId)) {
+            if (distribution.getTagForChunk(chunk) == tag) {
+                cost += chunkCost(distribution.getChunkLoad(chunk));
+            }
+        }
+        return cost;
+    };
+
+    ShardId from;
+    ShardId to;
+    double maxCost = 0;
+    double minCost = numeric_limits<double>::max();
+    double totalCost = 0;
+    size_t totalNumberOfShardsWithTag = 0;
+
+    for (const auto& stat : shardStats) {
+        const double cost = shardCost(stat.shardId);
+        totalCost += cost;
+
+        if (tag.empty() || stat.shardTags.count(tag)) {
+            totalNumberOfShardsWithTag++;
+        }
+
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        if (cost > maxCost) {
+            from = stat.shardId;
+            maxCost = cost;
+        }
+
+        if (cost < minCost && isShardSuitableReceiver(stat, tag).isOK()) {
+            to = stat.shardId;
+            minCost = cost;
+        }
+    }
+
+    if (!from.isValid())
+        return false;
+
+    if (!to.isValid()) {
+        if (migrations->empty()) {
+            LOGV2(5023414, "No available shards to take chunks for zone", "zone"_attr = tag);
+        }
+        return false;
+    }
+
+    if (from == to || totalNumberOfShardsWithTag == 0)
+        return false;
+
+    const double idealCost = totalCost / totalNumberOfShardsWithTag;
+    const double imbalance = maxCost - minCost;
+    const double imbalanceThreshold = balancerCostImbalanceThreshold.load() * idealCost;
+
+    LOGV2_DEBUG(5023413,
+                1,
+                "Balancing single zone by cost",
+                "namespace"_attr = distribution.nss().ns(),
+                "zone"_attr = tag,
+                "fromShardId"_attr = from,
+                "fromShardCost"_attr = maxCost,
+                "toShardId"_attr = to,
+                "toShardCost"_attr = minCost,
+                "idealCost"_attr = idealCost,
+                "imbalanceThreshold"_attr = imbalanceThreshold);
+
+    // Check whether it is necessary to balance within this zone
+    if (imbalance <= imbalanceThreshold)
+        return false;
+
+    // Moving a chunk of cost c changes the difference between the two shards from D to |D - 2c|,
+    // so pick the chunk which reduces it the most per byte moved, preferring smaller chunks
+    const ChunkType* best = nullptr;
+    double bestScore = 0;
+    long long bestBytes = 0;
+    unsigned numJumboChunks = 0;
+
+    for (const auto& chunk : distribution.getChunks(from)) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo()) {
+            numJumboChunks++;
+            continue;
+        }
+
+        const auto& load = distribution.getChunkLoad(chunk);
+        const double gain = imbalance - std::abs(imbalance - 2 * chunkCost(load));
+        if (gain <= 0)
+            continue;
+
+        const double score = gain / std::max<long long>(load.dataSizeBytes, 1);
+        if (!best || score > bestScore || (score == bestScore && load.dataSizeBytes < bestBytes)) {
+            best = &chunk;
+            bestScore = score;
+            bestBytes = load.dataSizeBytes;
+        }
+    }
+
+    if (best) {
+        migrations->emplace_back(to, *best, forceJumbo, MigrateInfo::chunksImbalance);
+        invariant(usedShards->insert(from).second);
+        invariant(usedShards->insert(to).second);
+        return true;
+    }
+
+    if (numJumboChunks) {
+        LOGV2_WARNING(5023415,
+                      "Shard has no chunks for zone which can be moved to balance its cost",
+                      "shardId"_attr = from,
+                      "namespace"_attr = distribution.nss().ns(),
+                      "zone"_attr = tag,
+                      "numJumboChunks"_attr = numJumboChunks);
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
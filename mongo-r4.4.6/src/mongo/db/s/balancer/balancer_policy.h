@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <set>
 #include <vector>
 
@@ -77,6 +78,14 @@ struct MigrateInfo {
     MigrationReason reason;
 };
 
+/**
+ * Estimated load of a chunk, as reported by the shard which owns it.
+ */
+struct ChunkLoad {
+    long long dataSizeBytes{0};
+    double writesPerSecond{0};
+};
+
 typedef std::vector<ClusterStatistics::ShardStatistics> ShardStatisticsVector;
 typedef std::map<ShardId, std::vector<ChunkType>> ShardToChunksMap;
 
@@ -152,6 +161,24 @@ public:
      */
     std::string getTagForChunk(const ChunkType& chunk) const;
 
+    /**
+     * Sets the load of each chunk of the collection, keyed by the chunk's min key, which makes the
+     * balancer use its cost model for this collection. Must contain every chunk.
+     */
+    void setChunkLoads(BSONObjIndexedMap<ChunkLoad> chunkLoads);
+
+    /**
+     * Returns whether setChunkLoads() was called.
+     */
+    bool hasChunkLoads() const {
+        return _chunkLoads.has_value();
+    }
+
+    /**
+     * Returns the load of the specified chunk. May only be called if hasChunkLoads() is true.
+     */
+    const ChunkLoad& getChunkLoad(const ChunkType& chunk) const;
+
     /**
      * Returns a BSON/string representation of this distribution status.
      */
@@ -170,6 +197,9 @@ private:
 
     // Set of all zones defined for this collection
     std::set<std::string> _allTags;
+
+    // Map of chunk min key to the load of the chunk, if reported for all chunks
+    boost::optional<BSONObjIndexedMap<ChunkLoad>> _chunkLoads;
 };
 
 class BalancerPolicy {
@@ -191,7 +221,8 @@ public:
      *
      * The balancing logic calculates the optimum number of chunks per shard for each zone and if
      * any of the shards have chunks, which are sufficiently higher than this number, suggests
-     * moving chunks to shards, which are under this number.
+     * moving chunks to shards, which are under this number. If the balancer cost model is enabled
+     * and the distribution has the load of each chunk, balances the cost of the shards instead.
      *
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
@@ -248,6 +279,21 @@ private:
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards,
                                    MoveChunkRequest::ForceJumbo forceJumbo);
+
+    /**
+     * Same as _singleZoneBalance, but balances the cost of the shards rather than their number of
+     * chunks. The cost of a chunk is its share of the data size of the zone plus its share of the
+     * write rate of the zone, multiplied by 'writeWeight'. Moves a chunk from the shard with the
+     * highest cost to the one with the lowest if they differ by more than the imbalance threshold,
+     * choosing the chunk which reduces their difference the most per byte moved.
+     */
+    static bool _singleZoneBalanceByCost(const ShardStatisticsVector& shardStats,
+                                         const DistributionStatus& distribution,
+                                         const std::string& tag,
+                                         double writeWeight,
+                                         std::vector<MigrateInfo>* migrations,
+                                         std::set<ShardId>* usedShards,
+                                         MoveChunkRequest::ForceJumbo forceJumbo);
 };
 
 }  // namespace mongo
@@ -110,6 +110,27 @@ std::pair<ShardStatisticsVector, ShardToChunksMap> generateCluster(
     return std::make_pair(std::move(shardStats), std::move(chunkMap));
 }
 
+/**
+ * Returns the load of each chunk generated by generateCluster for the specified shards, assigning
+ * 'loads' to the chunks in the order in which they were generated.
+ */
+BSONObjIndexedMap<ChunkLoad> generateChunkLoads(const ShardStatisticsVector& shardStats,
+                                                const ShardToChunksMap& chunkMap,
+                                                const vector<ChunkLoad>& loads) {
+    auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+
+    auto loadIt = loads.begin();
+    for (const auto& stat : shardStats) {
+        for (const auto& chunk : chunkMap.at(stat.shardId)) {
+            invariant(loadIt != loads.end());
+            chunkLoads.emplace(chunk.getMin(), *loadIt++);
+        }
+    }
+    invariant(loadIt == loads.end());
+
+    return chunkLoads;
+}
+
 std::vector<MigrateInfo> balanceChunks(const ShardStatisticsVector& shardStats,
                                        const DistributionStatus& distribution,
                                        bool shouldAggressivelyBalance,
@@ -692,6 +713,66 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false, false).empty());
 }
 
+TEST(BalancerPolicy, CostModelMovesWriteHotChunkAwayFromBalancedChunkCount) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 2}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.setChunkLoads(
+        generateChunkLoads(cluster.first,
+                           cluster.second,
+                           {{1 << 20, 100}, {1 << 20, 100}, {1 << 20, 0}, {1 << 20, 0}}));
+
+    const auto migrations(balanceChunks(cluster.first, distribution, false, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_EQ(MigrateInfo::chunksImbalance, migrations[0].reason);
+}
+
+TEST(BalancerPolicy, CostModelPrefersSmallestChunkWhichReducesImbalance) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 12, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 1}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.setChunkLoads(generateChunkLoads(
+        cluster.first, cluster.second, {{8 << 20, 0}, {2 << 20, 0}, {2 << 20, 0}, {2 << 20, 0}}));
+
+    const auto migrations(balanceChunks(cluster.first, distribution, false, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, CostModelDoesNotMoveChunksWithinImbalanceThreshold) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 11, false, emptyTagSet, emptyShardVersion), 1},
+         {ShardStatistics(kShardId1, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 3}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.setChunkLoads(generateChunkLoads(
+        cluster.first, cluster.second, {{11 << 20, 10}, {4 << 20, 3}, {3 << 20, 3}, {3 << 20, 3}}));
+
+    ASSERT(balanceChunks(cluster.first, distribution, false, false).empty());
+}
+
+TEST(BalancerPolicy, CostModelDoesNotMoveJumboChunks) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 1},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    cluster.second[kShardId0][0].setJumbo(true);
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.setChunkLoads(generateChunkLoads(cluster.first, cluster.second, {{10 << 20, 5}}));
+
+    ASSERT(balanceChunks(cluster.first, distribution, false, false).empty());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/balancer/chunk_statistics_registry.h"
+
+#include <algorithm>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getChunkStatisticsRegistry =
+    ServiceContext::declareDecoration<ChunkStatisticsRegistry>();
+
+}  // namespace
+
+ChunkStatisticsRegistry& ChunkStatisticsRegistry::get(ServiceContext* serviceContext) {
+    return getChunkStatisticsRegistry(serviceContext);
+}
+
+ChunkStatisticsRegistry& ChunkStatisticsRegistry::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+Milliseconds ChunkStatisticsRegistry::maxReportAge() {
+    return Seconds(3 * chunkStatisticsReportIntervalSecs);
+}
+
+void ChunkStatisticsRegistry::noteReport(const ConfigsvrReportChunkStatistics& report,
+                                         Date_t now) {
+    const ShardId shardId(report.getShard().toString());
+    const double periodSecs = std::max<long long>(report.getPeriodMillis(), 1) / 1000.0;
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto& entry = _shards[shardId];
+
+    std::map<NamespaceString, ReportedChunks> collections;
+
+    for (const auto& coll : report.getCollections()) {
+        const auto& chunks = coll.getChunks();
+        if (chunks.empty()) {
+            continue;
+        }
+
+        // Shards do not track the size of each chunk, so split the size of the collection evenly
+        // between the chunks which the shard owns
+        const long long chunkSizeBytes = coll.getDataSizeBytes() / (long long)chunks.size();
+
+        const auto previous = entry.collections.find(coll.getNs());
+
+        auto reportedChunks =
+            SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ReportedChunk>();
+
+        for (const auto& chunk : chunks) {
+            double writesPerSecond = chunk.getNumWrites() / periodSecs;
+
+            if (previous != entry.collections.end()) {
+                auto it = previous->second.find(chunk.getMin());
+                if (it != previous->second.end() &&
+                    SimpleBSONObjComparator::kInstance.evaluate(it->second.max ==
+                                                                chunk.getMax())) {
+                    writesPerSecond = kWriteRateSmoothing * writesPerSecond +
+                        (1 - kWriteRateSmoothing) * it->second.load.writesPerSecond;
+                }
+            }
+
+            reportedChunks.emplace(chunk.getMin().getOwned(),
+                                   ReportedChunk{chunk.getMax().getOwned(),
+                                                 ChunkLoad{chunkSizeBytes, writesPerSecond}});
+        }
+
+        collections.emplace(coll.getNs(), std::move(reportedChunks));
+    }
+
+    entry.report =
+        ShardReport{now, report.getTotalSizeBytes(), report.getMongoVersion().toString()};
+    entry.collections = std::move(collections);
+}
+
+boost::optional<ChunkStatisticsRegistry::ShardReport> ChunkStatisticsRegistry::getShardReport(
+    const ShardId& shardId, Date_t now) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    const auto entry = _getFreshEntry(lk, shardId, now);
+    if (!entry) {
+        return boost::none;
+    }
+
+    return entry->report;
+}
+
+boost::optional<ChunkLoad> ChunkStatisticsRegistry::getChunkLoad(const ShardId& shardId,
+                                                                 const NamespaceString& nss,
+                                                                 const BSONObj& min,
+                                                                 const BSONObj& max,
+                                                                 Date_t now) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    const auto entry = _getFreshEntry(lk, shardId, now);
+    if (!entry) {
+        return boost::none;
+    }
+
+    const auto collIt = entry->collections.find(nss);
+    if (collIt == entry->collections.end()) {
+        return boost::none;
+    }
+
+    const auto chunkIt = collIt->second.find(min);
+    if (chunkIt == collIt->second.end() ||
+        !SimpleBSONObjComparator::kInstance.evaluate(chunkIt->second.max == max)) {
+        return boost::none;
+    }
+
+    return chunkIt->second.load;
+}
+
+const ChunkStatisticsRegistry::ShardEntry* ChunkStatisticsRegistry::_getFreshEntry(
+    WithLock, const ShardId& shardId, Date_t now) const {
+    const auto it = _shards.find(shardId);
+    if (it == _shards.end() || now - it->second.report.receivedAt > maxReportAge()) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+}  // namespace mongo
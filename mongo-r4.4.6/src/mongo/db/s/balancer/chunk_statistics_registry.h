@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+#include <string>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/s/balancer/balancer_policy.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/s/request_types/report_chunk_statistics_gen.h"
+#include "mongo/s/shard_id.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Keeps the statistics which the primary of each shard periodically pushes to the config server
+ * through _configsvrReportChunkStatistics. The balancer uses them instead of polling every shard
+ * for its size and version on each round, and to estimate the load of each chunk for its cost
+ * model. The statistics are only kept in memory, so they are empty after the config server primary
+ * changes until the shards report again.
+ */
+class ChunkStatisticsRegistry {
+    ChunkStatisticsRegistry(const ChunkStatisticsRegistry&) = delete;
+    ChunkStatisticsRegistry& operator=(const ChunkStatisticsRegistry&) = delete;
+
+public:
+    /**
+     * Weight of the write rate of the latest report in the moving average of the write rate of a
+     * chunk.
+     */
+    static constexpr double kWriteRateSmoothing = 0.5;
+
+    struct ShardReport {
+        Date_t receivedAt;
+        long long totalSizeBytes{0};
+        std::string mongoVersion;
+    };
+
+    ChunkStatisticsRegistry() = default;
+
+    static ChunkStatisticsRegistry& get(ServiceContext* serviceContext);
+    static ChunkStatisticsRegistry& get(OperationContext* opCtx);
+
+    /**
+     * Returns how long the report of a shard may be used after it was received. Allows for two
+     * missed reports before the balancer falls back to polling the shard.
+     */
+    static Milliseconds maxReportAge();
+
+    /**
+     * Replaces the statistics of the reporting shard with the ones in 'report'. The chunks which
+     * the shard no longer reports, for instance because they were split or moved, are forgotten.
+     */
+    void noteReport(const ConfigsvrReportChunkStatistics& report, Date_t now);
+
+    /**
+     * Returns the latest report of the specified shard, or boost::none if it has not reported
+     * within maxReportAge().
+     */
+    boost::optional<ShardReport> getShardReport(const ShardId& shardId, Date_t now) const;
+
+    /**
+     * Returns the load of the chunk [min, max) of 'nss' on the specified shard, or boost::none if
+     * the shard has not reported a chunk with exactly these bounds within maxReportAge().
+     */
+    boost::optional<ChunkLoad> getChunkLoad(const ShardId& shardId,
+                                            const NamespaceString& nss,
+                                            const BSONObj& min,
+                                            const BSONObj& max,
+                                            Date_t now) const;
+
+private:
+    struct ReportedChunk {
+        BSONObj max;
+        ChunkLoad load;
+    };
+
+    // Map of chunk min key to the reported chunk
+    using ReportedChunks = BSONObjIndexedMap<ReportedChunk>;
+
+    struct ShardEntry {
+        ShardReport report;
+        std::map<NamespaceString, ReportedChunks> collections;
+    };
+
+    // Returns the entry of the specified shard if its report is recent enough
+    const ShardEntry* _getFreshEntry(WithLock, const ShardId& shardId, Date_t now) const;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ChunkStatisticsRegistry::_mutex");
+
+    std::map<ShardId, ShardEntry> _shards;
+};
+
+}  // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/balancer/chunk_statistics_registry.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const ShardId kShardId("shard0");
+
+ChunkWriteStatistics makeChunk(int min, int max, long long numWrites) {
+    ChunkWriteStatistics chunk;
+    chunk.setMin(BSON("x" << min));
+    chunk.setMax(BSON("x" << max));
+    chunk.setNumWrites(numWrites);
+    chunk.setBytesWritten(numWrites * 100);
+    return chunk;
+}
+
+ConfigsvrReportChunkStatistics makeReport(long long dataSizeBytes,
+                                          std::vector<ChunkWriteStatistics> chunks) {
+    CollectionChunkStatistics coll;
+    coll.setNs(kNss);
+    coll.setDataSizeBytes(dataSizeBytes);
+    coll.setChunks(std::move(chunks));
+
+    ConfigsvrReportChunkStatistics report;
+    report.setDbName(NamespaceString::kAdminDb);
+    report.setShard(kShardId.toString());
+    report.setMongoVersion("4.4.6");
+    report.setTotalSizeBytes(10 << 20);
+    report.setPeriodMillis(10 * 1000);
+    report.setCollections({coll});
+    return report;
+}
+
+TEST(ChunkStatisticsRegistry, ReportsAreOnlyUsedWhileFresh) {
+    const auto oldReportInterval = chunkStatisticsReportIntervalSecs;
+    ON_BLOCK_EXIT([oldReportInterval] { chunkStatisticsReportIntervalSecs = oldReportInterval; });
+    chunkStatisticsReportIntervalSecs = 60;
+    ASSERT_EQ(Milliseconds(Seconds(180)), ChunkStatisticsRegistry::maxReportAge());
+
+    ChunkStatisticsRegistry registry;
+    const auto now = Date_t::now();
+
+    ASSERT_FALSE(registry.getShardReport(kShardId, now));
+
+    registry.noteReport(makeReport(0, {}), now);
+
+    const auto report = registry.getShardReport(kShardId, now);
+    ASSERT(report);
+    ASSERT_EQ(10 << 20, report->totalSizeBytes);
+    ASSERT_EQ("4.4.6", report->mongoVersion);
+
+    ASSERT(registry.getShardReport(kShardId, now + ChunkStatisticsRegistry::maxReportAge()));
+    ASSERT_FALSE(registry.getShardReport(
+        kShardId, now + ChunkStatisticsRegistry::maxReportAge() + Milliseconds(1)));
+}
+
+TEST(ChunkStatisticsRegistry, SplitsCollectionSizeAndAveragesWriteRate) {
+    ChunkStatisticsRegistry registry;
+    const auto now = Date_t::now();
+
+    registry.noteReport(makeReport(1000, {makeChunk(0, 10, 100), makeChunk(10, 20, 0)}), now);
+
+    auto load = registry.getChunkLoad(kShardId, kNss, BSON("x" << 0), BSON("x" << 10), now);
+    ASSERT(load);
+    ASSERT_EQ(500, load->dataSizeBytes);
+    ASSERT_EQ(10.0, load->writesPerSecond);
+
+    registry.noteReport(makeReport(1000, {makeChunk(0, 10, 0), makeChunk(10, 20, 0)}), now);
+
+    load = registry.getChunkLoad(kShardId, kNss, BSON("x" << 0), BSON("x" << 10), now);
+    ASSERT(load);
+    ASSERT_EQ(5.0, load->writesPerSecond);
+}
+
+TEST(ChunkStatisticsRegistry, ForgetsChunksWhichAreNoLongerReported) {
+    ChunkStatisticsRegistry registry;
+    const auto now = Date_t::now();
+
+    registry.noteReport(makeReport(1000, {makeChunk(0, 20, 100)}), now);
+    ASSERT(registry.getChunkLoad(kShardId, kNss, BSON("x" << 0), BSON("x" << 20), now));
+
+    // The chunk was split, so the new chunks do not inherit the write rate of the old one
+    registry.noteReport(makeReport(1000, {makeChunk(0, 10, 0), makeChunk(10, 20, 0)}), now);
+    ASSERT_FALSE(registry.getChunkLoad(kShardId, kNss, BSON("x" << 0), BSON("x" << 20), now));
+
+    const auto load = registry.getChunkLoad(kShardId, kNss, BSON("x" << 0), BSON("x" << 10), now);
+    ASSERT(load);
+    ASSERT_EQ(0.0, load->writesPerSecond);
+}
+
+}  // namespace
+}  // namespace mongo
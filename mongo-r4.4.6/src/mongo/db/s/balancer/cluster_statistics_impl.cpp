@@ -38,6 +38,8 @@
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/s/balancer/chunk_statistics_registry.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
@@ -100,8 +102,9 @@ ClusterStatisticsImpl::~ClusterStatisticsImpl() = default;
 
 StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationContext* opCtx) {
     // Get a list of all the shards that are participating in this balance round along with any
-    // maximum allowed quotas and current utilization. We get the latter by issuing
-    // db.serverStatus() (mem.mapped) to all shards.
+    // maximum allowed quotas and current utilization. We get the latter from the statistics which
+    // the shards periodically push or, for shards which have not reported recently, by issuing
+    // db.serverStatus() (mem.mapped) to them.
     //
     // TODO: skip unresponsive shards and mark information as stale.
     auto shardsStatus = Grid::get(opCtx)->catalogClient()->getAllShards(
@@ -116,7 +119,27 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
 
     std::vector<ShardStatistics> stats;
 
+    const auto& chunkStatistics = ChunkStatisticsRegistry::get(opCtx);
+    const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+
     for (const auto& shard : shards) {
+        std::set<std::string> shardTags;
+
+        for (const auto& shardTag : shard.getTags()) {
+            shardTags.insert(shardTag);
+        }
+
+        // Use the statistics which the shard pushed recently, if any, rather than polling it
+        if (const auto report = chunkStatistics.getShardReport(shard.getName(), now)) {
+            stats.emplace_back(shard.getName(),
+                               shard.getMaxSizeMB(),
+                               report->totalSizeBytes / 1024 / 1024,
+                               shard.getDraining(),
+                               std::move(shardTags),
+                               report->mongoVersion);
+            continue;
+        }
+
         const auto shardSizeStatus = [&]() -> StatusWith<long long> {
             if (!shard.getMaxSizeMB()) {
                 return 0;
@@ -148,12 +171,6 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                   "error"_attr = mongoDVersionStatus.getStatus());
         }
 
-        std::set<std::string> shardTags;
-
-        for (const auto& shardTag : shard.getTags()) {
-            shardTags.insert(shardTag);
-        }
-
         stats.emplace_back(shard.getName(),
                            shard.getMaxSizeMB(),
                            shardSizeStatus.getValue() / 1024 / 1024,
@@ -731,19 +731,25 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(OperationCon
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::unique_lock<Latch> lk(_mutex);
-    auto iter = _cloneLocs.begin();
-
-    for (; iter != _cloneLocs.end(); ++iter) {
+    // Take each record id out of _cloneLocs before fetching its document, so that concurrent
+    // callers, which the recipient uses to clone with several streams, get disjoint batches
+    while (true) {
         // We must always make progress in this method by at least one document because empty
         // return indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
             break;
         }
 
-        auto nextRecordId = *iter;
+        RecordId nextRecordId;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_cloneLocs.empty()) {
+                break;
+            }
 
-        lk.unlock();
+            nextRecordId = *_cloneLocs.begin();
+            _cloneLocs.erase(_cloneLocs.begin());
+        }
 
         Snapshotted<BSONObj> doc;
         if (collection->findDoc(opCtx, nextRecordId, &doc)) {
@@ -751,18 +757,16 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(OperationCon
             // that we take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
                 (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
-
+                // Leave the document for the next batch
+                stdx::lock_guard<Latch> lk(_mutex);
+                _cloneLocs.insert(nextRecordId);
                 break;
             }
 
             arrBuilder->append(doc.value());
             ShardingStatistics::get(opCtx).countDocsClonedOnDonor.addAndFetch(1);
         }
-
-        lk.lock();
     }
-
-    _cloneLocs.erase(_cloneLocs.begin(), iter);
 }
 
 uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
@@ -783,6 +787,7 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
     // attempt to move it, scan the collection directly.
     if (_jumboChunkCloneState && _forceJumbo) {
         try {
+            stdx::lock_guard<Latch> lk(_jumboChunkCloneMutex);
             _nextCloneBatchFromIndexScan(opCtx, collection, arrBuilder);
             return Status::OK();
         } catch (const DBException& ex) {
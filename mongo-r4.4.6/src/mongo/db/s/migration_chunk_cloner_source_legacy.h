@@ -149,8 +149,8 @@ public:
 
     /**
      * Called by the recipient shard. Populates the passed BSONArrayBuilder with a set of documents,
-     * which are part of the initial clone sequence. Assumes that there is only one active caller
-     * to this method at a time (otherwise, it can cause corruption/crash).
+     * which are part of the initial clone sequence. May be called concurrently, in which case each
+     * caller gets a disjoint set of documents.
      *
      * Returns OK status on success. If there were documents returned in the result argument, this
      * method should be called more times until the result is empty. If it returns failure, it is
@@ -347,6 +347,11 @@ private:
 
     std::unique_ptr<SessionCatalogMigrationSource> _sessionCatalogSource;
 
+    // Serializes the callers of nextCloneBatch while cloning a jumbo chunk, since only one of them
+    // at a time may advance the index scan
+    Mutex _jumboChunkCloneMutex =
+        MONGO_MAKE_LATCH("MigrationChunkClonerSourceLegacy::_jumboChunkCloneMutex");
+
     // Protects the entries below
     Mutex _mutex = MONGO_MAKE_LATCH("MigrationChunkClonerSourceLegacy::_mutex");
 
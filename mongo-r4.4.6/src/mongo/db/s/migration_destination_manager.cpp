@@ -34,6 +34,7 @@
 #include "mongo/db/s/migration_destination_manager.h"
 
 #include <list>
+#include <memory>
 #include <vector>
 
 #include "mongo/db/auth/authorization_session.h"
@@ -65,6 +66,7 @@
 #include "mongo/db/storage/remove_saver.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
@@ -74,6 +76,7 @@
 #include "mongo/util/producer_consumer_queue.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -470,53 +473,52 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
 repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     std::function<void(OperationContext*, BSONObj)> insertBatchFn,
-    std::function<BSONObj(OperationContext*)> fetchBatchFn) {
+    std::function<BSONObj(OperationContext*)> fetchBatchFn,
+    int numCloneStreams) {
+    invariant(numCloneStreams >= 1);
 
-    SingleProducerSingleConsumerQueue<BSONObj>::Options options;
-    options.maxQueueDepth = 1;
+    auto serviceContext = opCtx->getServiceContext();
 
-    SingleProducerSingleConsumerQueue<BSONObj> batches(options);
-    repl::OpTime lastOpApplied;
+    // Each stream fetches batches from the donor and hands them to an inserter thread of its own.
+    // The first stream fetches on this thread and the others on threads of their own.
+    struct CloneStream {
+        explicit CloneStream(const SingleProducerSingleConsumerQueue<BSONObj>::Options& options)
+            : batches(options) {}
 
-    stdx::thread inserterThread{[&] {
-        Client::initKillableThread("chunkInserter", opCtx->getServiceContext());
+        SingleProducerSingleConsumerQueue<BSONObj> batches;
+        stdx::thread fetcherThread;
+        stdx::thread inserterThread;
+        repl::OpTime lastOpApplied;
+    };
 
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = makeGuard([&] {
-            batches.closeConsumerEnd();
-            lastOpApplied = repl::ReplClientInfo::forClient(inserterOpCtx->getClient()).getLastOp();
-        });
+    SingleProducerSingleConsumerQueue<BSONObj>::Options options;
+    options.maxQueueDepth = 1;
 
-        try {
-            while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
-                }
-                insertBatchFn(inserterOpCtx.get(), arr);
-            }
-        } catch (...) {
-            stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(lk, opCtx, ErrorCodes::Error(51008));
-            LOGV2(21999,
-                  "Batch insertion failed: {error}",
-                  "Batch insertion failed",
-                  "error"_attr = redact(exceptionToStatus()));
-        }
-    }};
+    std::vector<std::unique_ptr<CloneStream>> streams;
+    for (int i = 0; i < numCloneStreams; i++) {
+        streams.push_back(std::make_unique<CloneStream>(options));
+    }
 
+    // Set if this thread stops fetching before the donor ran out of documents, so that the other
+    // fetcher threads stop as well
+    AtomicWord<bool> cloneStopped{false};
 
-    {
-        auto inserterThreadJoinGuard = makeGuard([&] {
-            batches.closeProducerEnd();
-            inserterThread.join();
-        });
+    // The helper threads use killOp to propagate errors to this thread
+    auto interruptCaller = [&](ErrorCodes::Error code) {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        serviceContext->killOperation(lk, opCtx, code);
+    };
 
-        while (true) {
-            auto res = fetchBatchFn(opCtx);
+    auto callerInterrupted = [&] {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        return opCtx->isKillPending();
+    };
+
+    auto fetchBatches = [&](OperationContext* fetcherOpCtx, CloneStream* stream) {
+        while (!cloneStopped.load() && !callerInterrupted()) {
+            auto res = fetchBatchFn(fetcherOpCtx);
             try {
-                batches.push(res.getOwned(), opCtx);
+                stream->batches.push(res.getOwned(), fetcherOpCtx);
                 auto arr = res["objects"].Obj();
                 if (arr.isEmpty()) {
                     break;
@@ -525,11 +527,85 @@ repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
                 break;
             }
         }
+    };
+
+    for (auto& streamPtr : streams) {
+        auto stream = streamPtr.get();
+        stream->inserterThread = stdx::thread([&, stream] {
+            Client::initKillableThread("chunkInserter", serviceContext);
+
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            auto consumerGuard = makeGuard([&] {
+                stream->batches.closeConsumerEnd();
+                stream->lastOpApplied =
+                    repl::ReplClientInfo::forClient(inserterOpCtx->getClient()).getLastOp();
+            });
+
+            try {
+                while (true) {
+                    auto nextBatch = stream->batches.pop(inserterOpCtx.get());
+                    auto arr = nextBatch["objects"].Obj();
+                    if (arr.isEmpty()) {
+                        return;
+                    }
+                    insertBatchFn(inserterOpCtx.get(), arr);
+                }
+            } catch (...) {
+                interruptCaller(ErrorCodes::Error(51008));
+                LOGV2(21999,
+                      "Batch insertion failed: {error}",
+                      "Batch insertion failed",
+                      "error"_attr = redact(exceptionToStatus()));
+            }
+        });
+    }
+
+    for (size_t i = 1; i < streams.size(); i++) {
+        auto stream = streams[i].get();
+        stream->fetcherThread = stdx::thread([&, stream] {
+            Client::initKillableThread("chunkFetcher", serviceContext);
+
+            auto fetcherOpCtx = Client::getCurrent()->makeOperationContext();
+            auto producerGuard = makeGuard([&] { stream->batches.closeProducerEnd(); });
+
+            try {
+                fetchBatches(fetcherOpCtx.get(), stream);
+            } catch (...) {
+                const auto status = exceptionToStatus();
+                interruptCaller(status.code());
+                LOGV2(5023417, "Batch fetch failed", "error"_attr = redact(status));
+            }
+        });
+    }
+
+    {
+        auto streamsJoinGuard = makeGuard([&] {
+            streams.front()->batches.closeProducerEnd();
+
+            for (auto& stream : streams) {
+                if (stream->fetcherThread.joinable()) {
+                    stream->fetcherThread.join();
+                }
+                stream->inserterThread.join();
+            }
+        });
+
+        // The other streams may still be cloning documents when this one runs out, so only stop
+        // them on error
+        auto stopGuard = makeGuard([&] { cloneStopped.store(true); });
+        fetchBatches(opCtx, streams.front().get());
+        stopGuard.dismiss();
     }  // This scope ensures that the guard is destroyed
 
-    // This check is necessary because the consumer thread uses killOp to propagate errors to the
-    // producer thread (this thread)
+    // This check is necessary because the helper threads use killOp to propagate errors to this
+    // thread
     opCtx->checkForInterrupt();
+
+    repl::OpTime lastOpApplied;
+    for (const auto& stream : streams) {
+        lastOpApplied = std::max(lastOpApplied, stream->lastOpApplied);
+    }
+
     return lastOpApplied;
 }
 
@@ -1050,6 +1126,14 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
 
         _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
+        // Serializes the secondary throttle of the clone streams, which checks the session of the
+        // outer operation context in and out
+        Mutex secondaryThrottleMutex =
+            MONGO_MAKE_LATCH("MigrationDestinationManager::secondaryThrottleMutex");
+
+        // Measures the clone rate against migrateCloneMaxBytesPerSec
+        Timer cloneTimer;
+
         auto assertNotAborted = [&](OperationContext* opCtx) {
             opCtx->checkForInterrupt();
             outerOpCtx->checkForInterrupt();
@@ -1089,14 +1173,17 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
                         str::stream() << "Insert of " << insertOp.getDocuments()[i] << " failed.");
                 }
 
+                long long totalClonedBytes;
                 {
                     stdx::lock_guard<Latch> statsLock(_mutex);
                     _numCloned += batchNumCloned;
                     ShardingStatistics::get(opCtx).countDocsClonedOnRecipient.addAndFetch(
                         batchNumCloned);
                     _clonedBytes += batchClonedBytes;
+                    totalClonedBytes = _clonedBytes;
                 }
                 if (_writeConcern.needToWaitForOtherNodes()) {
+                    stdx::lock_guard<Latch> throttleLock(secondaryThrottleMutex);
                     runWithoutSession(
                         outerOpCtx,
                         [&] {
@@ -1120,6 +1207,17 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
                 }
 
                 sleepmillis(migrateCloneInsertionBatchDelayMS.load());
+
+                // Pace all the clone streams together so that they stay within the bandwidth
+                // budget of the migration
+                const long long maxBytesPerSec = migrateCloneMaxBytesPerSec.load();
+                if (maxBytesPerSec > 0) {
+                    const Milliseconds budgetedElapsed(totalClonedBytes * 1000 / maxBytesPerSec);
+                    const Milliseconds elapsed(cloneTimer.millis());
+                    if (elapsed < budgetedElapsed) {
+                        opCtx->sleepFor(budgetedElapsed - elapsed);
+                    }
+                }
             }
         };
 
@@ -1140,7 +1238,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
 
         // If running on a replicated system, we'll need to flush the docs we cloned to the
         // secondaries
-        lastOpApplied = cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        lastOpApplied = cloneDocumentsFromDonor(
+            opCtx, insertBatchFn, fetchBatchFn, chunkMigrationConcurrency.load());
 
         timing.done(3);
         migrateThreadHangAtStep3.pauseWhileSet();
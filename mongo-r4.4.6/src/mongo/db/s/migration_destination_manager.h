@@ -114,12 +114,16 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard. Runs 'numCloneStreams' streams, each of which fetches
+     * batches with 'fetchBatchFn' and inserts them with 'insertBatchFn' on a thread of its own,
+     * until the donor returns an empty batch. If there is more than one stream, both functions must
+     * be safe to call concurrently.
      */
     static repl::OpTime cloneDocumentsFromDonor(
         OperationContext* opCtx,
         std::function<void(OperationContext*, BSONObj)> insertBatchFn,
-        std::function<BSONObj(OperationContext*)> fetchBatchFn);
+        std::function<BSONObj(OperationContext*)> fetchBatchFn,
+        int numCloneStreams = 1);
 
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
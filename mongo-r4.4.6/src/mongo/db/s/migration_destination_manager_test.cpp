@@ -30,6 +30,9 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/s/migration_destination_manager.h"
+
+#include <algorithm>
+
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
 
@@ -105,6 +108,49 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that with several clone streams every document which the donor hands out is inserted
+// exactly once.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithSeveralStreams) {
+    const int kNumBatches = 20;
+
+    auto mutex = MONGO_MAKE_LATCH();
+    int numBatchesFetched = 0;
+    std::vector<int> insertedIds;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONArrayBuilder arrayBuilder;
+        {
+            stdx::lock_guard<Latch> lk(mutex);
+            if (numBatchesFetched < kNumBatches) {
+                const int batch = numBatchesFetched++;
+                for (int i = 0; i < 3; i++) {
+                    arrayBuilder.append(createDocument(batch * 3 + i));
+                }
+            }
+        }
+
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<Latch> lk(mutex);
+        for (auto&& docToClone : docs) {
+            insertedIds.push_back(docToClone.Obj()["_id"].numberInt());
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, 4);
+
+    std::sort(insertedIds.begin(), insertedIds.end());
+    ASSERT_EQ(size_t(kNumBatches * 3), insertedIds.size());
+    for (int i = 0; i < kNumBatches * 3; i++) {
+        ASSERT_EQ(i, insertedIds[i]);
+    }
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
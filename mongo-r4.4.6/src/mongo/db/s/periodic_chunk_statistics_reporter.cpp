@@ -0,0 +1,242 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/periodic_chunk_statistics_reporter.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/s/catalog_cache.h"
+#include "mongo/s/chunk_writes_tracker.h"
+#include "mongo/s/client/shard_registry.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/request_types/report_chunk_statistics_gen.h"
+#include "mongo/util/version.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getPeriodicChunkStatisticsReporter =
+    ServiceContext::declareDecoration<PeriodicChunkStatisticsReporter>();
+
+// Writes taken from the tracker of each reported chunk
+using TakenWrites = std::vector<
+    std::pair<std::shared_ptr<ChunkWritesTracker>, ChunkWritesTracker::WriteStatistics>>;
+
+/**
+ * Collects the statistics of the chunks which this shard owns in 'nss' and takes their writes
+ * since the previous report, recording them in 'takenWrites' so they can be restored if the report
+ * cannot be sent. Returns boost::none if the collection is not sharded or its metadata is not
+ * known yet.
+ */
+boost::optional<CollectionChunkStatistics> collectCollectionStatistics(
+    OperationContext* opCtx,
+    const NamespaceString& nss,
+    const ShardId& shardId,
+    TakenWrites* takenWrites) {
+    AutoGetCollectionForRead autoColl(opCtx, nss);
+    const auto coll = autoColl.getCollection();
+    if (!coll) {
+        return boost::none;
+    }
+
+    const auto metadata = CollectionShardingState::get(opCtx, nss)->getCurrentMetadataIfKnown();
+    if (!metadata || !metadata->isSharded()) {
+        return boost::none;
+    }
+
+    std::vector<ChunkWriteStatistics> chunks;
+
+    for (const auto& chunk : (*metadata)->getChunkManager()->chunks()) {
+        if (chunk.getShardId() != shardId) {
+            continue;
+        }
+
+        const auto writesTracker = chunk.getWritesTracker();
+        const auto writes = writesTracker->takeWritesSinceReport();
+        takenWrites->emplace_back(writesTracker, writes);
+
+        ChunkWriteStatistics chunkStats;
+        chunkStats.setMin(chunk.getMin());
+        chunkStats.setMax(chunk.getMax());
+        chunkStats.setNumWrites(writes.numWrites);
+        chunkStats.setBytesWritten(writes.bytesWritten);
+        chunks.push_back(std::move(chunkStats));
+    }
+
+    CollectionChunkStatistics collStats;
+    collStats.setNs(nss);
+    collStats.setDataSizeBytes(coll->dataSize(opCtx));
+    collStats.setChunks(std::move(chunks));
+    return collStats;
+}
+
+/**
+ * Sends the statistics of this shard for the last 'period' to the config server.
+ */
+Status reportChunkStatistics(OperationContext* opCtx, Milliseconds period) {
+    const auto shardId = ShardingState::get(opCtx)->shardId();
+
+    TakenWrites takenWrites;
+    std::vector<CollectionChunkStatistics> collections;
+
+    for (const auto& collVersion :
+         Grid::get(opCtx)->catalogCache()->getCachedCollectionVersions()) {
+        if (auto collStats =
+                collectCollectionStatistics(opCtx, collVersion.first, shardId, &takenWrites)) {
+            collections.push_back(std::move(*collStats));
+        }
+    }
+
+    const auto status = [&]() -> Status {
+        BSONObj listDatabasesResponse;
+        DBDirectClient client(opCtx);
+        if (!client.runCommand("admin", BSON("listDatabases" << 1), listDatabasesResponse)) {
+            return getStatusFromCommandResult(listDatabasesResponse);
+        }
+
+        ConfigsvrReportChunkStatistics request;
+        request.setDbName(NamespaceString::kAdminDb);
+        request.setShard(shardId.toString());
+        request.setMongoVersion(VersionInfoInterface::instance().version());
+        request.setTotalSizeBytes(listDatabasesResponse["totalSize"].safeNumberLong());
+        request.setPeriodMillis(durationCount<Milliseconds>(period));
+        request.setCollections(std::move(collections));
+
+        auto configShard = Grid::get(opCtx)->shardRegistry()->getConfigShard();
+        auto cmdResponse = configShard->runCommandWithFixedRetryAttempts(
+            opCtx,
+            ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+            NamespaceString::kAdminDb.toString(),
+            request.toBSON({}),
+            Shard::RetryPolicy::kIdempotent);
+
+        return Shard::CommandResponse::getEffectiveStatus(std::move(cmdResponse));
+    }();
+
+    if (!status.isOK()) {
+        // Report the writes with the next statistics instead
+        for (const auto& [writesTracker, writes] : takenWrites) {
+            writesTracker->addWritesSinceReport(writes);
+        }
+    }
+
+    return status;
+}
+
+PeriodicJobAnchor launchChunkStatisticsReporter(ServiceContext* serviceContext) {
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    const Milliseconds interval = Seconds(chunkStatisticsReportIntervalSecs);
+
+    // The writes of a report which could not be sent are reported with the next one, so the period
+    // of a report runs from the last one which was sent, or from the start of the reporter.
+    PeriodicRunner::PeriodicJob job(
+        "PeriodicChunkStatisticsReporter",
+        [lastReportAt = serviceContext->getFastClockSource()->now()](Client* client) mutable {
+            auto opCtx = client->makeOperationContext();
+
+            const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+
+            try {
+                uassertStatusOK(reportChunkStatistics(opCtx.get(), now - lastReportAt));
+                lastReportAt = now;
+            } catch (const DBException& ex) {
+                LOGV2(5023416,
+                      "Failed to report chunk statistics to the config server",
+                      "error"_attr = redact(ex.toStatus()));
+            }
+        },
+        interval);
+    auto chunkStatisticsReporter = periodicRunner->makeJob(std::move(job));
+    chunkStatisticsReporter.start();
+    return chunkStatisticsReporter;
+}
+
+}  // namespace
+
+PeriodicChunkStatisticsReporter& PeriodicChunkStatisticsReporter::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+PeriodicChunkStatisticsReporter& PeriodicChunkStatisticsReporter::get(
+    ServiceContext* serviceContext) {
+    return getPeriodicChunkStatisticsReporter(serviceContext);
+}
+
+void PeriodicChunkStatisticsReporter::onShardingInitialization(ServiceContext* serviceContext,
+                                                               bool isPrimary) {
+    _isPrimary = isPrimary;
+    if (isPrimary && chunkStatisticsReportIntervalSecs > 0 &&
+        !_chunkStatisticsReporter.isValid()) {
+        _chunkStatisticsReporter = launchChunkStatisticsReporter(serviceContext);
+    }
+}
+
+void PeriodicChunkStatisticsReporter::onStepUp(ServiceContext* serviceContext) {
+    if (!_isPrimary) {
+        _isPrimary = true;
+        if (chunkStatisticsReportIntervalSecs == 0) {
+            return;
+        }
+
+        if (!_chunkStatisticsReporter.isValid()) {
+            _chunkStatisticsReporter = launchChunkStatisticsReporter(serviceContext);
+        } else {
+            _chunkStatisticsReporter.resume();
+        }
+    }
+}
+
+void PeriodicChunkStatisticsReporter::onStepDown() {
+    if (_isPrimary) {
+        _isPrimary = false;
+        if (_chunkStatisticsReporter.isValid()) {
+            _chunkStatisticsReporter.pause();
+        }
+    }
+}
+
+}  // namespace mongo
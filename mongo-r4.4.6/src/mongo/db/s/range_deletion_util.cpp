@@ -56,6 +56,7 @@
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/persistent_task_store.h"
 #include "mongo/db/s/range_deletion_task_gen.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/s/wait_for_majority_service.h"
 #include "mongo/db/service_context.h"
@@ -63,6 +64,7 @@
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/logv2/log.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/future_util.h"
 
 namespace mongo {
@@ -113,19 +115,76 @@ bool collectionUuidHasChanged(const NamespaceString& nss,
     return false;
 }
 
+/**
+ * State carried from one batch of a range deletion to the next. Only touched by the batches of a
+ * single deletion, which run one after another.
+ */
+struct RangeDeletionProgress {
+    // Shard key of the last document deleted. The next batch starts its index scan here rather
+    // than at the lower bound of the range, so that it does not walk again over the index entries
+    // which the earlier batches removed.
+    boost::optional<BSONObj> resumeKey;
+
+    // Size of the last successful batch and how long it took, used to pace the next one.
+    int lastBatchDocs{0};
+    long long lastBatchBytes{0};
+    Milliseconds lastBatchDuration{0};
+};
+
+/**
+ * The wait before the next batch of a range deletion. When rangeDeleterMaxDeletesPerSec or
+ * rangeDeleterMaxBytesPerSec is set, the wait is whatever remains of the time the last batch was
+ * allowed to take at those rates; otherwise it is the fixed delay between batches.
+ *
+ * AsyncTry converts the delay to Milliseconds before every iteration, so the wait is recomputed
+ * after each batch.
+ */
+class BatchDelay {
+public:
+    BatchDelay(std::shared_ptr<const RangeDeletionProgress> progress, Milliseconds fixedDelay)
+        : _progress(std::move(progress)), _fixedDelay(fixedDelay) {}
+
+    explicit operator Milliseconds() const {
+        const auto maxDeletesPerSec = rangeDeleterMaxDeletesPerSec.load();
+        const auto maxBytesPerSec = rangeDeleterMaxBytesPerSec.load();
+        if (maxDeletesPerSec == 0 && maxBytesPerSec == 0) {
+            return _fixedDelay;
+        }
+
+        Milliseconds allowed{0};
+        if (maxDeletesPerSec > 0) {
+            allowed = std::max(
+                allowed, Milliseconds(_progress->lastBatchDocs * 1000LL / maxDeletesPerSec));
+        }
+        if (maxBytesPerSec > 0) {
+            allowed = std::max(
+                allowed, Milliseconds(_progress->lastBatchBytes * 1000LL / maxBytesPerSec));
+        }
+        return std::max(Milliseconds(0), allowed - _progress->lastBatchDuration);
+    }
+
+private:
+    std::shared_ptr<const RangeDeletionProgress> _progress;
+    Milliseconds _fixedDelay;
+};
+
 /**
  * Performs the deletion of up to numDocsToRemovePerBatch entries within the range in progress. Must
- * be called under the collection lock.
+ * be called under the collection lock. Scans the shard key index from 'progress.resumeKey' when it
+ * is set, and advances it past the documents deleted.
  *
  * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
- * the range failed.
+ * the range failed. The total size of the deleted documents is returned in 'bytesDeleted'.
  */
 StatusWith<int> deleteNextBatch(OperationContext* opCtx,
                                 Collection* collection,
                                 BSONObj const& keyPattern,
                                 ChunkRange const& range,
-                                int numDocsToRemovePerBatch) {
+                                int numDocsToRemovePerBatch,
+                                RangeDeletionProgress* progress,
+                                long long* bytesDeleted) {
     invariant(collection != nullptr);
+    *bytesDeleted = 0;
 
     auto const& nss = collection->ns();
 
@@ -148,7 +207,7 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
         return Helpers::toKeyFormat(indexKeyPattern.extendRangeBound(key, false));
     };
 
-    const auto min = extend(range.getMin());
+    const auto min = extend(progress->resumeKey ? *progress->resumeKey : range.getMin());
     const auto max = extend(range.getMax());
 
     LOGV2_DEBUG(23766,
@@ -198,6 +257,9 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
 
     PlanYieldPolicy planYieldPolicy(exec.get(), PlanExecutor::YIELD_MANUAL);
 
+    const ShardKeyPattern shardKeyPattern(keyPattern);
+    BSONObj lastShardKeyDeleted;
+
     int numDeleted = 0;
     do {
         BSONObj deletedObj;
@@ -235,9 +297,22 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
 
         invariant(PlanExecutor::ADVANCED == state);
         ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(1);
+        *bytesDeleted += deletedObj.objsize();
+
+        // Documents without a complete shard key are still deleted, but cannot be resumed from.
+        auto shardKey = shardKeyPattern.extractShardKeyFromDoc(deletedObj);
+        if (!shardKey.isEmpty()) {
+            lastShardKeyDeleted = std::move(shardKey);
+        }
 
     } while (++numDeleted < numDocsToRemovePerBatch);
 
+    // Only advance once every deletion in the batch has committed, so that a batch which fails
+    // part way is retried from where it started.
+    if (!lastShardKeyDeleted.isEmpty()) {
+        progress->resumeKey = std::move(lastShardKeyDeleted);
+    }
+
     return numDeleted;
 }
 
@@ -302,6 +377,7 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                                           const boost::optional<UUID>& migrationId,
                                           int numDocsToRemovePerBatch,
                                           Milliseconds delayBetweenBatches) {
+    auto progress = std::make_shared<RangeDeletionProgress>();
     return AsyncTry([=] {
                return withTemporaryOperationContext([=](OperationContext* opCtx) {
                    LOGV2_DEBUG(5346200,
@@ -326,8 +402,19 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                            "deletion task. No need to delete documents.",
                            !collectionUuidHasChanged(nss, collection, collectionUuid));
 
-                   auto numDeleted = uassertStatusOK(deleteNextBatch(
-                       opCtx, collection, keyPattern, range, numDocsToRemovePerBatch));
+                   const auto batchStart = executor->now();
+                   long long bytesDeleted = 0;
+                   auto numDeleted = uassertStatusOK(deleteNextBatch(opCtx,
+                                                                     collection,
+                                                                     keyPattern,
+                                                                     range,
+                                                                     numDocsToRemovePerBatch,
+                                                                     progress.get(),
+                                                                     &bytesDeleted));
+
+                   progress->lastBatchDocs = numDeleted;
+                   progress->lastBatchBytes = bytesDeleted;
+                   progress->lastBatchDuration = executor->now() - batchStart;
 
                    LOGV2_DEBUG(
                        23769,
@@ -354,7 +441,7 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                 ErrorCodes::isShutdownError(swNumDeleted.getStatus()) ||
                 ErrorCodes::isNotPrimaryError(swNumDeleted.getStatus());
         })
-        .withDelayBetweenIterations(delayBetweenBatches)
+        .withDelayBetweenIterations(BatchDelay(progress, delayBetweenBatches))
         .on(executor)
         .ignoreValue();
 }
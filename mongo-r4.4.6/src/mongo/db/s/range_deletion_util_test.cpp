@@ -43,6 +43,7 @@
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -692,6 +693,48 @@ TEST_F(RangeDeleterTest, RemoveDocumentsInRangeRespectsDelayInBetweenBatches) {
     ASSERT_EQUALS(dbclient.count(kNss, BSONObj()), 0);
 }
 
+TEST_F(RangeDeleterTest, RemoveDocumentsInRangePacesBatchesByMaxDeletesPerSec) {
+    const ChunkRange range(BSON(kShardKey << 0), BSON(kShardKey << 10));
+    // More documents than the batch size.
+    const auto numDocsToInsert = 3;
+    const auto numDocsToRemovePerBatch = 1;
+    auto queriesComplete = SemiFuture<void>::makeReady();
+
+    // One document every 10 milliseconds, in place of the fixed delay of 0.
+    rangeDeleterMaxDeletesPerSec.store(100);
+    ON_BLOCK_EXIT([] { rangeDeleterMaxDeletesPerSec.store(0); });
+
+    // Insert documents in range.
+    DBDirectClient dbclient(operationContext());
+    for (auto i = 0; i < numDocsToInsert; ++i) {
+        dbclient.insert(kNss.toString(), BSON(kShardKey << i));
+    }
+
+    auto cleanupComplete =
+        removeDocumentsInRange(executor(),
+                               std::move(queriesComplete),
+                               kNss,
+                               uuid(),
+                               kShardKeyPattern,
+                               range,
+                               boost::none,
+                               numDocsToRemovePerBatch,
+                               Seconds(0) /* delayForActiveQueriesOnSecondariesToComplete */,
+                               Milliseconds(0) /* delayBetweenBatches */);
+
+    // A best-effort check that cleanup has not completed without advancing the clock.
+    sleepsecs(1);
+    ASSERT_FALSE(cleanupComplete.isReady());
+
+    while (!cleanupComplete.isReady()) {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(network());
+        network()->advanceTime(network()->now() + Milliseconds(1));
+    }
+
+    cleanupComplete.get();
+    ASSERT_EQUALS(dbclient.count(kNss, BSONObj()), 0);
+}
+
 TEST_F(RangeDeleterTest, RemoveDocumentsInRangeRespectsOrphanCleanupDelay) {
     const ChunkRange range(BSON(kShardKey << 0), BSON(kShardKey << 10));
     // More documents than the batch size.
@@ -190,7 +190,7 @@ void incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
     // collations.
     auto chunk = chunkManager.findIntersectingChunkWithSimpleCollation(shardKey);
     auto chunkWritesTracker = chunk.getWritesTracker();
-    chunkWritesTracker->addBytesWritten(dataWritten);
+    chunkWritesTracker->addWrite(dataWritten);
     // Don't trigger chunk splits from inserts happening due to migration since
     // we don't necessarily own that chunk yet
     if (!fromMigrate) {
@@ -49,6 +49,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/periodic_balancer_config_refresher.h"
+#include "mongo/db/s/periodic_chunk_statistics_reporter.h"
 #include "mongo/db/s/read_only_catalog_cache_loader.h"
 #include "mongo/db/s/shard_server_catalog_cache_loader.h"
 #include "mongo/db/s/sharding_config_optime_gossip.h"
@@ -273,6 +274,8 @@ void ShardingInitializationMongoD::initializeShardingEnvironmentOnShardServer(
     ChunkSplitter::get(opCtx).onShardingInitialization(isStandaloneOrPrimary);
     PeriodicBalancerConfigRefresher::get(opCtx).onShardingInitialization(opCtx->getServiceContext(),
                                                                          isStandaloneOrPrimary);
+    PeriodicChunkStatisticsReporter::get(opCtx).onShardingInitialization(opCtx->getServiceContext(),
+                                                                         isStandaloneOrPrimary);
 
     // Start the transaction coordinator service only if the node is the primary of a replica set
     TransactionCoordinatorService::get(opCtx)->onShardingInitialization(
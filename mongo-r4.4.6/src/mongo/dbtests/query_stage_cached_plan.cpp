@@ -404,6 +404,64 @@ TEST_F(QueryStageCachedPlan, DeactivatesEntriesOnReplan) {
     ASSERT_EQ(assertGet(cache->getEntry(*shapeCq))->works, 1U);
 }
 
+TEST_F(QueryStageCachedPlan, ReplanningKeepsBetterPlanAsParameterVariant) {
+    const int oldMaxVariants = internalQueryCacheMaxParameterVariantsPerEntry.load();
+    ON_BLOCK_EXIT([oldMaxVariants] {
+        internalQueryCacheMaxParameterVariantsPerEntry.store(oldMaxVariants);
+    });
+    internalQueryCacheMaxParameterVariantsPerEntry.store(4);
+
+    AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+    Collection* collection = ctx.getCollection();
+    ASSERT(collection);
+
+    // Never run - just used as a key for the cache's get() functions, since all of the other
+    // CanonicalQueries created in this test will have this shape.
+    const auto shapeCq =
+        canonicalQueryFromFilterObj(opCtx(), nss, fromjson("{a: {$gte: 123}, b: {$gte: 123}}"));
+
+    // The index on "a" finds no results right away for this query, while the index on "b" does for
+    // the other one.
+    const auto aIndexCq =
+        canonicalQueryFromFilterObj(opCtx(), nss, fromjson("{a: {$gte: 11}, b: {$gte: 0}}"));
+    const auto bIndexCq =
+        canonicalQueryFromFilterObj(opCtx(), nss, fromjson("{a: {$gte: 0}, b: {$gte: 2}}"));
+
+    PlanCache* cache = CollectionQueryInfo::get(collection).getPlanCache();
+    ASSERT(cache);
+    ASSERT_EQ(cache->get(*shapeCq).state, PlanCache::CacheEntryState::kNotPresent);
+
+    // Without an active entry, replanning caches the plan for the whole shape as usual.
+    forceReplanning(collection, aIndexCq.get());
+    ASSERT_EQ(cache->get(*shapeCq).state, PlanCache::CacheEntryState::kPresentInactive);
+    forceReplanning(collection, aIndexCq.get());
+    ASSERT_EQ(cache->get(*shapeCq).state, PlanCache::CacheEntryState::kPresentActive);
+    const auto entryPlan = assertGet(cache->getEntry(*shapeCq))->plannerData->toString();
+
+    // Replanning the other query picks the index on "b", which is kept for its constants only.
+    forceReplanning(collection, bIndexCq.get());
+    ASSERT_EQ(cache->get(*shapeCq).state, PlanCache::CacheEntryState::kPresentActive);
+    auto entry = assertGet(cache->getEntry(*shapeCq));
+    ASSERT_EQ(entry->plannerData->toString(), entryPlan);
+    ASSERT_EQ(entry->parameterVariants.size(), 1U);
+    ASSERT(entry->findParameterVariant(PlanCache::computeParameters(*bIndexCq)));
+
+    auto result = cache->get(*bIndexCq);
+    ASSERT_EQ(result.state, PlanCache::CacheEntryState::kPresentActive);
+    ASSERT_NE(result.cachedSolution->plannerData->toString(), entryPlan);
+    result = cache->get(*aIndexCq);
+    ASSERT_EQ(result.state, PlanCache::CacheEntryState::kPresentActive);
+    ASSERT_EQ(result.cachedSolution->plannerData->toString(), entryPlan);
+
+    // When replanning picks the plan of the entry again, the entry is replaced the usual way
+    // rather than getting a variant with the same plan.
+    forceReplanning(collection, aIndexCq.get());
+    ASSERT_EQ(cache->get(*shapeCq).state, PlanCache::CacheEntryState::kPresentActive);
+    entry = assertGet(cache->getEntry(*shapeCq));
+    ASSERT_EQ(entry->plannerData->toString(), entryPlan);
+    ASSERT_EQ(entry->parameterVariants.size(), 0U);
+}
+
 TEST_F(QueryStageCachedPlan, EntriesAreNotDeactivatedWhenInactiveEntriesDisabled) {
     // Set the global flag for disabling active entries.
     internalQueryCacheDisableInactiveEntries.store(true);
@@ -521,6 +521,89 @@ TEST_F(QueryStageMultiPlanTest, MPSExplainAllPlans) {
     }
 }
 
+TEST_F(QueryStageMultiPlanTest, MPSStopsWorkingLaggingCandidates) {
+    const double oldRatio = internalQueryPlanEvaluationLaggingCandidateRatio.load();
+    ON_BLOCK_EXIT(
+        [oldRatio] { internalQueryPlanEvaluationLaggingCandidateRatio.store(oldRatio); });
+    internalQueryPlanEvaluationLaggingCandidateRatio.store(10.0);
+
+    // Insert a document to create the collection.
+    insert(BSON("x" << 1));
+
+    const int nDocs = 500;
+
+    auto ws = std::make_unique<WorkingSet>();
+    auto firstPlan = std::make_unique<QueuedDataStage>(_expCtx.get(), ws.get());
+    auto secondPlan = std::make_unique<QueuedDataStage>(_expCtx.get(), ws.get());
+
+    // The second plan only needs time until well after the trial period is over.
+    for (int i = 0; i < nDocs; ++i) {
+        addMember(firstPlan.get(), ws.get(), BSON("x" << 1));
+        secondPlan->pushBack(PlanStage::NEED_TIME);
+    }
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+
+    auto qr = std::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("x" << 1));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    unique_ptr<MultiPlanStage> mps =
+        std::make_unique<MultiPlanStage>(_expCtx.get(), ctx.getCollection(), cq.get());
+    mps->addPlan(std::make_unique<QuerySolution>(), std::move(firstPlan), ws.get());
+    mps->addPlan(std::make_unique<QuerySolution>(), std::move(secondPlan), ws.get());
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(mps->pickBestPlan(&yieldPolicy));
+    ASSERT_EQ(mps->bestPlanIdx(), 0);
+
+    // The second plan was stopped once the first one returned ten results, while the first one
+    // kept going until the end of the trial period.
+    ASSERT_EQ(mps->getChildren()[1]->getStats()->common.works, 10U);
+    ASSERT_EQ(mps->getChildren()[0]->getStats()->common.advanced,
+              static_cast<size_t>(internalQueryPlanEvaluationMaxResults.load()));
+}
+
+TEST_F(QueryStageMultiPlanTest, MPSDoesNotStopCandidatesTiedWithTheLeader) {
+    const double oldRatio = internalQueryPlanEvaluationLaggingCandidateRatio.load();
+    ON_BLOCK_EXIT(
+        [oldRatio] { internalQueryPlanEvaluationLaggingCandidateRatio.store(oldRatio); });
+    internalQueryPlanEvaluationLaggingCandidateRatio.store(0.5);
+
+    // Insert a document to create the collection.
+    insert(BSON("x" << 1));
+
+    const int nDocs = 500;
+
+    auto ws = std::make_unique<WorkingSet>();
+    auto firstPlan = std::make_unique<QueuedDataStage>(_expCtx.get(), ws.get());
+    auto secondPlan = std::make_unique<QueuedDataStage>(_expCtx.get(), ws.get());
+
+    // Both plans return a result on every call to work().
+    for (int i = 0; i < nDocs; ++i) {
+        addMember(firstPlan.get(), ws.get(), BSON("x" << 1));
+        addMember(secondPlan.get(), ws.get(), BSON("x" << 1));
+    }
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+
+    auto qr = std::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("x" << 1));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    unique_ptr<MultiPlanStage> mps =
+        std::make_unique<MultiPlanStage>(_expCtx.get(), ctx.getCollection(), cq.get());
+    mps->addPlan(std::make_unique<QuerySolution>(), std::move(firstPlan), ws.get());
+    mps->addPlan(std::make_unique<QuerySolution>(), std::move(secondPlan), ws.get());
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(mps->pickBestPlan(&yieldPolicy));
+
+    // A ratio below one disables stopping candidates, so both plans ran for the whole trial period.
+    const auto maxEvaluationResults =
+        static_cast<size_t>(internalQueryPlanEvaluationMaxResults.load());
+    ASSERT_EQ(mps->getChildren()[0]->getStats()->common.advanced, maxEvaluationResults);
+    ASSERT_EQ(mps->getChildren()[1]->getStats()->common.advanced, maxEvaluationResults);
+}
+
 // Test that the plan summary only includes stats from the winning plan.
 //
 // This is a regression test for SERVER-20111.
@@ -35,10 +35,12 @@
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/sort.h"
@@ -599,6 +601,101 @@ public:
     }
 };
 
+// Sort the results of an index scan which provides a prefix of the sort, yielding and rewriting
+// every document after each call to work(). The result which ends a run is kept while the run is
+// returned, so it must not point into the storage cursor across those yields.
+class QueryStageSortPrefixYieldsBetweenRuns : public QueryStageSortTestBase {
+public:
+    virtual int numObj() {
+        return 30;
+    }
+
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll =
+            CollectionCatalog::get(&_opCtx).lookupCollectionByNamespace(&_opCtx, nss());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        // Runs of ten documents with the same 'a', whose 'b' values are out of order within the
+        // run and identify the document together with 'a'.
+        for (int i = 0; i < numObj(); ++i) {
+            insert(BSON("a" << i / 10 << "b" << (i * 7) % 10 << "i" << i));
+        }
+        ASSERT_OK(dbtests::createIndex(&_opCtx, ns(), BSON("a" << 1)));
+
+        std::vector<const IndexDescriptor*> indexes;
+        coll->getIndexCatalog()->findIndexesByKeyPattern(&_opCtx, BSON("a" << 1), false, &indexes);
+        ASSERT_EQ(indexes.size(), 1U);
+
+        auto ws = std::make_unique<WorkingSet>();
+        IndexScanParams params(&_opCtx, indexes[0]);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << MINKEY);
+        params.bounds.endKey = BSON("" << MAXKEY);
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        auto ixscan = std::make_unique<IndexScan>(_expCtx.get(), params, ws.get(), nullptr);
+        auto fetchStage = std::make_unique<FetchStage>(
+            _expCtx.get(), ws.get(), std::move(ixscan), nullptr, coll);
+
+        auto sortPattern = BSON("a" << 1 << "b" << 1);
+        auto keyGenStage = std::make_unique<SortKeyGeneratorStage>(
+            _expCtx, std::move(fetchStage), ws.get(), sortPattern);
+        auto sortStage = std::make_unique<SortStageDefault>(_expCtx,
+                                                            ws.get(),
+                                                            SortPattern{sortPattern, _expCtx},
+                                                            0u,
+                                                            maxMemoryUsageBytes(),
+                                                            false,  // addSortKeyMetadata
+                                                            std::move(keyGenStage),
+                                                            SortPattern{BSON("a" << 1), _expCtx});
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_opCtx, std::move(ws), std::move(sortStage), coll, PlanExecutor::NO_YIELD);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        auto exec = std::move(statusWithPlanExecutor.getValue());
+        auto ss = static_cast<SortStage*>(exec->getRootStage());
+
+        int count = 0;
+        int numWorks = 0;
+        BSONObj last;
+        while (!ss->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState status = ss->work(&id);
+            ASSERT_NE(status, PlanStage::FAILURE);
+
+            if (PlanStage::ADVANCED == status) {
+                // The values of the result must be those of the document it was read from.
+                WorkingSetMember* member = exec->getWorkingSet()->get(id);
+                ASSERT(member->hasObj());
+                const BSONObj obj = member->doc.value().toBson();
+                const int i = obj["i"].numberInt();
+                ASSERT_EQ(obj["a"].numberInt(), i / 10);
+                ASSERT_EQ(obj["b"].numberInt(), (i * 7) % 10);
+                if (count > 0) {
+                    ASSERT_LT(dps::compareObjectsAccordingToSort(last, obj, sortPattern), 0);
+                }
+                last = obj.getOwned();
+                ++count;
+            }
+
+            // Yield, and change the size of every document, so that their storage is rewritten
+            exec->saveState();
+            _client.update(ns(),
+                           BSONObj(),
+                           BSON("$set" << BSON("pad" << std::string(++numWorks % 100, 'x'))),
+                           false,  // upsert
+                           true);  // multi
+            exec->restoreState();
+        }
+        ASSERT_EQUALS(numObj(), count);
+    }
+};
+
 class All : public OldStyleSuiteSpecification {
 public:
     All() : OldStyleSuiteSpecification("query_stage_sort") {}
@@ -616,6 +713,7 @@ public:
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
         add<QueryStageSortDeletionInvalidationWithLimit<1>>();
         add<QueryStageSortParallelArrays>();
+        add<QueryStageSortPrefixYieldsBetweenRuns>();
     }
 };
 
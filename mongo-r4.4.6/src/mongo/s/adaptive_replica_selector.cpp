@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/adaptive_replica_selector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/service_context.h"
+#include "mongo/s/mongos_server_parameters_gen.h"
+
+namespace mongo {
+namespace {
+
+const auto getAdaptiveReplicaSelector =
+    ServiceContext::declareDecoration<AdaptiveReplicaSelector>();
+
+}  // namespace
+
+AdaptiveReplicaSelector& AdaptiveReplicaSelector::get(ServiceContext* serviceContext) {
+    return getAdaptiveReplicaSelector(serviceContext);
+}
+
+bool AdaptiveReplicaSelector::isEnabled() {
+    return gAdaptiveReplicaSelection.load();
+}
+
+AdaptiveReplicaSelector::Selection AdaptiveReplicaSelector::selectHosts(
+    std::vector<HostAndPort> candidates, bool hedgingRequested, Date_t now) {
+    invariant(!candidates.empty());
+
+    std::vector<std::pair<double, HostAndPort>> predictions;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto& host : candidates) {
+            const auto prediction = _predictLatencyMillis(lk, host, now);
+            predictions.emplace_back(prediction, std::move(host));
+        }
+    }
+
+    // The candidates are already shuffled, so a stable sort spreads the reads between hosts with
+    // the same prediction
+    std::stable_sort(predictions.begin(),
+                     predictions.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    Selection selection;
+    selection.hosts.push_back(std::move(predictions[0].second));
+    if (hedgingRequested && predictions.size() > 1 &&
+        predictions[0].first > gAdaptiveHedgingLatencyThresholdMS.load()) {
+        selection.hosts.push_back(std::move(predictions[1].second));
+        selection.hedge = true;
+    }
+
+    return selection;
+}
+
+void AdaptiveReplicaSelector::onRequestSent(const std::vector<HostAndPort>& hosts) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (const auto& host : hosts) {
+        ++_hosts[host].inFlight;
+    }
+}
+
+void AdaptiveReplicaSelector::onResponse(const std::vector<HostAndPort>& hosts,
+                                         const boost::optional<HostAndPort>& respondingHost,
+                                         boost::optional<Microseconds> elapsed,
+                                         Date_t now) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (const auto& host : hosts) {
+        auto& stats = _hosts[host];
+        stats.inFlight = std::max(stats.inFlight - 1, 0);
+    }
+
+    if (!respondingHost || !elapsed) {
+        return;
+    }
+
+    auto& stats = _hosts[*respondingHost];
+    const double sampleMillis = durationCount<Microseconds>(*elapsed) / 1000.0;
+    if (!stats.lastResponseAt || now - *stats.lastResponseAt > kStatsLifetime) {
+        stats.latencyMillis = sampleMillis;
+        stats.deviationMillis = sampleMillis / 2;
+    } else {
+        stats.deviationMillis += kDeviationSmoothing *
+            (std::abs(sampleMillis - stats.latencyMillis) - stats.deviationMillis);
+        stats.latencyMillis += kLatencySmoothing * (sampleMillis - stats.latencyMillis);
+    }
+    stats.lastResponseAt = now;
+}
+
+Milliseconds AdaptiveReplicaSelector::getPredictedLatency(const HostAndPort& host,
+                                                          Date_t now) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return Milliseconds(static_cast<long long>(_predictLatencyMillis(lk, host, now)));
+}
+
+double AdaptiveReplicaSelector::_predictLatencyMillis(WithLock,
+                                                      const HostAndPort& host,
+                                                      Date_t now) const {
+    const auto it = _hosts.find(host);
+    if (it == _hosts.end()) {
+        return 0;
+    }
+
+    // Without a recent response, only the outstanding requests tell the host apart
+    const auto& stats = it->second;
+    if (!stats.lastResponseAt || now - *stats.lastResponseAt > kStatsLifetime) {
+        return stats.inFlight;
+    }
+
+    return (stats.latencyMillis + 4 * stats.deviationMillis) * (1 + stats.inFlight);
+}
+
+}  // namespace mongo
@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Chooses which hosts of a shard a read is sent to when its read preference allows several. Keeps,
+ * for each host, a moving average of the latency of its responses and of their deviation from it,
+ * and how many requests from this router it has outstanding. The predicted tail latency of a host
+ * is its average latency plus four deviations, multiplied by the number of requests queued ahead
+ * of this one. Reads go to the host with the lowest prediction, and hedged reads only also go to
+ * the second best host when that prediction exceeds adaptiveHedgingLatencyThresholdMS.
+ *
+ * Hosts without a recent response are predicted to be as fast as their outstanding requests allow,
+ * so that a host which was slow once is probed again after kStatsLifetime rather than avoided
+ * forever.
+ */
+class AdaptiveReplicaSelector {
+    AdaptiveReplicaSelector(const AdaptiveReplicaSelector&) = delete;
+    AdaptiveReplicaSelector& operator=(const AdaptiveReplicaSelector&) = delete;
+
+public:
+    // Weights of the latest sample in the moving averages of the latency and its deviation
+    static constexpr double kLatencySmoothing = 0.125;
+    static constexpr double kDeviationSmoothing = 0.25;
+
+    // How long the statistics of a host are used after its latest response
+    static constexpr Seconds kStatsLifetime{5};
+
+    struct Selection {
+        std::vector<HostAndPort> hosts;
+        bool hedge{false};
+    };
+
+    AdaptiveReplicaSelector() = default;
+
+    static AdaptiveReplicaSelector& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns whether adaptiveReplicaSelection is enabled.
+     */
+    static bool isEnabled();
+
+    /**
+     * Returns the host among 'candidates' with the lowest predicted latency, followed by the second
+     * best when 'hedgingRequested' and the prediction for the best host exceeds the hedging
+     * threshold. 'candidates' must not be empty.
+     */
+    Selection selectHosts(std::vector<HostAndPort> candidates, bool hedgingRequested, Date_t now);
+
+    /**
+     * Counts a request as outstanding against each of 'hosts'.
+     */
+    void onRequestSent(const std::vector<HostAndPort>& hosts);
+
+    /**
+     * Ends the request which was sent to 'hosts'. If 'respondingHost' answered, records the
+     * 'elapsed' time as a sample of its latency.
+     */
+    void onResponse(const std::vector<HostAndPort>& hosts,
+                    const boost::optional<HostAndPort>& respondingHost,
+                    boost::optional<Microseconds> elapsed,
+                    Date_t now);
+
+    /**
+     * Returns the predicted tail latency of 'host'.
+     */
+    Milliseconds getPredictedLatency(const HostAndPort& host, Date_t now) const;
+
+private:
+    struct HostStats {
+        double latencyMillis{0};
+        double deviationMillis{0};
+        int inFlight{0};
+        boost::optional<Date_t> lastResponseAt;
+    };
+
+    double _predictLatencyMillis(WithLock, const HostAndPort& host, Date_t now) const;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("AdaptiveReplicaSelector::_mutex");
+
+    stdx::unordered_map<HostAndPort, HostStats> _hosts;
+};
+
+}  // namespace mongo
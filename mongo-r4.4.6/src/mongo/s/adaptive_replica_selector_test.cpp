@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/adaptive_replica_selector.h"
+
+#include "mongo/s/mongos_server_parameters_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const HostAndPort kHost1("host1", 27017);
+const HostAndPort kHost2("host2", 27017);
+const HostAndPort kHost3("host3", 27017);
+
+class AdaptiveReplicaSelectorTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _savedThreshold = gAdaptiveHedgingLatencyThresholdMS.load();
+        gAdaptiveHedgingLatencyThresholdMS.store(50);
+    }
+
+    void tearDown() override {
+        gAdaptiveHedgingLatencyThresholdMS.store(_savedThreshold);
+    }
+
+    /**
+     * Sends a request to 'host' and records a response from it after 'elapsed'.
+     */
+    void respond(const HostAndPort& host, Milliseconds elapsed) {
+        selector.onRequestSent({host});
+        selector.onResponse({host}, host, Microseconds(elapsed), now);
+    }
+
+    AdaptiveReplicaSelector selector;
+    Date_t now = Date_t::fromMillisSinceEpoch(100000);
+
+private:
+    int _savedThreshold;
+};
+
+TEST_F(AdaptiveReplicaSelectorTest, SelectsHostWithLowestLatency) {
+    respond(kHost1, Milliseconds(20));
+    respond(kHost2, Milliseconds(2));
+    respond(kHost3, Milliseconds(10));
+
+    auto selection = selector.selectHosts({kHost1, kHost2, kHost3}, false, now);
+    ASSERT_EQ(1U, selection.hosts.size());
+    ASSERT_EQ(kHost2, selection.hosts[0]);
+    ASSERT_FALSE(selection.hedge);
+}
+
+TEST_F(AdaptiveReplicaSelectorTest, HedgesOnlyWhenBestHostIsSlowerThanThreshold) {
+    respond(kHost1, Milliseconds(5));
+    respond(kHost2, Milliseconds(8));
+
+    auto selection = selector.selectHosts({kHost1, kHost2}, true, now);
+    ASSERT_EQ(1U, selection.hosts.size());
+    ASSERT_EQ(kHost1, selection.hosts[0]);
+    ASSERT_FALSE(selection.hedge);
+
+    respond(kHost1, Milliseconds(500));
+    respond(kHost2, Milliseconds(400));
+
+    selection = selector.selectHosts({kHost1, kHost2}, true, now);
+    ASSERT_EQ(2U, selection.hosts.size());
+    ASSERT_TRUE(selection.hedge);
+}
+
+TEST_F(AdaptiveReplicaSelectorTest, DoesNotHedgeWhenNotRequested) {
+    respond(kHost1, Milliseconds(500));
+    respond(kHost2, Milliseconds(400));
+
+    auto selection = selector.selectHosts({kHost1, kHost2}, false, now);
+    ASSERT_EQ(1U, selection.hosts.size());
+    ASSERT_FALSE(selection.hedge);
+}
+
+TEST_F(AdaptiveReplicaSelectorTest, OutstandingRequestsPenalizeHost) {
+    respond(kHost1, Milliseconds(10));
+    respond(kHost2, Milliseconds(15));
+    ASSERT_EQ(kHost1, selector.selectHosts({kHost1, kHost2}, false, now).hosts[0]);
+
+    selector.onRequestSent({kHost1});
+    selector.onRequestSent({kHost1});
+    ASSERT_EQ(kHost2, selector.selectHosts({kHost1, kHost2}, false, now).hosts[0]);
+
+    selector.onResponse({kHost1}, boost::none, boost::none, now);
+    selector.onResponse({kHost1}, boost::none, boost::none, now);
+    ASSERT_EQ(kHost1, selector.selectHosts({kHost1, kHost2}, false, now).hosts[0]);
+}
+
+TEST_F(AdaptiveReplicaSelectorTest, StaleStatisticsAreProbedAgain) {
+    respond(kHost1, Milliseconds(200));
+    respond(kHost2, Milliseconds(10));
+    ASSERT_EQ(kHost2, selector.selectHosts({kHost1, kHost2}, false, now).hosts[0]);
+
+    now += AdaptiveReplicaSelector::kStatsLifetime + Seconds(1);
+    respond(kHost2, Milliseconds(10));
+    ASSERT_EQ(kHost1, selector.selectHosts({kHost1, kHost2}, false, now).hosts[0]);
+    ASSERT_EQ(Milliseconds(0), selector.getPredictedLatency(kHost1, now));
+}
+
+TEST_F(AdaptiveReplicaSelectorTest, LatencyIsSmoothedAcrossResponses) {
+    respond(kHost1, Milliseconds(10));
+    ASSERT_EQ(Milliseconds(30), selector.getPredictedLatency(kHost1, now));
+
+    respond(kHost1, Milliseconds(10));
+    ASSERT_LT(selector.getPredictedLatency(kHost1, now), Milliseconds(30));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/s/adaptive_replica_selector.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/hedge_options_util.h"
@@ -75,15 +76,29 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
       _subExecutor(std::move(executor)),
       _subBaton(opCtx->getBaton()->makeSubBaton()) {
 
-    _remotesLeft = requests.size();
+    _remotesLeft = 0;
 
     // Initialize command metadata to handle the read preference.
     _metadataObj = readPreference.toContainingBSON();
 
-    _remotes.reserve(requests.size());
+    addRequests(requests);
+}
+
+void AsyncRequestsSender::addRequests(const std::vector<AsyncRequestsSender::Request>& requests) {
+    _remotesLeft += requests.size();
+
     for (const auto& request : requests) {
+        auto& remote =
+            _remotes.emplace_back(this, request.shardId, request.cmdObj, _remotes.size());
+
+        // If we've been interrupted, the new requests fail the same way as the outstanding ones
+        if (!_interruptStatus.isOK()) {
+            _responseQueue.push(std::move(remote).makeFailedResponse(_interruptStatus));
+            continue;
+        }
+
         // Kick off requests immediately.
-        _remotes.emplace_back(this, request.shardId, request.cmdObj).executeRequest();
+        remote.executeRequest();
     }
 }
 
@@ -148,8 +163,12 @@ AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
 
 AsyncRequestsSender::RemoteData::RemoteData(AsyncRequestsSender* ars,
                                             ShardId shardId,
-                                            BSONObj cmdObj)
-    : _ars(ars), _shardId(std::move(shardId)), _cmdObj(std::move(cmdObj)) {}
+                                            BSONObj cmdObj,
+                                            size_t requestIndex)
+    : _ars(ars),
+      _shardId(std::move(shardId)),
+      _cmdObj(std::move(cmdObj)),
+      _requestIndex(requestIndex) {}
 
 std::shared_ptr<Shard> AsyncRequestsSender::RemoteData::getShard() {
     // TODO: Pass down an OperationContext* to use here.
@@ -162,11 +181,15 @@ void AsyncRequestsSender::RemoteData::executeRequest() {
         .getAsync([this](StatusWith<RemoteCommandOnAnyCallbackArgs> rcr) {
             _done = true;
             if (rcr.isOK()) {
-                _ars->_responseQueue.push(
-                    {std::move(_shardId), rcr.getValue().response, std::move(_shardHostAndPort)});
+                _ars->_responseQueue.push({std::move(_shardId),
+                                           rcr.getValue().response,
+                                           std::move(_shardHostAndPort),
+                                           _requestIndex});
             } else {
-                _ars->_responseQueue.push(
-                    {std::move(_shardId), rcr.getStatus(), std::move(_shardHostAndPort)});
+                _ars->_responseQueue.push({std::move(_shardId),
+                                           rcr.getStatus(),
+                                           std::move(_shardHostAndPort),
+                                           _requestIndex});
             }
         });
 }
@@ -212,6 +235,26 @@ auto AsyncRequestsSender::RemoteData::scheduleRemoteCommand(std::vector<HostAndP
         });
 
     auto hedgeOptions = extractHedgeOptions(_cmdObj, _ars->_readPreference);
+
+    // When several hosts are eligible, pick by their observed latency and load instead of letting
+    // the first connection to any of them win, and only hedge if the best one is predicted to be
+    // slow.
+    auto serviceContext = _ars->_opCtx->getServiceContext();
+    AdaptiveReplicaSelector* selector = nullptr;
+    if (AdaptiveReplicaSelector::isEnabled() && hostAndPorts.size() > 1) {
+        selector = &AdaptiveReplicaSelector::get(serviceContext);
+
+        auto selection = selector->selectHosts(std::move(hostAndPorts),
+                                               hedgeOptions.is_initialized(),
+                                               serviceContext->getFastClockSource()->now());
+        hostAndPorts = std::move(selection.hosts);
+        if (!selection.hedge) {
+            hedgeOptions = boost::none;
+        }
+
+        selector->onRequestSent(hostAndPorts);
+    }
+
     executor::RemoteCommandRequestOnAny request(std::move(hostAndPorts),
                                                 _ars->_db,
                                                 _cmdObj,
@@ -223,14 +266,30 @@ auto AsyncRequestsSender::RemoteData::scheduleRemoteCommand(std::vector<HostAndP
     // future returning variant of scheduleRemoteCommand
     auto [p, f] = makePromiseFuture<RemoteCommandOnAnyCallbackArgs>();
 
-    // Failures to schedule skip the retry loop
-    uassertStatusOK(_ars->_subExecutor->scheduleRemoteCommandOnAny(
+    auto swCallbackHandle = _ars->_subExecutor->scheduleRemoteCommandOnAny(
         request,
         // We have to make a shared_ptr<Promise> here because scheduleRemoteCommand requires
         // copyable callbacks
-        [p = std::make_shared<Promise<RemoteCommandOnAnyCallbackArgs>>(std::move(p))](
-            const RemoteCommandOnAnyCallbackArgs& cbData) { p->emplaceValue(cbData); },
-        *_ars->_subBaton));
+        [p = std::make_shared<Promise<RemoteCommandOnAnyCallbackArgs>>(std::move(p)),
+         selector,
+         serviceContext](const RemoteCommandOnAnyCallbackArgs& cbData) {
+            if (selector) {
+                selector->onResponse(cbData.request.target,
+                                     cbData.response.target,
+                                     cbData.response.elapsed,
+                                     serviceContext->getFastClockSource()->now());
+            }
+            p->emplaceValue(cbData);
+        },
+        *_ars->_subBaton);
+
+    if (!swCallbackHandle.isOK() && selector) {
+        selector->onResponse(
+            request.target, boost::none, boost::none, serviceContext->getFastClockSource()->now());
+    }
+
+    // Failures to schedule skip the retry loop
+    uassertStatusOK(swCallbackHandle);
 
     return std::move(f).semi();
 }
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 #include <vector>
 
 #include "mongo/base/status_with.h"
@@ -124,6 +125,11 @@ public:
         // The exact host on which the remote command was run. Is unset if the shard could not be
         // found or no shard hosts matching the readPreference could be found.
         boost::optional<HostAndPort> shardHostAndPort;
+
+        // Position of the request among all the requests scheduled on the ARS, in the order in
+        // which they were passed to the constructor and to addRequests. Identifies the request
+        // when several requests are sent to the same shard.
+        size_t requestIndex = 0;
     };
 
     /**
@@ -137,6 +143,13 @@ public:
                         const ReadPreferenceSetting& readPreference,
                         Shard::RetryPolicy retryPolicy);
 
+    /**
+     * Schedules more requests on this ARS. Their responses are returned by next() along with the
+     * responses to the requests which are already outstanding. If next() has already observed an
+     * interruption, the requests are not sent and their responses carry the interruption status.
+     */
+    void addRequests(const std::vector<AsyncRequestsSender::Request>& requests);
+
     /**
      * Returns true if responses for all requests have been returned via next().
      */
@@ -174,7 +187,7 @@ private:
         /**
          * Creates a new uninitialized remote state with a command to send.
          */
-        RemoteData(AsyncRequestsSender* ars, ShardId shardId, BSONObj cmdObj);
+        RemoteData(AsyncRequestsSender* ars, ShardId shardId, BSONObj cmdObj, size_t requestIndex);
 
         /**
          * Returns the Shard object associated with this remote.
@@ -192,7 +205,10 @@ private:
          * Extracts a failed response from the remote, given an interruption status.
          */
         Response makeFailedResponse(Status status) && {
-            return {std::move(_shardId), std::move(status), std::move(_shardHostAndPort)};
+            return {std::move(_shardId),
+                    std::move(status),
+                    std::move(_shardHostAndPort),
+                    _requestIndex};
         }
 
         /**
@@ -248,6 +264,9 @@ private:
         // sent.
         boost::optional<HostAndPort> _shardHostAndPort;
 
+        // The position of this request among all the requests scheduled on the ARS.
+        size_t _requestIndex;
+
         // The number of times we've retried sending the command to this remote.
         int _retryCount = 0;
     };
@@ -267,8 +286,10 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
-    // Data tracking the state of our communication with each of the remote nodes.
-    std::vector<RemoteData> _remotes;
+    // Data tracking the state of our communication with each of the remote nodes. The callbacks of
+    // outstanding requests refer to their RemoteData, so it must not move when addRequests appends
+    // more remotes.
+    std::deque<RemoteData> _remotes;
 
     // Number of remotes we haven't returned final results from.
     size_t _remotesLeft;
@@ -42,6 +42,7 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/repl/optime_with.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/bits.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_database.h"
 #include "mongo/s/client/shard_registry.h"
@@ -277,8 +278,12 @@ CatalogCache::RefreshResult CatalogCache::_getCollectionRoutingInfoAt(
             ul.unlock();
 
             auto refreshStatus = [&]() {
+                const Timer waitTimer;
                 Timer t;
-                ON_BLOCK_EXIT([&] { _stats.totalRefreshWaitTimeMicros.addAndFetch(t.micros()); });
+                ON_BLOCK_EXIT([&] {
+                    _stats.totalRefreshWaitTimeMicros.addAndFetch(t.micros());
+                    _stats.refreshWaitLatency.record(waitTimer.elapsed());
+                });
 
                 try {
                     const Milliseconds kReportingInterval{250};
@@ -562,6 +567,135 @@ void CatalogCache::purgeAllDatabases() {
     _collectionsByDb.clear();
 }
 
+std::vector<std::pair<NamespaceString, ChunkVersion>> CatalogCache::getCachedCollectionVersions()
+    const {
+    std::vector<std::pair<NamespaceString, ChunkVersion>> collectionVersions;
+
+    stdx::lock_guard<Latch> lg(_mutex);
+    for (const auto& db : _collectionsByDb) {
+        for (const auto& coll : db.second) {
+            const auto& collEntry = coll.second;
+            if (collEntry->needsRefresh || !collEntry->routingInfo) {
+                continue;
+            }
+
+            collectionVersions.emplace_back(NamespaceString(coll.first),
+                                            collEntry->routingInfo->getVersion());
+        }
+    }
+
+    return collectionVersions;
+}
+
+void CatalogCache::refreshCollectionInBackground(const NamespaceString& nss) {
+    stdx::lock_guard<Latch> lg(_mutex);
+
+    const auto itDb = _collectionsByDb.find(nss.db());
+    if (itDb == _collectionsByDb.end()) {
+        return;
+    }
+
+    const auto itColl = itDb->second.find(nss.ns());
+    if (itColl == itDb->second.end()) {
+        return;
+    }
+
+    auto collEntry = itColl->second;
+
+    // Operations are already going to block on a regular refresh of this collection, so there is
+    // nothing to be gained from refreshing it in the background as well
+    if (collEntry->needsRefresh || !collEntry->routingInfo ||
+        collEntry->backgroundRefreshInProgress) {
+        return;
+    }
+
+    const auto existingRoutingInfo = collEntry->routingInfo;
+
+    collEntry->backgroundRefreshInProgress = true;
+    _stats.numActiveBackgroundRefreshes.addAndFetch(1);
+    _stats.countBackgroundRefreshesStarted.addAndFetch(1);
+
+    // Invoked with the mutex held once the background refresh has completed, whether with success
+    // or error
+    const auto onRefreshCompleted = [this, t = Timer(), nss, collEntry](WithLock,
+                                                                         const Status& status) {
+        collEntry->backgroundRefreshInProgress = false;
+        _stats.numActiveBackgroundRefreshes.subtractAndFetch(1);
+        _stats.backgroundRefreshLatency.record(t.elapsed());
+
+        if (!status.isOK()) {
+            _stats.countFailedBackgroundRefreshes.addAndFetch(1);
+
+            LOGV2_FOR_CATALOG_REFRESH(5023408,
+                                      1,
+                                      "Error refreshing cached collection {namespace} in the "
+                                      "background; Took {duration} and failed due to {error}",
+                                      "Error refreshing cached collection in the background",
+                                      "namespace"_attr = nss,
+                                      "duration"_attr = Milliseconds(t.millis()),
+                                      "error"_attr = redact(status));
+        }
+    };
+
+    const auto refreshCallback = [this, collEntry, nss, existingRoutingInfo, onRefreshCompleted](
+                                     OperationContext* opCtx,
+                                     StatusWith<CatalogCacheLoader::CollectionAndChangedChunks>
+                                         swCollAndChunks) noexcept {
+        std::shared_ptr<RoutingTableHistory> newRoutingInfo;
+        try {
+            newRoutingInfo = refreshCollectionRoutingInfo(
+                opCtx, nss, existingRoutingInfo, std::move(swCollAndChunks));
+        } catch (const DBException& ex) {
+            stdx::lock_guard<Latch> lg(_mutex);
+            onRefreshCompleted(lg, ex.toStatus());
+            return;
+        }
+
+        stdx::lock_guard<Latch> lg(_mutex);
+        onRefreshCompleted(lg, Status::OK());
+
+        // If the entry was invalidated or replaced by a regular refresh in the meantime, that
+        // refresh is authoritative and the result of this one is discarded
+        if (collEntry->needsRefresh || collEntry->routingInfo != existingRoutingInfo ||
+            newRoutingInfo == existingRoutingInfo) {
+            return;
+        }
+
+        _stats.countBackgroundRefreshesApplied.addAndFetch(1);
+
+        if (!newRoutingInfo) {
+            // The refresh found that collection was dropped, so remove it from our cache.
+            auto itDb = _collectionsByDb.find(nss.db());
+            if (itDb == _collectionsByDb.end()) {
+                return;
+            }
+
+            auto itColl = itDb->second.find(nss.ns());
+            if (itColl != itDb->second.end() && itColl->second == collEntry) {
+                itDb->second.erase(itColl);
+            }
+            return;
+        }
+
+        LOGV2_FOR_CATALOG_REFRESH(5023409,
+                                  0,
+                                  "Refreshed cached collection {namespace} in the background to "
+                                  "version {newVersion} from version {oldVersion}",
+                                  "Refreshed cached collection in the background",
+                                  "namespace"_attr = nss,
+                                  "newVersion"_attr = newRoutingInfo->getVersion(),
+                                  "oldVersion"_attr = existingRoutingInfo->getVersion());
+
+        collEntry->routingInfo = std::move(newRoutingInfo);
+    };
+
+    try {
+        _cacheLoader.getChunksSince(nss, existingRoutingInfo->getVersion(), refreshCallback);
+    } catch (const DBException& ex) {
+        onRefreshCompleted(lg, ex.toStatus());
+    }
+}
+
 //db.serverstatus().shardingStatistics
 void CatalogCache::report(BSONObjBuilder* builder) const {
     BSONObjBuilder cacheStatsBuilder(builder->subobjStart("catalogCache"));
@@ -732,6 +866,8 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
             _stats.numActiveFullRefreshes.subtractAndFetch(1);
         }
 
+        _stats.refreshLatency.record(t.elapsed());
+
         if (!status.isOK()) {
             _stats.countFailedRefreshes.addAndFetch(1);
 
@@ -929,6 +1065,15 @@ void CatalogCache::Stats::report(BSONObjBuilder* builder) const {
 
     builder->append("countFailedRefreshes", countFailedRefreshes.load());
 
+    builder->append("numActiveBackgroundRefreshes", numActiveBackgroundRefreshes.load());
+    builder->append("countBackgroundRefreshesStarted", countBackgroundRefreshesStarted.load());
+    builder->append("countBackgroundRefreshesApplied", countBackgroundRefreshesApplied.load());
+    builder->append("countFailedBackgroundRefreshes", countFailedBackgroundRefreshes.load());
+
+    refreshWaitLatency.report("refreshWaitLatency", builder);
+    refreshLatency.report("refreshLatency", builder);
+    backgroundRefreshLatency.report("backgroundRefreshLatency", builder);
+
     if (isMongos()) {
         BSONObjBuilder operationsBlockedByRefreshBuilder(
             builder->subobjStart("operationsBlockedByRefresh"));
@@ -950,6 +1095,39 @@ void CatalogCache::Stats::report(BSONObjBuilder* builder) const {
     }
 }
 
+void CatalogCache::Stats::LatencyHistogram::record(Microseconds latency) {
+    const auto micros = static_cast<unsigned long long>(
+        std::max<long long>(durationCount<Microseconds>(latency), 1));
+    const int bucket = std::min(63 - countLeadingZeros64(micros), kNumBuckets - 1);
+
+    _buckets[bucket].fetchAndAddRelaxed(1);
+    _count.fetchAndAddRelaxed(1);
+    _sumMicros.fetchAndAddRelaxed(durationCount<Microseconds>(latency));
+}
+
+void CatalogCache::Stats::LatencyHistogram::report(StringData name,
+                                                   BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart(name));
+
+    BSONArrayBuilder bucketsBuilder(histogramBuilder.subarrayStart("histogram"));
+    for (int i = 0; i < kNumBuckets; i++) {
+        const auto count = _buckets[i].loadRelaxed();
+        if (count == 0) {
+            continue;
+        }
+
+        BSONObjBuilder entryBuilder(bucketsBuilder.subobjStart());
+        entryBuilder.append("micros", static_cast<long long>(i == 0 ? 0 : 1LL << i));
+        entryBuilder.append("count", count);
+        entryBuilder.doneFast();
+    }
+    bucketsBuilder.doneFast();
+
+    histogramBuilder.append("latencyMicros", _sumMicros.loadRelaxed());
+    histogramBuilder.append("count", _count.loadRelaxed());
+    histogramBuilder.doneFast();
+}
+
 CachedDatabaseInfo::CachedDatabaseInfo(DatabaseType dbt, std::shared_ptr<Shard> primaryShard)
     : _dbt(std::move(dbt)), _primaryShard(std::move(primaryShard)) {}
 
@@ -29,7 +29,9 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
@@ -293,6 +295,20 @@ public:
      */
     void purgeAllDatabases();
 
+    /**
+     * Returns the namespace and collection version of every sharded collection, which currently
+     * has routing info loaded in the cache and is not waiting on a refresh.
+     */
+    std::vector<std::pair<NamespaceString, ChunkVersion>> getCachedCollectionVersions() const;
+
+    /**
+     * Non-blocking method, which refreshes the routing info of the specified collection without
+     * making operations wait for it. Operations keep routing with the cached routing info until the
+     * refresh installs the new one. Does nothing if the collection is not cached, is already
+     * marked as needing refresh, or has a background refresh in progress.
+     */
+    void refreshCollectionInBackground(const NamespaceString& nss);
+
     /**
      * Reports statistics about the catalog cache to be used by serverStatus
      */
@@ -327,6 +343,10 @@ private:
 
         // Contains the cached routing information (only available if needsRefresh is false)
         std::shared_ptr<RoutingTableHistory> routingInfo;
+
+        // Specifies whether a refresh scheduled by refreshCollectionInBackground is in progress.
+        // Operations never wait on it.
+        bool backgroundRefreshInProgress{false};
     };
 
     /**
@@ -482,6 +502,48 @@ private:
             AtomicWord<long long> countCommands{0};
         } operationsBlockedByRefresh;
 
+        // Tracks how many background refreshes are waiting to complete currently
+        AtomicWord<long long> numActiveBackgroundRefreshes{0};
+
+        // Cumulative, always-increasing counter of how many background refreshes have been kicked
+        // off
+        AtomicWord<long long> countBackgroundRefreshesStarted{0};
+
+        // Cumulative, always-increasing counter of how many background refreshes installed newer
+        // routing info before any operation had to wait for it
+        AtomicWord<long long> countBackgroundRefreshesApplied{0};
+
+        // Cumulative, always-increasing counter of how many background refreshes failed for
+        // whatever reason
+        AtomicWord<long long> countFailedBackgroundRefreshes{0};
+
+        /**
+         * Latency histogram with power-of-two buckets in microseconds, which may be updated
+         * concurrently.
+         */
+        class LatencyHistogram {
+        public:
+            void record(Microseconds latency);
+
+            void report(StringData name, BSONObjBuilder* builder) const;
+
+        private:
+            static constexpr int kNumBuckets = 32;
+
+            std::array<AtomicWord<long long>, kNumBuckets> _buckets;
+            AtomicWord<long long> _count{0};
+            AtomicWord<long long> _sumMicros{0};
+        };
+
+        // Time each operation blocked behind a refresh spent waiting for it
+        LatencyHistogram refreshWaitLatency;
+
+        // Duration of the refreshes, which operations block on
+        LatencyHistogram refreshLatency;
+
+        // Duration of the refreshes scheduled by refreshCollectionInBackground
+        LatencyHistogram backgroundRefreshLatency;
+
         /**
          * Reports the accumulated statistics for serverStatus.
          */
@@ -0,0 +1,247 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kShardingCatalogRefresh
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/catalog_cache_background_refresher.h"
+
+#include <set>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/logv2/log.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/catalog/type_collection.h"
+#include "mongo/s/catalog_cache.h"
+#include "mongo/s/client/shard_registry.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/mongos_server_parameters_gen.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+using CachedCollectionVersions = std::vector<std::pair<NamespaceString, ChunkVersion>>;
+
+// How often to check whether the background refresh has been enabled while it is disabled
+const Milliseconds kDisabledPollInterval(1000);
+
+// Maximum number of collections checked by a single query against the config server
+const size_t kMaxCollectionsPerQuery = 100;
+
+// Maximum number of newer chunks returned by a single query against config.chunks. If more of them
+// match, the collections they belong to are found by the next checks, once the ones found by this
+// check have been refreshed.
+const long long kMaxChangedChunksPerQuery = 1000;
+
+/**
+ * Runs a find with 'filter' and 'projection' against 'nss' on the config server, with majority
+ * read concern, and returns the documents of its single batch of at most 'limit' documents.
+ */
+std::vector<BSONObj> findOnConfig(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  const BSONObj& filter,
+                                  const BSONObj& projection,
+                                  long long limit) {
+    const auto configShard = Grid::get(opCtx)->shardRegistry()->getConfigShard();
+
+    BSONObjBuilder findCmd;
+    findCmd.append("find", nss.coll());
+    findCmd.append("filter", filter);
+    findCmd.append("projection", projection);
+    findCmd.append("limit", limit);
+    findCmd.append("singleBatch", true);
+    findCmd.append(repl::ReadConcernArgs::kReadConcernFieldName,
+                   BSON(repl::ReadConcernArgs::kLevelFieldName
+                        << repl::readConcernLevels::kMajorityName));
+
+    auto response = uassertStatusOK(configShard->runCommandWithFixedRetryAttempts(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::Nearest},
+        nss.db().toString(),
+        findCmd.obj(),
+        Shard::RetryPolicy::kIdempotent));
+    uassertStatusOK(response.commandStatus);
+
+    auto cursorResponse = uassertStatusOK(CursorResponse::parseFromBSON(response.response));
+    return cursorResponse.releaseBatch();
+}
+
+/**
+ * Adds to 'changed' the cached collections, which were dropped or whose epoch changed since they
+ * were loaded, and returns the others. Only reads the epochs of the cached collections from
+ * config.collections.
+ */
+CachedCollectionVersions findCollectionsWithChangedEpoch(
+    OperationContext* opCtx,
+    const CachedCollectionVersions& cachedVersions,
+    std::set<NamespaceString>* changed) {
+    CachedCollectionVersions unchanged;
+
+    for (size_t begin = 0; begin < cachedVersions.size(); begin += kMaxCollectionsPerQuery) {
+        const auto end = std::min(begin + kMaxCollectionsPerQuery, cachedVersions.size());
+
+        BSONArrayBuilder namespaces;
+        for (auto i = begin; i < end; ++i) {
+            namespaces.append(cachedVersions[i].first.ns());
+        }
+
+        const auto collections = findOnConfig(
+            opCtx,
+            CollectionType::ConfigNS,
+            BSON(CollectionType::fullNs() << BSON("$in" << namespaces.arr()) << "dropped"
+                                          << BSON("$ne" << true)),
+            BSON(CollectionType::fullNs() << 1 << CollectionType::epoch() << 1),
+            end - begin);
+
+        StringMap<OID> epochs;
+        for (const auto& coll : collections) {
+            epochs[coll[CollectionType::fullNs()].str()] = coll[CollectionType::epoch()].OID();
+        }
+
+        for (auto i = begin; i < end; ++i) {
+            const auto& cachedVersion = cachedVersions[i];
+            const auto it = epochs.find(cachedVersion.first.ns());
+            if (it == epochs.end() || it->second != cachedVersion.second.epoch()) {
+                changed->insert(cachedVersion.first);
+            } else {
+                unchanged.push_back(cachedVersion);
+            }
+        }
+    }
+
+    return unchanged;
+}
+
+/**
+ * Adds to 'changed' the cached collections, which have chunks of the same epoch with a version
+ * newer than the cached collection version. Each query against config.chunks covers a batch of
+ * collections, is answered from the {ns: 1, lastmod: 1} index and only returns the namespaces of
+ * a bounded number of newer chunks.
+ */
+void findCollectionsWithChangedChunks(OperationContext* opCtx,
+                                      const CachedCollectionVersions& cachedVersions,
+                                      std::set<NamespaceString>* changed) {
+    for (size_t begin = 0; begin < cachedVersions.size(); begin += kMaxCollectionsPerQuery) {
+        const auto end = std::min(begin + kMaxCollectionsPerQuery, cachedVersions.size());
+
+        BSONArrayBuilder orBuilder;
+        for (auto i = begin; i < end; ++i) {
+            const auto& nss = cachedVersions[i].first;
+            const auto& collectionVersion = cachedVersions[i].second;
+            orBuilder.append(BSON(ChunkType::ns(nss.ns())
+                                  << ChunkType::lastmod() << GT
+                                  << Timestamp(collectionVersion.toLong()) << ChunkType::epoch()
+                                  << collectionVersion.epoch()));
+        }
+
+        const auto chunks = findOnConfig(opCtx,
+                                         ChunkType::ConfigNS,
+                                         BSON("$or" << orBuilder.arr()),
+                                         BSON("_id" << 0 << ChunkType::ns() << 1),
+                                         kMaxChangedChunksPerQuery);
+
+        for (const auto& chunk : chunks) {
+            changed->insert(NamespaceString(chunk[ChunkType::ns()].str()));
+        }
+    }
+}
+
+/**
+ * Checks the config server for changes to the collections cached in the CatalogCache and schedules
+ * a background refresh for each collection that changed.
+ */
+void refreshChangedCollections(OperationContext* opCtx) {
+    const auto catalogCache = Grid::get(opCtx)->catalogCache();
+
+    const auto cachedVersions = catalogCache->getCachedCollectionVersions();
+    if (cachedVersions.empty()) {
+        return;
+    }
+
+    // The collections whose epoch changed are refreshed entirely, so their chunks need no check
+    std::set<NamespaceString> changed;
+    const auto unchangedEpochVersions =
+        findCollectionsWithChangedEpoch(opCtx, cachedVersions, &changed);
+    findCollectionsWithChangedChunks(opCtx, unchangedEpochVersions, &changed);
+
+    for (const auto& nss : changed) {
+        LOGV2_DEBUG(5023410,
+                    2,
+                    "Routing info of {namespace} changed on the config server, refreshing it in "
+                    "the background",
+                    "Routing info changed on the config server, refreshing it in the background",
+                    "namespace"_attr = nss);
+        catalogCache->refreshCollectionInBackground(nss);
+    }
+}
+
+}  // namespace
+
+CatalogCacheBackgroundRefresher catalogCacheBackgroundRefresher;
+
+std::string CatalogCacheBackgroundRefresher::name() const {
+    return "CatalogCacheBackgroundRefresher";
+}
+
+void CatalogCacheBackgroundRefresher::run() {
+    ThreadClient tc(name(), getGlobalServiceContext());
+
+    auto* const client = Client::getCurrent();
+
+    while (!globalInShutdownDeprecated()) {
+        const Milliseconds interval(gRoutingTableBackgroundRefreshIntervalMS.load());
+
+        if (interval > Milliseconds(0) &&
+            Grid::get(client->getServiceContext())->isShardingInitialized()) {
+            try {
+                const auto opCtx = client->makeOperationContext();
+                refreshChangedCollections(opCtx.get());
+            } catch (const DBException& ex) {
+                LOGV2_DEBUG(5023411,
+                            1,
+                            "Failed to check the config server for routing info changes: {error}",
+                            "Failed to check the config server for routing info changes",
+                            "error"_attr = redact(ex));
+            }
+        }
+
+        MONGO_IDLE_THREAD_BLOCK;
+        sleepFor(interval > Milliseconds(0) ? interval : kDisabledPollInterval);
+    }
+}
+
+}  // namespace mongo
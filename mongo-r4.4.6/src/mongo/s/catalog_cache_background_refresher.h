@@ -0,0 +1,55 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/util/background.h"
+
+namespace mongo {
+
+/**
+ * Background job, which runs on mongos and keeps the routing info in the CatalogCache up to date
+ * without waiting for a StaleConfig error to trigger the refresh.
+ *
+ * Every routingTableBackgroundRefreshIntervalMS (disabled by default) it checks the config server
+ * for changes to the collections, which have routing info cached:
+ * - Collections whose epoch changed or which were dropped, read from config.collections.
+ * - For the other collections, chunks with a version newer than the cached collection version
+ *   (migrations, splits, merges), of which only the namespaces are read from config.chunks.
+ * Each changed collection is then refreshed through CatalogCache::refreshCollectionInBackground.
+ */
+class CatalogCacheBackgroundRefresher final : public BackgroundJob {
+public:
+    std::string name() const final;
+    void run() final;
+};
+
+extern CatalogCacheBackgroundRefresher catalogCacheBackgroundRefresher;
+
+}  // namespace mongo
@@ -75,6 +75,27 @@ protected:
             return std::vector<BSONObj>{collType.toBSON()};
         }());
     }
+
+    /**
+     * Waits for a background refresh to change the set of cached collection versions from
+     * 'previous' and returns the new set.
+     */
+    std::vector<std::pair<NamespaceString, ChunkVersion>> waitForCachedCollectionVersionsToChange(
+        const std::vector<std::pair<NamespaceString, ChunkVersion>>& previous) {
+        auto const catalogCache = Grid::get(getServiceContext())->catalogCache();
+
+        std::vector<std::pair<NamespaceString, ChunkVersion>> current;
+        for (int attempt = 0; attempt < 1000; ++attempt) {
+            current = catalogCache->getCachedCollectionVersions();
+            if (current != previous) {
+                break;
+            }
+            sleepmillis(10);
+        }
+
+        ASSERT(current != previous);
+        return current;
+    }
 };
 
 TEST_F(CatalogCacheRefreshTest, FullLoad) {
@@ -661,5 +682,84 @@ TEST_F(CatalogCacheRefreshTest, IncrementalLoadAfterMoveLastChunk) {
     ASSERT_EQ(version, cm->getVersion({"1"}));
 }
 
+TEST_F(CatalogCacheRefreshTest, BackgroundRefreshAfterMove) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
+
+    auto initialRoutingInfo(
+        makeChunkManager(kNss, shardKeyPattern, nullptr, true, {BSON("_id" << 0)}));
+    ASSERT_EQ(2, initialRoutingInfo->numChunks());
+
+    ChunkVersion version = initialRoutingInfo->getVersion();
+
+    auto const catalogCache = Grid::get(getServiceContext())->catalogCache();
+    const auto initialVersions = catalogCache->getCachedCollectionVersions();
+    ASSERT_EQ(1U, initialVersions.size());
+    ASSERT_EQ(kNss, initialVersions[0].first);
+    ASSERT_EQ(version, initialVersions[0].second);
+
+    catalogCache->refreshCollectionInBackground(kNss);
+
+    // Operations keep routing with the cached routing info while the background refresh is running
+    auto futureNoRefresh = scheduleRoutingInfoUnforcedRefresh(kNss);
+    ASSERT_EQ(version, futureNoRefresh.default_timed_get()->cm()->getVersion());
+
+    ChunkVersion expectedDestShardVersion;
+
+    expectGetCollection(version.epoch(), shardKeyPattern);
+
+    // Return set of chunks, which represent a move
+    expectFindSendBSONObjVector(kConfigHostAndPort, [&]() {
+        version.incMajor();
+        expectedDestShardVersion = version;
+        ChunkType chunk1(
+            kNss, {shardKeyPattern.getKeyPattern().globalMin(), BSON("_id" << 0)}, version, {"1"});
+        chunk1.setName(OID::gen());
+
+        version.incMinor();
+        ChunkType chunk2(
+            kNss, {BSON("_id" << 0), shardKeyPattern.getKeyPattern().globalMax()}, version, {"0"});
+        chunk2.setName(OID::gen());
+
+        return std::vector<BSONObj>{chunk1.toConfigBSON(), chunk2.toConfigBSON()};
+    }());
+
+    const auto refreshedVersions = waitForCachedCollectionVersionsToChange(initialVersions);
+    ASSERT_EQ(1U, refreshedVersions.size());
+    ASSERT_EQ(version, refreshedVersions[0].second);
+
+    auto future = scheduleRoutingInfoUnforcedRefresh(kNss);
+    auto routingInfo = future.default_timed_get();
+    ASSERT(routingInfo->cm());
+    auto cm = routingInfo->cm();
+
+    ASSERT_EQ(2, cm->numChunks());
+    ASSERT_EQ(version, cm->getVersion());
+    ASSERT_EQ(version, cm->getVersion({"0"}));
+    ASSERT_EQ(expectedDestShardVersion, cm->getVersion({"1"}));
+}
+
+TEST_F(CatalogCacheRefreshTest, BackgroundRefreshAfterCollectionDrop) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
+
+    auto initialRoutingInfo(
+        makeChunkManager(kNss, shardKeyPattern, nullptr, true, {BSON("_id" << 0)}));
+    ASSERT_EQ(2, initialRoutingInfo->numChunks());
+
+    auto const catalogCache = Grid::get(getServiceContext())->catalogCache();
+    const auto initialVersions = catalogCache->getCachedCollectionVersions();
+    ASSERT_EQ(1U, initialVersions.size());
+
+    catalogCache->refreshCollectionInBackground(kNss);
+
+    // Return an empty collection
+    expectFindSendBSONObjVector(kConfigHostAndPort, {});
+
+    ASSERT(waitForCachedCollectionVersionsToChange(initialVersions).empty());
+
+    auto future = scheduleRoutingInfoUnforcedRefresh(kNss);
+    auto routingInfo = future.default_timed_get();
+    ASSERT(!routingInfo->cm());
+}
+
 }  // namespace
 }  // namespace mongo
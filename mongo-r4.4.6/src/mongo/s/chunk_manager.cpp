@@ -33,8 +33,12 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/index_bounds_builder.h"
@@ -77,8 +81,76 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
     return {ks.getBuffer(), ks.getSize()};
 }
 
+/**
+ * Tracks which entries of an existing ChunkInfoMap have been replaced by changed chunks while a
+ * new routing table is being built. Finding the next entry which has not been replaced takes
+ * amortized near-constant time, using a disjoint-set forest with path compression.
+ */
+class ReplacedChunkTracker {
+public:
+    explicit ReplacedChunkTracker(size_t size) : _next(size + 1) {
+        std::iota(_next.begin(), _next.end(), 0);
+    }
+
+    /**
+     * Returns the index of the first entry at or after "i" which has not been replaced, or the
+     * size of the map if there is none.
+     */
+    size_t nextRemaining(size_t i) {
+        size_t root = i;
+        while (_next[root] != root) {
+            root = _next[root];
+        }
+        while (_next[i] != root) {
+            const auto next = _next[i];
+            _next[i] = root;
+            i = next;
+        }
+        return root;
+    }
+
+    /**
+     * Marks the entries in [begin, end) as replaced.
+     */
+    void replace(size_t begin, size_t end) {
+        for (auto i = nextRemaining(begin); i < end; i = nextRemaining(i + 1)) {
+            _next[i] = i + 1;
+        }
+    }
+
+private:
+    std::vector<size_t> _next;
+};
+
 }  // namespace
 
+ChunkInfoMap::ChunkInfoMap(std::vector<value_type> entries) : _entries(std::move(entries)) {
+    dassert(std::is_sorted(
+        _entries.begin(), _entries.end(), [](const value_type& a, const value_type& b) {
+            return a.first < b.first;
+        }));
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upper_bound(const std::string& key) const {
+    return std::upper_bound(
+        _entries.begin(), _entries.end(), key, [](const std::string& k, const value_type& entry) {
+            return k < entry.first;
+        });
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::lower_bound(const std::string& key) const {
+    return std::lower_bound(
+        _entries.begin(), _entries.end(), key, [](const value_type& entry, const std::string& k) {
+            return entry.first < k;
+        });
+}
+
+const std::shared_ptr<ChunkInfo>& ChunkInfoMap::at(const std::string& key) const {
+    const auto it = lower_bound(key);
+    invariant(it != end() && it->first == key);
+    return it->second;
+}
+
 ShardVersionTargetingInfo::ShardVersionTargetingInfo(const OID& epoch)
     : shardVersion(0, 0, epoch) {}
 
@@ -155,6 +227,15 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
                                        const BSONObj& query,
                                        const BSONObj& collation,
                                        std::set<ShardId>* shardIds) const {
+    // Fast path for targeting a $in on a hashed shard key, which would otherwise be planned and
+    // flattened into one point interval per value.
+    if (auto inValuesByShard = getHashedInValuesByShard(query, collation)) {
+        for (const auto& shardAndValues : *inValuesByShard) {
+            shardIds->insert(shardAndValues.first);
+        }
+        return;
+    }
+
     auto qr = std::make_unique<QueryRequest>(_rt->getns());
     qr->setFilter(query);
 
@@ -220,6 +301,83 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     }
 }
 
+boost::optional<std::map<ShardId, std::vector<BSONElement>>>
+ChunkManager::getHashedInValuesByShard(const BSONObj& query, const BSONObj& collation) const {
+    const auto& shardKeyPattern = _rt->getShardKeyPattern();
+    const auto shardKeyField = shardKeyPattern.toBSON().firstElement();
+    if (!shardKeyPattern.isHashedPattern() || shardKeyPattern.toBSON().nFields() != 1) {
+        return boost::none;
+    }
+
+    // Only {<shard key field>: {$in: [...]}}
+    if (query.nFields() != 1 ||
+        query.firstElement().fieldNameStringData() != shardKeyField.fieldNameStringData() ||
+        query.firstElement().type() != Object) {
+        return boost::none;
+    }
+
+    const auto inExpr = query.firstElement().embeddedObject();
+    if (inExpr.nFields() != 1 || inExpr.firstElement().fieldNameStringData() != "$in"_sd ||
+        inExpr.firstElement().type() != Array) {
+        return boost::none;
+    }
+
+    const bool hasSimpleCollation = (collation.isEmpty() && !_rt->getDefaultCollator()) ||
+        SimpleBSONObjComparator::kInstance.evaluate(collation == CollationSpec::kSimpleSpec);
+
+    std::vector<std::pair<long long, BSONElement>> hashedValues;
+    for (auto&& value : inExpr.firstElement().embeddedObject()) {
+        // Arrays and regexes match documents whose shard key is not the value itself, null also
+        // matches documents without the field, and a non-simple collation makes strings match
+        // values with a different hash.
+        if (value.type() == Array || value.type() == RegEx || value.isNull() ||
+            (!hasSimpleCollation && CollationIndexKey::isCollatableType(value.type()))) {
+            return boost::none;
+        }
+
+        hashedValues.emplace_back(
+            BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED), value);
+    }
+
+    if (hashedValues.empty()) {
+        return boost::none;
+    }
+
+    std::sort(hashedValues.begin(), hashedValues.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    // Walk the values in hash order, only looking up a chunk when a value falls past the end of
+    // the previous one
+    std::map<ShardId, std::vector<BSONElement>> inValuesByShard;
+    const ChunkInfo* chunk = nullptr;
+    std::vector<BSONElement>* chunkValues = nullptr;
+    for (const auto& hashedValue : hashedValues) {
+        if (chunk) {
+            const auto chunkMax = chunk->getMax().firstElement();
+            if (chunkMax.type() != MaxKey &&
+                (chunkMax.type() != NumberLong || hashedValue.first >= chunkMax.numberLong())) {
+                chunk = nullptr;
+            }
+        }
+
+        if (!chunk) {
+            const auto shardKey = BSON(shardKeyField.fieldNameStringData() << hashedValue.first);
+            const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+            if (it == _rt->getChunkMap().end() || !it->second->containsKey(shardKey)) {
+                return boost::none;
+            }
+
+            chunk = it->second.get();
+            chunkValues = &inValuesByShard[chunk->getShardIdAt(_clusterTime)];
+        }
+
+        chunkValues->push_back(hashedValue.second);
+    }
+
+    return inValuesByShard;
+}
+
 void ChunkManager::getShardIdsForRange(const BSONObj& min,
                                        const BSONObj& max,
                                        std::set<ShardId>* shardIds) const {
@@ -593,11 +751,87 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeNew(
         .makeUpdated(chunks);
 }
 
+std::shared_ptr<RoutingTableHistory> RoutingTableHistory::_makeFromNonOverlappingChunks(
+    const std::vector<ChunkType>& chunks) const {
+    invariant(_chunkMap.empty());
+
+    struct ChunkKeys {
+        std::string minKeyString;
+        std::string maxKeyString;
+        const ChunkType* chunk;
+    };
+    std::vector<ChunkKeys> sortedChunks;
+    sortedChunks.reserve(chunks.size());
+
+    ChunkVersion collectionVersion = getVersion();
+    for (const auto& chunk : chunks) {
+        const auto& chunkVersion = chunk.getVersion();
+
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Chunk with namespace " << chunk.getNS().ns() << " and min key "
+                              << chunk.getMin()
+                              << " has epoch different from that of the collection "
+                              << chunkVersion.epoch(),
+                collectionVersion.epoch() == chunkVersion.epoch());
+
+        // Chunks must always come in incrementally sorted order
+        invariant(chunkVersion >= collectionVersion);
+        collectionVersion = chunkVersion;
+
+        sortedChunks.push_back(
+            {_extractKeyString(chunk.getMin()), _extractKeyString(chunk.getMax()), &chunk});
+    }
+
+    if (sortedChunks.empty()) {
+        return nullptr;
+    }
+
+    std::sort(sortedChunks.begin(), sortedChunks.end(), [](const auto& a, const auto& b) {
+        return a.maxKeyString < b.maxKeyString;
+    });
+    for (size_t i = 1; i < sortedChunks.size(); ++i) {
+        if (sortedChunks[i - 1].maxKeyString != sortedChunks[i].minKeyString) {
+            return nullptr;
+        }
+    }
+
+    std::vector<ChunkInfoMap::value_type> entries;
+    entries.reserve(sortedChunks.size());
+    for (auto& chunkKeys : sortedChunks) {
+        entries.emplace_back(std::move(chunkKeys.maxKeyString),
+                             std::make_shared<ChunkInfo>(*chunkKeys.chunk));
+    }
+
+    return std::shared_ptr<RoutingTableHistory>(
+        new RoutingTableHistory(_nss,
+                                _uuid,
+                                KeyPattern(getShardKeyPattern().getKeyPattern()),
+                                CollatorInterface::cloneCollator(getDefaultCollator()),
+                                isUnique(),
+                                ChunkInfoMap(std::move(entries)),
+                                collectionVersion));
+}
+
 std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
+    if (_chunkMap.empty()) {
+        if (auto routingTable = _makeFromNonOverlappingChunks(changedChunks)) {
+            return routingTable;
+        }
+    }
 
     const auto startingCollectionVersion = getVersion();
-    auto chunkMap = _chunkMap;
+
+    // The changed chunks are applied to a small ordered map of their own, while the entries of
+    // the current routing table which they overlap are only marked as replaced. The new routing
+    // table is then produced by a single merge pass over both, so an incremental refresh costs
+    // O(n + k log k) and shares every unchanged ChunkInfo with this routing table.
+    std::map<std::string, std::shared_ptr<ChunkInfo>> changedChunkMap;
+    ReplacedChunkTracker replacedChunks(_chunkMap.size());
+
+    const auto indexOf = [this](ChunkInfoMap::const_iterator it) -> size_t {
+        return std::distance(_chunkMap.begin(), it);
+    };
 
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
@@ -618,40 +852,72 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         const auto chunkMaxKeyString = _extractKeyString(chunk.getMax());
 
         // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
-        // min
-        const auto low = chunkMap.upper_bound(chunkMinKeyString);
+        // min. Both the existing and the already changed chunks are considered.
+        const auto low = changedChunkMap.upper_bound(chunkMinKeyString);
+        const auto existingLow =
+            replacedChunks.nextRemaining(indexOf(_chunkMap.upper_bound(chunkMinKeyString)));
 
         // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
         // not overlap max
-        const auto high = chunkMap.upper_bound(chunkMaxKeyString);
+        const auto high = changedChunkMap.upper_bound(chunkMaxKeyString);
+        const auto existingHigh = indexOf(_chunkMap.upper_bound(chunkMaxKeyString));
+
+        // The chunk with the lowest max key > min among the existing and the changed chunks.
+        std::shared_ptr<ChunkInfo> lowChunk;
+        if (existingLow < _chunkMap.size() &&
+            (low == changedChunkMap.end() ||
+             (_chunkMap.begin() + existingLow)->first < low->first)) {
+            lowChunk = (_chunkMap.begin() + existingLow)->second;
+        } else if (low != changedChunkMap.end()) {
+            lowChunk = low->second;
+        }
+
+        // Number of chunks, up to 2, with a max key in (min, max].
+        auto numOverlapping = std::distance(low, high);
+        if (existingLow < existingHigh) {
+            const bool multipleExisting =
+                replacedChunks.nextRemaining(existingLow + 1) < existingHigh;
+            numOverlapping += multipleExisting ? 2 : 1;
+        }
 
         // If we are in the middle of splitting a chunk, for the first few
         // chunks inserted, low == high, because both lookups will point to the
         // same chunk (the one being split). If we're inserting the last chunk
         // for the current chunk being split, low will point to the chunk that
         // we're splitting, and high will point to the next chunk past the one
-        // we're splitting (which could be chunkMap.end()). In this case,
-        // std::distance(low, high) == 1. Lastly, this does not apply during
+        // we're splitting (which could be the end of the map). In this case,
+        // there is exactly one overlapping chunk. Lastly, this does not apply during
         // the creation of the original routing table, in which case the map is
-        // empty and the first chunk that is inserted will find that low ==
-        // high, but low == chunkMap.end(), and we aren't doing a split in that
+        // empty and the first chunk that is inserted will find no overlapping
+        // chunk, but also no low chunk, and we aren't doing a split in that
         // case.
-        auto foundSingleChunk =
-            ((low == high || std::distance(low, high) == 1) && low != chunkMap.end());
+        auto foundSingleChunk = (numOverlapping <= 1 && lowChunk);
 
         auto newChunk = std::make_shared<ChunkInfo>(chunk);
         if (foundSingleChunk) {
-            auto chunkBeingReplacedBySplit = low->second;
-            auto bytesInReplacedChunk =
-                chunkBeingReplacedBySplit->getWritesTracker()->getBytesWritten();
+            auto bytesInReplacedChunk = lowChunk->getWritesTracker()->getBytesWritten();
             newChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
         }
 
+        // Unlike the bytes written, the writes not reported to the config server yet must not be
+        // counted twice, so they are only carried over from the chunks which this chunk takes out
+        // of the routing table. Merged chunks thus add up their writes, whereas all the writes of
+        // a split chunk go to the last of its pieces, since which piece they fell in is not known.
+        for (auto i = existingLow; i < existingHigh; i = replacedChunks.nextRemaining(i + 1)) {
+            newChunk->getWritesTracker()->addWritesSinceReport(
+                (_chunkMap.begin() + i)->second->getWritesTracker()->getWritesSinceReport());
+        }
+        for (auto it = low; it != high; ++it) {
+            newChunk->getWritesTracker()->addWritesSinceReport(
+                it->second->getWritesTracker()->getWritesSinceReport());
+        }
+
         // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+        replacedChunks.replace(existingLow, existingHigh);
+        changedChunkMap.erase(low, high);
 
         // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
+        changedChunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -665,6 +931,25 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    std::vector<ChunkInfoMap::value_type> entries;
+    entries.reserve(_chunkMap.size() + changedChunkMap.size());
+
+    auto changedIt = changedChunkMap.begin();
+    for (auto i = replacedChunks.nextRemaining(0); i < _chunkMap.size();
+         i = replacedChunks.nextRemaining(i + 1)) {
+        const auto& existing = *(_chunkMap.begin() + i);
+        for (; changedIt != changedChunkMap.end() && changedIt->first < existing.first;
+             ++changedIt) {
+            entries.emplace_back(changedIt->first, std::move(changedIt->second));
+        }
+        entries.push_back(existing);
+    }
+    for (; changedIt != changedChunkMap.end(); ++changedIt) {
+        entries.emplace_back(changedIt->first, std::move(changedIt->second));
+    }
+
+    ChunkInfoMap chunkMap(std::move(entries));
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
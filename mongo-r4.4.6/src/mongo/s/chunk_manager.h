@@ -49,8 +49,64 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+/**
+ * Ordered map from the max for each chunk (encoded as a KeyString) to an entry describing the
+ * chunk. The entries are kept sorted in one contiguous array, so lookups are a binary search over
+ * adjacent memory instead of a walk down the nodes of a tree, and building a new routing table
+ * does not allocate a node per chunk. Instances are immutable; RoutingTableHistory::makeUpdated
+ * produces a new map which shares the unchanged ChunkInfo objects with the previous one.
+ */
+class ChunkInfoMap {
+public:
+    using value_type = std::pair<std::string, std::shared_ptr<ChunkInfo>>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    ChunkInfoMap() = default;
+
+    /**
+     * The entries must be sorted in ascending order by key, without duplicates.
+     */
+    explicit ChunkInfoMap(std::vector<value_type> entries);
+
+    const_iterator begin() const {
+        return _entries.cbegin();
+    }
+    const_iterator end() const {
+        return _entries.cend();
+    }
+    const_iterator cbegin() const {
+        return _entries.cbegin();
+    }
+    const_iterator cend() const {
+        return _entries.cend();
+    }
+
+    size_t size() const {
+        return _entries.size();
+    }
+    bool empty() const {
+        return _entries.empty();
+    }
+
+    /**
+     * Returns the first entry whose key is greater than "key", i.e. the chunk which contains a
+     * shard key whose KeyString is "key".
+     */
+    const_iterator upper_bound(const std::string& key) const;
+
+    /**
+     * Returns the first entry whose key is not less than "key".
+     */
+    const_iterator lower_bound(const std::string& key) const;
+
+    /**
+     * Returns the chunk whose max is "key", which must exist.
+     */
+    const std::shared_ptr<ChunkInfo>& at(const std::string& key) const;
+
+private:
+    std::vector<value_type> _entries;
+};
 
 struct ShardVersionTargetingInfo {
     // Indicates whether the shard is stale and thus needs a catalog cache refresh. Is false by
@@ -206,6 +262,15 @@ private:
 
     ChunkVersion _getVersion(const ShardId& shardName, bool throwOnStaleShard) const;
 
+    /**
+     * Builds the routing table of a full load straight into a sorted array, without the ordered
+     * map which makeUpdated merges the changed chunks in. Returns nullptr if the chunks do not
+     * tile the key space exactly, as they then include superseded versions of some chunks, which
+     * need the overlap handling of makeUpdated.
+     */
+    std::shared_ptr<RoutingTableHistory> _makeFromNonOverlappingChunks(
+        const std::vector<ChunkType>& chunks) const;
+
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
 
     // The shard versioning mechanism hinges on keeping track of the number of times we reload
@@ -398,6 +463,17 @@ public:
                              const BSONObj& collation,
                              std::set<ShardId>* shardIds) const;
 
+    /**
+     * If the shard key is a single hashed field and 'query' is a $in over that field only, returns
+     * the values of the $in grouped by the shard which owns their hash. The values are hashed in
+     * one pass and matched against the chunks in hash order, without planning the query. Returns
+     * boost::none for any other query, which getShardIdsForQuery() must then target.
+     *
+     * The returned elements point into 'query', which must outlive them.
+     */
+    boost::optional<std::map<ShardId, std::vector<BSONElement>>> getHashedInValuesByShard(
+        const BSONObj& query, const BSONObj& collation) const;
+
     /**
      * Returns all shard ids which contain chunks overlapping the range [min, max]. Please note the
      * inclusive bounds on both sides (SERVER-20768).
@@ -33,6 +33,7 @@
 
 #include <set>
 
+#include "mongo/db/hasher.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
 #include "mongo/s/chunk_manager.h"
@@ -487,6 +488,71 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, HashedInValuesAreGroupedByOwningShard) {
+    const ShardKeyPattern shardKeyPattern(BSON("a"
+                                               << "hashed"));
+    auto chunkManager =
+        makeChunkManager(kNss, shardKeyPattern, nullptr, false, {BSON("a" << 0LL)});
+
+    const int numValues = 100;
+    BSONArrayBuilder valuesBuilder;
+    for (int i = 0; i < numValues; ++i) {
+        valuesBuilder.append(i);
+    }
+    const auto query = BSON("a" << BSON("$in" << valuesBuilder.arr()));
+
+    auto inValuesByShard = chunkManager->getHashedInValuesByShard(query, BSONObj());
+    ASSERT(inValuesByShard);
+    ASSERT_EQ(2U, inValuesByShard->size());
+
+    size_t numGroupedValues = 0;
+    for (const auto& shardAndValues : *inValuesByShard) {
+        for (const auto& value : shardAndValues.second) {
+            const auto hash =
+                BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED);
+            ASSERT_EQ(hash < 0 ? ShardId("0") : ShardId("1"), shardAndValues.first);
+        }
+        numGroupedValues += shardAndValues.second.size();
+    }
+    ASSERT_EQ(size_t(numValues), numGroupedValues);
+
+    std::set<ShardId> shardIds;
+    chunkManager->getShardIdsForQuery(operationContext(), query, BSONObj(), &shardIds);
+    ASSERT_EQ(2U, shardIds.size());
+}
+
+TEST_F(ChunkManagerQueryTest, HashedInValuesOnlyForInOverHashedShardKey) {
+    const ShardKeyPattern hashedShardKeyPattern(BSON("a"
+                                                     << "hashed"));
+    auto hashedChunkManager =
+        makeChunkManager(kNss, hashedShardKeyPattern, nullptr, false, {BSON("a" << 0LL)});
+
+    ASSERT(hashedChunkManager->getHashedInValuesByShard(
+        BSON("a" << BSON("$in" << BSON_ARRAY(1 << "x"))), BSONObj()));
+
+    // Ranges, other fields and values which match more than their own hash are not split
+    ASSERT_FALSE(
+        hashedChunkManager->getHashedInValuesByShard(BSON("a" << BSON("$gt" << 1)), BSONObj()));
+    ASSERT_FALSE(hashedChunkManager->getHashedInValuesByShard(
+        BSON("a" << BSON("$in" << BSON_ARRAY(1)) << "b" << 1), BSONObj()));
+    ASSERT_FALSE(hashedChunkManager->getHashedInValuesByShard(
+        BSON("a" << BSON("$in" << BSON_ARRAY(1 << BSONNULL))), BSONObj()));
+    ASSERT_FALSE(hashedChunkManager->getHashedInValuesByShard(
+        BSON("a" << BSON("$in" << BSON_ARRAY(1 << BSON_ARRAY(2)))), BSONObj()));
+    ASSERT_FALSE(hashedChunkManager->getHashedInValuesByShard(
+        BSON("a" << BSON("$in" << BSON_ARRAY("x"))),
+        BSON("locale"
+             << "mock_reverse_string")));
+}
+
+TEST_F(ChunkManagerQueryTest, NoHashedInValuesForRangeShardKey) {
+    const ShardKeyPattern rangeShardKeyPattern(BSON("a" << 1));
+    auto rangeChunkManager =
+        makeChunkManager(kNss, rangeShardKeyPattern, nullptr, false, {BSON("a" << 0)});
+    ASSERT_FALSE(rangeChunkManager->getHashedInValuesByShard(
+        BSON("a" << BSON("$in" << BSON_ARRAY(1 << 2))), BSONObj()));
+}
+
 TEST_F(ChunkManagerQueryTest, SnapshotQueryWithMoreShardsThanLatestMetadata) {
     const auto epoch = OID::gen();
     ChunkVersion version(1, 0, epoch);
@@ -122,7 +122,9 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
     }
 }
 
-BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
+BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 500000});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
@@ -372,6 +374,31 @@ void BM_RangeOverlapsChunk(benchmark::State& state,
     state.SetItemsProcessed(state.iterations());
 }
 
+template <typename CollectionMetadataBuilderFn>
+void BM_GetNextChunkOnShard(benchmark::State& state,
+                            CollectionMetadataBuilderFn makeCollectionMetadata) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+
+    auto cm = makeCollectionMetadata(nShards, nChunks);
+    auto keys = makeKeys(nChunks);
+    auto keysIter = makeCircularIterator(keys);
+    const ShardId shardId("shard0");
+
+    size_t nFound = 0;
+
+    for (auto keepRunning : state) {
+        auto range = cm->getChunkManager()->getNextChunkOnShard(*keysIter, shardId);
+        if (range.begin() != range.end()) {
+            ++nFound;
+        }
+        ++keysIter;
+    }
+
+    state.counters["nFound"] = nFound;
+    state.SetItemsProcessed(state.iterations());
+}
+
 // The following was adapted from the BENCHMARK_CAPTURE() macro where the
 // benchmark::internal::Benchmark* is returned rather than declared as a static variable.
 #define REGISTER_BENCHMARK_CAPTURE(func, test_case_name, ...) \
@@ -406,6 +433,10 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             BM_RangeOverlapsChunk, Pessimal, makeChunkManagerWithPessimalBalancedDistribution),
         REGISTER_BENCHMARK_CAPTURE(
             BM_RangeOverlapsChunk, Optimal, makeChunkManagerWithOptimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_GetNextChunkOnShard, Pessimal, makeChunkManagerWithPessimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_GetNextChunkOnShard, Optimal, makeChunkManagerWithOptimalBalancedDistribution),
     };
 
     for (auto bmCase : bmCases) {
@@ -413,6 +444,8 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({10, 50000})
             ->Args({100, 50000})
             ->Args({1000, 50000})
+            ->Args({2, 500000})
+            ->Args({100, 500000})
             ->Args({2, 2});
     }
 
@@ -42,6 +42,10 @@ uint64_t ChunkWritesTracker::clearBytesWritten() {
     return _bytesWritten.swap(0);
 }
 
+ChunkWritesTracker::WriteStatistics ChunkWritesTracker::takeWritesSinceReport() {
+    return {_numWritesSinceReport.swap(0), _bytesWrittenSinceReport.swap(0)};
+}
+
 bool ChunkWritesTracker::shouldSplit(uint64_t maxChunkSize) {
     if (_isLockedForSplitting) {
         return false;
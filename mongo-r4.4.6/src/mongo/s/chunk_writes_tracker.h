@@ -42,6 +42,14 @@ public:
      */
     static constexpr uint64_t kSplitTestFactor = 5;
 
+    /**
+     * Writes made to the chunk since its statistics were last reported to the config server.
+     */
+    struct WriteStatistics {
+        uint64_t numWrites{0};
+        uint64_t bytesWritten{0};
+    };
+
     /**
      * Add more bytes written to the chunk.
      */
@@ -56,6 +64,38 @@ public:
         return _bytesWritten.loadRelaxed();
     }
 
+    /**
+     * Notes a write of 'bytesWritten' bytes to the chunk, both for deciding when to split it and
+     * for the write statistics reported to the config server.
+     */
+    void addWrite(uint64_t bytesWritten) {
+        addBytesWritten(bytesWritten);
+        _numWritesSinceReport.fetchAndAdd(1);
+        _bytesWrittenSinceReport.fetchAndAdd(bytesWritten);
+    }
+
+    /**
+     * Returns the writes made to the chunk since the last call to takeWritesSinceReport().
+     */
+    WriteStatistics getWritesSinceReport() const {
+        return {_numWritesSinceReport.loadRelaxed(), _bytesWrittenSinceReport.loadRelaxed()};
+    }
+
+    /**
+     * Returns the writes made to the chunk since the previous call and starts counting again from
+     * zero. Unlike the bytes written used for splitting, these are not reset by splits.
+     */
+    WriteStatistics takeWritesSinceReport();
+
+    /**
+     * Adds writes which have not been reported yet, for instance the ones of a chunk which this
+     * chunk replaces in the routing table.
+     */
+    void addWritesSinceReport(const WriteStatistics& writes) {
+        _numWritesSinceReport.fetchAndAdd(writes.numWrites);
+        _bytesWrittenSinceReport.fetchAndAdd(writes.bytesWritten);
+    }
+
     /**
      * Sets the number of bytes in the tracker to zero and returns the number
      * of bytes in the tracker prior to clearing it.
@@ -86,6 +126,13 @@ private:
      */
     AtomicWord<unsigned long long> _bytesWritten{0};
 
+    /**
+     * The number of writes and of bytes written to this chunk since the write statistics were last
+     * taken for reporting to the config server.
+     */
+    AtomicWord<unsigned long long> _numWritesSinceReport{0};
+    AtomicWord<unsigned long long> _bytesWrittenSinceReport{0};
+
     /**
      * Protects _splitState when starting a split.
      */
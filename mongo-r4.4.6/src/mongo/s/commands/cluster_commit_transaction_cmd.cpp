@@ -34,7 +34,9 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/s/cluster_commands_helpers.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/transaction_router.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -79,6 +81,18 @@ public:
 
         const auto commitCmd =
             CommitTransaction::parse(IDLParserErrorContext("commit cmd"), cmdObj);
+
+        // Whether or not the commit succeeded, its writes may now be visible, so stop serving
+        // cached finds for the namespaces the transaction wrote to. A commit recovered through a
+        // recovery token on another router has no record of them here, and relies on the cache's
+        // expiry instead.
+        ON_BLOCK_EXIT([&] {
+            auto& resultCache = ClusterQueryResultCache::get(opCtx);
+            for (const auto& nss : txnRouter.getWrittenNamespaces()) {
+                resultCache.invalidate(nss);
+            }
+        });
+
         auto commitRes = txnRouter.commitTransaction(opCtx, commitCmd.getRecoveryToken());
         CommandHelpers::filterCommandReplyForPassthrough(commitRes, &result);
         return true;
@@ -48,11 +48,13 @@
 #include "mongo/s/commands/strategy.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/session_catalog_router.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/transaction_router.h"
 #include "mongo/s/would_change_owning_shard_exception.h"
 #include "mongo/s/write_ops/cluster_write.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -248,6 +250,17 @@ public:
              BSONObjBuilder& result) override {
         const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbName, cmdObj));
 
+        // Once the write is done, stop serving cached finds which may not reflect it. A write made
+        // in a transaction only becomes visible when the transaction commits, so defer it until
+        // then.
+        ON_BLOCK_EXIT([&] {
+            if (auto txnRouter = TransactionRouter::get(opCtx)) {
+                txnRouter.onWriteToNamespace(nss);
+            } else {
+                ClusterQueryResultCache::get(opCtx).invalidate(nss);
+            }
+        });
+
         // Collect metrics.
         _updateMetrics.collectMetrics(cmdObj);
 
@@ -35,6 +35,7 @@
 #include "mongo/logv2/log.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 
 namespace mongo {
 namespace {
@@ -83,11 +84,13 @@ public:
                 grid->isShardingInitialized());
 
         auto const catalogCache = grid->catalogCache();
+        auto& resultCache = ClusterQueryResultCache::get(opCtx);
 
         const auto argumentElem = cmdObj.firstElement();
         if (argumentElem.isNumber() || argumentElem.isBoolean()) {
             LOGV2(22761, "Routing metadata flushed for all databases");
             catalogCache->purgeAllDatabases();
+            resultCache.clear();
         } else {
             const auto ns = argumentElem.checkAndGetStringData();
             if (nsIsDbOnly(ns)) {
@@ -96,6 +99,7 @@ public:
                       "Routing metadata flushed for database",
                       "db"_attr = ns);
                 catalogCache->purgeDatabase(ns);
+                resultCache.clear();
             } else {
                 const NamespaceString nss(ns);
                 LOGV2(22763,
@@ -103,6 +107,7 @@ public:
                       "Routing metadata flushed for collection",
                       "namespace"_attr = nss);
                 catalogCache->purgeCollection(nss);
+                resultCache.invalidate(nss);
             }
         }
 
@@ -83,6 +83,20 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, rules);
 }
 
+/**
+ * Returns the ordering with which to encode the sort keys of a sorted merge as KeyStrings, or
+ * boost::none if there is no sort or it has more fields than a KeyString ordering can hold.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const AsyncResultsMergerParams& params) {
+    const auto& sort = params.getSort();
+    if (!sort || static_cast<size_t>(sort->nFields()) > Ordering::kMaxCompoundIndexKeys) {
+        return boost::none;
+    }
+    // Like the woCompare() in compareSortKeys(), the ordering only looks at the sign of each field
+    // of the sort key pattern.
+    return Ordering::make(*sort);
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -95,8 +109,11 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _sortKeyOrdering(makeSortKeyOrdering(_params)),
+      _mergeQueue(MergingComparator(_remotes,
+                                    _params.getSort().value_or(BSONObj()),
+                                    _params.getCompareWholeSortKey(),
+                                    _sortKeyOrdering.has_value())),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
@@ -111,6 +128,7 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
 
         // A remote cannot be flagged as 'partialResultsReturned' if 'allowPartialResults' is false.
         invariant(!(_remotes.back().partialResultsReturned && !_params.getAllowPartialResults()));
+        _mergeQueue.resize(_remotes.size());
 
         // We don't check the return value of _addBatchToBuffer here; if there was an error,
         // it will be stored in the remote and the first call to ready() will return true.
@@ -209,6 +227,7 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
                               remote.getCursorResponse().getNSS(),
                               remote.getCursorResponse().getCursorId(),
                               remote.getCursorResponse().getPartialResultsReturned());
+        _mergeQueue.resize(_remotes.size());
         _addBatchToBuffer(lk, newIndex, remote.getCursorResponse());
     }
 }
@@ -354,18 +373,22 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     }
 
     size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
 
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    if (_sortKeyOrdering) {
+        _remotes[smallestRemote].sortKeyBuffer.pop();
+    }
 
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
+    // Replay the merge with the next result from 'smallestRemote' if it has a next result, or
+    // take it out of the merge until its next batch arrives.
     if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+        _mergeQueue.replaceTop();
+    } else {
+        _mergeQueue.pop();
     }
 
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
@@ -698,6 +721,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         remote.partialResultsReturned = (remote.status != ErrorCodes::ExchangePassthrough);
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<KeyString::Value> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
         remote.status = Status::OK();
         remote.cursorId = 0;
     }
@@ -770,6 +795,14 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                          << "' was not of type Object in document: " << obj);
                 return false;
             }
+
+            if (_sortKeyOrdering) {
+                remote.sortKeyBuffer.push(
+                    KeyString::HeapBuilder(KeyString::Version::kLatestVersion,
+                                           extractSortKey(obj, _params.getCompareWholeSortKey()),
+                                           *_sortKeyOrdering)
+                        .release());
+            }
         }
 
         ClusterQueryResult result(obj);
@@ -896,13 +929,17 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 // AsyncResultsMerger::MergingComparator
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+int AsyncResultsMerger::MergingComparator::operator()(size_t lhs, size_t rhs) const {
+    if (_compareKeyStrings) {
+        return _remotes[lhs].sortKeyBuffer.front().compare(_remotes[rhs].sortKeyBuffer.front());
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
     return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
                            extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+                           _sort);
 }
 
 bool AsyncResultsMerger::PromisedMinSortKeyComparator::operator()(
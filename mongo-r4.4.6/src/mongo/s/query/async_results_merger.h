@@ -35,11 +35,14 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
+#include "mongo/s/query/loser_tree.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
@@ -308,6 +311,10 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The sort keys of the results in 'docBuffer', encoded as KeyStrings so that comparing
+        // two of them is a memcmp. Only used when merging in sorted order by KeyString.
+        std::queue<KeyString::Value> sortKeyBuffer;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -320,14 +327,22 @@ private:
         long long fetchedCount = 0;
     };
 
+    /**
+     * Compares the next results of two remotes by sort key, returning an int less than, equal to
+     * or greater than 0 like woCompare.
+     */
     class MergingComparator {
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool compareKeyStrings)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _compareKeyStrings(compareKeyStrings) {}
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        int operator()(size_t lhs, size_t rhs) const;
 
     private:
         const std::vector<RemoteCursorData>& _remotes;
@@ -338,6 +353,10 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When true, the remotes' 'sortKeyBuffer' is filled and compared instead of the $sortKey
+        // of the buffered documents.
+        const bool _compareKeyStrings;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -480,15 +499,20 @@ private:
     TailableModeEnum _tailableMode;
     AsyncResultsMergerParams _params;
 
+    // The ordering used to encode sort keys as KeyStrings. Is unset if there is no sort, or if the
+    // sort has too many fields to be encoded, in which case the merge compares the $sortKey BSON.
+    const boost::optional<Ordering> _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     mutable Mutex _mutex = MONGO_MAKE_LATCH("AsyncResultsMerger::_mutex");
 
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // Tournament over the remotes which have buffered results, whose winner is the index into
+    // '_remotes' for the remote host that has the next document to return, according to the sort
+    // order. Has one leaf per remote. Used only if there is a sort.
+    LoserTree<MergingComparator> _mergeQueue;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
@@ -42,6 +42,7 @@
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_merge.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
@@ -68,6 +69,7 @@
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/cluster_query_knobs_gen.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 #include "mongo/s/query/establish_cursors.h"
@@ -77,6 +79,7 @@
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/transaction_router.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -188,6 +191,26 @@ void updateHostsTargetedMetrics(OperationContext* opCtx,
     }
 }
 
+/**
+ * Returns the namespaces which the $out or $merge stage ending the pipeline of 'request', if any,
+ * may write to.
+ */
+stdx::unordered_set<NamespaceString> getOutputNamespaces(const AggregationRequest& request) {
+    const auto& pipeline = request.getPipeline();
+    if (pipeline.empty()) {
+        return {};
+    }
+
+    const auto lastStage =
+        LiteParsedDocumentSource::parse(request.getNamespaceString(), pipeline.back());
+    const auto& stageName = lastStage->getParseTimeName();
+    if (stageName != DocumentSourceOut::kStageName &&
+        stageName != DocumentSourceMerge::kStageName) {
+        return {};
+    }
+    return lastStage->getInvolvedNamespaces();
+}
+
 }  // namespace
 
 Status ClusterAggregate::runAggregate(OperationContext* opCtx,
@@ -225,6 +248,18 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
     auto hasChangeStream = liteParsedPipeline.hasChangeStream();
     auto involvedNamespaces = liteParsedPipeline.getInvolvedNamespaces();
 
+    // Once an $out or $merge has run, stop serving cached finds on the collection it wrote to,
+    // which may not reflect its output. Explains do not write anything.
+    const auto outputNamespaces = request.getExplain()
+        ? stdx::unordered_set<NamespaceString>{}
+        : getOutputNamespaces(request);
+    ON_BLOCK_EXIT([&] {
+        auto& resultCache = ClusterQueryResultCache::get(opCtx);
+        for (const auto& nss : outputNamespaces) {
+            resultCache.invalidate(nss);
+        }
+    });
+
     // If the routing table is valid, we obtain a reference to it. If the table is not valid, then
     // either the database does not exist, or there are no shards in the cluster. In the latter
     // case, we always return an empty cursor. In the former case, if the requested aggregation is a
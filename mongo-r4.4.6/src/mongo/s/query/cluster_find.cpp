@@ -33,6 +33,7 @@
 
 #include "mongo/s/query/cluster_find.h"
 
+#include <map>
 #include <memory>
 #include <set>
 #include <vector>
@@ -50,6 +51,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/overflow_arithmetic.h"
@@ -61,6 +63,7 @@
 #include "mongo/s/query/async_results_merger.h"
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/establish_cursors.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/s/stale_exception.h"
@@ -170,16 +173,35 @@ StatusWith<std::unique_ptr<QueryRequest>> transformQueryForShards(
     return std::move(newQR);
 }
 
+/**
+ * Returns the filter {<field>: {$in: <values>}} sent to a shard in place of a $in over a hashed
+ * shard key, with only the values which the shard owns.
+ */
+BSONObj makeHashedInFilterForShard(const BSONObj& filter, const std::vector<BSONElement>& values) {
+    BSONObjBuilder filterBuilder;
+    {
+        BSONObjBuilder inBuilder(
+            filterBuilder.subobjStart(filter.firstElementFieldNameStringData()));
+        BSONArrayBuilder valuesBuilder(inBuilder.subarrayStart("$in"));
+        for (const auto& value : values) {
+            valuesBuilder.append(value);
+        }
+    }
+    return filterBuilder.obj();
+}
+
 /**
  * Constructs the find commands sent to each targeted shard to establish cursors, attaching the
- * shardVersion and txnNumber, if necessary.
+ * shardVersion and txnNumber, if necessary. If 'hashedInValuesByShard' is set, the filter sent to
+ * each shard only keeps the values of the $in over the hashed shard key which that shard owns.
  */
 std::vector<std::pair<ShardId, BSONObj>> constructRequestsForShards(
     OperationContext* opCtx,
     const CachedCollectionRoutingInfo& routingInfo,
     const std::set<ShardId>& shardIds,
     const CanonicalQuery& query,
-    bool appendGeoNearDistanceProjection) {
+    bool appendGeoNearDistanceProjection,
+    const boost::optional<std::map<ShardId, std::vector<BSONElement>>>& hashedInValuesByShard) {
 
     std::unique_ptr<QueryRequest> qrToForward;
     if (shardIds.size() > 1) {
@@ -201,7 +223,14 @@ std::vector<std::pair<ShardId, BSONObj>> constructRequestsForShards(
         invariant(!shard->isConfig() || shard->getConnString().type() != ConnectionString::INVALID);
 
         BSONObjBuilder cmdBuilder;
-        qrToForward->asFindCommand(&cmdBuilder);
+        if (hashedInValuesByShard && shardIds.size() > 1) {
+            QueryRequest qrForShard(*qrToForward);
+            qrForShard.setFilter(makeHashedInFilterForShard(qrToForward->getFilter(),
+                                                            hashedInValuesByShard->at(shardId)));
+            qrForShard.asFindCommand(&cmdBuilder);
+        } else {
+            qrToForward->asFindCommand(&cmdBuilder);
+        }
 
         if (routingInfo.cm()) {
             routingInfo.cm()->getVersion(shardId).appendToCommand(&cmdBuilder);
@@ -241,11 +270,25 @@ CursorId runQueryWithoutRetrying(OperationContext* opCtx,
                                  const CachedCollectionRoutingInfo& routingInfo,
                                  std::vector<BSONObj>* results,
                                  bool* partialResultsReturned) {
-    // Get the set of shards on which we will run the query.
-    auto shardIds = getTargetedShardsForQuery(opCtx,
-                                              routingInfo,
-                                              query.getQueryRequest().getFilter(),
-                                              query.getQueryRequest().getCollation());
+    // Get the set of shards on which we will run the query. A $in over a hashed shard key is split
+    // by the shard which owns each value.
+    boost::optional<std::map<ShardId, std::vector<BSONElement>>> hashedInValuesByShard;
+    if (routingInfo.cm()) {
+        hashedInValuesByShard = routingInfo.cm()->getHashedInValuesByShard(
+            query.getQueryRequest().getFilter(), query.getQueryRequest().getCollation());
+    }
+
+    std::set<ShardId> shardIds;
+    if (hashedInValuesByShard) {
+        for (const auto& shardAndValues : *hashedInValuesByShard) {
+            shardIds.insert(shardAndValues.first);
+        }
+    } else {
+        shardIds = getTargetedShardsForQuery(opCtx,
+                                             routingInfo,
+                                             query.getQueryRequest().getFilter(),
+                                             query.getQueryRequest().getCollation());
+    }
 
     // Construct the query and parameters. Defer setting skip and limit here until
     // we determine if the query is targeting multi-shards or a single shard below.
@@ -306,8 +349,12 @@ CursorId runQueryWithoutRetrying(OperationContext* opCtx,
     // Construct the requests that we will use to establish cursors on the targeted shards,
     // attaching the shardVersion and txnNumber, if necessary.
 
-    auto requests = constructRequestsForShards(
-        opCtx, routingInfo, shardIds, query, appendGeoNearDistanceProjection);
+    auto requests = constructRequestsForShards(opCtx,
+                                               routingInfo,
+                                               shardIds,
+                                               query,
+                                               appendGeoNearDistanceProjection,
+                                               hashedInValuesByShard);
 
     // Establish the cursors with a consistent shardVersion across shards.
     params.remotes = establishCursors(opCtx,
@@ -425,6 +472,73 @@ CursorId runQueryWithoutRetrying(OperationContext* opCtx,
     return cursorId;
 }
 
+/**
+ * Returns whether the results of 'query' may be served from the result cache and stored in it. The
+ * cache only holds the results of finds on sharded collections which return everything in their
+ * first batch. It is not used when the client asks to observe a particular point in time, since the
+ * cached results may predate it, nor when the results depend on when the find runs.
+ */
+bool canUseResultCache(OperationContext* opCtx,
+                       const CanonicalQuery& query,
+                       const CachedCollectionRoutingInfo& routingInfo) {
+    if (!ClusterQueryResultCache::isEnabled() || !routingInfo.cm() ||
+        TransactionRouter::get(opCtx)) {
+        return false;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern &&
+        readConcernArgs.getLevel() != repl::ReadConcernLevel::kAvailableReadConcern) {
+        return false;
+    }
+
+    if (readConcernArgs.getArgsAfterClusterTime() || readConcernArgs.getArgsAtClusterTime() ||
+        readConcernArgs.getArgsOpTime()) {
+        return false;
+    }
+
+    const auto& qr = query.getQueryRequest();
+    return !qr.isTailable() && !qr.isAllowPartialResults() && !qr.isExhaust() &&
+        !qr.isReadOnce() && ClusterQueryResultCache::isCacheable(qr);
+}
+
+/**
+ * Answers 'query' from the result cache if it holds its results for the current routing table of
+ * the collection, and otherwise runs it against the shards and caches its results if they fit in
+ * the first batch.
+ */
+CursorId runQueryWithResultCache(OperationContext* opCtx,
+                                 const CanonicalQuery& query,
+                                 const ReadPreferenceSetting& readPref,
+                                 const CachedCollectionRoutingInfo& routingInfo,
+                                 std::vector<BSONObj>* results,
+                                 bool* partialResultsReturned) {
+    auto& resultCache = ClusterQueryResultCache::get(opCtx);
+    const auto key = ClusterQueryResultCache::makeKey(query, readPref);
+    const auto version = routingInfo.cm()->getVersion();
+    const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+
+    if (auto cachedResults = resultCache.lookup(query.nss(), key, version, now)) {
+        *results = std::move(*cachedResults);
+        CurOp::get(opCtx)->debug().nShards = 0;
+        CurOp::get(opCtx)->debug().nreturned = results->size();
+        CurOp::get(opCtx)->debug().cursorExhausted = true;
+        return CursorId(0);
+    }
+
+    // Read before the find starts, so that a write which completes while it runs prevents its
+    // results from being cached
+    const auto generation = resultCache.getGeneration(query.nss());
+
+    const auto cursorId = runQueryWithoutRetrying(
+        opCtx, query, readPref, routingInfo, results, partialResultsReturned);
+    if (cursorId == CursorId(0)) {
+        resultCache.insert(query.nss(), key, version, generation, *results, now);
+    }
+
+    return cursorId;
+}
+
 /**
  * Populates or re-populates some state of the OperationContext from what's stored on the cursor
  * and/or what's specified on the request.
@@ -508,6 +622,11 @@ CursorId ClusterFind::runQuery(OperationContext* opCtx,
         auto routingInfo = uassertStatusOK(routingInfoStatus);
 
         try {
+            if (canUseResultCache(opCtx, query, routingInfo)) {
+                return runQueryWithResultCache(
+                    opCtx, query, readPref, routingInfo, results, partialResultsReturned);
+            }
+
             return runQueryWithoutRetrying(
                 opCtx, query, readPref, routingInfo, results, partialResultsReturned);
         } catch (ExceptionFor<ErrorCodes::StaleDbVersion>& ex) {
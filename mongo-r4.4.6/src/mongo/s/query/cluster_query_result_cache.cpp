@@ -0,0 +1,249 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include <iterator>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/service_context.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
+
+namespace mongo {
+namespace {
+
+const auto getClusterQueryResultCache =
+    ServiceContext::declareDecoration<ClusterQueryResultCache>();
+
+// Approximate memory used by an entry besides its key and results
+constexpr size_t kPerEntryOverheadBytes = 128;
+
+/**
+ * Returns whether 'obj' uses an expression or a variable, whose value depends on when the find
+ * runs. Also matches such names within string literals, which only makes the find uncacheable.
+ */
+bool usesNondeterministicValues(const BSONObj& obj) {
+    for (const auto& elem : obj) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "$rand"_sd || fieldName == "$sampleRate"_sd) {
+            return true;
+        }
+
+        if (elem.type() == String) {
+            const auto value = elem.valueStringData();
+            for (auto&& variable : {"$$NOW"_sd, "$$CLUSTER_TIME"_sd}) {
+                if (value.startsWith(variable) &&
+                    (value.size() == variable.size() || value[variable.size()] == '.')) {
+                    return true;
+                }
+            }
+        } else if (elem.isABSONObj() && usesNondeterministicValues(elem.Obj())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+ClusterQueryResultCache& ClusterQueryResultCache::get(ServiceContext* serviceContext) {
+    return getClusterQueryResultCache(serviceContext);
+}
+
+ClusterQueryResultCache& ClusterQueryResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool ClusterQueryResultCache::isEnabled() {
+    return clusterQueryResultCacheSizeBytes.load() > 0;
+}
+
+std::string ClusterQueryResultCache::makeKey(const CanonicalQuery& query,
+                                             const ReadPreferenceSetting& readPref) {
+    BSONObjBuilder findCmdBuilder;
+    query.getQueryRequest().asFindCommand(&findCmdBuilder);
+
+    // Neither the time limit of the find nor the runtime constants, which mongos attaches to every
+    // find, change the results of the finds which are cacheable
+    const auto findCmd = findCmdBuilder.obj()
+                             .removeField(QueryRequest::cmdOptionMaxTimeMS)
+                             .removeField(QueryRequest::kRuntimeConstantsField);
+
+    // Compare the find commands byte for byte, so that even values which compare equal but have a
+    // different type get their own entry
+    return std::string(findCmd.objdata(), findCmd.objsize()) + readPref.toString();
+}
+
+bool ClusterQueryResultCache::isCacheable(const QueryRequest& qr) {
+    return !usesNondeterministicValues(qr.getFilter()) && !usesNondeterministicValues(qr.getProj());
+}
+
+uint64_t ClusterQueryResultCache::getGeneration(const NamespaceString& nss) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _generation;
+}
+
+boost::optional<std::vector<BSONObj>> ClusterQueryResultCache::lookup(const NamespaceString& nss,
+                                                                      const std::string& key,
+                                                                      const ChunkVersion& version,
+                                                                      Date_t now) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    const auto nsIt = _namespaces.find(nss.ns());
+    if (nsIt == _namespaces.end()) {
+        return boost::none;
+    }
+
+    const auto entryIt = nsIt->second.entries.find(key);
+    if (entryIt == nsIt->second.entries.end()) {
+        return boost::none;
+    }
+
+    const auto it = entryIt->second;
+    if (it->version != version || it->expiresAt <= now) {
+        _erase(lk, it);
+        return boost::none;
+    }
+
+    // Move the entry to the front of the LRU list
+    _entries.splice(_entries.begin(), _entries, it);
+    return it->results;
+}
+
+void ClusterQueryResultCache::insert(const NamespaceString& nss,
+                                     const std::string& key,
+                                     const ChunkVersion& version,
+                                     uint64_t generation,
+                                     std::vector<BSONObj> results,
+                                     Date_t now) {
+    const auto maxSizeBytes = static_cast<size_t>(clusterQueryResultCacheSizeBytes.load());
+
+    size_t sizeBytes = kPerEntryOverheadBytes + key.size();
+    for (auto& result : results) {
+        result = result.getOwned();
+        sizeBytes += result.objsize();
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (sizeBytes > maxSizeBytes) {
+        return;
+    }
+
+    // A namespace without entries is not tracked, so it may have been invalidated at any point
+    auto nsIt = _namespaces.find(nss.ns());
+    const auto invalidatedAt = nsIt != _namespaces.end() ? nsIt->second.invalidatedAt : _generation;
+    if (invalidatedAt > generation) {
+        return;
+    }
+
+    if (nsIt != _namespaces.end()) {
+        const auto existing = nsIt->second.entries.find(key);
+        if (existing != nsIt->second.entries.end()) {
+            _erase(lk, existing->second);
+        }
+    }
+
+    _evictToFit(lk, maxSizeBytes - sizeBytes);
+
+    // Erasing entries may have dropped the namespace
+    auto& nsEntries = _namespaces[nss.ns()];
+    if (nsEntries.entries.empty()) {
+        nsEntries.invalidatedAt = invalidatedAt;
+    }
+
+    const auto lifetime = Milliseconds(clusterQueryResultCacheEntryLifetimeMS.load());
+    _entries.push_front(
+        {nss, key, version, lifetime > Milliseconds(0) ? now + lifetime : Date_t::max(),
+         std::move(results), sizeBytes});
+    nsEntries.entries[key] = _entries.begin();
+    _sizeBytes += sizeBytes;
+}
+
+void ClusterQueryResultCache::invalidate(const NamespaceString& nss) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_generation;
+
+    const auto nsIt = _namespaces.find(nss.ns());
+    if (nsIt == _namespaces.end()) {
+        return;
+    }
+
+    // Dropping the last entry drops the namespace, whose invalidation is then implied by it not
+    // being tracked
+    auto entries = nsIt->second.entries;
+    for (auto&& entry : entries) {
+        _erase(lk, entry.second);
+    }
+}
+
+void ClusterQueryResultCache::clear() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_generation;
+    _namespaces.clear();
+    _entries.clear();
+    _sizeBytes = 0;
+}
+
+size_t ClusterQueryResultCache::numEntries() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _entries.size();
+}
+
+size_t ClusterQueryResultCache::numNamespaces() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _namespaces.size();
+}
+
+size_t ClusterQueryResultCache::sizeBytes() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _sizeBytes;
+}
+
+void ClusterQueryResultCache::_erase(WithLock, EntryList::iterator it) {
+    const auto nsIt = _namespaces.find(it->nss.ns());
+    invariant(nsIt != _namespaces.end());
+    nsIt->second.entries.erase(it->key);
+    if (nsIt->second.entries.empty()) {
+        _namespaces.erase(nsIt);
+    }
+    _sizeBytes -= it->sizeBytes;
+    _entries.erase(it);
+}
+
+void ClusterQueryResultCache::_evictToFit(WithLock lk, size_t maxSizeBytes) {
+    while (!_entries.empty() && _sizeBytes > maxSizeBytes) {
+        _erase(lk, std::prev(_entries.end()));
+    }
+}
+
+}  // namespace mongo
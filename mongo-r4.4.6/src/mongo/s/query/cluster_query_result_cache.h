@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class OperationContext;
+class QueryRequest;
+struct ReadPreferenceSetting;
+class ServiceContext;
+
+/**
+ * Caches on mongos the complete results of finds on sharded collections, so that repeated reads of
+ * hot, rarely written data are answered without contacting the shards. Disabled unless
+ * clusterQueryResultCacheSizeBytes is set.
+ *
+ * Each entry is tagged with the version of the routing table which the find ran against and is
+ * only served while the routing table of the collection still has that version, so chunk
+ * migrations, splits and drops reported by the shards invalidate it. Writes routed through this
+ * mongos invalidate the entries of their collection. There is no channel for the shards to report
+ * the writes which go through other routers, so entries also expire after
+ * clusterQueryResultCacheEntryLifetimeMS.
+ */
+class ClusterQueryResultCache {
+    ClusterQueryResultCache(const ClusterQueryResultCache&) = delete;
+    ClusterQueryResultCache& operator=(const ClusterQueryResultCache&) = delete;
+
+public:
+    ClusterQueryResultCache() = default;
+
+    static ClusterQueryResultCache& get(ServiceContext* serviceContext);
+    static ClusterQueryResultCache& get(OperationContext* opCtx);
+
+    /**
+     * Returns whether the cache is enabled through clusterQueryResultCacheSizeBytes.
+     */
+    static bool isEnabled();
+
+    /**
+     * Returns the key for the results of 'query' when run with 'readPref'. Finds which differ in
+     * anything that can change their result, including the values they compare against, get
+     * different keys.
+     */
+    static std::string makeKey(const CanonicalQuery& query, const ReadPreferenceSetting& readPref);
+
+    /**
+     * Returns whether the results of 'qr' may be cached, which is not the case when they depend on
+     * when the find runs, through $rand, $sampleRate, $$NOW or $$CLUSTER_TIME.
+     */
+    static bool isCacheable(const QueryRequest& qr);
+
+    /**
+     * Returns the current generation, which must be read before a find on 'nss' starts and passed
+     * to insert() with its results. Every invalidation starts a new generation.
+     */
+    uint64_t getGeneration(const NamespaceString& nss);
+
+    /**
+     * Returns the cached results for 'key' if they were produced against routing table 'version'
+     * and have not expired.
+     */
+    boost::optional<std::vector<BSONObj>> lookup(const NamespaceString& nss,
+                                                 const std::string& key,
+                                                 const ChunkVersion& version,
+                                                 Date_t now);
+
+    /**
+     * Caches 'results' for 'key', unless 'nss' was invalidated after 'generation' was read, in
+     * which case the results may predate a write. Evicts the least recently used entries to stay
+     * within clusterQueryResultCacheSizeBytes.
+     */
+    void insert(const NamespaceString& nss,
+                const std::string& key,
+                const ChunkVersion& version,
+                uint64_t generation,
+                std::vector<BSONObj> results,
+                Date_t now);
+
+    /**
+     * Drops the cached results of 'nss' and rejects the results of the finds on it which are still
+     * running. Called once a write to 'nss' through this mongos has completed.
+     */
+    void invalidate(const NamespaceString& nss);
+
+    /**
+     * Drops every cached result.
+     */
+    void clear();
+
+    size_t numEntries() const;
+    size_t numNamespaces() const;
+    size_t sizeBytes() const;
+
+private:
+    struct Entry {
+        NamespaceString nss;
+        std::string key;
+        ChunkVersion version;
+        Date_t expiresAt;
+        std::vector<BSONObj> results;
+        size_t sizeBytes;
+    };
+
+    // Most recently used first
+    using EntryList = std::list<Entry>;
+
+    // Only kept for the namespaces which have entries
+    struct NamespaceEntries {
+        // The generation at which the namespace may have been invalidated last
+        uint64_t invalidatedAt{0};
+        stdx::unordered_map<std::string, EntryList::iterator> entries;
+    };
+
+    void _erase(WithLock, EntryList::iterator it);
+
+    void _evictToFit(WithLock, size_t maxSizeBytes);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ClusterQueryResultCache::_mutex");
+
+    EntryList _entries;
+
+    StringMap<NamespaceEntries> _namespaces;
+
+    // Incremented by every invalidation
+    uint64_t _generation{0};
+
+    size_t _sizeBytes{0};
+};
+
+}  // namespace mongo
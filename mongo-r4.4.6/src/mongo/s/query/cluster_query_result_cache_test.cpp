@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test", "coll");
+const NamespaceString kOtherNss("test", "other");
+const std::string kKey = "key";
+
+class ClusterQueryResultCacheTest : public unittest::Test {
+protected:
+    void setUp() override {
+        clusterQueryResultCacheSizeBytes.store(1024 * 1024);
+        clusterQueryResultCacheEntryLifetimeMS.store(1000);
+    }
+
+    void tearDown() override {
+        clusterQueryResultCacheSizeBytes.store(0);
+        clusterQueryResultCacheEntryLifetimeMS.store(1000);
+    }
+
+    std::vector<BSONObj> makeResults(int numDocs) {
+        std::vector<BSONObj> results;
+        for (int i = 0; i < numDocs; ++i) {
+            results.push_back(BSON("_id" << i));
+        }
+        return results;
+    }
+
+    void insert(const NamespaceString& nss, const std::string& key, std::vector<BSONObj> results) {
+        _cache.insert(nss, key, _version, _cache.getGeneration(nss), std::move(results), _now);
+    }
+
+    ClusterQueryResultCache _cache;
+    const ChunkVersion _version{1, 0, OID::gen()};
+    const Date_t _now = Date_t::fromMillisSinceEpoch(1000 * 1000);
+};
+
+TEST_F(ClusterQueryResultCacheTest, ServesCachedResults) {
+    insert(kNss, kKey, makeResults(3));
+
+    auto results = _cache.lookup(kNss, kKey, _version, _now);
+    ASSERT(results);
+    ASSERT_EQ(3U, results->size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), (*results)[2]);
+
+    ASSERT_FALSE(_cache.lookup(kNss, "otherKey", _version, _now));
+    ASSERT_FALSE(_cache.lookup(kOtherNss, kKey, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, DoesNotServeResultsForOtherRoutingTableVersion) {
+    insert(kNss, kKey, makeResults(1));
+
+    ChunkVersion newerVersion(2, 0, _version.epoch());
+    ASSERT_FALSE(_cache.lookup(kNss, kKey, newerVersion, _now));
+
+    // The stale entry is dropped on lookup
+    ASSERT_EQ(0U, _cache.numEntries());
+    ASSERT_EQ(0U, _cache.sizeBytes());
+}
+
+TEST_F(ClusterQueryResultCacheTest, ExpiresEntries) {
+    insert(kNss, kKey, makeResults(1));
+
+    ASSERT(_cache.lookup(kNss, kKey, _version, _now + Milliseconds(999)));
+    ASSERT_FALSE(_cache.lookup(kNss, kKey, _version, _now + Milliseconds(1000)));
+}
+
+TEST_F(ClusterQueryResultCacheTest, InvalidateDropsOnlyEntriesOfNamespace) {
+    insert(kNss, kKey, makeResults(1));
+    insert(kOtherNss, kKey, makeResults(1));
+
+    _cache.invalidate(kNss);
+
+    ASSERT_FALSE(_cache.lookup(kNss, kKey, _version, _now));
+    ASSERT(_cache.lookup(kOtherNss, kKey, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, RejectsResultsOfFindWhichRanConcurrentlyWithWrite) {
+    const auto generation = _cache.getGeneration(kNss);
+
+    // A write completes while the find is running
+    _cache.invalidate(kNss);
+
+    _cache.insert(kNss, kKey, _version, generation, makeResults(1), _now);
+    ASSERT_FALSE(_cache.lookup(kNss, kKey, _version, _now));
+
+    // A find which starts after the write may cache its results
+    insert(kNss, kKey, makeResults(1));
+    ASSERT(_cache.lookup(kNss, kKey, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, AcceptsResultsOfFindWhichRanConcurrentlyWithOtherWrite) {
+    insert(kNss, "a", makeResults(1));
+    const auto generation = _cache.getGeneration(kNss);
+
+    // A write to another namespace completes while the find is running
+    _cache.invalidate(kOtherNss);
+
+    _cache.insert(kNss, kKey, _version, generation, makeResults(1), _now);
+    ASSERT(_cache.lookup(kNss, kKey, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, TracksOnlyNamespacesWithEntries) {
+    for (int i = 0; i < 10; ++i) {
+        _cache.getGeneration(NamespaceString("test", "coll" + std::to_string(i)));
+    }
+    ASSERT_EQ(0U, _cache.numNamespaces());
+
+    insert(kNss, kKey, makeResults(1));
+    insert(kOtherNss, kKey, makeResults(1));
+    ASSERT_EQ(2U, _cache.numNamespaces());
+
+    _cache.invalidate(kNss);
+    ASSERT_EQ(1U, _cache.numNamespaces());
+
+    // Dropping the last entry of a namespace on lookup also drops the namespace
+    ASSERT_FALSE(_cache.lookup(kOtherNss, kKey, _version, _now + Milliseconds(1000)));
+    ASSERT_EQ(0U, _cache.numNamespaces());
+}
+
+TEST_F(ClusterQueryResultCacheTest, EvictsLeastRecentlyUsedEntriesToStayWithinSize) {
+    insert(kNss, "a", makeResults(10));
+    const auto entrySizeBytes = _cache.sizeBytes();
+    clusterQueryResultCacheSizeBytes.store(2 * entrySizeBytes + entrySizeBytes / 2);
+
+    insert(kNss, "b", makeResults(10));
+
+    // Using "a" makes "b" the least recently used entry
+    ASSERT(_cache.lookup(kNss, "a", _version, _now));
+    insert(kNss, "c", makeResults(10));
+
+    ASSERT_EQ(2U, _cache.numEntries());
+    ASSERT_LTE(_cache.sizeBytes(), 2 * entrySizeBytes + entrySizeBytes / 2);
+    ASSERT(_cache.lookup(kNss, "a", _version, _now));
+    ASSERT_FALSE(_cache.lookup(kNss, "b", _version, _now));
+    ASSERT(_cache.lookup(kNss, "c", _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, DoesNotCacheResultsLargerThanCache) {
+    clusterQueryResultCacheSizeBytes.store(64);
+    insert(kNss, kKey, makeResults(100));
+    ASSERT_EQ(0U, _cache.numEntries());
+}
+
+TEST_F(ClusterQueryResultCacheTest, ClearDropsAllEntries) {
+    insert(kNss, kKey, makeResults(1));
+    insert(kOtherNss, kKey, makeResults(1));
+
+    _cache.clear();
+
+    ASSERT_EQ(0U, _cache.numEntries());
+    ASSERT_EQ(0U, _cache.sizeBytes());
+    ASSERT_FALSE(_cache.lookup(kNss, kKey, _version, _now));
+}
+
+TEST(ClusterQueryResultCacheIsCacheableTest, RejectsFindsWhoseResultsDependOnWhenTheyRun) {
+    auto isCacheable = [](const char* filter, const char* projection) {
+        QueryRequest qr(kNss);
+        qr.setFilter(fromjson(filter));
+        qr.setProj(fromjson(projection));
+        return ClusterQueryResultCache::isCacheable(qr);
+    };
+
+    ASSERT(isCacheable("{a: 1, b: {$in: ['$$NOWHERE', 'NOW']}}", "{a: 1}"));
+    ASSERT(isCacheable("{$expr: {$eq: ['$a', '$$ROOT.b']}}", "{c: '$d'}"));
+
+    ASSERT_FALSE(isCacheable("{$expr: {$lt: [{$rand: {}}, 0.5]}}", "{}"));
+    ASSERT_FALSE(isCacheable("{a: 1, $sampleRate: 0.5}", "{}"));
+    ASSERT_FALSE(isCacheable("{$expr: {$lt: ['$date', '$$NOW']}}", "{}"));
+    ASSERT_FALSE(isCacheable("{$or: [{a: 1}, {$expr: {$eq: ['$ts', '$$CLUSTER_TIME']}}]}", "{}"));
+    ASSERT_FALSE(isCacheable("{}", "{now: '$$NOW'}"));
+}
+
+}  // namespace
+}  // namespace mongo
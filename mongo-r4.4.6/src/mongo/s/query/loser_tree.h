@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * A tournament tree which tracks the smallest of a number of leaves, identified by their index in
+ * [0, size()). Each internal node records the leaf which lost the match played at that node, so
+ * that when the winner changes, only the matches on the path from its leaf to the root are played
+ * again, with one comparison per level.
+ *
+ * Leaves are either active, in which case they take part in the tournament, or inactive. When
+ * merging sorted streams, leaf i is active while stream i has a buffered element and 'Compare'
+ * compares the front elements of two streams.
+ *
+ * 'Compare' is a callable which, given two active leaves, returns an int less than, equal to or
+ * greater than 0 if the first one is respectively smaller than, equal to or greater than the
+ * second one. Ties are won by the leaf with the lower index.
+ *
+ * Popping the winner or replacing its value costs O(log n) comparisons. Activating a leaf which is
+ * not the winner cannot be replayed that way, so it makes the tree play the whole tournament again,
+ * in O(n) comparisons, the next time the winner is needed. Leaves activated in a row share one
+ * such rebuild.
+ */
+template <typename Compare>
+class LoserTree {
+public:
+    explicit LoserTree(Compare compare) : _compare(std::move(compare)) {}
+
+    /**
+     * Returns true if no leaf is active.
+     */
+    bool empty() const {
+        return _numActive == 0;
+    }
+
+    /**
+     * Returns the number of leaves, active or not.
+     */
+    size_t size() const {
+        return _active.size();
+    }
+
+    /**
+     * Adds inactive leaves so that the tree has 'numLeaves' leaves. The tree cannot shrink.
+     */
+    void resize(size_t numLeaves) {
+        invariant(numLeaves >= size());
+        _active.resize(numLeaves, false);
+        _nodes.resize(numLeaves);
+        _needsRebuild = true;
+    }
+
+    /**
+     * Makes 'leaf' active. Activating a leaf which is already active is a no-op.
+     */
+    void push(size_t leaf) {
+        invariant(leaf < size());
+        if (_active[leaf]) {
+            return;
+        }
+        _active[leaf] = true;
+        ++_numActive;
+        _needsRebuild = true;
+    }
+
+    /**
+     * Returns the smallest active leaf. Must not be called on an empty tree.
+     */
+    size_t top() {
+        invariant(!empty());
+        if (_needsRebuild) {
+            _rebuild();
+        }
+        return _winner;
+    }
+
+    /**
+     * Makes the smallest active leaf inactive.
+     */
+    void pop() {
+        const size_t winner = top();
+        _active[winner] = false;
+        --_numActive;
+        _replay(winner);
+    }
+
+    /**
+     * Finds the smallest active leaf again after the value of the current one grew, for instance
+     * because the stream it stands for moved on to its next element.
+     */
+    void replaceTop() {
+        _replay(top());
+    }
+
+private:
+    /**
+     * Returns whether 'lhs' wins its match against 'rhs'. Inactive leaves lose against the active
+     * ones.
+     */
+    bool _beats(size_t lhs, size_t rhs) const {
+        if (!_active[lhs] || !_active[rhs]) {
+            return _active[lhs] == _active[rhs] ? lhs < rhs : _active[lhs];
+        }
+        const int cmp = _compare(lhs, rhs);
+        return cmp < 0 || (cmp == 0 && lhs < rhs);
+    }
+
+    /**
+     * Plays the whole tournament. Leaf i sits at node n + i, and the children of the internal node
+     * k, for k in [1, n), are the nodes 2k and 2k + 1.
+     */
+    void _rebuild() {
+        const size_t n = size();
+
+        // The winner of the subtree rooted at each internal node, computed bottom-up
+        _winners.resize(n);
+        auto winnerAt = [&](size_t node) { return node >= n ? node - n : _winners[node]; };
+
+        for (size_t node = n - 1; node > 0; --node) {
+            size_t winner = winnerAt(2 * node);
+            size_t loser = winnerAt(2 * node + 1);
+            if (_beats(loser, winner)) {
+                std::swap(winner, loser);
+            }
+            _winners[node] = winner;
+            _nodes[node] = loser;
+        }
+
+        _winner = n > 1 ? _winners[1] : 0;
+        _needsRebuild = false;
+    }
+
+    /**
+     * Plays again the matches on the path from the leaf of the current winner to the root.
+     */
+    void _replay(size_t leaf) {
+        invariant(leaf == _winner && !_needsRebuild);
+
+        size_t winner = leaf;
+        for (size_t node = (size() + leaf) / 2; node > 0; node /= 2) {
+            if (_beats(_nodes[node], winner)) {
+                std::swap(_nodes[node], winner);
+            }
+        }
+        _winner = winner;
+    }
+
+    Compare _compare;
+
+    // Whether each leaf takes part in the tournament, and the number of those which do
+    std::vector<bool> _active;
+    size_t _numActive = 0;
+
+    // The loser of the match played at each internal node. Node 0 is unused.
+    std::vector<size_t> _nodes;
+
+    // The leaf which won the tournament, valid unless '_needsRebuild' is set
+    size_t _winner = 0;
+    bool _needsRebuild = false;
+
+    // Scratch space for _rebuild()
+    std::vector<size_t> _winners;
+};
+
+}  // namespace mongo
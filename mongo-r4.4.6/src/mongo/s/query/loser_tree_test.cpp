@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/loser_tree.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Streams = std::vector<std::deque<int>>;
+
+struct StreamComparator {
+    int operator()(size_t lhs, size_t rhs) const {
+        return (*streams)[lhs].front() - (*streams)[rhs].front();
+    }
+
+    const Streams* streams;
+};
+
+/**
+ * Merges 'streams' by popping the smallest front element until all of them are empty.
+ */
+std::vector<int> merge(Streams streams) {
+    LoserTree<StreamComparator> tree(StreamComparator{&streams});
+    tree.resize(streams.size());
+    for (size_t i = 0; i < streams.size(); ++i) {
+        if (!streams[i].empty()) {
+            tree.push(i);
+        }
+    }
+
+    std::vector<int> merged;
+    while (!tree.empty()) {
+        const size_t smallest = tree.top();
+        merged.push_back(streams[smallest].front());
+        streams[smallest].pop_front();
+        if (streams[smallest].empty()) {
+            tree.pop();
+        } else {
+            tree.replaceTop();
+        }
+    }
+    return merged;
+}
+
+TEST(LoserTreeTest, EmptyTree) {
+    LoserTree<StreamComparator> tree(StreamComparator{nullptr});
+    ASSERT(tree.empty());
+
+    tree.resize(3);
+    ASSERT(tree.empty());
+    ASSERT_EQ(3U, tree.size());
+}
+
+TEST(LoserTreeTest, SingleStream) {
+    ASSERT(merge({{1, 2, 3}}) == std::vector<int>({1, 2, 3}));
+}
+
+TEST(LoserTreeTest, TiesAreWonByLowerIndex) {
+    Streams streams{{5}, {3}, {3}, {3}};
+    LoserTree<StreamComparator> tree(StreamComparator{&streams});
+    tree.resize(streams.size());
+    for (size_t i = 0; i < streams.size(); ++i) {
+        tree.push(i);
+    }
+
+    ASSERT_EQ(1U, tree.top());
+    tree.pop();
+    ASSERT_EQ(2U, tree.top());
+    tree.pop();
+    ASSERT_EQ(3U, tree.top());
+    tree.pop();
+    ASSERT_EQ(0U, tree.top());
+    tree.pop();
+    ASSERT(tree.empty());
+}
+
+TEST(LoserTreeTest, PushingActiveLeafIsNoOp) {
+    Streams streams{{2}, {1}};
+    LoserTree<StreamComparator> tree(StreamComparator{&streams});
+    tree.resize(streams.size());
+    tree.push(0);
+    tree.push(1);
+    tree.push(1);
+
+    ASSERT_EQ(1U, tree.top());
+    tree.pop();
+    ASSERT_EQ(0U, tree.top());
+    tree.pop();
+    ASSERT(tree.empty());
+}
+
+TEST(LoserTreeTest, LeafCanBeReactivatedAndTreeCanGrow) {
+    Streams streams{{1, 4}, {2}};
+    LoserTree<StreamComparator> tree(StreamComparator{&streams});
+    tree.resize(streams.size());
+    tree.push(0);
+    tree.push(1);
+
+    ASSERT_EQ(0U, tree.top());
+    streams[0].pop_front();
+    tree.replaceTop();
+
+    ASSERT_EQ(1U, tree.top());
+    streams[1].pop_front();
+    tree.pop();
+
+    // Stream 1 gets more elements, and a third stream is added.
+    streams[1].push_back(3);
+    tree.push(1);
+    streams.push_back({2});
+    tree.resize(streams.size());
+    tree.push(2);
+
+    ASSERT_EQ(2U, tree.top());
+    tree.pop();
+    ASSERT_EQ(1U, tree.top());
+    tree.pop();
+    ASSERT_EQ(0U, tree.top());
+    tree.pop();
+    ASSERT(tree.empty());
+}
+
+TEST(LoserTreeTest, MergesRandomStreams) {
+    PseudoRandom random(1);
+
+    for (int numStreams = 1; numStreams <= 40; ++numStreams) {
+        Streams streams(numStreams);
+        std::vector<int> expected;
+        for (auto& stream : streams) {
+            int value = random.nextInt32(100);
+            for (int i = random.nextInt32(20); i > 0; --i) {
+                value += random.nextInt32(5);
+                stream.push_back(value);
+                expected.push_back(value);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+
+        ASSERT(merge(streams) == expected);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Compares the two ways a sorted merge of remote cursors can order the next results: a priority
+ * queue comparing the $sortKey BSON of the documents, which the AsyncResultsMerger used to do, and
+ * the loser tree over sort keys encoded as KeyStrings, which it does now.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/platform/random.h"
+#include "mongo/s/query/loser_tree.h"
+
+namespace mongo {
+namespace {
+
+const int kTotalDocs = 1 << 18;
+
+// Sort pattern of the synthetic merge, for which the sort keys are [<int>, <string>]
+const BSONObj kSortPattern = BSON("a" << 1 << "b" << -1);
+
+/**
+ * Returns 'numStreams' streams of sort keys, each in increasing order according to kSortPattern,
+ * the way the shards would return them in the $sortKey field of their results.
+ */
+std::vector<std::vector<BSONObj>> makeStreams(int numStreams) {
+    PseudoRandom random(numStreams);
+
+    std::vector<std::vector<BSONObj>> streams(numStreams);
+    for (auto& stream : streams) {
+        int a = 0;
+        for (int i = 0; i < kTotalDocs / numStreams; ++i) {
+            a += random.nextInt32(4);
+            stream.push_back(BSON_ARRAY(a << std::string(16, 'z' - random.nextInt32(26))));
+        }
+        // Equal 'a' values must be sorted by descending 'b'
+        std::sort(stream.begin(), stream.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+            return lhs.woCompare(rhs, kSortPattern, 0) < 0;
+        });
+    }
+    return streams;
+}
+
+void BM_MergeBSONSortKeysWithPriorityQueue(benchmark::State& state) {
+    const auto streams = makeStreams(state.range(0));
+
+    for (auto _ : state) {
+        std::vector<size_t> positions(streams.size(), 0);
+        auto greater = [&](size_t lhs, size_t rhs) {
+            return streams[lhs][positions[lhs]].woCompare(
+                       streams[rhs][positions[rhs]], kSortPattern, 0) > 0;
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> mergeQueue(greater);
+        for (size_t i = 0; i < streams.size(); ++i) {
+            mergeQueue.push(i);
+        }
+
+        while (!mergeQueue.empty()) {
+            const size_t smallest = mergeQueue.top();
+            mergeQueue.pop();
+            benchmark::DoNotOptimize(streams[smallest][positions[smallest]]);
+            if (++positions[smallest] < streams[smallest].size()) {
+                mergeQueue.push(smallest);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kTotalDocs);
+}
+
+void BM_MergeKeyStringSortKeysWithLoserTree(benchmark::State& state) {
+    const auto streams = makeStreams(state.range(0));
+    const auto ordering = Ordering::make(kSortPattern);
+
+    for (auto _ : state) {
+        // Encoding each sort key once, as the results arrive, is part of the cost of the merge.
+        std::vector<std::queue<KeyString::Value>> keyStreams(streams.size());
+        for (size_t i = 0; i < streams.size(); ++i) {
+            for (const auto& sortKey : streams[i]) {
+                keyStreams[i].push(
+                    KeyString::HeapBuilder(KeyString::Version::kLatestVersion, sortKey, ordering)
+                        .release());
+            }
+        }
+
+        auto compare = [&](size_t lhs, size_t rhs) {
+            return keyStreams[lhs].front().compare(keyStreams[rhs].front());
+        };
+        LoserTree<decltype(compare)> mergeTree(compare);
+        mergeTree.resize(keyStreams.size());
+        for (size_t i = 0; i < keyStreams.size(); ++i) {
+            mergeTree.push(i);
+        }
+
+        while (!mergeTree.empty()) {
+            const size_t smallest = mergeTree.top();
+            benchmark::DoNotOptimize(keyStreams[smallest].front());
+            keyStreams[smallest].pop();
+            if (keyStreams[smallest].empty()) {
+                mergeTree.pop();
+            } else {
+                mergeTree.replaceTop();
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kTotalDocs);
+}
+
+BENCHMARK(BM_MergeBSONSortKeysWithPriorityQueue)->Arg(2)->Arg(16)->Arg(128)->Arg(512);
+BENCHMARK(BM_MergeKeyStringSortKeysWithLoserTree)->Arg(2)->Arg(16)->Arg(128)->Arg(512);
+
+}  // namespace
+}  // namespace mongo
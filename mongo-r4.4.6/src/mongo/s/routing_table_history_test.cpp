@@ -318,5 +318,95 @@ TEST_F(RoutingTableHistoryTestThreeInitialChunks,
                               expectedBytesInChunksNotSplit);
 }
 
+TEST(RoutingTableHistoryMakeNewTest, FullLoadWithSupersededChunksKeepsLatestVersions) {
+    const KeyPattern shardKeyPattern(BSON("a" << 1));
+    const OID epoch = OID::gen();
+    const auto globalMin = shardKeyPattern.globalMin();
+    const auto globalMax = shardKeyPattern.globalMax();
+
+    // The whole-range chunk was split afterwards, so it is superseded by the two later ones.
+    const std::vector<ChunkType> chunks{
+        ChunkType{kNss, ChunkRange{globalMin, globalMax}, ChunkVersion{1, 0, epoch}, kThisShard},
+        ChunkType{
+            kNss, ChunkRange{globalMin, BSON("a" << 10)}, ChunkVersion{2, 0, epoch}, kThisShard},
+        ChunkType{
+            kNss, ChunkRange{BSON("a" << 10), globalMax}, ChunkVersion{2, 1, epoch}, kThisShard}};
+
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), shardKeyPattern, nullptr, false, epoch, chunks);
+    ASSERT_EQ(rt->getChunkMap().size(), 2ull);
+    ASSERT_EQ(rt->getVersion(), (ChunkVersion{2, 1, epoch}));
+
+    // The same chunks without the superseded one build the same routing table.
+    auto rtWithoutSuperseded = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), shardKeyPattern, nullptr, false, epoch, {chunks[1], chunks[2]});
+    ASSERT_EQ(rtWithoutSuperseded->getChunkMap().size(), 2ull);
+    ASSERT_EQ(rtWithoutSuperseded->getVersion(), (ChunkVersion{2, 1, epoch}));
+
+    auto it = rt->getChunkMap().begin();
+    auto itWithoutSuperseded = rtWithoutSuperseded->getChunkMap().begin();
+    for (; it != rt->getChunkMap().end(); ++it, ++itWithoutSuperseded) {
+        ASSERT_EQ(it->first, itWithoutSuperseded->first);
+        ASSERT_BSONOBJ_EQ(it->second->getMin(), itWithoutSuperseded->second->getMin());
+        ASSERT_BSONOBJ_EQ(it->second->getMax(), itWithoutSuperseded->second->getMax());
+    }
+}
+
+TEST_F(RoutingTableHistoryTestThreeInitialChunks, SplittingChunkDoesNotDuplicateUnreportedWrites) {
+    auto minKey = getInitialChunkBoundaryPoints()[1];
+    auto maxKey = getInitialChunkBoundaryPoints()[2];
+    auto newChunkBoundaryPoints = {minKey, BSON("a" << 16), BSON("a" << 17), maxKey};
+
+    auto chunkToSplit = getChunkToSplit(getInitialRoutingTable(), minKey, maxKey);
+    chunkToSplit->getWritesTracker()->addWrite(5);
+    chunkToSplit->getWritesTracker()->addWrite(7);
+
+    // Split middle chunk into three
+    auto rt = splitChunk(getInitialRoutingTable(), newChunkBoundaryPoints);
+    ASSERT_EQ(rt->getChunkMap().size(), 5ull);
+
+    // The unreported writes of the split chunk are counted once, by the last of its pieces
+    auto chunksFromSplit = getChunksInRange(rt, minKey, maxKey);
+    ASSERT_EQ(chunksFromSplit.size(), 3ull);
+    for (auto kv : rt->getChunkMap()) {
+        const auto writes = kv.second->getWritesTracker()->getWritesSinceReport();
+        if (kv.second->getMax().woCompare(maxKey) == 0) {
+            ASSERT_EQ(writes.numWrites, 2ull);
+            ASSERT_EQ(writes.bytesWritten, 12ull);
+        } else {
+            ASSERT_EQ(writes.numWrites, 0ull);
+            ASSERT_EQ(writes.bytesWritten, 0ull);
+        }
+    }
+}
+
+TEST_F(RoutingTableHistoryTestThreeInitialChunks, MergingChunksAddsUpUnreportedWrites) {
+    const auto& boundaryPoints = getInitialChunkBoundaryPoints();
+    const auto rt = getInitialRoutingTable();
+
+    getChunkToSplit(rt, boundaryPoints[0], boundaryPoints[1])->getWritesTracker()->addWrite(5);
+    getChunkToSplit(rt, boundaryPoints[1], boundaryPoints[2])->getWritesTracker()->addWrite(7);
+    getChunkToSplit(rt, boundaryPoints[2], boundaryPoints[3])->getWritesTracker()->addWrite(11);
+
+    // Merge the first two chunks
+    auto version = rt->getVersion();
+    version.incMajor();
+    auto mergedRt = rt->makeUpdated(
+        {ChunkType{kNss, ChunkRange{boundaryPoints[0], boundaryPoints[2]}, version, kThisShard}});
+    ASSERT_EQ(mergedRt->getChunkMap().size(), 2ull);
+
+    const auto mergedWrites = getChunkToSplit(mergedRt, boundaryPoints[0], boundaryPoints[2])
+                                  ->getWritesTracker()
+                                  ->getWritesSinceReport();
+    ASSERT_EQ(mergedWrites.numWrites, 2ull);
+    ASSERT_EQ(mergedWrites.bytesWritten, 12ull);
+
+    const auto lastWrites = getChunkToSplit(mergedRt, boundaryPoints[2], boundaryPoints[3])
+                                ->getWritesTracker()
+                                ->getWritesSinceReport();
+    ASSERT_EQ(lastWrites.numWrites, 1ull);
+    ASSERT_EQ(lastWrites.bytesWritten, 11ull);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -75,6 +75,7 @@
 #include "mongo/rpc/metadata/egress_metadata_hook_list.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog_cache.h"
+#include "mongo/s/catalog_cache_background_refresher.h"
 #include "mongo/s/client/shard_connection.h"
 #include "mongo/s/client/shard_factory.h"
 #include "mongo/s/client/shard_registry.h"
@@ -750,6 +751,8 @@ ExitCode runMongosServer(ServiceContext* serviceContext) {
 
     clusterCursorCleanupJob.go();
 
+    catalogCacheBackgroundRefresher.go();
+
     UserCacheInvalidator cacheInvalidatorThread(AuthorizationManager::get(serviceContext));
     cacheInvalidatorThread.initialize(opCtx);
     cacheInvalidatorThread.go();
@@ -1322,6 +1322,7 @@ void TransactionRouter::Router::_resetRouterState(OperationContext* opCtx,
     o(lk).abortCause = std::string();
     o(lk).metricsTracker.emplace(opCtx->getServiceContext());
     p().terminationInitiated = false;
+    p().writtenNamespaces.clear();
 
     auto tickSource = opCtx->getServiceContext()->getTickSource();
     o(lk).metricsTracker->trySetActive(tickSource, tickSource->getTicks());
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <set>
 
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/logical_session_id.h"
@@ -521,6 +522,21 @@ public:
             return p().latestStmtId;
         }
 
+        /**
+         * Records that a statement of this transaction wrote to 'nss', so that cached results for
+         * it can be discarded once the transaction commits.
+         */
+        void onWriteToNamespace(const NamespaceString& nss) {
+            p().writtenNamespaces.insert(nss);
+        }
+
+        /**
+         * Returns the namespaces this transaction has written to so far.
+         */
+        const std::set<NamespaceString>& getWrittenNamespaces() const {
+            return p().writtenNamespaces;
+        }
+
         /**
          * Returns a copy of the timing stats of the transaction router's active transaction.
          */
@@ -765,6 +781,11 @@ private:
 
         // Track whether commit or abort have been initiated.
         bool terminationInitiated{false};
+
+        // The namespaces written to by statements of this transaction. Mongos' query result cache
+        // is invalidated for these when the transaction commits rather than at statement end,
+        // since the writes are not visible to other readers before then.
+        std::set<NamespaceString> writtenNamespaces;
     } _p;
 };
 
@@ -305,6 +305,33 @@ TEST_F(TransactionRouterTestWithDefaultSession, BasicStartTxnWithAtClusterTime)
     }
 }
 
+TEST_F(TransactionRouterTestWithDefaultSession, StartingNewTxnShouldClearWrittenNamespaces) {
+    const NamespaceString nss1("test.foo");
+    const NamespaceString nss2("test.bar");
+
+    auto txnRouter = TransactionRouter::get(operationContext());
+    txnRouter.beginOrContinueTxn(
+        operationContext(), 3, TransactionRouter::TransactionActions::kStart);
+    ASSERT(txnRouter.getWrittenNamespaces().empty());
+
+    txnRouter.onWriteToNamespace(nss1);
+    txnRouter.onWriteToNamespace(nss2);
+    txnRouter.onWriteToNamespace(nss1);
+    ASSERT_EQ(2UL, txnRouter.getWrittenNamespaces().size());
+    ASSERT_EQ(1UL, txnRouter.getWrittenNamespaces().count(nss1));
+    ASSERT_EQ(1UL, txnRouter.getWrittenNamespaces().count(nss2));
+
+    // New statement.
+    repl::ReadConcernArgs::get(operationContext()) = repl::ReadConcernArgs();
+    txnRouter.beginOrContinueTxn(
+        operationContext(), 3, TransactionRouter::TransactionActions::kContinue);
+    ASSERT_EQ(2UL, txnRouter.getWrittenNamespaces().size());
+
+    txnRouter.beginOrContinueTxn(
+        operationContext(), 5, TransactionRouter::TransactionActions::kStart);
+    ASSERT(txnRouter.getWrittenNamespaces().empty());
+}
+
 TEST_F(TransactionRouterTestWithDefaultSession, CannotContiueTxnWithoutStarting) {
     TxnNumber txnNum{3};
 
@@ -43,12 +43,16 @@
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/logv2/log.h"
+#include "mongo/s/async_requests_sender.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/mongos_server_parameters_gen.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
 #include "mongo/s/transaction_router.h"
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
+#include "mongo/util/log_with_sampling.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -111,6 +115,315 @@ bool hasTransientTransactionError(const BatchedCommandResponse& response) {
 // applies when no writes are occurring and metadata is not changing on reload.
 const int kMaxRoundsWithoutProgress(5);
 
+// Builds the command to send a child batch to its shard
+BSONObj buildShardBatchRequest(OperationContext* opCtx,
+                               const BatchWriteOp& batchOp,
+                               const TargetedWriteBatch& batch) {
+    const auto shardBatchRequest(batchOp.buildBatchRequest(batch));
+
+    BSONObjBuilder requestBuilder;
+    shardBatchRequest.serialize(&requestBuilder);
+    logical_session_id_helpers::serializeLsidAndTxnNumber(opCtx, &requestBuilder);
+
+    const auto request = requestBuilder.obj();
+
+    LOGV2_DEBUG(22905,
+                4,
+                "Sending write batch to {shardId}: {request}",
+                "Sending write batch",
+                "shardId"_attr = batch.getEndpoint().shardName,
+                "request"_attr = redact(request));
+
+    return request;
+}
+
+// Helper to parse the response of a shard to a child batch. Returns a non-OK status if the batch
+// could not be dispatched or the response is malformed.
+Status parseShardBatchResponse(const AsyncRequestsSender::Response& response,
+                               BatchedCommandResponse* batchedCommandResponse) {
+    Status responseStatus = response.swResponse.getStatus();
+    if (responseStatus.isOK()) {
+        std::string errMsg;
+        if (!batchedCommandResponse->parseBSON(response.swResponse.getValue().data, &errMsg) ||
+            !batchedCommandResponse->isValid(&errMsg)) {
+            responseStatus = {ErrorCodes::FailedToParse, errMsg};
+        }
+    }
+    return responseStatus;
+}
+
+// Helper to note the stale errors tracked while noting a child batch response. Returns true if
+// there were any.
+bool noteStaleResponses(const TrackedErrors& trackedErrors,
+                        NSTargeter* targeter,
+                        BatchWriteExecStats* stats) {
+    const auto& staleShardErrors = trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+    const auto& staleDbErrors = trackedErrors.getErrors(ErrorCodes::StaleDbVersion);
+
+    if (!staleShardErrors.empty()) {
+        invariant(staleDbErrors.empty());
+        noteStaleShardResponses(staleShardErrors, targeter);
+        ++stats->numStaleShardBatches;
+    }
+
+    if (!staleDbErrors.empty()) {
+        invariant(staleShardErrors.empty());
+        noteStaleDbResponses(staleDbErrors, targeter);
+        ++stats->numStaleDbBatches;
+    }
+
+    return !staleShardErrors.empty() || !staleDbErrors.empty();
+}
+
+// Remember that we successfully wrote to the shard which returned 'response'
+// NOTE: This will record lastOps for shards where we actually didn't update or delete any
+// documents, which preserves old behavior but is conservative
+void noteWriteAt(const AsyncRequestsSender::Response& response,
+                 const BatchedCommandResponse& batchedCommandResponse,
+                 BatchWriteExecStats* stats) {
+    if (!response.shardHostAndPort)
+        return;
+
+    stats->noteWriteAt(*response.shardHostAndPort,
+                       batchedCommandResponse.isLastOpSet() ? batchedCommandResponse.getLastOp()
+                                                            : repl::OpTime(),
+                       batchedCommandResponse.isElectionIdSet()
+                           ? batchedCommandResponse.getElectionId()
+                           : OID());
+}
+
+// Refreshes the targeter if needed (no-op if nothing stale) and returns whether its routing info
+// changed
+bool refreshTargeter(OperationContext* opCtx, NSTargeter& targeter) {
+    bool targeterChanged = false;
+    Status refreshStatus = targeter.refreshIfNeeded(opCtx, &targeterChanged);
+
+    LOGV2_DEBUG(22909,
+                4,
+                "executeBatch targeter changed: {targeterChanged}",
+                "targeterChanged"_attr = targeterChanged);
+
+    if (!refreshStatus.isOK()) {
+        // It's okay if we can't refresh, we'll just record errors for the ops if
+        // needed.
+        LOGV2_WARNING(22911,
+                      "Could not refresh targeter due to {error}",
+                      "Could not refresh targeter",
+                      "error"_attr = redact(refreshStatus.reason()));
+    }
+
+    return targeterChanged;
+}
+
+/**
+ * Executes an unordered batch outside of a transaction by keeping up to
+ * 'maxInFlightBatchesPerShard' child batches outstanding against each shard. Every time a shard
+ * responds, the writes which are still ready (including the ones which came back stale) are
+ * targeted again and sent to the shards which have room in their window, so that a slow shard does
+ * not hold back the writes for the other shards.
+ *
+ * Returns once the batch op is finished.
+ */
+void executePipelinedBatch(OperationContext* opCtx,
+                           NSTargeter& targeter,
+                           const BatchedCommandRequest& clientRequest,
+                           BatchWriteOp& batchOp,
+                           BatchWriteExecStats* stats,
+                           const int maxInFlightBatchesPerShard) {
+    struct InFlightBatch {
+        std::unique_ptr<TargetedWriteBatch> batch;
+        Timer timer;
+
+        // The number of targeter refreshes done before the batch was sent
+        int numRefreshesAtSend;
+    };
+
+    // Child batches out on the network, keyed by the index of their request in the ARS
+    std::map<size_t, InFlightBatch> inFlightBatches;
+    std::map<ShardId, int> numInFlightBatchesByShard;
+    size_t numRequests = 0;
+
+    AsyncRequestsSender ars(opCtx,
+                            Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                            clientRequest.getNS().db(),
+                            {},
+                            kPrimaryOnlyReadPreference,
+                            opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
+                                                  : Shard::RetryPolicy::kNoRetry);
+
+    // See executeBatch for why target errors are only recorded once the targeter was refreshed
+    bool refreshedTargeter = false;
+
+    // Set when the ready writes could not be targeted. Nothing is targeted again until the batches
+    // in flight have drained and the targeter has been refreshed.
+    bool awaitingRefreshToTarget = false;
+
+    int numRefreshes = 0;
+    int numCompletedOps = 0;
+    int numRoundsWithoutProgress = 0;
+    boost::optional<WriteErrorDetail> noProgressError;
+
+    // Refreshes the targeter and stops targeting if this keeps happening without any write
+    // completing or the routing info changing. Only a refresh done once all the batches have come
+    // back counts as a round without progress, like a round of the serial execution does.
+    auto refreshAndCheckProgress = [&] {
+        const bool targeterChanged = refreshTargeter(opCtx, targeter);
+        ++numRefreshes;
+        if (awaitingRefreshToTarget) {
+            refreshedTargeter = true;
+            awaitingRefreshToTarget = false;
+        }
+
+        int currCompletedOps = batchOp.numWriteOpsIn(WriteOpState_Completed);
+        if (currCompletedOps != numCompletedOps || targeterChanged) {
+            numRoundsWithoutProgress = 0;
+        } else if (inFlightBatches.empty()) {
+            ++numRoundsWithoutProgress;
+        }
+        numCompletedOps = currCompletedOps;
+
+        if (numRoundsWithoutProgress > kMaxRoundsWithoutProgress) {
+            noProgressError = errorFromStatus(
+                {ErrorCodes::NoProgressMade,
+                 str::stream() << "no progress was made executing batch write op in "
+                               << clientRequest.getNS().ns() << " after "
+                               << kMaxRoundsWithoutProgress << " rounds (" << numCompletedOps
+                               << " ops completed in " << stats->numRounds << " rounds total)"});
+        }
+    };
+
+    while (!batchOp.isFinished()) {
+        //
+        // Target the ready writes to the shards which have room for another batch
+        //
+
+        if (!noProgressError && !awaitingRefreshToTarget) {
+            std::set<ShardId> saturatedShards;
+            for (const auto& shardAndCount : numInFlightBatchesByShard) {
+                if (shardAndCount.second >= maxInFlightBatchesPerShard)
+                    saturatedShards.insert(shardAndCount.first);
+            }
+
+            OwnedPointerMap<ShardId, TargetedWriteBatch> childBatchesOwned;
+            std::map<ShardId, TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableMap();
+
+            Status targetStatus = batchOp.targetBatch(
+                targeter, refreshedTargeter, &childBatches, &saturatedShards);
+            if (!targetStatus.isOK()) {
+                // Don't do anything until a targeter refresh
+                targeter.noteCouldNotTarget();
+                awaitingRefreshToTarget = true;
+                ++stats->numTargetErrors;
+                dassert(childBatches.size() == 0u);
+            }
+
+            std::vector<AsyncRequestsSender::Request> requests;
+            for (auto& childBatch : childBatches) {
+                const auto& targetShardId = childBatch.first;
+                stats->noteTargetedShard(targetShardId);
+
+                requests.emplace_back(targetShardId,
+                                      buildShardBatchRequest(opCtx, batchOp, *childBatch.second));
+
+                // The batch stays in flight until the response with its request index comes back
+                ++numInFlightBatchesByShard[targetShardId];
+                auto& inFlight = inFlightBatches[numRequests++];
+                inFlight.batch.reset(childBatch.second);
+                inFlight.numRefreshesAtSend = numRefreshes;
+                childBatch.second = nullptr;
+            }
+
+            if (!requests.empty()) {
+                ars.addRequests(requests);
+                ++stats->numRounds;
+
+                // Fill the windows of the shards which still have room before waiting
+                continue;
+            }
+        }
+
+        if (inFlightBatches.empty()) {
+            if (batchOp.isFinished())
+                break;
+
+            if (noProgressError) {
+                batchOp.abortBatch(*noProgressError);
+                break;
+            }
+
+            // Nothing could be sent, so the remaining writes are waiting for a targeter refresh
+            refreshAndCheckProgress();
+            continue;
+        }
+
+        //
+        // Receive the next response and note it on the batch op
+        //
+
+        auto response = ars.next();
+
+        auto inFlightIt = inFlightBatches.find(response.requestIndex);
+        invariant(inFlightIt != inFlightBatches.end());
+        const auto inFlight = std::move(inFlightIt->second);
+        inFlightBatches.erase(inFlightIt);
+
+        const TargetedWriteBatch& batch = *inFlight.batch;
+        --numInFlightBatchesByShard[batch.getEndpoint().shardName];
+        stats->noteShardBatchResponse(batch.getEndpoint().shardName,
+                                      Microseconds(inFlight.timer.micros()));
+
+        const auto shardInfo = response.shardHostAndPort ? response.shardHostAndPort->toString()
+                                                         : batch.getEndpoint().shardName;
+
+        BatchedCommandResponse batchedCommandResponse;
+        Status responseStatus = parseShardBatchResponse(response, &batchedCommandResponse);
+
+        if (responseStatus.isOK()) {
+            TrackedErrors trackedErrors;
+            trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+            trackedErrors.startTracking(ErrorCodes::StaleDbVersion);
+
+            LOGV2_DEBUG(22907,
+                        4,
+                        "Write results received from {shardInfo}: {response}",
+                        "Write results received",
+                        "shardInfo"_attr = shardInfo,
+                        "status"_attr = redact(batchedCommandResponse.toStatus()));
+
+            // Dispatch was ok, note response
+            batchOp.noteBatchResponse(batch, batchedCommandResponse, &trackedErrors);
+
+            // The stale writes are ready again. Refresh right away rather than waiting for the
+            // other shards, so they can be sent with the next targeting. The batches sent before
+            // the last refresh may all come back stale for the same reason, so only the first of
+            // them refreshes, and the others are targeted again with the refreshed routing info.
+            if (noteStaleResponses(trackedErrors, &targeter, stats) &&
+                inFlight.numRefreshesAtSend == numRefreshes) {
+                refreshAndCheckProgress();
+            }
+
+            noteWriteAt(response, batchedCommandResponse, stats);
+        } else {
+            // Error occurred dispatching, note it
+            const Status status = responseStatus.withContext(
+                str::stream() << "Write results unavailable "
+                              << (response.shardHostAndPort
+                                      ? "from "
+                                      : "from failing to target a host in the shard ")
+                              << shardInfo);
+
+            batchOp.noteBatchError(batch, errorFromStatus(status));
+
+            LOGV2_DEBUG(22908,
+                        4,
+                        "Unable to receive write results from {shardInfo}: {error}",
+                        "Unable to receive write results",
+                        "shardInfo"_attr = shardInfo,
+                        "error"_attr = redact(status));
+        }
+    }
+}
+
 }  // namespace
 
 void BatchWriteExec::executeBatch(OperationContext* opCtx,
@@ -129,6 +442,16 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
     BatchWriteOp batchOp(opCtx, clientRequest);
 
+    // Unordered writes outside of a transaction do not need to wait for all the shards to respond
+    // before sending the writes which remain
+    const int maxInFlightBatchesPerShard = gMaxInFlightWriteBatchesPerShard.load();
+    if (maxInFlightBatchesPerShard > 0 && !clientRequest.getWriteCommandBase().getOrdered() &&
+        !TransactionRouter::get(opCtx)) {
+        executePipelinedBatch(
+            opCtx, targeter, clientRequest, batchOp, stats, maxInFlightBatchesPerShard);
+        invariant(batchOp.isFinished());
+    }
+
     // Current batch status
     bool refreshedTargeter = false;
     int rounds = 0;
@@ -223,24 +546,8 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
                 stats->noteTargetedShard(targetShardId);
 
-                const auto request = [&] {
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
-
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
-                    logical_session_id_helpers::serializeLsidAndTxnNumber(opCtx, &requestBuilder);
-
-                    return requestBuilder.obj();
-                }();
-
-                LOGV2_DEBUG(22905,
-                            4,
-                            "Sending write batch to {shardId}: {request}",
-                            "Sending write batch",
-                            "shardId"_attr = targetShardId,
-                            "request"_attr = redact(request));
-
-                requests.emplace_back(targetShardId, request);
+                requests.emplace_back(targetShardId,
+                                      buildShardBatchRequest(opCtx, batchOp, *nextBatch));
 
                 // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
                 // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
@@ -262,6 +569,9 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 isRetryableWrite ? Shard::RetryPolicy::kIdempotent : Shard::RetryPolicy::kNoRetry);
             numSent += pendingBatches.size();
 
+            // All the batches of this round were sent at the same time
+            Timer roundTimer;
+
             //
             // Receive the responses.
             //
@@ -274,21 +584,16 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
                 TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
 
+                stats->noteShardBatchResponse(response.shardId,
+                                              Microseconds(roundTimer.micros()));
+
                 const auto shardInfo = response.shardHostAndPort
                     ? response.shardHostAndPort->toString()
                     : batch->getEndpoint().shardName;
 
                 // Then check if we successfully got a response.
-                Status responseStatus = response.swResponse.getStatus();
                 BatchedCommandResponse batchedCommandResponse;
-                if (responseStatus.isOK()) {
-                    std::string errMsg;
-                    if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
-                                                          &errMsg) ||
-                        !batchedCommandResponse.isValid(&errMsg)) {
-                        responseStatus = {ErrorCodes::FailedToParse, errMsg};
-                    }
-                }
+                Status responseStatus = parseShardBatchResponse(response, &batchedCommandResponse);
 
                 if (responseStatus.isOK()) {
                     TrackedErrors trackedErrors;
@@ -329,34 +634,9 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                     }
 
                     // Note if anything was stale
-                    const auto& staleShardErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-                    const auto& staleDbErrors = trackedErrors.getErrors(ErrorCodes::StaleDbVersion);
-
-                    if (!staleShardErrors.empty()) {
-                        invariant(staleDbErrors.empty());
-                        noteStaleShardResponses(staleShardErrors, &targeter);
-                        ++stats->numStaleShardBatches;
-                    }
+                    noteStaleResponses(trackedErrors, &targeter, stats);
 
-                    if (!staleDbErrors.empty()) {
-                        invariant(staleShardErrors.empty());
-                        noteStaleDbResponses(staleDbErrors, &targeter);
-                        ++stats->numStaleDbBatches;
-                    }
-
-                    if (response.shardHostAndPort) {
-                        // Remember that we successfully wrote to this shard
-                        // NOTE: This will record lastOps for shards where we actually didn't update
-                        // or delete any documents, which preserves old behavior but is conservative
-                        stats->noteWriteAt(*response.shardHostAndPort,
-                                           batchedCommandResponse.isLastOpSet()
-                                               ? batchedCommandResponse.getLastOp()
-                                               : repl::OpTime(),
-                                           batchedCommandResponse.isElectionIdSet()
-                                               ? batchedCommandResponse.getElectionId()
-                                               : OID());
-                    }
+                    noteWriteAt(response, batchedCommandResponse, stats);
                 } else {
                     // Error occurred dispatching, note it
                     const Status status = responseStatus.withContext(
@@ -406,22 +686,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         // Refresh the targeter if we need to (no-op if nothing stale)
         //
 
-        bool targeterChanged = false;
-        Status refreshStatus = targeter.refreshIfNeeded(opCtx, &targeterChanged);
-
-        LOGV2_DEBUG(22909,
-                    4,
-                    "executeBatch targeter changed: {targeterChanged}",
-                    "targeterChanged"_attr = targeterChanged);
-
-        if (!refreshStatus.isOK()) {
-            // It's okay if we can't refresh, we'll just record errors for the ops if
-            // needed.
-            LOGV2_WARNING(22911,
-                          "Could not refresh targeter due to {error}",
-                          "Could not refresh targeter",
-                          "error"_attr = redact(refreshStatus.reason()));
-        }
+        const bool targeterChanged = refreshTargeter(opCtx, targeter);
 
         //
         // Ensure progress is being made toward completing the batch op
@@ -462,6 +727,26 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 "wcSucceededOrFailed"_attr =
                     (clientResponse->isWriteConcernErrorSet() ? "failed" : "succeeded"),
                 "namespace"_attr = clientRequest.getNS());
+
+    // Report the latency of every shard when the slowest of them took longer than the slow
+    // operation threshold, so that a lagging shard shows up at the default verbosity.
+    Microseconds maxShardLatency{0};
+    for (const auto& shardStatsEntry : stats->getShardStats()) {
+        maxShardLatency = std::max(maxShardLatency, shardStatsEntry.second.maxLatency);
+    }
+
+    if (shouldLogSlowOpWithSampling(opCtx,
+                                    logv2::LogComponent::kSharding,
+                                    duration_cast<Milliseconds>(maxShardLatency),
+                                    Milliseconds(serverGlobalParams.slowMS))
+            .first) {
+        LOGV2(5023412,
+              "Write batch latency per shard for namespace {namespace}: {shardStats}",
+              "Write batch latency per shard",
+              "namespace"_attr = clientRequest.getNS(),
+              "numRounds"_attr = stats->numRounds,
+              "shardStats"_attr = stats->shardStatsToBSON());
+    }
 }
 
 void BatchWriteExecStats::noteTargetedShard(const ShardId& shardId) {
@@ -478,6 +763,13 @@ void BatchWriteExecStats::noteNumShardsOwningChunks(const int nShardsOwningChunk
     _numShardsOwningChunks.emplace(nShardsOwningChunks);
 }
 
+void BatchWriteExecStats::noteShardBatchResponse(const ShardId& shardId, Microseconds latency) {
+    auto& shardStats = _shardStats[shardId];
+    ++shardStats.numBatches;
+    shardStats.totalLatency += latency;
+    shardStats.maxLatency = std::max(shardStats.maxLatency, latency);
+}
+
 const std::set<ShardId>& BatchWriteExecStats::getTargetedShards() const {
     return _targetedShards;
 }
@@ -490,4 +782,22 @@ const boost::optional<int> BatchWriteExecStats::getNumShardsOwningChunks() const
     return _numShardsOwningChunks;
 }
 
+const std::map<ShardId, BatchWriteExecStats::ShardStats>& BatchWriteExecStats::getShardStats()
+    const {
+    return _shardStats;
+}
+
+BSONObj BatchWriteExecStats::shardStatsToBSON() const {
+    BSONObjBuilder builder;
+    for (const auto& shardAndStats : _shardStats) {
+        const auto& shardStats = shardAndStats.second;
+        BSONObjBuilder shardBuilder(builder.subobjStart(shardAndStats.first.toString()));
+        shardBuilder.append("numBatches", shardStats.numBatches);
+        shardBuilder.append("totalLatencyMicros",
+                            durationCount<Microseconds>(shardStats.totalLatency));
+        shardBuilder.append("maxLatencyMicros", durationCount<Microseconds>(shardStats.maxLatency));
+    }
+    return builder.obj();
+}
+
 }  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/s/ns_targeter.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -85,6 +86,17 @@ typedef std::map<ConnectionString, HostOpTime> HostOpTimeMap;
 
 class BatchWriteExecStats {
 public:
+    /**
+     * Latency breakdown of the child batches sent to one shard.
+     */
+    struct ShardStats {
+        // Number of child batches for which the shard returned a response
+        int numBatches{0};
+        // Sum and maximum of the time between sending a child batch and receiving its response
+        Microseconds totalLatency{0};
+        Microseconds maxLatency{0};
+    };
+
     BatchWriteExecStats()
         : numRounds(0),
           numTargetErrors(0),
@@ -95,14 +107,18 @@ public:
     void noteWriteAt(const HostAndPort& host, repl::OpTime opTime, const OID& electionId);
     void noteTargetedShard(const ShardId& shardId);
     void noteNumShardsOwningChunks(const int nShardsOwningChunks);
+    void noteShardBatchResponse(const ShardId& shardId, Microseconds latency);
 
     const std::set<ShardId>& getTargetedShards() const;
     const HostOpTimeMap& getWriteOpTimes() const;
     const boost::optional<int> getNumShardsOwningChunks() const;
+    const std::map<ShardId, ShardStats>& getShardStats() const;
+    BSONObj shardStatsToBSON() const;
 
     // Expose via helpers if this gets more complex
 
-    // Number of round trips required for the batch
+    // Number of round trips required for the batch. When child batches are pipelined, this is the
+    // number of times child batches were targeted and sent.
     int numRounds;
     // Number of times targeting failed
     int numTargetErrors;
@@ -117,6 +133,7 @@ private:
     std::set<ShardId> _targetedShards;
     HostOpTimeMap _writeOpTimes;
     boost::optional<int> _numShardsOwningChunks;
+    std::map<ShardId, ShardStats> _shardStats;
 };
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/logical_session_id.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
+#include "mongo/s/mongos_server_parameters_gen.h"
 #include "mongo/s/session_catalog_router.h"
 #include "mongo/s/sharding_router_test_fixture.h"
 #include "mongo/s/stale_exception.h"
@@ -46,6 +47,7 @@
 #include "mongo/s/write_ops/batched_command_response.h"
 #include "mongo/s/write_ops/mock_ns_targeter.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -355,6 +357,132 @@ TEST_F(BatchWriteExecTest, MultiOpLarge) {
     future.default_timed_get();
 }
 
+TEST_F(BatchWriteExecTest, UnorderedMultiOpLargeIsPipelined) {
+    const auto oldMaxInFlight = gMaxInFlightWriteBatchesPerShard.load();
+    ON_BLOCK_EXIT([oldMaxInFlight] { gMaxInFlightWriteBatchesPerShard.store(oldMaxInFlight); });
+    gMaxInFlightWriteBatchesPerShard.store(2);
+
+    const int kNumDocsToInsert = 100'000;
+    const std::string kDocValue(200, 'x');
+
+    std::vector<BSONObj> docsToInsert;
+    docsToInsert.reserve(kNumDocsToInsert);
+    for (int i = 0; i < kNumDocsToInsert; i++) {
+        docsToInsert.push_back(BSON("_id" << i << "someLargeKeyToWasteSpace" << kDocValue));
+    }
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(
+            operationContext(), singleShardNSTargeter, request, &response, &stats);
+
+        ASSERT(response.getOk());
+        ASSERT_EQUALS(response.getN(), kNumDocsToInsert);
+        ASSERT_EQUALS(stats.numRounds, 2);
+
+        // Both child batches are accounted for in the latency breakdown of the shard
+        const auto& shardStats = stats.getShardStats();
+        ASSERT_EQUALS(1U, shardStats.size());
+        ASSERT_EQUALS(2, shardStats.at(ShardId(kShardName1)).numBatches);
+    });
+
+    expectInsertsReturnSuccess(docsToInsert.begin(), docsToInsert.begin() + 66576);
+    expectInsertsReturnSuccess(docsToInsert.begin() + 66576, docsToInsert.end());
+
+    future.default_timed_get();
+}
+
+TEST_F(BatchWriteExecTest, StaleInFlightBatchesAcrossShardsCountAsOneRound) {
+    const auto oldMaxInFlight = gMaxInFlightWriteBatchesPerShard.load();
+    ON_BLOCK_EXIT([oldMaxInFlight] { gMaxInFlightWriteBatchesPerShard.store(oldMaxInFlight); });
+    gMaxInFlightWriteBatchesPerShard.store(2);
+
+    // Each shard gets two child batches, which are in flight at the same time
+    const int kNumDocsToInsert = 20'000;
+    const std::string kDocValue(2'000, 'x');
+
+    std::vector<BSONObj> docsToInsert;
+    docsToInsert.reserve(kNumDocsToInsert);
+    for (int i = 0; i < kNumDocsToInsert; i++) {
+        docsToInsert.push_back(
+            BSON("x" << i - kNumDocsToInsert / 2 << "someLargeKeyToWasteSpace" << kDocValue));
+    }
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    const auto epoch = OID::gen();
+    MockNSTargeter multiShardNSTargeter(
+        nss,
+        {MockRange(ShardEndpoint(kShardName1, ChunkVersion(100, 200, epoch)),
+                   BSON("x" << MINKEY),
+                   BSON("x" << 0)),
+         MockRange(ShardEndpoint(kShardName2, ChunkVersion(101, 200, epoch)),
+                   BSON("x" << 0),
+                   BSON("x" << MAXKEY))});
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(
+            operationContext(), multiShardNSTargeter, request, &response, &stats);
+
+        // More stale responses come back than the rounds allowed without progress, but they are
+        // all stale against the same routing info, so none of the writes are given up on
+        ASSERT(response.getOk());
+        ASSERT_EQUALS(response.getN(), kNumDocsToInsert);
+        ASSERT(!response.isErrDetailsSet());
+        ASSERT_GT(stats.numStaleShardBatches, kMaxRoundsWithoutProgress);
+    });
+
+    // The first batches sent to the shards all come back stale, then the writes succeed
+    int numStaleResponses = 0;
+    int numInserted = 0;
+    while (numInserted < kNumDocsToInsert) {
+        onCommandForPoolExecutor([&](const executor::RemoteCommandRequest& request) {
+            const auto opMsgRequest(OpMsgRequest::fromDBAndBody(request.dbname, request.cmdObj));
+            const auto actualBatchedInsert(BatchedCommandRequest::parseInsert(opMsgRequest));
+            const auto& inserted = actualBatchedInsert.getInsertRequest().getDocuments();
+
+            if (numStaleResponses <= kMaxRoundsWithoutProgress) {
+                ++numStaleResponses;
+                return expectInsertsReturnStaleVersionErrorsBase(nss, inserted, request);
+            }
+
+            numInserted += inserted.size();
+
+            BatchedCommandResponse response;
+            response.setStatus(Status::OK());
+            response.setN(inserted.size());
+            return response.toBSON();
+        });
+    }
+
+    future.default_timed_get();
+}
+
 TEST_F(BatchWriteExecTest, SingleOpError) {
     BatchedCommandResponse errResponse;
     errResponse.setStatus({ErrorCodes::UnknownError, "mock error"});
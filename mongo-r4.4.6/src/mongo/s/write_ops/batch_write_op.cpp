@@ -31,6 +31,7 @@
 
 #include "mongo/s/write_ops/batch_write_op.h"
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 
@@ -127,6 +128,15 @@ bool isNewBatchRequiredUnordered(const std::vector<TargetedWrite*>& writes,
     return false;
 }
 
+/**
+ * Helper to determine whether any of a number of targeted writes is for one of the given shards.
+ */
+bool targetsAnyShard(const std::vector<TargetedWrite*>& writes, const std::set<ShardId>& shardIds) {
+    return std::any_of(writes.begin(), writes.end(), [&](const TargetedWrite* write) {
+        return shardIds.count(write->endpoint.shardName) > 0;
+    });
+}
+
 /**
  * Helper to determine whether a number of targeted writes require a new targeted batch.
  */
@@ -262,7 +272,8 @@ BatchWriteOp::BatchWriteOp(OperationContext* opCtx, const BatchedCommandRequest&
 
 Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
                                  bool recordTargetErrors,
-                                 std::map<ShardId, TargetedWriteBatch*>* targetedBatches) {
+                                 std::map<ShardId, TargetedWriteBatch*>* targetedBatches,
+                                 const std::set<ShardId>* saturatedShards) {
     //
     // Targeting of unordered batches is fairly simple - each remaining write op is targeted,
     // and each of those targeted writes are grouped into a batch for a particular shard
@@ -298,6 +309,11 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const bool ordered = _clientRequest.getWriteCommandBase().getOrdered();
 
+    // Whether write ops which cannot be added to the current batches are skipped rather than
+    // ending this round of targeting
+    const bool skipWritesThatDoNotFit = saturatedShards != nullptr;
+    invariant(!skipWritesThatDoNotFit || (!ordered && !TransactionRouter::get(_opCtx)));
+
     TargetedBatchMap batchMap;
     std::set<ShardId> targetedShards;
 
@@ -378,6 +394,15 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
             write_ops::kWriteCommandBSONArrayPerElementOverheadBytes +
             (_batchTxnNum ? write_ops::kWriteCommandBSONArrayPerElementOverheadBytes + 4 : 0);
 
+        if (skipWritesThatDoNotFit) {
+            if (targetsAnyShard(writes, *saturatedShards) ||
+                wouldMakeBatchesTooBig(writes, writeSizeBytes, batchMap) ||
+                isNewBatchRequiredUnordered(writes, batchMap, targetedShards)) {
+                writeOp.cancelWrites(nullptr);
+                continue;
+            }
+        }
+
         if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchMap)) {
             invariant(!batchMap.empty());
             writeOp.cancelWrites(nullptr);
@@ -141,11 +141,18 @@ public:
      * (The idea here is that if we are sure our NSTargeter is up-to-date we should record
      * targeting errors, but if not we should refresh once first.)
      *
+     * If 'saturatedShards' is set, which is only allowed for unordered batches outside of a
+     * transaction, targeting does not stop at the first write op which cannot be added to the
+     * current batches. Write ops which target one of the 'saturatedShards', or which do not fit in
+     * the batch for their shard, are skipped and stay ready to be targeted by a later call, while
+     * the following write ops are still targeted.
+     *
      * Returned TargetedWriteBatches are owned by the caller.
      */
     Status targetBatch(const NSTargeter& targeter,
                        bool recordTargetErrors,
-                       std::map<ShardId, TargetedWriteBatch*>* targetedBatches);
+                       std::map<ShardId, TargetedWriteBatch*>* targetedBatches,
+                       const std::set<ShardId>* saturatedShards = nullptr);
 
     /**
      * Fills a BatchCommandRequest from a TargetedWriteBatch for this BatchWriteOp.
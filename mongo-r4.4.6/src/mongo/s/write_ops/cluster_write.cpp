@@ -47,8 +47,11 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/config_server_client.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/shard_util.h"
+#include "mongo/s/transaction_router.h"
 #include "mongo/s/write_ops/chunk_manager_targeter.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -69,6 +72,16 @@ void ClusterWriter::write(OperationContext* opCtx,
                           boost::optional<OID> targetEpoch) {
     const NamespaceString& nss = request.getNS();
 
+    // Once the write is done, stop serving cached finds which may not reflect it. A write made in
+    // a transaction only becomes visible when the transaction commits, so defer it until then.
+    ON_BLOCK_EXIT([&] {
+        if (auto txnRouter = TransactionRouter::get(opCtx)) {
+            txnRouter.onWriteToNamespace(nss);
+        } else {
+            ClusterQueryResultCache::get(opCtx).invalidate(nss);
+        }
+    });
+
     LastError::Disabled disableLastError(&LastError::get(opCtx->getClient()));
 
     // Config writes and shard writes are done differently